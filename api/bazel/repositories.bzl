@@ -133,17 +133,35 @@ go_proto_library(
     visibility = ["//visibility:public"],
 )
 
+api_cc_py_proto_library(
+    name = "resource",
+    srcs = [
+        "opentelemetry/proto/resource/v1/resource.proto",
+    ],
+    deps = [
+        "//:common",
+    ],
+    visibility = ["//visibility:public"],
+)
+
+go_proto_library(
+    name = "resource_go_proto",
+    importpath = "go.opentelemetry.io/proto/otlp/resource/v1",
+    proto = ":resource",
+    visibility = ["//visibility:public"],
+)
+
 # TODO(snowp): Generating one Go package from all of these protos could cause problems in the future,
-# but nothing references symbols from collector or resource so we're fine for now.
+# but nothing references symbols from collector so we're fine for now.
 api_cc_py_proto_library(
     name = "logs",
     srcs = [
         "opentelemetry/proto/collector/logs/v1/logs_service.proto",
         "opentelemetry/proto/logs/v1/logs.proto",
-        "opentelemetry/proto/resource/v1/resource.proto",
     ],
     deps = [
         "//:common",
+        "//:resource",
     ],
     visibility = ["//visibility:public"],
 )
@@ -154,6 +172,26 @@ go_proto_library(
     proto = ":logs",
     visibility = ["//visibility:public"],
 )
+
+api_cc_py_proto_library(
+    name = "trace",
+    srcs = [
+        "opentelemetry/proto/collector/trace/v1/trace_service.proto",
+        "opentelemetry/proto/trace/v1/trace.proto",
+    ],
+    deps = [
+        "//:common",
+        "//:resource",
+    ],
+    visibility = ["//visibility:public"],
+)
+
+go_proto_library(
+    name = "trace_go_proto",
+    importpath = "go.opentelemetry.io/proto/otlp/trace/v1",
+    proto = ":trace",
+    visibility = ["//visibility:public"],
+)
 """
 
 BUF_BUILD_CONTENT = """
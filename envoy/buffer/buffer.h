@@ -295,6 +295,27 @@ public:
     return search(data, size, start, 0);
   }
 
+  /**
+   * Search for the first occurrence of any of a set of bytes within the buffer. Like search(), this
+   * scans the slices of the buffer in place rather than linearizing it.
+   * @param bytes supplies the set of bytes to search for.
+   * @param start supplies the starting index to search from.
+   * @param length limits the search to specified number of bytes starting from start index.
+   * When length value is zero, entire length of data from starting index to the end is searched.
+   * @return the index of the first byte which is in the set or -1 if there is none.
+   */
+  virtual ssize_t findFirstOf(absl::string_view bytes, size_t start, size_t length) const PURE;
+
+  /**
+   * Search for the first occurrence of any of a set of bytes within the entire buffer.
+   * @param bytes supplies the set of bytes to search for.
+   * @param start supplies the starting index to search from.
+   * @return the index of the first byte which is in the set or -1 if there is none.
+   */
+  ssize_t findFirstOf(absl::string_view bytes, size_t start) const {
+    return findFirstOf(bytes, start, 0);
+  }
+
   /**
    * Search for an occurrence of data at the start of a buffer.
    * @param data supplies the data to search for.
@@ -75,6 +75,32 @@ public:
                                          const Http::ResponseTrailerMap& response_trailers,
                                          const StreamInfo::StreamInfo& stream_info,
                                          absl::string_view local_reply_body) const PURE;
+
+  /**
+   * Extract a value from the provided headers/trailers/stream and append it to the output.
+   * Providers which can append their value without building a temporary string override this.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param response_trailers supplies the response trailers.
+   * @param stream_info supplies the stream info.
+   * @param local_reply_body supplies the local reply body.
+   * @param output supplies the string to append the value to. It is left untouched if there is no
+   *        value.
+   * @return bool whether a value was appended.
+   */
+  virtual bool formatTo(const Http::RequestHeaderMap& request_headers,
+                        const Http::ResponseHeaderMap& response_headers,
+                        const Http::ResponseTrailerMap& response_trailers,
+                        const StreamInfo::StreamInfo& stream_info,
+                        absl::string_view local_reply_body, std::string& output) const {
+    const absl::optional<std::string> value =
+        format(request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+    if (!value.has_value()) {
+      return false;
+    }
+    output.append(value.value());
+    return true;
+  }
 };
 
 using FormatterProviderPtr = std::unique_ptr<FormatterProvider>;
@@ -226,6 +226,13 @@ public:
    * @return StreamInfo::StreamInfo& the stream_info for this stream.
    */
   virtual StreamInfo::StreamInfo& streamInfo() PURE;
+
+  /**
+   * @return HeaderMapArenaSharedPtr the arena the codec should allocate this stream's request
+   *         headers and trailers from, or nullptr to allocate them from the heap. Called once,
+   *         before any headers are decoded.
+   */
+  virtual HeaderMapArenaSharedPtr headerMapArena() PURE;
 };
 
 /**
@@ -451,6 +458,9 @@ struct Http1Settings {
   // True if this is an edge Envoy (using downstream address, no trusted hops)
   // and https:// URLs should be rejected over unencrypted connections.
   bool validate_scheme_{false};
+
+  // Use the vectorized HTTP/1 parser instead of http_parser.
+  bool use_vectorized_parser_{false};
 };
 
 /**
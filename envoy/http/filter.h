@@ -1049,6 +1049,13 @@ public:
    * @param return the worker thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Sets the name of the filter config whose filters are added next. It names the filters in the
+   * timing breakdown of the stream.
+   * @param name supplies the name of the filter config, which must outlive the stream.
+   */
+  virtual void setFilterConfigName(absl::string_view name) PURE;
 };
 
 /**
@@ -681,6 +681,35 @@ public:
 
 using HeaderMapPtr = std::unique_ptr<HeaderMap>;
 
+/**
+ * Memory arena that the header maps belonging to a single stream can allocate their entries from.
+ * Memory is returned to the system all at once when the arena is destroyed, which happens once the
+ * owning stream and every header map that allocated from the arena are gone. An arena is not
+ * thread safe and must only be used on the thread that owns the stream.
+ */
+class HeaderMapArena {
+public:
+  virtual ~HeaderMapArena() = default;
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment of the returned memory.
+   * @return void* the allocated memory. Never nullptr.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * Return memory previously obtained from allocate(). The arena may or may not be able to reuse
+   * it before the arena itself is destroyed.
+   * @param p supplies the memory to return.
+   * @param size supplies the size that was passed to allocate().
+   */
+  virtual void deallocate(void* p, size_t size) PURE;
+};
+
+using HeaderMapArenaSharedPtr = std::shared_ptr<HeaderMapArena>;
+
 /**
  * Wraps a set of header modifications.
  */
@@ -60,6 +60,27 @@ enum class DrainStrategy {
   Immediate,
 };
 
+/**
+ * What an access log file does with a write when the buffer of the writing thread is full, because
+ * the disk is not keeping up with the access log.
+ */
+enum class AccessLogOverflowPolicy {
+  /**
+   * The write is buffered in memory until the disk catches up.
+   */
+  Buffer,
+
+  /**
+   * The writing thread waits until there is room for the write.
+   */
+  Block,
+
+  /**
+   * The write is dropped.
+   */
+  Drop,
+};
+
 using CommandLineOptionsPtr = std::unique_ptr<envoy::admin::v3::CommandLineOptions>;
 
 /**
@@ -199,6 +220,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return AccessLogOverflowPolicy what to do with access log writes which the disk is not
+   *         keeping up with.
+   */
+  virtual AccessLogOverflowPolicy accessLogOverflowPolicy() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
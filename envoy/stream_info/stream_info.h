@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
@@ -20,6 +21,7 @@
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/singleton/const_singleton.h"
 
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -238,6 +240,48 @@ struct UpstreamTiming {
   absl::optional<MonotonicTime> last_upstream_rx_byte_received_;
 };
 
+/**
+ * Fine-grained timings of the hot path of a stream. They are only recorded when the connection
+ * manager is configured to, as each timing point reads the monotonic clock. Durations accumulate
+ * over all the callbacks of a stream, and over all the attempts of a request upstream. They are
+ * exclusive: the time of a timing point which runs nested in another, e.g. the encoder filters of
+ * a local reply sent from a decoder filter, is only added to the inner one.
+ */
+struct TimingBreakdown {
+  struct FilterTiming {
+    // The name of the filter config, which outlives the stream.
+    absl::string_view name_;
+    // The time spent in the decoder callbacks of the filter.
+    std::chrono::nanoseconds decode_{};
+    // The time spent in the encoder callbacks of the filter.
+    std::chrono::nanoseconds encode_{};
+  };
+
+  /**
+   * Adds a filter of the filter chain of the stream.
+   * @param name supplies the name of the filter config.
+   * @return the index of the timings of the filter in filters_.
+   */
+  uint32_t addFilter(absl::string_view name) {
+    filters_.push_back({name});
+    return filters_.size() - 1;
+  }
+
+  // The filters of the filter chain, in the order they were added.
+  std::vector<FilterTiming> filters_;
+  // The time spent selecting the route.
+  std::chrono::nanoseconds route_selection_{};
+  // The time spent selecting an upstream host and its connection pool.
+  std::chrono::nanoseconds host_selection_{};
+  // The time spent waiting for connection pools to provide upstream streams.
+  std::chrono::nanoseconds connection_pool_wait_{};
+  // The time spent encoding the response with the downstream codec.
+  std::chrono::nanoseconds codec_encode_{};
+  // The time covered by all the timing points which have completed, which the timing points
+  // enclosing them use to leave out their time.
+  std::chrono::nanoseconds timed_{};
+};
+
 // Measure the number of bytes sent and received for a stream.
 struct BytesMeter {
   uint64_t wireBytesSent() const { return wire_bytes_sent_; }
@@ -646,6 +690,17 @@ public:
    */
   virtual void setDownstreamBytesMeter(const BytesMeterSharedPtr& downstream_bytes_meter) PURE;
 
+  /**
+   * Starts recording the timing breakdown of the stream.
+   */
+  virtual void enableTimingBreakdown() PURE;
+
+  /**
+   * @return the timing breakdown of the stream, or nullptr if it is not recorded.
+   */
+  virtual TimingBreakdown* timingBreakdown() PURE;
+  virtual const TimingBreakdown* timingBreakdown() const PURE;
+
   static void syncUpstreamAndDownstreamBytesMeter(StreamInfo& downstream_info,
                                                   StreamInfo& upstream_info) {
     downstream_info.setUpstreamBytesMeter(upstream_info.getUpstreamBytesMeter());
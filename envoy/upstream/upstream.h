@@ -535,6 +535,7 @@ public:
   COUNTER(original_dst_host_invalid)                                                               \
   COUNTER(retry_or_shadow_abandoned)                                                               \
   COUNTER(update_attempt)                                                                          \
+  COUNTER(update_coalesced)                                                                        \
   COUNTER(update_empty)                                                                            \
   COUNTER(update_failure)                                                                          \
   COUNTER(update_no_rebuild)                                                                       \
@@ -760,6 +761,12 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the time constant of the stream demand average each connection pool uses to
+   *         preconnect ahead of predicted demand, if predictive per-pool preconnecting is enabled.
+   */
+  virtual absl::optional<std::chrono::milliseconds> preconnectDemandTimeConstant() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -995,6 +1002,12 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   *  @return whether streams to HTTP/2 only hosts are carried by a single worker's connection pool
+   *          for each host rather than by a pool on every worker.
+   */
+  virtual bool shareHttp2ConnectionPoolAcrossWorkers() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
@@ -1,5 +1,7 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -8,7 +10,7 @@
 #include "source/common/common/fmt.h"
 #include "source/common/common/lock_guard.h"
 
-#include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
 namespace AccessLog {
@@ -34,29 +36,156 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = std::make_shared<AccessLogFlushThread>(api_.threadFactory());
+  }
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_, flush_thread_,
+      overflow_policy_);
   return access_logs_[file_name];
 }
 
+AccessLogRingBuffer::AccessLogRingBuffer(uint64_t capacity)
+    : capacity_(capacity), data_(new char[capacity]) {
+  ASSERT(capacity_ > 0 && (capacity_ & (capacity_ - 1)) == 0);
+}
+
+bool AccessLogRingBuffer::write(absl::string_view data) {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  const uint64_t tail = tail_.load(std::memory_order_acquire);
+  if (capacity_ - (head - tail) < data.size()) {
+    return false;
+  }
+
+  const uint64_t offset = head & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(data.size(), capacity_ - offset);
+  memcpy(data_.get() + offset, data.data(), first);
+  memcpy(data_.get(), data.data() + first, data.size() - first);
+  head_.store(head + data.size(), std::memory_order_release);
+  return true;
+}
+
+uint64_t AccessLogRingBuffer::drainTo(std::string& output) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  const uint64_t length = head - tail;
+  if (length == 0) {
+    return 0;
+  }
+
+  const uint64_t offset = tail & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(length, capacity_ - offset);
+  output.append(data_.get() + offset, first);
+  output.append(data_.get(), length - first);
+  tail_.store(head, std::memory_order_release);
+  return length;
+}
+
+AccessLogRingBufferPtr AccessLogRingBuffer::grow() const {
+  auto grown = std::make_unique<AccessLogRingBuffer>(capacity_ * 2);
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t length = head_.load(std::memory_order_relaxed) - tail;
+  const uint64_t offset = tail & (capacity_ - 1);
+  const uint64_t first = std::min<uint64_t>(length, capacity_ - offset);
+  memcpy(grown->data_.get(), data_.get() + offset, first);
+  memcpy(grown->data_.get() + first, data_.get(), length - first);
+  grown->head_.store(length, std::memory_order_relaxed);
+  return grown;
+}
+
+AccessLogFlushThread::~AccessLogFlushThread() {
+  {
+    Thread::LockGuard lock(wake_lock_);
+    exit_ = true;
+    wake_event_.notifyOne();
+  }
+
+  if (thread_ != nullptr) {
+    thread_->join();
+  }
+}
+
+void AccessLogFlushThread::addFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.push_back(&file);
+}
+
+void AccessLogFlushThread::removeFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.erase(std::remove(files_.begin(), files_.end(), &file), files_.end());
+}
+
+void AccessLogFlushThread::wake() {
+  Thread::LockGuard lock(wake_lock_);
+  if (thread_ == nullptr) {
+    thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
+                                           Thread::Options{"AccessLogFlush"});
+  }
+  wake_pending_ = true;
+  wake_event_.notifyOne();
+}
+
+void AccessLogFlushThread::flushThreadFunc() {
+  while (true) {
+    {
+      Thread::LockGuard lock(wake_lock_);
+      while (!wake_pending_ && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        wake_event_.wait(wake_lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+      wake_pending_ = false;
+    }
+
+    Thread::LockGuard lock(files_lock_);
+    for (AccessLogFileImpl* file : files_) {
+      file->flushIfRequested();
+    }
+  }
+}
+
+namespace {
+
+uint64_t nextFileId() {
+  static std::atomic<uint64_t> next_id{};
+  return next_id++;
+}
+
+struct ThreadRingBuffer {
+  AccessLogRingBuffer* ring_buffer_{};
+  // Expires once the file is destroyed, so that the entry can be forgotten.
+  std::weak_ptr<AccessLogRingBuffer> owner_;
+};
+
+// The ring buffers of the files the thread has written to. Files are looked up by id rather than
+// by address, so that a file which reuses the address of a destroyed one gets a ring of its own.
+thread_local absl::flat_hash_map<uint64_t, ThreadRingBuffer> thread_ring_buffers;
+
+} // namespace
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
+                                     AccessLogFlushThreadSharedPtr flush_thread,
+                                     Server::AccessLogOverflowPolicy overflow_policy)
+    : id_(nextFileId()), file_(std::move(file)), file_lock_(lock),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        requestFlush();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flush_thread_(std::move(flush_thread)), overflow_policy_(overflow_policy),
+      flush_interval_msec_(flush_interval_msec), stats_(stats) {
   flush_timer_->enableTimer(flush_interval_msec_);
   auto open_result = open();
   if (!open_result.return_value_) {
     throw EnvoyException(fmt::format("unable to open file '{}': {}", file_->path(),
                                      open_result.err_->getErrorDetails()));
   }
+  flush_thread_->addFile(*this);
 }
 
 Filesystem::FlagSet AccessLogFileImpl::defaultFlags() {
@@ -75,30 +204,19 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flush_thread_->removeFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
+  Thread::LockGuard flush_lock(flush_lock_);
+  flushLocked();
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
-    }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
                                              result.err_->getErrorDetails()));
   }
 }
 
-void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
-  Buffer::RawSliceVector slices = buffer.getRawSlices();
-
+void AccessLogFileImpl::doWrite(absl::string_view data) {
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
   // different AccessLogFileImpl pointing to the same underlying file. This can happen either via
   // hot restart or if calling code opens the same underlying file into a different
@@ -109,106 +227,171 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   //            process lock or had multiple locks.
   {
     Thread::LockGuard lock(file_lock_);
-    for (const Buffer::RawSlice& slice : slices) {
-      absl::string_view data(static_cast<char*>(slice.mem_), slice.len_);
-      const Api::IoCallSizeResult result = file_->write(data);
-      if (result.ok() && result.return_value_ == static_cast<ssize_t>(slice.len_)) {
-        stats_.write_completed_.inc();
-      } else {
-        // Probably disk full.
-        stats_.write_failed_.inc();
-      }
+    const Api::IoCallSizeResult result = file_->write(data);
+    if (result.ok() && result.return_value_ == static_cast<ssize_t>(data.size())) {
+      stats_.write_completed_.inc();
+    } else {
+      // Probably disk full.
+      stats_.write_failed_.inc();
     }
   }
-
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
-
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
-
-    {
-      Thread::LockGuard write_lock(write_lock_);
-
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
-
-      if (flush_thread_exit_) {
-        return;
-      }
-
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
+void AccessLogFileImpl::flushLocked() {
+  // Gather everything which has been buffered so far, so that it goes to disk in a single write.
+  // Only one flush runs at a time, which makes it the only reader of the ring buffers.
+  {
+    Thread::LockGuard lock(ring_buffers_lock_);
+    for (const AccessLogRingBufferSharedPtr& ring_buffer : ring_buffers_) {
+      ring_buffer->drainTo(about_to_write_buffer_);
     }
+  }
+  if (blocked_writers_.load() > 0) {
+    Thread::LockGuard lock(space_lock_);
+    space_event_.notifyAll();
+  }
+  {
+    Thread::LockGuard lock(overflow_lock_);
+    about_to_write_buffer_.append(overflow_buffer_);
+    overflow_buffer_.clear();
+  }
 
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      if (reopen_file_) {
-        reopen_file_ = false;
-        const Api::IoCallBoolResult result = file_->close();
-        ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                                 result.err_->getErrorDetails()));
-        const Api::IoCallBoolResult open_result = open();
-        if (!open_result.return_value_) {
-          stats_.reopen_failed_.inc();
-          return;
-        }
-      }
-      doWrite(about_to_write_buffer_);
+  // if we failed to open file before, then simply ignore
+  if (file_->isOpen() && reopen_file_.exchange(false)) {
+    const Api::IoCallBoolResult result = file_->close();
+    ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                             result.err_->getErrorDetails()));
+    const Api::IoCallBoolResult open_result = open();
+    if (!open_result.return_value_) {
+      stats_.reopen_failed_.inc();
     }
   }
+
+  if (about_to_write_buffer_.empty()) {
+    return;
+  }
+  if (file_->isOpen()) {
+    doWrite(about_to_write_buffer_);
+  }
+  stats_.write_total_buffered_.sub(about_to_write_buffer_.size());
+  about_to_write_buffer_.clear();
+}
+
+void AccessLogFileImpl::flushIfRequested() {
+  if (!flush_requested_.exchange(false)) {
+    return;
+  }
+  Thread::LockGuard flush_lock(flush_lock_);
+  flushLocked();
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
+  // flush_lock_ must be held while draining, or else it is possible that the flush thread has
+  // already drained the buffered data but has not yet completed doWrite(). This would allow
+  // flush() to return before the pending data has actually been written to disk.
+  Thread::LockGuard flush_lock(flush_lock_);
+  flushLocked();
+}
 
-  {
-    Thread::LockGuard write_lock(write_lock_);
+void AccessLogFileImpl::requestFlush() {
+  if (!flush_requested_.exchange(true)) {
+    flush_thread_->wake();
+  }
+}
 
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+AccessLogRingBuffer& AccessLogFileImpl::threadRingBuffer(bool& created) {
+  auto it = thread_ring_buffers.find(id_);
+  created = it == thread_ring_buffers.end();
+  if (!created) {
+    return *it->second.ring_buffer_;
+  }
 
-    if (flush_buffer_.length() == 0) {
-      return;
+  // Forget the ring buffers of the files which were destroyed since the thread last started
+  // writing to a file, so that the entries do not pile up as files come and go.
+  for (auto entry = thread_ring_buffers.begin(); entry != thread_ring_buffers.end();) {
+    if (entry->second.owner_.expired()) {
+      thread_ring_buffers.erase(entry++);
+    } else {
+      ++entry;
     }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
   }
 
-  doWrite(about_to_write_buffer_);
+  auto ring_buffer = std::make_shared<AccessLogRingBuffer>(INITIAL_RING_BUFFER_SIZE);
+  thread_ring_buffers[id_] = {ring_buffer.get(), ring_buffer};
+  Thread::LockGuard lock(ring_buffers_lock_);
+  ring_buffers_.push_back(ring_buffer);
+  return *ring_buffer;
 }
 
-void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
-
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+AccessLogRingBuffer& AccessLogFileImpl::growThreadRingBuffer(AccessLogRingBuffer& ring_buffer) {
+  // The ring buffers are only drained under the lock, so holding it keeps the flush thread away
+  // while the data is moved over.
+  Thread::LockGuard lock(ring_buffers_lock_);
+  AccessLogRingBufferSharedPtr grown = ring_buffer.grow();
+  for (AccessLogRingBufferSharedPtr& entry : ring_buffers_) {
+    if (entry.get() == &ring_buffer) {
+      entry = grown;
+      break;
+    }
   }
+  thread_ring_buffers[id_] = {grown.get(), grown};
+  return *grown;
+}
 
+void AccessLogFileImpl::write(absl::string_view data) {
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+
+  if (data.size() > MAX_RING_BUFFER_SIZE) {
+    {
+      Thread::LockGuard lock(overflow_lock_);
+      overflow_buffer_.append(data.data(), data.size());
+    }
+    requestFlush();
+    return;
   }
-}
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
-                                               Thread::Options{"AccessLogFlush"});
+  // The first write from each thread is flushed right away, which also gets the flush thread
+  // started.
+  bool created;
+  AccessLogRingBuffer* ring_buffer = &threadRingBuffer(created);
+  bool written = ring_buffer->write(data);
+  while (!written && ring_buffer->capacity() < MAX_RING_BUFFER_SIZE) {
+    ring_buffer = &growThreadRingBuffer(*ring_buffer);
+    written = ring_buffer->write(data);
+  }
+  if (written) {
+    // A flush is asked for before the ring buffer fills up, so that it only grows when the flush
+    // thread does not get to it in time.
+    if (created || ring_buffer->length() > std::min(MIN_FLUSH_SIZE, ring_buffer->capacity() / 2)) {
+      requestFlush();
+    }
+    return;
+  }
+
+  // The ring buffer is full at its largest size: the flush thread is not keeping up with the disk.
+  switch (overflow_policy_) {
+  case Server::AccessLogOverflowPolicy::Buffer: {
+    Thread::LockGuard lock(overflow_lock_);
+    overflow_buffer_.append(data.data(), data.size());
+    break;
+  }
+  case Server::AccessLogOverflowPolicy::Block:
+    stats_.write_blocked_.inc();
+    blocked_writers_++;
+    while (!ring_buffer->write(data)) {
+      requestFlush();
+      Thread::LockGuard lock(space_lock_);
+      space_event_.waitFor(space_lock_, std::chrono::milliseconds(10));
+    }
+    blocked_writers_--;
+    break;
+  case Server::AccessLogOverflowPolicy::Drop:
+    stats_.write_dropped_.inc();
+    stats_.write_total_buffered_.sub(data.length());
+    break;
+  }
+  requestFlush();
 }
 
 } // namespace AccessLog
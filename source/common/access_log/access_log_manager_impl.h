@@ -1,15 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/filesystem/filesystem.h"
+#include "envoy/server/options.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stats/store.h"
 
-#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
@@ -20,8 +24,10 @@ namespace Envoy {
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
+  COUNTER(write_blocked)                                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
 
@@ -31,15 +37,20 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+class AccessLogFlushThread;
+using AccessLogFlushThreadSharedPtr = std::shared_ptr<AccessLogFlushThread>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
-  AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
-                       Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
+  AccessLogManagerImpl(
+      std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
+      Event::Dispatcher& dispatcher, Thread::BasicLockable& lock, Stats::Store& stats_store,
+      Server::AccessLogOverflowPolicy overflow_policy = Server::AccessLogOverflowPolicy::Buffer)
       : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
-                         ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                                               POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
+        lock_(lock), overflow_policy_(overflow_policy),
+        file_stats_{ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
+                                          POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
 
   // AccessLog::AccessLogManager
@@ -51,23 +62,116 @@ private:
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
+  const Server::AccessLogOverflowPolicy overflow_policy_;
   AccessLogFileStats file_stats_;
+  AccessLogFlushThreadSharedPtr flush_thread_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
+/**
+ * A ring buffer which a single thread writes access log data into, and which is drained by one
+ * thread at a time, without either side taking a lock.
+ */
+class AccessLogRingBuffer {
+public:
+  explicit AccessLogRingBuffer(uint64_t capacity);
+
+  /**
+   * Copy data into the ring. Only called by the thread which owns the ring.
+   * @return whether there was room for all of the data. Nothing is written if there was not.
+   */
+  bool write(absl::string_view data);
+
+  /**
+   * Move all of the data in the ring to the end of the output. Callers must make sure that only
+   * one thread drains the ring at a time.
+   * @return the number of bytes moved.
+   */
+  uint64_t drainTo(std::string& output);
+
+  /**
+   * @return the number of bytes in the ring. Exact only when called by the writing thread with no
+   * concurrent drain.
+   */
+  uint64_t length() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  uint64_t capacity() const { return capacity_; }
+
+  /**
+   * @return a ring of twice the capacity which holds the data of this one. Callers must make sure
+   * that the ring is neither written to nor drained concurrently.
+   */
+  std::unique_ptr<AccessLogRingBuffer> grow() const;
+
+private:
+  const uint64_t capacity_;
+  const std::unique_ptr<char[]> data_;
+  // The total number of bytes ever written to and drained from the ring. Each is only stored to by
+  // one side, and they are kept on separate cache lines so the two sides do not contend.
+  alignas(64) std::atomic<uint64_t> head_{};
+  alignas(64) std::atomic<uint64_t> tail_{};
+};
+
+using AccessLogRingBufferPtr = std::unique_ptr<AccessLogRingBuffer>;
+using AccessLogRingBufferSharedPtr = std::shared_ptr<AccessLogRingBuffer>;
+
+/**
+ * A single thread which writes out the buffered data of every access log file, so that files do
+ * not each need a thread of their own. The thread is only started once there is data to flush.
+ */
+class AccessLogFlushThread {
+public:
+  explicit AccessLogFlushThread(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+  ~AccessLogFlushThread();
+
+  void addFile(AccessLogFileImpl& file);
+
+  /**
+   * Stop flushing a file. Waits for a flush of the file which is in progress to complete.
+   */
+  void removeFile(AccessLogFileImpl& file);
+
+  /**
+   * Have the thread go over the files and flush the ones which asked for it. May be called from
+   * any thread.
+   */
+  void wake();
+
+private:
+  void flushThreadFunc();
+
+  Thread::ThreadFactory& thread_factory_;
+  // Held while files are being flushed, so that a file is not destroyed in the middle of a flush.
+  Thread::MutexBasicLockable files_lock_;
+  std::vector<AccessLogFileImpl*> files_ ABSL_GUARDED_BY(files_lock_);
+  // Only held for short periods, so that waking the thread does not wait on the disk.
+  Thread::MutexBasicLockable wake_lock_;
+  Thread::CondVar wake_event_;
+  bool wake_pending_ ABSL_GUARDED_BY(wake_lock_){};
+  bool exit_ ABSL_GUARDED_BY(wake_lock_){};
+  Thread::ThreadPtr thread_ ABSL_GUARDED_BY(wake_lock_);
+};
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore buffered and written to disk by a flush thread which is shared by all
+ * files. Each thread which writes to the file has a ring buffer of its own, so that threads do not
+ * contend with each other or with the flush thread. A ring buffer starts small and doubles in size
+ * whenever it fills up before the flush thread gets to it. When a thread's ring buffer is full at
+ * its largest size, because the disk cannot keep up, the write is buffered under a lock, waits for
+ * the ring buffer to be flushed or is dropped, according to the overflow policy.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlushThreadSharedPtr flush_thread,
+                    Server::AccessLogOverflowPolicy overflow_policy);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -81,24 +185,41 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * Write out the buffered data if a flush was asked for since the last one. Called by the flush
+   * thread.
+   */
+  void flushIfRequested();
+
 private:
-  void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  // Returns the ring buffer of the calling thread, creating it on the thread's first write.
+  AccessLogRingBuffer& threadRingBuffer(bool& created);
+  // Replaces the ring buffer of the calling thread with one of twice the size.
+  AccessLogRingBuffer& growThreadRingBuffer(AccessLogRingBuffer& ring_buffer);
+  void requestFlush();
+  void flushLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(flush_lock_);
+  void doWrite(absl::string_view data);
   Api::IoCallBoolResult open();
-  void createFlushStructures();
 
   // return default flags set which used by open
   static Filesystem::FlagSet defaultFlags();
 
   // Minimum size before the flush thread will be told to flush.
-  static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  static constexpr uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  // Initial size of the ring buffer of each thread.
+  static constexpr uint64_t INITIAL_RING_BUFFER_SIZE = 1024 * 16;
+  // Size up to which the ring buffer of a thread grows. Writes which are larger than this are
+  // buffered under a lock instead.
+  static constexpr uint64_t MAX_RING_BUFFER_SIZE = 1024 * 256;
 
+  // Identifies the file in the per-thread lookup of ring buffers. Unlike the address of the file,
+  // it is never reused.
+  const uint64_t id_;
   Filesystem::FilePtr file_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
-  //    3) file_lock_
+  //    1) flush_lock_
+  //    2) ring_buffers_lock_, overflow_lock_ or file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -107,29 +228,31 @@ private:
                                           // the flush thread and a synchronous flush. This protects
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
-                                          // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
-  std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
+                                          // re-opening. It makes the flush the only thread which
+                                          // drains the ring buffers.
+  Thread::MutexBasicLockable ring_buffers_lock_; // Protects the list of ring buffers, which only
+                                                 // changes when a thread first writes to the file
+                                                 // or grows its ring buffer. The ring buffers are
+                                                 // only drained under it.
+  std::vector<AccessLogRingBufferSharedPtr> ring_buffers_ ABSL_GUARDED_BY(ring_buffers_lock_);
+  Thread::MutexBasicLockable overflow_lock_;
+  std::string overflow_buffer_ ABSL_GUARDED_BY(overflow_lock_); // Writes which are too large for
+                                                                // a ring buffer.
   // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
   // through the std::make_unique assignment. I do not believe it's possible to annotate this
   // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  std::string about_to_write_buffer_; // This buffer is used only while flushing. Data is moved to
+                                      // it from the ring buffers, and then written to disk at
+                                      // once.
+  // Writers which wait for room in their ring buffer under the Block policy wait on this.
+  Thread::MutexBasicLockable space_lock_;
+  Thread::CondVar space_event_;
+  std::atomic<uint32_t> blocked_writers_{};
+  std::atomic<bool> flush_requested_{};
+  std::atomic<bool> reopen_file_{};
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
+  const AccessLogFlushThreadSharedPtr flush_thread_;
+  const Server::AccessLogOverflowPolicy overflow_policy_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
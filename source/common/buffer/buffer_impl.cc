@@ -5,10 +5,18 @@
 #include <string>
 
 #include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/macros.h"
+#include "source/common/common/thread.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_set.h"
 #include "event2/buffer.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace Envoy {
 namespace Buffer {
 namespace {
@@ -17,9 +25,212 @@ namespace {
 // TODO(yanavlasov): This may not be optimal for all hardware configurations or traffic patterns and
 // may need to be configurable in the future.
 constexpr uint64_t CopyThreshold = 512;
+
+#if defined(__SSE2__)
+/**
+ * @return the first position in [p, end) at which the needle starts, or nullptr if there is none.
+ * Every match starting in [p, end) must end within the same contiguous memory. Checks 16 candidate
+ * positions at a time by comparing both the first and the last byte of the needle, which filters
+ * out most candidates before any memcmp().
+ */
+const uint8_t* findByFirstAndLastByte(const uint8_t* p, const uint8_t* end, const uint8_t* needle,
+                                      uint64_t size) {
+  ASSERT(size > 1);
+  const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+  const __m128i last = _mm_set1_epi8(static_cast<char>(needle[size - 1]));
+  while (end - p >= 16) {
+    const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + size - 1));
+    int mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+    while (mask != 0) {
+      const int candidate = __builtin_ctz(mask);
+      if (memcmp(p + candidate + 1, needle + 1, size - 2) == 0) {
+        return p + candidate;
+      }
+      mask &= mask - 1;
+    }
+    p += 16;
+  }
+  for (; p < end; ++p) {
+    if (*p == needle[0] && memcmp(p + 1, needle + 1, size - 1) == 0) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+#endif
+
+/**
+ * Finds the first byte of a range which is in a set of bytes. Where SSE2 is available, small sets
+ * are compared against 16 bytes at a time. Larger sets use a lookup table.
+ */
+class ByteSetScanner {
+public:
+  explicit ByteSetScanner(absl::string_view bytes) : bytes_(bytes) {
+    ASSERT(!bytes.empty());
+#if defined(__SSE2__)
+    if (bytes_.size() <= MaxVectorSetSize) {
+      for (size_t i = 0; i < MaxVectorSetSize; i++) {
+        // Repeat the last byte to fill the unused entries, so the scan needs no bounds checks.
+        vectors_[i] = _mm_set1_epi8(bytes_[std::min(i, bytes_.size() - 1)]);
+      }
+      return;
+    }
+#endif
+    for (const char c : bytes_) {
+      table_[static_cast<uint8_t>(c)] = true;
+    }
+  }
+
+  /**
+   * @return the first byte in [p, end) which is in the set, or nullptr if there is none.
+   */
+  const uint8_t* find(const uint8_t* p, const uint8_t* end) const {
+    if (bytes_.size() == 1) {
+      return static_cast<const uint8_t*>(memchr(p, bytes_[0], end - p));
+    }
+#if defined(__SSE2__)
+    if (bytes_.size() <= MaxVectorSetSize) {
+      while (end - p >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i found = _mm_cmpeq_epi8(block, vectors_[0]);
+        for (size_t i = 1; i < MaxVectorSetSize; i++) {
+          found = _mm_or_si128(found, _mm_cmpeq_epi8(block, vectors_[i]));
+        }
+        const int mask = _mm_movemask_epi8(found);
+        if (mask != 0) {
+          return p + __builtin_ctz(mask);
+        }
+        p += 16;
+      }
+      for (; p < end; ++p) {
+        if (bytes_.find(static_cast<char>(*p)) != absl::string_view::npos) {
+          return p;
+        }
+      }
+      return nullptr;
+    }
+#endif
+    for (; p < end; ++p) {
+      if (table_[*p]) {
+        return p;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  // Beyond this many bytes, a table lookup per byte is cheaper than a comparison per set member.
+  static constexpr size_t MaxVectorSetSize = 4;
+
+  const absl::string_view bytes_;
+#if defined(__SSE2__)
+  __m128i vectors_[MaxVectorSetSize];
+#endif
+  bool table_[256]{};
+};
+
+// The pools of all running threads, and the stats of the pools of threads which have exited.
+struct SliceStoragePoolRegistry {
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_set<const SliceStoragePool*> pools_ ABSL_GUARDED_BY(mutex_);
+  SliceStoragePool::Stats retired_stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+SliceStoragePoolRegistry& poolRegistry() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(SliceStoragePoolRegistry);
+}
+
+void addStats(SliceStoragePool::Stats& total, const SliceStoragePool::Stats& stats) {
+  total.hits_ += stats.hits_;
+  total.misses_ += stats.misses_;
+  total.watermark_releases_ += stats.watermark_releases_;
+  total.cached_bytes_ += stats.cached_bytes_;
+}
+
+// Trivially destructible, so that they can still be read while the thread is exiting.
+thread_local SliceStoragePool* thread_pool = nullptr;
+thread_local bool thread_pool_destroyed = false;
+
+// Destroys the calling thread's pool when the thread exits. Slices destroyed after that, for
+// example by other thread local objects, go straight back to the allocator.
+struct SliceStoragePoolReaper {
+  ~SliceStoragePoolReaper() {
+    delete thread_pool;
+    thread_pool = nullptr;
+    thread_pool_destroyed = true;
+  }
+  bool armed_{};
+};
+thread_local SliceStoragePoolReaper thread_pool_reaper;
+
 } // namespace
 
-thread_local absl::InlinedVector<Slice::StoragePtr, Slice::free_list_max_> Slice::free_list_;
+SliceStoragePool::SliceStoragePool() {
+  SliceStoragePoolRegistry& registry = poolRegistry();
+  Thread::LockGuard lock(registry.mutex_);
+  registry.pools_.insert(this);
+}
+
+SliceStoragePool::~SliceStoragePool() {
+  clear();
+  SliceStoragePoolRegistry& registry = poolRegistry();
+  Thread::LockGuard lock(registry.mutex_);
+  registry.pools_.erase(this);
+  addStats(registry.retired_stats_, stats());
+}
+
+SliceStoragePool* SliceStoragePool::threadLocal() {
+  if (thread_pool == nullptr && !thread_pool_destroyed) {
+    // Touching the reaper registers its destructor to run when the thread exits.
+    thread_pool_reaper.armed_ = true;
+    thread_pool = new SliceStoragePool();
+  }
+  return thread_pool;
+}
+
+SliceStoragePool::Stats SliceStoragePool::aggregateStats() {
+  SliceStoragePoolRegistry& registry = poolRegistry();
+  Thread::LockGuard lock(registry.mutex_);
+  Stats total = registry.retired_stats_;
+  for (const SliceStoragePool* pool : registry.pools_) {
+    addStats(total, pool->stats());
+  }
+  return total;
+}
+
+SliceStoragePool::Stats SliceStoragePool::stats() const {
+  Stats stats;
+  stats.hits_ = stats_.hits_.load(std::memory_order_relaxed);
+  stats.misses_ = stats_.misses_.load(std::memory_order_relaxed);
+  stats.watermark_releases_ = stats_.watermark_releases_.load(std::memory_order_relaxed);
+  stats.cached_bytes_ = stats_.cached_bytes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void SliceStoragePool::clear() {
+  for (FreeList& free_list : free_lists_) {
+    free_list.clear();
+  }
+  cached_bytes_ = 0;
+  publishCachedBytes();
+}
+
+void SliceStoragePool::releaseToLowWatermark() {
+  for (uint32_t size_class = num_size_classes_; size_class-- > 0;) {
+    FreeList& free_list = free_lists_[size_class];
+    const uint64_t capacity = (size_class + 1) * page_size_;
+    while (!free_list.empty() && cached_bytes_ > low_watermark_bytes_) {
+      free_list.pop_back();
+      cached_bytes_ -= capacity;
+      bump(stats_.watermark_releases_, 1);
+    }
+    if (cached_bytes_ <= low_watermark_bytes_) {
+      return;
+    }
+  }
+}
 
 void OwnedImpl::addImpl(const void* data, uint64_t size) {
   const char* src = static_cast<const char*>(data);
@@ -429,85 +640,129 @@ void OwnedImpl::commit(uint64_t length, absl::Span<RawSlice> slices,
 }
 
 ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start, size_t length) const {
-  // This implementation uses the same search algorithm as evbuffer_search(), a naive
-  // scan that requires O(M*N) comparisons in the worst case.
-  // TODO(brian-pane): replace this with a more efficient search if it shows up
-  // prominently in CPU profiling.
   if (size == 0) {
     return (start <= length_) ? start : -1;
   }
 
-  // length equal to zero means that entire buffer must be searched.
-  // Adjust the length to buffer length taking the staring index into account.
-  size_t left_to_search = length;
-  if (0 == length) {
-    left_to_search = length_ - start;
+  // length equal to zero means that entire buffer must be searched. A match has to lie entirely
+  // within the searched range.
+  const uint64_t search_end =
+      (length == 0) ? length_ : std::min<uint64_t>(length_, static_cast<uint64_t>(start) + length);
+  if (start >= search_end || search_end - start < size) {
+    return -1;
   }
-  ssize_t offset = 0;
+  // The index of the last byte at which a match can start.
+  const uint64_t last_match_start = search_end - size;
+
   const uint8_t* needle = static_cast<const uint8_t*>(data);
-  for (size_t slice_index = 0; slice_index < slices_.size() && (left_to_search > 0);
+#if defined(__SSE2__)
+  static constexpr uint32_t MaxFalseCandidates = 8;
+  uint32_t false_candidates = 0;
+#endif
+  uint64_t offset = 0;
+  for (size_t slice_index = 0; slice_index < slices_.size() && offset <= last_match_start;
        slice_index++) {
     const auto& slice = slices_[slice_index];
-    uint64_t slice_size = slice.dataSize();
-    if (slice_size <= start) {
-      start -= slice_size;
+    const uint64_t slice_size = slice.dataSize();
+    if (offset + slice_size <= start) {
       offset += slice_size;
       continue;
     }
+
     const uint8_t* slice_start = slice.data();
-    const uint8_t* haystack = slice_start;
-    const uint8_t* haystack_end = haystack + slice_size;
-    haystack += start;
-    while (haystack < haystack_end) {
-      const size_t slice_search_limit =
-          std::min(static_cast<size_t>(haystack_end - haystack), left_to_search);
-      // Search within this slice for the first byte of the needle.
-      const uint8_t* first_byte_match =
-          static_cast<const uint8_t*>(memchr(haystack, needle[0], slice_search_limit));
+    const uint8_t* haystack = slice_start + (std::max<uint64_t>(start, offset) - offset);
+    const uint8_t* candidates_end =
+        slice_start + (std::min(last_match_start + 1, offset + slice_size) - offset);
+
+    // Matches starting before in_slice_end lie entirely within this slice. Those starting after
+    // it continue into the following slices.
+    const uint8_t* in_slice_end =
+        slice_size >= size ? std::min(candidates_end, slice_start + slice_size - size + 1)
+                           : slice_start;
+    while (haystack < candidates_end) {
+      const uint8_t* first_byte_match = static_cast<const uint8_t*>(
+          memchr(haystack, needle[0], static_cast<size_t>(candidates_end - haystack)));
       if (first_byte_match == nullptr) {
-        left_to_search -= slice_search_limit;
         break;
       }
-      // After finding a match for the first byte of the needle, check whether the following
-      // bytes in the buffer match the remainder of the needle. Note that the match can span
-      // two or more slices.
-      left_to_search -= static_cast<size_t>(first_byte_match - haystack + 1);
-      // Save the current number of bytes left to search.
-      // If the pattern is not found, the search will resume from the next byte
-      // and left_to_search value must be restored.
-      const size_t saved_left_to_search = left_to_search;
-      size_t i = 1;
-      size_t match_index = slice_index;
-      const uint8_t* match_next = first_byte_match + 1;
-      const uint8_t* match_end = haystack_end;
-      while ((i < size) && (0 < left_to_search)) {
-        if (match_next >= match_end) {
-          // We've hit the end of this slice, so continue checking against the next slice.
-          match_index++;
-          if (match_index == slices_.size()) {
-            // We've hit the end of the entire buffer.
-            break;
-          }
-          const auto& match_slice = slices_[match_index];
-          match_next = match_slice.data();
-          match_end = match_next + match_slice.dataSize();
-          continue;
-        }
-        left_to_search--;
-        if (*match_next++ != needle[i]) {
-          break;
+      if (first_byte_match >= in_slice_end) {
+        if (matchesAcrossSlices(slice_index, first_byte_match - slice_start, needle, size)) {
+          return offset + (first_byte_match - slice_start);
         }
-        i++;
-      }
-      if (i == size) {
-        // Successful match of the entire needle.
+      } else if (memcmp(first_byte_match + 1, needle + 1, size - 1) == 0) {
         return offset + (first_byte_match - slice_start);
       }
-      // If this wasn't a successful match, start scanning again at the next byte.
       haystack = first_byte_match + 1;
-      left_to_search = saved_left_to_search;
+#if defined(__SSE2__)
+      // memchr() is the fastest way through content in which the first byte of the needle is rare.
+      // Once it keeps stopping at candidates which do not match, the rest of the in-slice range
+      // is searched by comparing both the first and the last byte of the needle instead.
+      if (size > 1 && haystack < in_slice_end && ++false_candidates >= MaxFalseCandidates) {
+        const uint8_t* match = findByFirstAndLastByte(haystack, in_slice_end, needle, size);
+        if (match != nullptr) {
+          return offset + (match - slice_start);
+        }
+        haystack = in_slice_end;
+      }
+#endif
+    }
+    offset += slice_size;
+  }
+  return -1;
+}
+
+bool OwnedImpl::matchesAcrossSlices(size_t slice_index, uint64_t slice_offset,
+                                    const uint8_t* needle, uint64_t size) const {
+  while (size != 0 && slice_index < slices_.size()) {
+    const auto& slice = slices_[slice_index];
+    const uint64_t compare_size = std::min(slice.dataSize() - slice_offset, size);
+    const uint8_t* slice_data = slice.data() + slice_offset;
+    // Matches usually fail within the first few bytes, which are cheaper to compare inline.
+    uint64_t i = 0;
+    for (; i < compare_size && i < 8; i++) {
+      if (slice_data[i] != needle[i]) {
+        return false;
+      }
+    }
+    if (i < compare_size && memcmp(slice_data + i, needle + i, compare_size - i) != 0) {
+      return false;
+    }
+    needle += compare_size;
+    size -= compare_size;
+    slice_index++;
+    slice_offset = 0;
+  }
+  return size == 0;
+}
+
+ssize_t OwnedImpl::findFirstOf(absl::string_view bytes, size_t start, size_t length) const {
+  if (bytes.empty()) {
+    return -1;
+  }
+  const uint64_t search_end =
+      (length == 0) ? length_ : std::min<uint64_t>(length_, static_cast<uint64_t>(start) + length);
+  if (start >= search_end) {
+    return -1;
+  }
+
+  const ByteSetScanner scanner(bytes);
+  uint64_t offset = 0;
+  for (const auto& slice : slices_) {
+    if (offset >= search_end) {
+      break;
+    }
+    const uint64_t slice_size = slice.dataSize();
+    if (offset + slice_size <= start) {
+      offset += slice_size;
+      continue;
+    }
+    const uint8_t* slice_start = slice.data();
+    const uint8_t* found =
+        scanner.find(slice_start + (std::max<uint64_t>(start, offset) - offset),
+                     slice_start + (std::min(search_end, offset + slice_size) - offset));
+    if (found != nullptr) {
+      return offset + (found - slice_start);
     }
-    start = 0;
     offset += slice_size;
   }
   return -1;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <memory>
@@ -17,6 +19,131 @@
 namespace Envoy {
 namespace Buffer {
 
+/**
+ * A per-thread cache of the storage backing mutable slices. The cache keeps one free list per size
+ * class, where the size classes are the multiples of page_size_ up to max_pooled_size_. Storage
+ * which is larger than that, or which does not fit in its free list, goes straight back to the
+ * allocator. Once the cache holds more than high_watermark_bytes_, it hands storage back to the
+ * allocator, largest size classes first, until it holds no more than low_watermark_bytes_.
+ *
+ * Storage may be released on a different thread than the one which allocated it, in which case it
+ * ends up in the cache of the releasing thread.
+ */
+class SliceStoragePool : NonCopyable {
+public:
+  using StoragePtr = std::unique_ptr<uint8_t[]>;
+
+  static constexpr uint64_t page_size_ = 4096;
+  static constexpr uint32_t num_size_classes_ = 16;
+  static constexpr uint64_t max_pooled_size_ = num_size_classes_ * page_size_;
+  static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
+  static constexpr uint64_t high_watermark_bytes_ = 1024 * 1024;
+  static constexpr uint64_t low_watermark_bytes_ = high_watermark_bytes_ / 2;
+
+  struct Stats {
+    // Allocations served from a free list.
+    uint64_t hits_{};
+    // Allocations which went to the allocator.
+    uint64_t misses_{};
+    // Pieces of storage handed back to the allocator to get under the low watermark.
+    uint64_t watermark_releases_{};
+    // Bytes of storage currently held in free lists.
+    uint64_t cached_bytes_{};
+  };
+
+  SliceStoragePool();
+  ~SliceStoragePool();
+
+  /**
+   * @return the calling thread's pool, or nullptr once the pool has been destroyed because the
+   * thread is exiting.
+   */
+  static SliceStoragePool* threadLocal();
+
+  /**
+   * @return stats summed over the pools of all threads, including threads which have exited.
+   */
+  static Stats aggregateStats();
+
+  /**
+   * @param capacity the size of the storage. Must be a multiple of page_size_.
+   * @return storage of the given size, from a free list if possible.
+   */
+  StoragePtr allocate(uint64_t capacity) {
+    ASSERT(capacity % page_size_ == 0);
+    if (capacity != 0 && capacity <= max_pooled_size_) {
+      FreeList& free_list = free_lists_[sizeClass(capacity)];
+      if (!free_list.empty()) {
+        StoragePtr storage = std::move(free_list.back());
+        ASSERT(storage != nullptr);
+        free_list.pop_back();
+        cached_bytes_ -= capacity;
+        bump(stats_.hits_, 1);
+        publishCachedBytes();
+        return storage;
+      }
+    }
+    bump(stats_.misses_, 1);
+    return StoragePtr(new uint8_t[capacity]);
+  }
+
+  /**
+   * Takes back storage returned by allocate().
+   * @param storage the storage.
+   * @param capacity the size the storage was allocated with.
+   */
+  void release(StoragePtr storage, uint64_t capacity) {
+    ASSERT(storage != nullptr);
+    if (capacity != 0 && capacity <= max_pooled_size_) {
+      FreeList& free_list = free_lists_[sizeClass(capacity)];
+      if (free_list.size() < free_list_max_) {
+        free_list.emplace_back(std::move(storage));
+        cached_bytes_ += capacity;
+        if (cached_bytes_ > high_watermark_bytes_) {
+          releaseToLowWatermark();
+        }
+        publishCachedBytes();
+      }
+    }
+  }
+
+  /**
+   * @return the stats of this pool.
+   */
+  Stats stats() const;
+
+  /**
+   * Hands all cached storage back to the allocator.
+   */
+  void clear();
+
+private:
+  using FreeList = absl::InlinedVector<StoragePtr, free_list_max_>;
+
+  struct AtomicStats {
+    std::atomic<uint64_t> hits_{};
+    std::atomic<uint64_t> misses_{};
+    std::atomic<uint64_t> watermark_releases_{};
+    std::atomic<uint64_t> cached_bytes_{};
+  };
+
+  static uint32_t sizeClass(uint64_t capacity) { return capacity / page_size_ - 1; }
+
+  // Stats are only written by the thread which owns the pool, so there is no need for an atomic
+  // read-modify-write. The atomics let other threads aggregate them.
+  static void bump(std::atomic<uint64_t>& stat, uint64_t delta) {
+    stat.store(stat.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+  void publishCachedBytes() {
+    stats_.cached_bytes_.store(cached_bytes_, std::memory_order_relaxed);
+  }
+  void releaseToLowWatermark();
+
+  std::array<FreeList, num_size_classes_> free_lists_;
+  uint64_t cached_bytes_{};
+  AtomicStats stats_;
+};
+
 /**
  * A Slice manages a contiguous block of bytes.
  * The block is arranged like this:
@@ -35,14 +162,12 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
+  using StoragePtr = SliceStoragePool::StoragePtr;
 
-  static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
-  using FreeListType = absl::InlinedVector<StoragePtr, free_list_max_>;
   class FreeListReference {
   private:
-    FreeListReference(FreeListType& free_list) : free_list_(free_list) {}
-    FreeListType& free_list_;
+    FreeListReference(SliceStoragePool* pool) : pool_(pool) {}
+    SliceStoragePool* pool_;
     friend class Slice;
   };
 
@@ -57,7 +182,7 @@ public:
    * @param min_capacity number of bytes of space the slice should have. Actual capacity is rounded
    * up to the next multiple of 4kb.
    * @param account the account to charge.
-   * @param freelist to search for the backing storage, if any.
+   * @param freelist to search for the backing storage. Defaults to the calling thread's.
    */
   Slice(uint64_t min_capacity, BufferMemoryAccountSharedPtr account,
         absl::optional<FreeListReference> free_list = absl::nullopt)
@@ -338,7 +463,7 @@ public:
 
   static constexpr uint32_t default_slice_size_ = 16384;
 
-  static FreeListReference freeList() { return FreeListReference(free_list_); }
+  static FreeListReference freeList() { return FreeListReference(SliceStoragePool::threadLocal()); }
 
 protected:
   /**
@@ -347,7 +472,7 @@ protected:
    * @return a recommended slice size, in bytes.
    */
   static uint64_t sliceSize(uint64_t data_size) {
-    static constexpr uint64_t PageSize = 4096;
+    static constexpr uint64_t PageSize = SliceStoragePool::page_size_;
     const uint64_t num_pages = (data_size + PageSize - 1) / PageSize;
     return num_pages * PageSize;
   }
@@ -357,22 +482,15 @@ protected:
            "default_slice_size_ incompatible with sliceSize()");
     ASSERT(sliceSize(capacity) == capacity,
            "newStorage should only be called on values returned from sliceSize()");
-    ASSERT(!free_list_opt.has_value() || &free_list_opt->free_list_ == &free_list_);
+    ASSERT(!free_list_opt.has_value() ||
+           free_list_opt->pool_ == SliceStoragePool::threadLocal());
 
-    StoragePtr storage;
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (!free_list.empty()) {
-        storage = std::move(free_list.back());
-        ASSERT(storage != nullptr);
-        ASSERT(free_list.back() == nullptr);
-        free_list.pop_back();
-        return storage;
-      }
+    SliceStoragePool* pool =
+        free_list_opt.has_value() ? free_list_opt->pool_ : SliceStoragePool::threadLocal();
+    if (pool != nullptr) {
+      return pool->allocate(capacity);
     }
-
-    storage.reset(new uint8_t[capacity]);
-    return storage;
+    return StoragePtr(new uint8_t[capacity]);
   }
 
   static void freeStorage(StoragePtr storage, uint64_t capacity,
@@ -381,20 +499,13 @@ protected:
       return;
     }
 
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (free_list.size() < free_list_max_) {
-        free_list.emplace_back(std::move(storage));
-        ASSERT(storage == nullptr);
-        return;
-      }
+    SliceStoragePool* pool =
+        free_list_opt.has_value() ? free_list_opt->pool_ : SliceStoragePool::threadLocal();
+    if (pool != nullptr) {
+      pool->release(std::move(storage), capacity);
     }
-
-    storage.reset();
   }
 
-  static thread_local FreeListType free_list_;
-
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_ = 0;
@@ -692,6 +803,7 @@ public:
   Reservation reserveForRead() override;
   ReservationSingleSlice reserveSingleSlice(uint64_t length, bool separate_slice = false) override;
   ssize_t search(const void* data, uint64_t size, size_t start, size_t length) const override;
+  ssize_t findFirstOf(absl::string_view bytes, size_t start, size_t length) const override;
   bool startsWith(absl::string_view data) const override;
   std::string toString() const override;
 
@@ -767,6 +879,13 @@ private:
    */
   void coalesceOrAddSlice(Slice&& other_slice);
 
+  /**
+   * @return whether the needle matches the buffer content starting at the given offset into the
+   * given slice, continuing into the following slices as needed.
+   */
+  bool matchesAcrossSlices(size_t slice_index, uint64_t slice_offset, const uint8_t* needle,
+                           uint64_t size) const;
+
   /** Ring buffer of slices. */
   SliceDeque slices_;
 
@@ -1,5 +1,7 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <cmath>
+
 #include "source/common/common/assert.h"
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/runtime/runtime_features.h"
@@ -18,6 +20,38 @@ namespace {
 }
 } // namespace
 
+DemandEstimator::DemandEstimator(std::chrono::milliseconds time_constant)
+    : time_constant_seconds_(std::chrono::duration<double>(time_constant).count()) {
+  ASSERT(time_constant_seconds_ > 0);
+}
+
+double DemandEstimator::decayedArrivals(MonotonicTime now) const {
+  const double age = std::chrono::duration<double>(now - last_arrival_).count();
+  return arrivals_ * std::exp(-std::max(age, 0.0) / time_constant_seconds_);
+}
+
+void DemandEstimator::onStreamArrival(MonotonicTime now) {
+  arrivals_ = decayedArrivals(now) + 1;
+  last_arrival_ = now;
+}
+
+void DemandEstimator::onConnected(std::chrono::milliseconds connect_latency) {
+  const double latency = std::chrono::duration<double>(connect_latency).count();
+  if (!connect_latency_seconds_.has_value()) {
+    connect_latency_seconds_ = latency;
+  } else {
+    // Same smoothing as TCP uses for its round trip time estimate.
+    connect_latency_seconds_ = connect_latency_seconds_.value() * 0.875 + latency * 0.125;
+  }
+}
+
+double DemandEstimator::anticipatedStreams(MonotonicTime now) const {
+  if (!connect_latency_seconds_.has_value()) {
+    return 0;
+  }
+  return decayedArrivals(now) / time_constant_seconds_ * connect_latency_seconds_.value();
+}
+
 ConnPoolImplBase::ConnPoolImplBase(
     Upstream::HostConstSharedPtr host, Upstream::ResourcePriority priority,
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -25,7 +59,12 @@ ConnPoolImplBase::ConnPoolImplBase(
     Upstream::ClusterConnectivityState& state)
     : state_(state), host_(host), priority_(priority), dispatcher_(dispatcher),
       socket_options_(options), transport_socket_options_(transport_socket_options),
-      upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {}
+      upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {
+  const auto demand_time_constant = host_->cluster().preconnectDemandTimeConstant();
+  if (demand_time_constant.has_value() && demand_time_constant.value().count() > 0) {
+    demand_estimator_ = std::make_unique<DemandEstimator>(demand_time_constant.value());
+  }
+}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
   ASSERT(isIdleImpl());
@@ -97,7 +136,8 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
     return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
-                         perUpstreamPreconnectRatio());
+                         perUpstreamPreconnectRatio()) ||
+           shouldPreconnectForAnticipatedDemand();
   }
 }
 
@@ -105,6 +145,23 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
 
+bool ConnPoolImplBase::shouldPreconnectForAnticipatedDemand() const {
+  if (demand_estimator_ == nullptr) {
+    return false;
+  }
+  const int64_t anticipated_streams = std::lround(
+      demand_estimator_->anticipatedStreams(dispatcher_.timeSource().monotonicTime()));
+  // Pending streams get the connecting capacity first. Only walk the ready clients as far as
+  // needed, since an HTTP/1.1 pool can have many idle connections.
+  int64_t spare_capacity = static_cast<int64_t>(connecting_stream_capacity_) -
+                           static_cast<int64_t>(pending_streams_.size());
+  for (auto it = ready_clients_.begin();
+       it != ready_clients_.end() && spare_capacity < anticipated_streams; ++it) {
+    spare_capacity += (*it)->currentUnusedCapacity();
+  }
+  return spare_capacity < anticipated_streams;
+}
+
 ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   ConnPoolImplBase::ConnectionResult result;
   // Somewhat arbitrarily cap the number of connections preconnected due to new
@@ -242,6 +299,9 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
 
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_)); // O(n) debug check.
+  if (demand_estimator_ != nullptr) {
+    demand_estimator_->onStreamArrival(dispatcher_.timeSource().monotonicTime());
+  }
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", client);
@@ -489,6 +549,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
       tryCreateNewConnections();
     }
   } else if (event == Network::ConnectionEvent::Connected) {
+    if (demand_estimator_ != nullptr) {
+      demand_estimator_->onConnected(client.conn_connect_ms_->elapsed());
+    }
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
     ASSERT(client.state() == ActiveClient::State::CONNECTING);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/common/conn_pool.h"
+#include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
 #include "envoy/stats/timespan.h"
@@ -142,6 +143,31 @@ using PendingStreamPtr = std::unique_ptr<PendingStream>;
 
 using ActiveClientPtr = std::unique_ptr<ActiveClient>;
 
+// Estimates how many streams a pool will see while a new connection is being established, from
+// exponentially weighted moving averages of the stream arrival rate and of the time connections
+// take to become ready.
+class DemandEstimator {
+public:
+  explicit DemandEstimator(std::chrono::milliseconds time_constant);
+
+  // Records a new stream arriving at the pool.
+  void onStreamArrival(MonotonicTime now);
+  // Records how long a connection, including any TLS handshake, took to become ready.
+  void onConnected(std::chrono::milliseconds connect_latency);
+  // Returns the number of streams expected to arrive within one connection establishment time.
+  double anticipatedStreams(MonotonicTime now) const;
+
+private:
+  double decayedArrivals(MonotonicTime now) const;
+
+  const double time_constant_seconds_;
+  // Stream arrivals, each weighted by exp(-age / time constant). Divided by the time constant this
+  // is the average arrival rate.
+  double arrivals_{0};
+  MonotonicTime last_arrival_{};
+  absl::optional<double> connect_latency_seconds_;
+};
+
 // Base class that handles stream queueing logic shared between connection pool implementations.
 class ConnPoolImplBase : protected Logger::Loggable<Logger::Id::pool> {
 public:
@@ -300,6 +326,10 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // A helper function which determines if the capacity that is connecting or ready falls short of
+  // the streams the demand estimator expects to arrive while a new connection is established.
+  bool shouldPreconnectForAnticipatedDemand() const;
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -357,6 +387,9 @@ private:
   bool deferred_deleting_{false};
 
   Event::SchedulableCallbackPtr upstream_ready_cb_;
+
+  // Set if the cluster enables preconnecting for anticipated demand.
+  std::unique_ptr<DemandEstimator> demand_estimator_;
 };
 
 } // namespace ConnectionPool
@@ -19,6 +19,7 @@
 #include "source/common/grpc/common.h"
 #include "source/common/grpc/status.h"
 #include "source/common/http/utility.h"
+#include "source/common/json/json_writer.h"
 #include "source/common/protobuf/message_validator_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
@@ -110,13 +111,26 @@ const std::string SubstitutionFormatUtils::getHostnameOrDefault() {
 
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
-  providers_ = SubstitutionFormatParser::parse(format);
+  compile(SubstitutionFormatParser::parse(format));
 }
 
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values,
                              const std::vector<CommandParserPtr>& command_parsers)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
-  providers_ = SubstitutionFormatParser::parse(format, command_parsers);
+  compile(SubstitutionFormatParser::parse(format, command_parsers));
+}
+
+void FormatterImpl::compile(std::vector<FormatterProviderPtr>&& providers) {
+  for (FormatterProviderPtr& provider : providers) {
+    const auto* plain = dynamic_cast<const PlainStringFormatter*>(provider.get());
+    if (plain == nullptr) {
+      instructions_.push_back({EMPTY_STRING, std::move(provider)});
+    } else if (!instructions_.empty() && instructions_.back().provider_ == nullptr) {
+      instructions_.back().literal_.append(plain->value());
+    } else {
+      instructions_.push_back({plain->value(), nullptr});
+    }
+  }
 }
 
 std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
@@ -127,20 +141,46 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
   std::string log_line;
   log_line.reserve(256);
 
-  for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+  for (const Instruction& instruction : instructions_) {
+    if (instruction.provider_ == nullptr) {
+      log_line.append(instruction.literal_);
+    } else if (!instruction.provider_->formatTo(request_headers, response_headers,
+                                                response_trailers, stream_info, local_reply_body,
+                                                log_line)) {
+      log_line.append(empty_value_string_);
+    }
   }
 
   return log_line;
 }
 
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values)
+    : struct_formatter_(format_mapping, preserve_types, omit_empty_values),
+      direct_json_serialization_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.direct_json_access_log_serialization")) {}
+
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values,
+                                     const std::vector<CommandParserPtr>& commands)
+    : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands),
+      direct_json_serialization_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.direct_json_access_log_serialization")) {}
+
 std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                       const Http::ResponseHeaderMap& response_headers,
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
+  if (direct_json_serialization_) {
+    std::string log_line;
+    log_line.reserve(256);
+    struct_formatter_.formatJson(request_headers, response_headers, response_trailers,
+                                 stream_info, local_reply_body, log_line);
+    log_line.push_back('\n');
+    return log_line;
+  }
+
   const ProtobufWkt::Struct output_struct = struct_formatter_.format(
       request_headers, response_headers, response_trailers, stream_info, local_reply_body);
 
@@ -298,6 +338,113 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return structFormatMapCallback(struct_output_format_, visitor).struct_value();
 }
 
+bool StructFormatter::providersJsonCallback(
+    const std::vector<FormatterProviderPtr>& providers,
+    const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap& response_headers,
+    const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+    absl::string_view local_reply_body, std::string& scratch, std::string& output) const {
+  ASSERT(!providers.empty());
+  // The cases mirror providersCallback(), which this must stay in line with.
+  scratch.clear();
+  if (providers.size() == 1) {
+    const auto& provider = providers.front();
+    if (preserve_types_) {
+      const ProtobufWkt::Value value = provider->formatValue(
+          request_headers, response_headers, response_trailers, stream_info, local_reply_body);
+      if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+        return false;
+      }
+      Json::Writer::appendValue(value, output);
+      return true;
+    }
+
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, scratch)) {
+      if (omit_empty_values_) {
+        return false;
+      }
+      scratch.append(DefaultUnspecifiedValueString);
+    }
+    Json::Writer::appendString(scratch, output);
+    return true;
+  }
+  // Multiple providers forces string output.
+  for (const auto& provider : providers) {
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, scratch)) {
+      scratch.append(empty_value_);
+    }
+  }
+  Json::Writer::appendString(scratch, output);
+  return true;
+}
+
+bool StructFormatter::structFormatMapJsonCallback(
+    const StructFormatter::StructFormatMapWrapper& format_map,
+    const StructFormatter::JsonFormatMapVisitor& visitor, std::string& output) const {
+  output.push_back('{');
+  bool first = true;
+  for (const auto& pair : *format_map.value_) {
+    // The key is written before the value is known, and taken back out if the value is omitted.
+    const size_t field_start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    Json::Writer::appendString(pair.first, output);
+    output.push_back(':');
+    if (absl::visit(visitor, pair.second)) {
+      first = false;
+    } else {
+      output.resize(field_start);
+    }
+  }
+  output.push_back('}');
+  return true;
+}
+
+bool StructFormatter::structFormatListJsonCallback(
+    const StructFormatter::StructFormatListWrapper& format_list,
+    const StructFormatter::JsonFormatMapVisitor& visitor, std::string& output) const {
+  output.push_back('[');
+  bool first = true;
+  for (const auto& val : *format_list.value_) {
+    const size_t element_start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    if (absl::visit(visitor, val)) {
+      first = false;
+    } else {
+      output.resize(element_start);
+    }
+  }
+  output.push_back(']');
+  return true;
+}
+
+void StructFormatter::formatJson(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body, std::string& output) const {
+  // String values are built here before they are escaped into the output.
+  std::string scratch;
+  JsonFormatMapVisitor visitor{
+      [&](const std::vector<FormatterProviderPtr>& providers) {
+        return providersJsonCallback(providers, request_headers, response_headers,
+                                     response_trailers, stream_info, local_reply_body, scratch,
+                                     output);
+      },
+      [&, this](const StructFormatter::StructFormatMapWrapper& format_map) {
+        return structFormatMapJsonCallback(format_map, visitor, output);
+      },
+      [&, this](const StructFormatter::StructFormatListWrapper& format_list) {
+        return structFormatListJsonCallback(format_list, visitor, output);
+      },
+  };
+  structFormatMapJsonCallback(struct_output_format_, visitor, output);
+}
+
 void SubstitutionFormatParser::parseCommandHeader(const std::string& token, const size_t start,
                                                   std::string& main_header,
                                                   std::string& alternative_header,
@@ -361,6 +508,7 @@ FormatterProviderPtr SubstitutionFormatParser::parseBuiltinCommand(const std::st
   static constexpr absl::string_view DYNAMIC_META_TOKEN{"DYNAMIC_METADATA("};
   static constexpr absl::string_view CLUSTER_META_TOKEN{"CLUSTER_METADATA("};
   static constexpr absl::string_view FILTER_STATE_TOKEN{"FILTER_STATE("};
+  static constexpr absl::string_view TIMING_BREAKDOWN_TOKEN{"TIMING_BREAKDOWN("};
   static constexpr absl::string_view PLAIN_SERIALIZATION{"PLAIN"};
   static constexpr absl::string_view TYPED_SERIALIZATION{"TYPED"};
 
@@ -423,6 +571,13 @@ FormatterProviderPtr SubstitutionFormatParser::parseBuiltinCommand(const std::st
     const bool serialize_as_string = serialize_type == PLAIN_SERIALIZATION;
 
     return std::make_unique<FilterStateFormatter>(key, max_length, serialize_as_string);
+  } else if (absl::StartsWith(token, TIMING_BREAKDOWN_TOKEN)) {
+    std::string point, filter_name, direction;
+    absl::optional<size_t> max_length;
+    const size_t start = TIMING_BREAKDOWN_TOKEN.size();
+
+    parseCommand(token, start, ':', max_length, point, filter_name, direction);
+    return std::make_unique<TimingBreakdownFormatter>(point, filter_name, direction);
   } else if (absl::StartsWith(token, "START_TIME")) {
     return std::make_unique<StartTimeFormatter>(token);
   } else if (absl::StartsWith(token, "DOWNSTREAM_PEER_CERT_V_START")) {
@@ -991,6 +1146,13 @@ ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMa
   return str_;
 }
 
+bool PlainStringFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                    absl::string_view, std::string& output) const {
+  output.append(str_.string_value());
+  return true;
+}
+
 absl::optional<std::string>
 LocalReplyBodyFormatter::format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                 const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
@@ -1006,6 +1168,16 @@ ProtobufWkt::Value LocalReplyBodyFormatter::formatValue(const Http::RequestHeade
   return ValueUtil::stringValue(std::string(local_reply_body));
 }
 
+bool LocalReplyBodyFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap&,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&,
+                                       absl::string_view local_reply_body,
+                                       std::string& output) const {
+  output.append(local_reply_body.data(), local_reply_body.size());
+  return true;
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  absl::optional<size_t> max_length)
@@ -1045,6 +1217,20 @@ ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers)
   return ValueUtil::stringValue(val);
 }
 
+bool HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+  return true;
+}
+
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
                                                  const std::string& alternative_header,
                                                  absl::optional<size_t> max_length)
@@ -1062,6 +1248,14 @@ ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
   return HeaderFormatter::formatValue(response_headers);
 }
 
+bool ResponseHeaderFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, absl::string_view,
+                                       std::string& output) const {
+  return HeaderFormatter::formatTo(response_headers, output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                absl::optional<size_t> max_length)
@@ -1081,6 +1275,14 @@ RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_header
   return HeaderFormatter::formatValue(request_headers);
 }
 
+bool RequestHeaderFormatter::formatTo(const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, absl::string_view,
+                                      std::string& output) const {
+  return HeaderFormatter::formatTo(request_headers, output);
+}
+
 ResponseTrailerFormatter::ResponseTrailerFormatter(const std::string& main_header,
                                                    const std::string& alternative_header,
                                                    absl::optional<size_t> max_length)
@@ -1100,6 +1302,14 @@ ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http:
   return HeaderFormatter::formatValue(response_trailers);
 }
 
+bool ResponseTrailerFormatter::formatTo(const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view,
+                                        std::string& output) const {
+  return HeaderFormatter::formatTo(response_trailers, output);
+}
+
 HeadersByteSizeFormatter::HeadersByteSizeFormatter(const HeaderType header_type)
     : header_type_(header_type) {}
 
@@ -1345,6 +1555,78 @@ ProtobufWkt::Value FilterStateFormatter::formatValue(const Http::RequestHeaderMa
   return val;
 }
 
+TimingBreakdownFormatter::TimingBreakdownFormatter(const std::string& point,
+                                                   const std::string& filter_name,
+                                                   const std::string& direction) {
+  if (point == "FILTER") {
+    if (filter_name.empty() || (direction != "DECODE" && direction != "ENCODE")) {
+      throw EnvoyException(
+          "Invalid timing breakdown filter, expected FILTER:<filter name>:DECODE|ENCODE.");
+    }
+    filter_name_ = filter_name;
+    decode_ = direction == "DECODE";
+    return;
+  }
+
+  if (point == "ROUTE_SELECTION") {
+    point_ = &StreamInfo::TimingBreakdown::route_selection_;
+  } else if (point == "HOST_SELECTION") {
+    point_ = &StreamInfo::TimingBreakdown::host_selection_;
+  } else if (point == "CONNECTION_POOL_WAIT") {
+    point_ = &StreamInfo::TimingBreakdown::connection_pool_wait_;
+  } else if (point == "CODEC_ENCODE") {
+    point_ = &StreamInfo::TimingBreakdown::codec_encode_;
+  }
+  if (point_ == nullptr || !filter_name.empty()) {
+    throw EnvoyException(fmt::format("Invalid timing breakdown point: {}.", point));
+  }
+}
+
+absl::optional<int64_t>
+TimingBreakdownFormatter::extractMicros(const StreamInfo::StreamInfo& stream_info) const {
+  const StreamInfo::TimingBreakdown* timing_breakdown = stream_info.timingBreakdown();
+  if (timing_breakdown == nullptr) {
+    return absl::nullopt;
+  }
+
+  absl::optional<std::chrono::nanoseconds> duration;
+  if (point_ != nullptr) {
+    duration = timing_breakdown->*point_;
+  } else {
+    // Filters which share a config name are summed up.
+    for (const StreamInfo::TimingBreakdown::FilterTiming& filter : timing_breakdown->filters_) {
+      if (filter.name_ == filter_name_) {
+        duration = duration.value_or(std::chrono::nanoseconds(0)) +
+                   (decode_ ? filter.decode_ : filter.encode_);
+      }
+    }
+  }
+  if (!duration.has_value()) {
+    return absl::nullopt;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration.value()).count();
+}
+
+absl::optional<std::string> TimingBreakdownFormatter::format(
+    const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+    const StreamInfo::StreamInfo& stream_info, absl::string_view) const {
+  const auto micros = extractMicros(stream_info);
+  if (!micros) {
+    return absl::nullopt;
+  }
+  return fmt::format_int(micros.value()).str();
+}
+
+ProtobufWkt::Value TimingBreakdownFormatter::formatValue(
+    const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+    const StreamInfo::StreamInfo& stream_info, absl::string_view) const {
+  const auto micros = extractMicros(stream_info);
+  if (!micros) {
+    return unspecifiedValue();
+  }
+  return ValueUtil::numberValue(micros.value());
+}
+
 // Given a token, extract the command string between parenthesis if it exists.
 std::string SystemTimeFormatter::parseFormat(const std::string& token, size_t parameters_start) {
   const size_t parameters_length = token.length() - (parameters_start + 1);
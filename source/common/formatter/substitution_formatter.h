@@ -153,8 +153,18 @@ public:
                      absl::string_view local_reply_body) const override;
 
 private:
+  // One step of a compiled format: either a literal, which is appended as is, or a provider.
+  struct Instruction {
+    std::string literal_;
+    FormatterProviderPtr provider_;
+  };
+
+  // Compiles the parsed format, merging adjacent literals so that each run of them costs a single
+  // append.
+  void compile(std::vector<FormatterProviderPtr>&& providers);
+
   const std::string& empty_value_string_;
-  std::vector<FormatterProviderPtr> providers_;
+  std::vector<Instruction> instructions_;
 };
 
 // Helper classes for StructFormatter::StructFormatMapVisitor.
@@ -178,6 +188,16 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Format the log entry as a JSON object, which is appended to the output as it is produced,
+   * rather than going through a Struct.
+   */
+  void formatJson(const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                  std::string& output) const;
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -202,6 +222,12 @@ private:
       const std::function<ProtobufWkt::Value(const std::vector<FormatterProviderPtr>&)>,
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatMapWrapper&)>,
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatListWrapper&)>>;
+  // Visits the format for formatJson(). Each callback appends its value to the output and returns
+  // whether it did, as empty values may be omitted.
+  using JsonFormatMapVisitor = StructFormatMapVisitorHelper<
+      const std::function<bool(const std::vector<FormatterProviderPtr>&)>,
+      const std::function<bool(const StructFormatter::StructFormatMapWrapper&)>,
+      const std::function<bool(const StructFormatter::StructFormatListWrapper&)>>;
 
   // Methods for building the format map.
   class FormatBuilder {
@@ -232,6 +258,19 @@ private:
   structFormatListCallback(const StructFormatter::StructFormatListWrapper& format_list,
                            const StructFormatMapVisitor& visitor) const;
 
+  // Methods for formatting JSON directly.
+  bool providersJsonCallback(const std::vector<FormatterProviderPtr>& providers,
+                             const Http::RequestHeaderMap& request_headers,
+                             const Http::ResponseHeaderMap& response_headers,
+                             const Http::ResponseTrailerMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info,
+                             absl::string_view local_reply_body, std::string& scratch,
+                             std::string& output) const;
+  bool structFormatMapJsonCallback(const StructFormatter::StructFormatMapWrapper& format_map,
+                                   const JsonFormatMapVisitor& visitor, std::string& output) const;
+  bool structFormatListJsonCallback(const StructFormatter::StructFormatListWrapper& format_list,
+                                    const JsonFormatMapVisitor& visitor, std::string& output) const;
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -244,11 +283,9 @@ using StructFormatterPtr = std::unique_ptr<StructFormatter>;
 class JsonFormatterImpl : public Formatter {
 public:
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values) {}
+                    bool omit_empty_values);
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands) {}
+                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands);
 
   // Formatter::format
   std::string format(const Http::RequestHeaderMap& request_headers,
@@ -259,6 +296,7 @@ public:
 
 private:
   const StructFormatter struct_formatter_;
+  const bool direct_json_serialization_;
 };
 
 /**
@@ -269,6 +307,8 @@ class PlainStringFormatter : public FormatterProvider {
 public:
   PlainStringFormatter(const std::string& str);
 
+  const std::string& value() const { return str_.string_value(); }
+
   // FormatterProvider
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
@@ -276,6 +316,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 
 private:
   ProtobufWkt::Value str_;
@@ -295,6 +338,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view local_reply_body) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view local_reply_body, std::string& output) const override;
 };
 
 class HeaderFormatter {
@@ -305,6 +351,7 @@ public:
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
+  bool formatTo(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
   const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers) const;
@@ -357,6 +404,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 };
 
 /**
@@ -375,6 +425,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
 };
 
 /**
@@ -393,6 +446,9 @@ public:
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view, std::string& output) const override;
 };
 
 /**
@@ -520,6 +576,36 @@ private:
   bool serialize_as_string_;
 };
 
+/**
+ * FormatterProvider for a duration of the timing breakdown from StreamInfo, in microseconds.
+ */
+class TimingBreakdownFormatter : public FormatterProvider {
+public:
+  /**
+   * @param point supplies the timing point, or FILTER for the timings of a filter.
+   * @param filter_name supplies the name of the filter config, if point is FILTER.
+   * @param direction supplies DECODE or ENCODE, if point is FILTER.
+   */
+  TimingBreakdownFormatter(const std::string& point, const std::string& filter_name,
+                           const std::string& direction);
+
+  // FormatterProvider
+  absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                     const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                     absl::string_view) const override;
+  ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                 const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                 absl::string_view) const override;
+
+private:
+  absl::optional<int64_t> extractMicros(const StreamInfo::StreamInfo& stream_info) const;
+
+  // The timing point, unless the timings of a filter are formatted.
+  std::chrono::nanoseconds StreamInfo::TimingBreakdown::*point_{};
+  std::string filter_name_;
+  bool decode_{};
+};
+
 /**
  * Base FormatterProvider for system times from StreamInfo.
  */
@@ -11,9 +11,11 @@
 #include "envoy/type/v3/percent.pb.h"
 
 #include "source/common/http/date_provider.h"
+#include "source/common/http/timing_breakdown_stats.h"
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/symbol_table_impl.h"
+#include "source/common/tracing/tail_sampler_impl.h"
 
 namespace Envoy {
 namespace Http {
@@ -133,6 +135,8 @@ struct TracingConnectionManagerConfig {
   envoy::type::v3::FractionalPercent overall_sampling_;
   bool verbose_;
   uint32_t max_path_tag_length_;
+  // Set if traces are sampled once requests complete.
+  Tracing::TailSamplerSharedPtr tail_sampler_;
 };
 
 using TracingConnectionManagerConfigPtr = std::unique_ptr<TracingConnectionManagerConfig>;
@@ -364,6 +368,12 @@ public:
    */
   virtual ConnectionManagerTracingStats& tracingStats() PURE;
 
+  /**
+   * @return TimingBreakdownStats* the stats to record the timing breakdowns of streams to, or
+   *         nullptr if timing breakdowns are not recorded.
+   */
+  virtual TimingBreakdownStats* timingBreakdownStats() PURE;
+
   /**
    * @return bool whether to use the remote address for populating XFF, determining internal request
    *         status, etc. or to assume that XFF will already be populated with the remote address.
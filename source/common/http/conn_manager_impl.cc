@@ -32,6 +32,7 @@
 #include "source/common/http/codes.h"
 #include "source/common/http/conn_manager_utility.h"
 #include "source/common/http/exception.h"
+#include "source/common/http/header_map_arena_impl.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/http/headers.h"
@@ -44,6 +45,7 @@
 #include "source/common/router/config_impl.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stats/timespan_impl.h"
+#include "source/common/stream_info/utility.h"
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
@@ -103,7 +105,9 @@ ConnectionManagerImpl::ConnectionManagerImpl(ConnectionManagerConfig& config,
           overload_state_.getState(Server::OverloadActionNames::get().DisableHttpKeepAlive)),
       time_source_(time_source),
       enable_internal_redirects_with_body_(Runtime::runtimeFeatureEnabled(
-          "envoy.reloadable_features.internal_redirects_with_body")) {}
+          "envoy.reloadable_features.internal_redirects_with_body")),
+      header_map_arena_enabled_(
+          Runtime::runtimeFeatureEnabled("envoy.reloadable_features.header_map_arena")) {}
 
 const ResponseHeaderMap& ConnectionManagerImpl::continueHeader() {
   static const auto headers = createHeaderMap<ResponseHeaderMapImpl>(
@@ -612,6 +616,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
                                                   Buffer::BufferMemoryAccountSharedPtr account)
     : connection_manager_(connection_manager),
       stream_id_(connection_manager.random_generator_.random()),
+      header_map_arena_(connection_manager.header_map_arena_enabled_
+                            ? std::make_shared<HeaderMapArenaImpl>()
+                            : nullptr),
       filter_manager_(*this, connection_manager_.read_callbacks_->connection().dispatcher(),
                       connection_manager_.read_callbacks_->connection(), stream_id_,
                       std::move(account), connection_manager_.config_.proxy100Continue(),
@@ -637,6 +644,10 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   filter_manager_.streamInfo().setRequestIDProvider(
       connection_manager.config_.requestIDExtension());
 
+  if (connection_manager_.config_.timingBreakdownStats() != nullptr) {
+    filter_manager_.streamInfo().enableTimingBreakdown();
+  }
+
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
     route_config_update_requester_ =
@@ -718,6 +729,11 @@ void ConnectionManagerImpl::ActiveStream::completeRequest() {
   if (state_.successful_upgrade_) {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
   }
+
+  TimingBreakdownStats* timing_breakdown_stats = connection_manager_.config_.timingBreakdownStats();
+  if (timing_breakdown_stats != nullptr) {
+    timing_breakdown_stats->record(filter_manager_.streamInfo());
+  }
 }
 
 void ConnectionManagerImpl::ActiveStream::resetIdleTimer() {
@@ -1073,8 +1089,23 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
   ConnectionManagerImpl::chargeTracingStats(tracing_decision.reason,
                                             connection_manager_.config_.tracingStats());
 
-  active_span_ = connection_manager_.tracer().startSpan(
-      *this, *request_headers_, filter_manager_.streamInfo(), tracing_decision);
+  const Tracing::TailSamplerSharedPtr& tail_sampler =
+      connection_manager_.config_.tracingConfig()->tail_sampler_;
+  if (tail_sampler == nullptr || tracing_decision.reason == Tracing::Reason::HealthCheck) {
+    active_span_ = connection_manager_.tracer().startSpan(
+        *this, *request_headers_, filter_manager_.streamInfo(), tracing_decision);
+  } else {
+    // Every request but health checks is recorded, and the tail sampler decides whether its trace
+    // is exported once the request completes.
+    active_span_ = connection_manager_.tracer().startSpan(
+        *this, *request_headers_, filter_manager_.streamInfo(),
+        Tracing::Decision{tracing_decision.reason, true});
+    if (active_span_) {
+      active_span_ = tail_sampler->wrapSpan(std::move(active_span_),
+                                            filter_manager_.streamInfo().startTimeMonotonic(),
+                                            tracing_decision.traced);
+    }
+  }
 
   if (!active_span_) {
     return;
@@ -1278,6 +1309,9 @@ void ConnectionManagerImpl::ActiveStream::refreshCachedRoute(const Router::Route
       snapScopedRouteConfig();
     }
     if (snapped_route_config_ != nullptr) {
+      StreamInfo::ScopedTimingPoint timing(connection_manager_.timeSource(),
+                                           filter_manager_.streamInfo(),
+                                           &StreamInfo::TimingBreakdown::route_selection_);
       route = snapped_route_config_->route(cb, *request_headers_, filter_manager_.streamInfo(),
                                            stream_id_);
     }
@@ -1465,6 +1499,9 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ResponseHeaderMap& heade
 
   // Now actually encode via the codec.
   filter_manager_.streamInfo().onFirstDownstreamTxByteSent();
+  StreamInfo::ScopedTimingPoint timing(connection_manager_.timeSource(),
+                                       filter_manager_.streamInfo(),
+                                       &StreamInfo::TimingBreakdown::codec_encode_);
   response_encoder_->encodeHeaders(headers, end_stream);
 }
 
@@ -1473,12 +1510,18 @@ void ConnectionManagerImpl::ActiveStream::encodeData(Buffer::Instance& data, boo
                    end_stream);
 
   filter_manager_.streamInfo().addBytesSent(data.length());
+  StreamInfo::ScopedTimingPoint timing(connection_manager_.timeSource(),
+                                       filter_manager_.streamInfo(),
+                                       &StreamInfo::TimingBreakdown::codec_encode_);
   response_encoder_->encodeData(data, end_stream);
 }
 
 void ConnectionManagerImpl::ActiveStream::encodeTrailers(ResponseTrailerMap& trailers) {
   ENVOY_STREAM_LOG(debug, "encoding trailers via codec:\n{}", *this, trailers);
 
+  StreamInfo::ScopedTimingPoint timing(connection_manager_.timeSource(),
+                                       filter_manager_.streamInfo(),
+                                       &StreamInfo::TimingBreakdown::codec_encode_);
   response_encoder_->encodeTrailers(trailers);
 }
 
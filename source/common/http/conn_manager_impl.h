@@ -191,6 +191,7 @@ private:
     void decodeHeaders(RequestHeaderMapPtr&& headers, bool end_stream) override;
     void decodeTrailers(RequestTrailerMapPtr&& trailers) override;
     StreamInfo::StreamInfo& streamInfo() override { return filter_manager_.streamInfo(); }
+    HeaderMapArenaSharedPtr headerMapArena() override { return header_map_arena_; }
     void sendLocalReply(Code code, absl::string_view body,
                         const std::function<void(ResponseHeaderMap& headers)>& modify_headers,
                         const absl::optional<Grpc::Status::GrpcStatus> grpc_status,
@@ -349,6 +350,10 @@ private:
     // TODO(snowp): It might make sense to move this to the FilterManager to avoid storing it in
     // both locations, then refer to the FM when doing stream logs.
     const uint64_t stream_id_;
+    // Backs the request headers and trailers decoded by the codec, if enabled. Every header map
+    // allocated from the arena holds a reference, so it is freed in one shot once the last of
+    // them is destroyed.
+    const HeaderMapArenaSharedPtr header_map_arena_;
 
     RequestHeaderMapPtr request_headers_;
     RequestTrailerMapPtr request_trailers_;
@@ -454,6 +459,7 @@ private:
   TimeSource& time_source_;
   bool remote_close_{};
   bool enable_internal_redirects_with_body_{};
+  const bool header_map_arena_enabled_{};
   // Hop by hop headers should always be cleared for Envoy-as-a-proxy but will
   // not be for Envoy-mobile.
   bool clear_hop_by_hop_response_headers_{true};
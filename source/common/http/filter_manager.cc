@@ -12,6 +12,7 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/http/utility.h"
+#include "source/common/stream_info/utility.h"
 
 #include "matching/data_impl.h"
 
@@ -461,6 +462,7 @@ void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr fi
     match_state->filter_ = filter.get();
   }
 
+  wrapper->timing_index_ = addFilterTiming();
   filter->setDecoderFilterCallbacks(*wrapper);
   // Note: configured decoder filters are appended to decoder_filters_.
   // This means that if filters are configured in the following order (assume all three filters are
@@ -483,6 +485,8 @@ void FilterManager::addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr fi
     match_state->filter_ = filter.get();
   }
 
+  // Dual filters are timed once, as the decoder filter was just added.
+  wrapper->timing_index_ = dual_filter ? decoder_filters_.back()->timing_index_ : addFilterTiming();
   filter->setEncoderFilterCallbacks(*wrapper);
   // Note: configured encoder filters are prepended to encoder_filters_.
   // This means that if filters are configured in the following order (assume all three filters are
@@ -499,6 +503,24 @@ void FilterManager::addAccessLogHandler(AccessLog::InstanceSharedPtr handler) {
   access_log_handlers_.push_back(handler);
 }
 
+absl::optional<uint32_t> FilterManager::addFilterTiming() {
+  StreamInfo::TimingBreakdown* timing_breakdown = stream_info_.timingBreakdown();
+  if (timing_breakdown == nullptr) {
+    return absl::nullopt;
+  }
+  return timing_breakdown->addFilter(filter_config_name_);
+}
+
+std::chrono::nanoseconds* FilterManager::filterTiming(const ActiveStreamFilterBase& filter,
+                                                      bool decode) {
+  if (!filter.timing_index_.has_value()) {
+    return nullptr;
+  }
+  StreamInfo::TimingBreakdown::FilterTiming& timing =
+      stream_info_.timingBreakdown()->filters_[filter.timing_index_.value()];
+  return decode ? &timing.decode_ : &timing.encode_;
+}
+
 void FilterManager::maybeContinueDecoding(
     const std::list<ActiveStreamDecoderFilterPtr>::iterator& continue_data_entry) {
   if (continue_data_entry != decoder_filters_.end()) {
@@ -530,7 +552,11 @@ void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHead
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == decoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_, filterTiming(**entry, true));
+      status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    }
     if (state_.decoder_filter_chain_aborted_) {
       ENVOY_STREAM_LOG(trace,
                        "decodeHeaders filter iteration aborted due to local reply: filter={}",
@@ -673,7 +699,11 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.requestTrailers();
-    FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_, filterTiming(**entry, true));
+      status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    }
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
     }
@@ -779,7 +809,11 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeTrailers));
     state_.filter_call_state_ |= FilterCallState::DecodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->decodeTrailers(trailers);
+    FilterTrailersStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_, filterTiming(**entry, true));
+      status = (*entry)->handle_->decodeTrailers(trailers);
+    }
     (*entry)->handle_->decodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::DecodeTrailers;
@@ -1095,7 +1129,12 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == encoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_,
+                                           filterTiming(**entry, false));
+      status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    }
     if (state_.encoder_filter_chain_aborted_) {
       ENVOY_STREAM_LOG(trace,
                        "encodeHeaders filter iteration aborted due to local reply: filter={}",
@@ -1263,7 +1302,12 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.responseTrailers();
-    FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_,
+                                           filterTiming(**entry, false));
+      status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    }
     if (state_.encoder_filter_chain_aborted_) {
       ENVOY_STREAM_LOG(trace, "encodeData filter iteration aborted due to local reply: filter={}",
                        *this, static_cast<const void*>((*entry).get()));
@@ -1321,7 +1365,12 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->encodeTrailers(trailers);
+    FilterTrailersStatus status;
+    {
+      StreamInfo::ScopedTimingPoint timing(time_source_, stream_info_,
+                                           filterTiming(**entry, false));
+      status = (*entry)->handle_->encodeTrailers(trailers);
+    }
     (*entry)->handle_->encodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::EncodeTrailers;
@@ -195,6 +195,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   IterationState iteration_state_;
 
   FilterMatchStateSharedPtr filter_match_state_;
+  // The index of the timings of the filter in the timing breakdown of the stream, if recorded.
+  absl::optional<uint32_t> timing_index_;
   // If the filter resumes iteration from a StopAllBuffer/Watermark state, the current filter
   // hasn't parsed data and trailers. As a result, the filter iteration should start with the
   // current filter instead of the next one. If true, filter iteration starts with the current
@@ -667,6 +669,7 @@ public:
         connection_(connection), stream_id_(stream_id), account_(std::move(account)),
         proxy_100_continue_(proxy_100_continue), buffer_limit_(buffer_limit),
         filter_chain_factory_(filter_chain_factory), local_reply_(local_reply),
+        time_source_(time_source),
         stream_info_(protocol, time_source, connection.connectionInfoProviderSharedPtr(),
                      parent_filter_state, filter_state_life_span) {}
   ~FilterManager() override {
@@ -688,6 +691,7 @@ public:
 
   // Http::FilterChainFactoryCallbacks
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  void setFilterConfigName(absl::string_view name) override { filter_config_name_ = name; }
   void addStreamDecoderFilter(StreamDecoderFilterSharedPtr filter) override {
     addStreamDecoderFilterWorker(filter, nullptr, false);
     filters_.push_back(filter.get());
@@ -830,6 +834,12 @@ public:
   void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter,
                                     FilterMatchStateSharedPtr match_state, bool dual_filter);
 
+  // Adds the filter being added to the timing breakdown, if it is recorded.
+  absl::optional<uint32_t> addFilterTiming();
+  // Returns the duration that the decoder or encoder callbacks of the filter add to, or nullptr if
+  // the timing breakdown is not recorded.
+  std::chrono::nanoseconds* filterTiming(const ActiveStreamFilterBase& filter, bool decode);
+
   void disarmRequestTimeout();
 
   /**
@@ -1013,6 +1023,8 @@ private:
   std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
   std::list<StreamFilterBase*> filters_;
   std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+  // The name of the filter config whose filters are being added.
+  absl::string_view filter_config_name_;
 
   // Stores metadata added in the decoding filter that is being processed. Will be cleared before
   // processing the next filter. The storage is created on demand. We need to store metadata
@@ -1028,6 +1040,7 @@ private:
 
   FilterChainFactory& filter_chain_factory_;
   const LocalReply::LocalReply& local_reply_;
+  TimeSource& time_source_;
   OverridableRemoteConnectionInfoSetterStreamInfo stream_info_;
   // TODO(snowp): Once FM has been moved to its own file we'll make these private classes of FM,
   // at which point they no longer need to be friends.
@@ -0,0 +1,46 @@
+#include "source/common/http/header_map_arena_impl.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Http {
+
+HeaderMapArenaImpl::~HeaderMapArenaImpl() = default;
+
+void* HeaderMapArenaImpl::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  uintptr_t start = (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(alignment - 1);
+  if (current_ == nullptr || start + size > reinterpret_cast<uintptr_t>(end_)) {
+    // The extra alignment bytes make sure the allocation fits wherever the block lands.
+    addBlock(size + alignment);
+    start = (reinterpret_cast<uintptr_t>(current_) + alignment - 1) & ~(alignment - 1);
+  }
+  last_ = reinterpret_cast<uint8_t*>(start);
+  current_ = last_ + size;
+  bytes_allocated_ += size;
+  return last_;
+}
+
+void HeaderMapArenaImpl::deallocate(void* p, size_t size) {
+  ASSERT(bytes_allocated_ >= size);
+  bytes_allocated_ -= size;
+  if (p == last_ && last_ + size == current_) {
+    current_ = last_;
+    last_ = nullptr;
+  }
+}
+
+void HeaderMapArenaImpl::addBlock(size_t min_size) {
+  const size_t block_size = std::max(next_block_size_, min_size);
+  next_block_size_ = std::min(next_block_size_ * 2, MaxBlockSize);
+  blocks_.emplace_back(new uint8_t[block_size]);
+  current_ = blocks_.back().get();
+  end_ = current_ + block_size;
+  last_ = nullptr;
+  bytes_reserved_ += block_size;
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/http/header_map.h"
+
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Bump pointer implementation of HeaderMapArena. Memory is carved out of blocks which grow
+ * geometrically up to a cap, so a typical request costs a single block allocation regardless of
+ * how many headers it carries. Deallocation only reclaims the most recent allocation, which covers
+ * the common add-then-remove pattern; everything else is reclaimed when the arena is destroyed.
+ */
+class HeaderMapArenaImpl : public HeaderMapArena, NonCopyable {
+public:
+  static constexpr size_t InitialBlockSize = 4096;
+  static constexpr size_t MaxBlockSize = 64 * 1024;
+
+  ~HeaderMapArenaImpl() override;
+
+  // Http::HeaderMapArena
+  void* allocate(size_t size, size_t alignment) override;
+  void deallocate(void* p, size_t size) override;
+
+  /**
+   * @return the number of bytes currently handed out by the arena.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return the number of bytes obtained from the system to back the arena.
+   */
+  uint64_t bytesReserved() const { return bytes_reserved_; }
+
+private:
+  void addBlock(size_t min_size);
+
+  std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+  uint8_t* current_{};
+  uint8_t* end_{};
+  // Start of the most recent allocation, which is the only one deallocate() can reclaim.
+  uint8_t* last_{};
+  size_t next_block_size_{InitialBlockSize};
+  uint64_t bytes_allocated_{};
+  uint64_t bytes_reserved_{};
+};
+
+/**
+ * Standard library compatible allocator for header map containers. When constructed without an
+ * arena it falls back to the global heap, so containers have the same behavior as with
+ * std::allocator.
+ */
+template <class T> class HeaderMapArenaAllocator {
+public:
+  using value_type = T;
+
+  HeaderMapArenaAllocator(HeaderMapArena* arena) : arena_(arena) {} // NOLINT
+  template <class U>
+  HeaderMapArenaAllocator(const HeaderMapArenaAllocator<U>& other) // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (arena_ == nullptr) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    arena_->deallocate(p, n * sizeof(T));
+  }
+
+  HeaderMapArena* arena() const { return arena_; }
+
+  template <class U> bool operator==(const HeaderMapArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <class U> bool operator!=(const HeaderMapArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+private:
+  HeaderMapArena* arena_;
+};
+
+} // namespace Http
+} // namespace Envoy
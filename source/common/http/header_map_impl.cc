@@ -1,7 +1,7 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <algorithm>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <string>
 
@@ -195,15 +195,123 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+HeaderMapImpl::HeaderList::~HeaderList() {
+  clear();
+  HeaderMapArenaAllocator<HeaderEntryImpl> allocator(arena_.get());
+  for (const Block& block : blocks_) {
+    allocator.deallocate(block.slots_, block.capacity_);
+  }
+}
+
+void* HeaderMapImpl::HeaderList::allocateSlot() {
+  if (!free_slots_.empty()) {
+    HeaderNode slot = free_slots_.back();
+    free_slots_.pop_back();
+    return slot;
+  }
+  if (current_block_ < blocks_.size() && current_block_used_ == blocks_[current_block_].capacity_) {
+    ++current_block_;
+    current_block_used_ = 0;
+  }
+  if (current_block_ == blocks_.size()) {
+    const uint32_t capacity = blocks_.empty()
+                                  ? MinBlockCapacity
+                                  : std::min(blocks_.back().capacity_ * 2, MaxBlockCapacity);
+    blocks_.push_back(
+        {HeaderMapArenaAllocator<HeaderEntryImpl>(arena_.get()).allocate(capacity), capacity});
+  }
+  return blocks_[current_block_].slots_ + current_block_used_++;
+}
+
+void HeaderMapImpl::HeaderList::destroy(HeaderNode entry) {
+  entry->~HeaderEntryImpl();
+  free_slots_.push_back(entry);
+}
+
+void HeaderMapImpl::HeaderList::insertAt(size_t position, HeaderNode entry) {
+  entries_.insert(entries_.begin() + position, entry);
+  for (size_t i = position; i < entries_.size(); ++i) {
+    if (entries_[i] != nullptr) {
+      entries_[i]->position_ = i;
+    }
+  }
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderNode entry, bool remove_from_map) {
+  ASSERT(entries_[entry->position_] == entry);
+  if (remove_from_map) {
+    lazy_map_.erase(entry->key().getStringView());
+  }
+  entries_[entry->position_] = nullptr;
+  ++tombstones_;
+  --size_;
+  destroy(entry);
+}
+
+void HeaderMapImpl::HeaderList::removeFromMap(HeaderNode entry) {
+  auto iter = lazy_map_.find(entry->key().getStringView());
+  ASSERT(iter != lazy_map_.end());
+  HeaderNodeVector& nodes = iter->second;
+  nodes.erase(std::find(nodes.begin(), nodes.end(), entry));
+  if (nodes.empty()) {
+    lazy_map_.erase(iter);
+  } else if (iter->first.data() == entry->key().getStringView().data()) {
+    // The map key refers to the storage of the entry being removed, so re-key the remaining
+    // entries by one of their own keys.
+    HeaderNodeVector remaining = std::move(nodes);
+    lazy_map_.erase(iter);
+    lazy_map_.emplace(remaining.front()->key().getStringView(), std::move(remaining));
+  }
+}
+
+void HeaderMapImpl::HeaderList::compact() {
+  uint32_t live = 0;
+  uint32_t pseudo_headers_end = 0;
+  for (uint32_t i = 0; i < entries_.size(); ++i) {
+    if (i == pseudo_headers_end_) {
+      pseudo_headers_end = live;
+    }
+    if (entries_[i] != nullptr) {
+      entries_[i]->position_ = live;
+      entries_[live++] = entries_[i];
+    }
+  }
+  if (pseudo_headers_end_ == entries_.size()) {
+    pseudo_headers_end = live;
+  }
+  ASSERT(live == size_);
+  entries_.resize(live);
+  pseudo_headers_end_ = pseudo_headers_end;
+  tombstones_ = 0;
+}
+
+void HeaderMapImpl::HeaderList::clear() {
+  for (HeaderNode entry : entries_) {
+    if (entry != nullptr) {
+      entry->~HeaderEntryImpl();
+    }
+  }
+  entries_.clear();
+  free_slots_.clear();
+  lazy_map_.clear();
+  // Keep the blocks around and hand out their slots again from the start.
+  current_block_ = 0;
+  current_block_used_ = 0;
+  pseudo_headers_end_ = 0;
+  size_ = 0;
+  tombstones_ = 0;
+}
+
 bool HeaderMapImpl::HeaderList::maybeMakeMap() {
   if (lazy_map_.empty()) {
-    if (headers_.size() < lazy_map_min_size_) {
+    if (size_ < lazy_map_min_size_) {
       return false;
     }
     // Add all entries from the list into the map.
-    for (auto node = headers_.begin(); node != headers_.end(); ++node) {
-      HeaderNodeVector& v = lazy_map_[node->key().getStringView()];
-      v.push_back(node);
+    for (HeaderNode entry : entries_) {
+      if (entry != nullptr) {
+        lazy_map_[entry->key().getStringView()].push_back(entry);
+      }
     }
   }
   return true;
@@ -217,20 +325,19 @@ size_t HeaderMapImpl::HeaderList::remove(absl::string_view key) {
       // Erase from the map, and all same key entries from the list.
       HeaderNodeVector header_nodes = std::move(iter->second);
       lazy_map_.erase(iter);
-      for (const HeaderNode& node : header_nodes) {
+      for (HeaderNode node : header_nodes) {
         ASSERT(node->key() == key);
         removed_bytes += node->key().size() + node->value().size();
         erase(node, false /* remove_from_map */);
       }
     }
   } else {
-    // Erase all same key entries from the list.
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key) {
-        removed_bytes += i->key().size() + i->value().size();
-        i = erase(i, false /* remove_from_map */);
-      } else {
-        ++i;
+    // Erase all same key entries from the list. Erasing only leaves tombstones, so the positions
+    // of the remaining entries do not change.
+    for (HeaderNode entry : entries_) {
+      if (entry != nullptr && entry->key() == key) {
+        removed_bytes += entry->key().size() + entry->value().size();
+        erase(entry, false /* remove_from_map */);
       }
     }
   }
@@ -387,8 +494,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     }
   } else {
     addSize(key.size() + value.size());
-    HeaderNode i = headers_.insert(std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.insert(std::move(key), std::move(value));
   }
 }
 
@@ -506,9 +612,8 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
     if (iter != headers_.mapEnd()) {
       const HeaderList::HeaderNodeVector& v = iter->second;
       ASSERT(!v.empty()); // It's impossible to have a map entry with an empty vector as its value.
-      for (const auto& values_it : v) {
-        // Convert the iterated value to a HeaderEntry*.
-        ret.push_back(&(*values_it));
+      for (HeaderNode node : v) {
+        ret.push_back(node);
       }
     }
     return ret;
@@ -596,9 +701,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size());
-  HeaderNode i = headers_.insert(key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = headers_.insert(key);
   return **entry;
 }
 
@@ -611,9 +714,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size() + value.size());
-  HeaderNode i = headers_.insert(key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = headers_.insert(key, std::move(value));
   return **entry;
 }
 
@@ -634,10 +735,10 @@ size_t HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
   }
 
   HeaderEntryImpl* entry = *ptr_to_entry;
-  const uint64_t size_to_subtract = entry->entry_->key().size() + entry->entry_->value().size();
+  const uint64_t size_to_subtract = entry->key().size() + entry->value().size();
   subtractSize(size_to_subtract);
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_, true);
+  headers_.erase(entry, true);
   return 1;
 }
 
@@ -2,7 +2,7 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -12,6 +12,7 @@
 
 #include "source/common/common/non_copyable.h"
 #include "source/common/common/utility.h"
+#include "source/common/http/header_map_arena_impl.h"
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -52,6 +53,7 @@ public:
  */
 class HeaderMapImpl : NonCopyable {
 public:
+  explicit HeaderMapImpl(HeaderMapArenaSharedPtr arena) : headers_(std::move(arena)) {}
   virtual ~HeaderMapImpl() = default;
 
   // The following "constructors" call virtual functions during construction and must use the
@@ -122,9 +124,10 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    // Index of this entry in the iteration order of the owning HeaderList.
+    uint32_t position_{};
   };
-  using HeaderNode = std::list<HeaderEntryImpl>::iterator;
+  using HeaderNode = HeaderEntryImpl*;
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
@@ -186,9 +189,17 @@ protected:
    * fast access given a header key. Once the map is initialized, it will be used even if the number
    * of headers decreases below the threshold.
    *
-   * Note: the internal iterators held in fields make this unsafe to copy and move, since the
-   * reference to end() is not preserved across a move (see Notes in
-   * https://en.cppreference.com/w/cpp/container/list/list). The NonCopyable will suppress both copy
+   * Entries are constructed in place in blocks of slots, so their addresses are stable for the
+   * O(1) inline header slots and the lazy map, and neighbouring headers share cache lines. The
+   * iteration order is a contiguous vector of entry pointers. Removing an entry leaves a tombstone
+   * (nullptr) in that vector which iteration skips, and the slot is reused by a later insertion.
+   * Tombstones are compacted away on insertion once they outnumber the live entries.
+   *
+   * If an arena is supplied, the blocks, the order vector and the lazy map are allocated from it,
+   * and the list keeps the arena alive until it is destroyed.
+   *
+   * Note: entries hold their position in the order vector and the map holds pointers to the
+   * entries, which makes this unsafe to copy and move. The NonCopyable will suppress both copy
    * and move constructors/assignment.
    * TODO(htuch): Maybe we want this to movable one day; for now, our header map moves happen on
    * HeaderMapPtr, so the performance impact should not be evident.
@@ -196,12 +207,66 @@ protected:
   class HeaderList : NonCopyable {
   public:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
-    using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
+    using HeaderLazyMap = absl::flat_hash_map<
+        absl::string_view, HeaderNodeVector, absl::Hash<absl::string_view>,
+        std::equal_to<absl::string_view>,
+        HeaderMapArenaAllocator<std::pair<const absl::string_view, HeaderNodeVector>>>;
+
+    /**
+     * Iterator over the live entries in order, skipping tombstones.
+     */
+    template <class Entry> class Iterator {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = Entry;
+      using difference_type = std::ptrdiff_t;
+      using pointer = Entry*;
+      using reference = Entry&;
+
+      Iterator(HeaderEntryImpl* const* entries, size_t index, size_t end)
+          : entries_(entries), index_(index), end_(end) {
+        skipTombstones();
+      }
+
+      Entry& operator*() const { return *entries_[index_]; }
+      Entry* operator->() const { return entries_[index_]; }
+      Iterator& operator++() {
+        ++index_;
+        skipTombstones();
+        return *this;
+      }
+      // Only valid when there is a live entry before the current position, which is always the
+      // case for the predecessor of anything but begin().
+      Iterator& operator--() {
+        do {
+          --index_;
+        } while (entries_[index_] == nullptr);
+        return *this;
+      }
+      bool operator==(const Iterator& rhs) const { return index_ == rhs.index_; }
+      bool operator!=(const Iterator& rhs) const { return index_ != rhs.index_; }
 
-    HeaderList()
-        : pseudo_headers_end_(headers_.end()),
+    private:
+      void skipTombstones() {
+        while (index_ < end_ && entries_[index_] == nullptr) {
+          ++index_;
+        }
+      }
+
+      HeaderEntryImpl* const* entries_;
+      size_t index_;
+      size_t end_;
+    };
+    using iterator = Iterator<HeaderEntryImpl>;
+    using const_iterator = Iterator<const HeaderEntryImpl>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    explicit HeaderList(HeaderMapArenaSharedPtr arena)
+        : arena_(std::move(arena)), entries_(arena_.get()),
           lazy_map_min_size_(static_cast<uint32_t>(
-              Runtime::getInteger("envoy.http.headermap.lazy_map_min_size", 3))) {}
+              Runtime::getInteger("envoy.http.headermap.lazy_map_min_size", 3))),
+          lazy_map_(arena_.get()) {}
+    ~HeaderList();
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -209,71 +274,44 @@ protected:
 
     template <class Key, class... Value> HeaderNode insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      HeaderNode i = headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
-                                      std::forward<Key>(key), std::forward<Value>(value)...);
-      if (!lazy_map_.empty()) {
-        lazy_map_[i->key().getStringView()].push_back(i);
-      }
-      if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
-        pseudo_headers_end_ = i;
+      HeaderNode entry = new (allocateSlot())
+          HeaderEntryImpl(std::forward<Key>(key), std::forward<Value>(value)...);
+      if (tombstones_ > size_) {
+        compact();
       }
-      return i;
-    }
-
-    HeaderNode erase(HeaderNode i, bool remove_from_map) {
-      if (pseudo_headers_end_ == i) {
-        pseudo_headers_end_++;
+      if (is_pseudo_header) {
+        insertAt(pseudo_headers_end_++, entry);
+      } else {
+        entry->position_ = entries_.size();
+        entries_.push_back(entry);
       }
-      if (remove_from_map) {
-        lazy_map_.erase(i->key().getStringView());
+      ++size_;
+      if (!lazy_map_.empty()) {
+        lazy_map_[entry->key().getStringView()].push_back(entry);
       }
-      return headers_.erase(i);
+      return entry;
     }
 
+    /*
+     * Removes a single entry, leaving a tombstone in its place.
+     *
+     * @param remove_from_map whether the entry's key must be removed from the lazy map. All
+     *        entries with the same key are then expected to be removed as well.
+     */
+    void erase(HeaderNode entry, bool remove_from_map);
+
     template <class UnaryPredicate> void removeIf(UnaryPredicate p) {
-      if (!lazy_map_.empty()) {
-        // Lazy map is used, iterate over its elements and remove those that satisfy the predicate
-        // from the map and from the list.
-        for (auto map_it = lazy_map_.begin(); map_it != lazy_map_.end();) {
-          auto& values_vec = map_it->second;
-          ASSERT(!values_vec.empty());
-          // The following call to std::remove_if removes the elements that satisfy the
-          // UnaryPredicate and shifts the vector elements, but does not resize the vector.
-          // The call to erase that follows erases the unneeded cells (from remove_pos to the
-          // end) and modifies the vector's size.
-          const auto remove_pos =
-              std::remove_if(values_vec.begin(), values_vec.end(), [&](HeaderNode it) {
-                if (p(*(it->entry_))) {
-                  // Remove the element from the list.
-                  if (pseudo_headers_end_ == it->entry_) {
-                    pseudo_headers_end_++;
-                  }
-                  headers_.erase(it);
-                  return true;
-                }
-                return false;
-              });
-          values_vec.erase(remove_pos, values_vec.end());
-
-          // If all elements were removed from the map entry, erase it.
-          if (values_vec.empty()) {
-            lazy_map_.erase(map_it++);
-          } else {
-            map_it++;
-          }
+      for (HeaderNode& entry : entries_) {
+        if (entry == nullptr || !p(*entry)) {
+          continue;
         }
-      } else {
-        // The lazy map isn't used, iterate over the list elements and remove elements that satisfy
-        // the predicate.
-        headers_.remove_if([&](const HeaderEntryImpl& entry) {
-          const bool to_remove = p(entry);
-          if (to_remove) {
-            if (pseudo_headers_end_ == entry.entry_) {
-              pseudo_headers_end_++;
-            }
-          }
-          return to_remove;
-        });
+        if (!lazy_map_.empty()) {
+          removeFromMap(entry);
+        }
+        destroy(entry);
+        entry = nullptr;
+        ++tombstones_;
+        --size_;
       }
     }
 
@@ -292,25 +330,47 @@ protected:
      */
     size_t remove(absl::string_view key);
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
+    iterator begin() { return {entries_.data(), 0, entries_.size()}; }
+    iterator end() { return {entries_.data(), entries_.size(), entries_.size()}; }
+    const_iterator begin() const { return {entries_.data(), 0, entries_.size()}; }
+    const_iterator end() const { return {entries_.data(), entries_.size(), entries_.size()}; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
-    size_t size() const { return headers_.size(); }
-    bool empty() const { return headers_.empty(); }
-    void clear() {
-      headers_.clear();
-      pseudo_headers_end_ = headers_.end();
-      lazy_map_.clear();
-    }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
 
   private:
-    std::list<HeaderEntryImpl> headers_;
-    HeaderNode pseudo_headers_end_;
+    // Storage for the entries, in blocks whose capacity grows from MinBlockCapacity to
+    // MaxBlockCapacity slots.
+    struct Block {
+      HeaderEntryImpl* slots_;
+      uint32_t capacity_;
+    };
+    static constexpr uint32_t MinBlockCapacity = 4;
+    static constexpr uint32_t MaxBlockCapacity = 16;
+
+    void* allocateSlot();
+    void destroy(HeaderNode entry);
+    void insertAt(size_t position, HeaderNode entry);
+    void removeFromMap(HeaderNode entry);
+    void compact();
+
+    // Must be destroyed after everything allocated from it.
+    const HeaderMapArenaSharedPtr arena_;
+    absl::InlinedVector<HeaderNode, 16, HeaderMapArenaAllocator<HeaderNode>> entries_;
+    absl::InlinedVector<Block, 2> blocks_;
+    // Slots of removed entries, reused before taking new slots from the blocks.
+    absl::InlinedVector<HeaderNode, 2> free_slots_;
+    // The block new slots are taken from, and how many of its slots have been taken.
+    uint32_t current_block_{};
+    uint32_t current_block_used_{};
+    // Index of the first non pseudo header position in entries_.
+    uint32_t pseudo_headers_end_{};
+    uint32_t size_{};
+    uint32_t tombstones_{};
     // The number of headers threshold for lazy map usage.
     const uint32_t lazy_map_min_size_;
     HeaderLazyMap lazy_map_;
@@ -353,6 +413,8 @@ protected:
  */
 template <class Interface> class TypedHeaderMapImpl : public HeaderMapImpl, public Interface {
 public:
+  explicit TypedHeaderMapImpl(HeaderMapArenaSharedPtr arena) : HeaderMapImpl(std::move(arena)) {}
+
   void setFormatter(StatefulHeaderKeyFormatterPtr&& formatter) {
     formatter_ = std::move(formatter);
   }
@@ -474,8 +536,9 @@ protected:
 class RequestHeaderMapImpl final : public TypedHeaderMapImpl<RequestHeaderMap>,
                                    public InlineStorage {
 public:
-  static std::unique_ptr<RequestHeaderMapImpl> create() {
-    return std::unique_ptr<RequestHeaderMapImpl>(new (inlineHeadersSize()) RequestHeaderMapImpl());
+  static std::unique_ptr<RequestHeaderMapImpl> create(HeaderMapArenaSharedPtr arena = nullptr) {
+    return std::unique_ptr<RequestHeaderMapImpl>(new (inlineHeadersSize())
+                                                 RequestHeaderMapImpl(std::move(arena)));
   }
 
   INLINE_REQ_STRING_HEADERS(DEFINE_INLINE_HEADER_STRING_FUNCS)
@@ -513,7 +576,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  RequestHeaderMapImpl() { clearInline(); }
+  explicit RequestHeaderMapImpl(HeaderMapArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -525,9 +591,9 @@ private:
 class RequestTrailerMapImpl final : public TypedHeaderMapImpl<RequestTrailerMap>,
                                     public InlineStorage {
 public:
-  static std::unique_ptr<RequestTrailerMapImpl> create() {
+  static std::unique_ptr<RequestTrailerMapImpl> create(HeaderMapArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<RequestTrailerMapImpl>(new (inlineHeadersSize())
-                                                      RequestTrailerMapImpl());
+                                                  RequestTrailerMapImpl(std::move(arena)));
   }
 
 protected:
@@ -537,7 +603,10 @@ protected:
   HeaderEntryImpl** inlineHeaders() override { return inline_headers_; }
 
 private:
-  RequestTrailerMapImpl() { clearInline(); }
+  explicit RequestTrailerMapImpl(HeaderMapArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -549,9 +618,9 @@ private:
 class ResponseHeaderMapImpl final : public TypedHeaderMapImpl<ResponseHeaderMap>,
                                     public InlineStorage {
 public:
-  static std::unique_ptr<ResponseHeaderMapImpl> create() {
+  static std::unique_ptr<ResponseHeaderMapImpl> create(HeaderMapArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<ResponseHeaderMapImpl>(new (inlineHeadersSize())
-                                                      ResponseHeaderMapImpl());
+                                                  ResponseHeaderMapImpl(std::move(arena)));
   }
 
   INLINE_RESP_STRING_HEADERS(DEFINE_INLINE_HEADER_STRING_FUNCS)
@@ -579,7 +648,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  ResponseHeaderMapImpl() { clearInline(); }
+  explicit ResponseHeaderMapImpl(HeaderMapArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -591,9 +663,9 @@ private:
 class ResponseTrailerMapImpl final : public TypedHeaderMapImpl<ResponseTrailerMap>,
                                      public InlineStorage {
 public:
-  static std::unique_ptr<ResponseTrailerMapImpl> create() {
+  static std::unique_ptr<ResponseTrailerMapImpl> create(HeaderMapArenaSharedPtr arena = nullptr) {
     return std::unique_ptr<ResponseTrailerMapImpl>(new (inlineHeadersSize())
-                                                       ResponseTrailerMapImpl());
+                                                   ResponseTrailerMapImpl(std::move(arena)));
   }
 
   INLINE_RESP_STRING_HEADERS_TRAILERS(DEFINE_INLINE_HEADER_STRING_FUNCS)
@@ -613,7 +685,10 @@ private:
 
   using HeaderHandles = ConstSingleton<HeaderHandleValues>;
 
-  ResponseTrailerMapImpl() { clearInline(); }
+  explicit ResponseTrailerMapImpl(HeaderMapArenaSharedPtr arena)
+      : TypedHeaderMapImpl(std::move(arena)) {
+    clearInline();
+  }
 
   HeaderEntryImpl* inline_headers_[];
 };
@@ -21,6 +21,7 @@
 #include "source/common/http/headers.h"
 #include "source/common/http/http1/header_formatter.h"
 #include "source/common/http/http1/legacy_parser_impl.h"
+#include "source/common/http/http1/vectorized_parser_impl.h"
 #include "source/common/http/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
@@ -245,8 +246,9 @@ void StreamEncoderImpl::encodeData(Buffer::Instance& data, bool end_stream) {
   // actually write the zero length buffer out.
   if (data.length() > 0) {
     if (chunk_encoding_) {
-      std::string chunk_header = absl::StrCat(absl::Hex(data.length()), CRLF);
-      connection_.buffer().add(std::move(chunk_header));
+      // AlphaNum formats the chunk size in place, without a temporary string.
+      connection_.buffer().add(absl::AlphaNum(absl::Hex(data.length())).Piece());
+      connection_.buffer().add(CRLF);
     }
 
     connection_.buffer().move(data);
@@ -497,13 +499,19 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
           "envoy.reloadable_features.send_strict_1xx_and_204_response_headers")),
       dispatching_(false), no_chunked_encoding_header_for_304_(Runtime::runtimeFeatureEnabled(
                                "envoy.reloadable_features.no_chunked_encoding_header_for_304")),
+      move_partial_body_slices_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http1_move_partial_body_slices")),
       output_buffer_(connection.dispatcher().getWatermarkFactory().createBuffer(
           [&]() -> void { this->onBelowLowWatermark(); },
           [&]() -> void { this->onAboveHighWatermark(); },
           []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
       max_headers_kb_(max_headers_kb), max_headers_count_(max_headers_count) {
   output_buffer_->setWatermarks(connection.bufferLimit());
-  parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
+  if (codec_settings_.use_vectorized_parser_) {
+    parser_ = std::make_unique<VectorizedHttpParserImpl>(type, this);
+  } else {
+    parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
+  }
 }
 
 Status ConnectionImpl::completeLastHeader() {
@@ -833,7 +841,16 @@ StatusOr<ParserStatus> ConnectionImpl::onHeadersComplete() {
 
 void ConnectionImpl::bufferBody(const char* data, size_t length) {
   auto slice = current_dispatching_buffer_->frontSlice();
-  if (data == slice.mem_ && length == slice.len_) {
+  const char* slice_start = static_cast<const char*>(slice.mem_);
+  if (data == slice_start && length == slice.len_) {
+    buffered_body_.move(*current_dispatching_buffer_, length);
+    dispatching_slice_already_drained_ = true;
+  } else if (move_partial_body_slices_ && data > slice_start &&
+             data + length == slice_start + slice.len_ && 2 * length >= slice.len_) {
+    // The body runs to the end of the slice, after headers or a chunk header which have already
+    // been parsed. Drop those and hand over the slice instead of copying the body out of it. Only
+    // do so when the body is most of the slice, so the body does not pin much unrelated memory.
+    current_dispatching_buffer_->drain(data - slice_start);
     buffered_body_.move(*current_dispatching_buffer_, length);
     dispatching_slice_already_drained_ = true;
   } else {
@@ -889,8 +906,11 @@ Status ConnectionImpl::onMessageBegin() {
   protocol_ = Protocol::Http11;
   processing_trailers_ = false;
   header_parsing_state_ = HeaderParsingState::Field;
+  // Headers are allocated once the stream exists so that a server stream can supply the arena to
+  // allocate them from.
+  const Status status = onMessageBeginBase();
   allocHeaders(statefulFormatterFromSettings(codec_settings_));
-  return onMessageBeginBase();
+  return status;
 }
 
 void ConnectionImpl::onResetStreamBase(StreamResetReason reason) {
@@ -1148,6 +1168,7 @@ Status ServerConnectionImpl::onMessageBeginBase() {
       return codecClientError("cannot create new streams after calling reset");
     }
     active_request.request_decoder_ = &callbacks_.newStream(active_request.response_encoder_);
+    active_request.header_map_arena_ = active_request.request_decoder_->headerMapArena();
 
     // Check for pipelined request flood as we prepare to accept a new request.
     // Parse errors that happen prior to onMessageBegin result in stream termination, it is not
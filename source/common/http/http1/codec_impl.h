@@ -320,6 +320,7 @@ protected:
   bool dispatching_ : 1;
   bool dispatching_slice_already_drained_ : 1;
   const bool no_chunked_encoding_header_for_304_ : 1;
+  const bool move_partial_body_slices_ : 1;
   StreamInfo::BytesMeterSharedPtr bytes_meter_before_stream_;
 
 private:
@@ -475,6 +476,7 @@ protected:
     void dumpState(std::ostream& os, int indent_level) const;
     HeaderString request_url_;
     RequestDecoder* request_decoder_{};
+    HeaderMapArenaSharedPtr header_map_arena_;
     ResponseEncoderImpl response_encoder_;
     bool remote_complete_{};
   };
@@ -531,16 +533,20 @@ private:
   void allocHeaders(StatefulHeaderKeyFormatterPtr&& formatter) override {
     ASSERT(nullptr == absl::get<RequestHeaderMapPtr>(headers_or_trailers_));
     ASSERT(!processing_trailers_);
-    auto headers = RequestHeaderMapImpl::create();
+    auto headers = RequestHeaderMapImpl::create(headerMapArena());
     headers->setFormatter(std::move(formatter));
     headers_or_trailers_.emplace<RequestHeaderMapPtr>(std::move(headers));
   }
   void allocTrailers() override {
     ASSERT(processing_trailers_);
     if (!absl::holds_alternative<RequestTrailerMapPtr>(headers_or_trailers_)) {
-      headers_or_trailers_.emplace<RequestTrailerMapPtr>(RequestTrailerMapImpl::create());
+      headers_or_trailers_.emplace<RequestTrailerMapPtr>(
+          RequestTrailerMapImpl::create(headerMapArena()));
     }
   }
+  HeaderMapArenaSharedPtr headerMapArena() const {
+    return active_request_.has_value() ? active_request_->header_map_arena_ : nullptr;
+  }
   void dumpAdditionalState(std::ostream& os, int indent_level) const override;
 
   void releaseOutboundResponse(const Buffer::OwnedBufferFragmentImpl* fragment);
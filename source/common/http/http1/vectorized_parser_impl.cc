@@ -0,0 +1,949 @@
+#include "source/common/http/http1/vectorized_parser_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Error codes, numbered as in http_parser so that return codes are interchangeable between parser
+// implementations.
+enum ErrorCode : int {
+  Ok = 0,
+  CbMessageBegin = 1,
+  CbUrl = 2,
+  CbHeaderField = 3,
+  CbHeaderValue = 4,
+  CbHeadersComplete = 5,
+  CbMessageComplete = 7,
+  InvalidEofState = 11,
+  ClosedConnection = 13,
+  InvalidVersion = 14,
+  InvalidStatus = 15,
+  InvalidMethod = 16,
+  InvalidUrl = 17,
+  LfExpected = 23,
+  InvalidHeaderToken = 24,
+  InvalidContentLength = 25,
+  UnexpectedContentLength = 26,
+  InvalidChunkSize = 27,
+  Strict = 30,
+  Paused = 31,
+  InvalidTransferEncoding = 33,
+};
+
+constexpr absl::string_view errorName(int rc) {
+  switch (rc) {
+  case Ok:
+    return "HPE_OK";
+  case CbMessageBegin:
+    return "HPE_CB_message_begin";
+  case CbUrl:
+    return "HPE_CB_url";
+  case CbHeaderField:
+    return "HPE_CB_header_field";
+  case CbHeaderValue:
+    return "HPE_CB_header_value";
+  case CbHeadersComplete:
+    return "HPE_CB_headers_complete";
+  case CbMessageComplete:
+    return "HPE_CB_message_complete";
+  case InvalidEofState:
+    return "HPE_INVALID_EOF_STATE";
+  case ClosedConnection:
+    return "HPE_CLOSED_CONNECTION";
+  case InvalidVersion:
+    return "HPE_INVALID_VERSION";
+  case InvalidStatus:
+    return "HPE_INVALID_STATUS";
+  case InvalidMethod:
+    return "HPE_INVALID_METHOD";
+  case InvalidUrl:
+    return "HPE_INVALID_URL";
+  case LfExpected:
+    return "HPE_LF_EXPECTED";
+  case InvalidHeaderToken:
+    return "HPE_INVALID_HEADER_TOKEN";
+  case InvalidContentLength:
+    return "HPE_INVALID_CONTENT_LENGTH";
+  case UnexpectedContentLength:
+    return "HPE_UNEXPECTED_CONTENT_LENGTH";
+  case InvalidChunkSize:
+    return "HPE_INVALID_CHUNK_SIZE";
+  case Strict:
+    return "HPE_STRICT";
+  case Paused:
+    return "HPE_PAUSED";
+  case InvalidTransferEncoding:
+    return "HPE_INVALID_TRANSFER_ENCODING";
+  default:
+    return "HPE_UNKNOWN";
+  }
+}
+
+// The methods accepted by http_parser.
+constexpr std::array<absl::string_view, 34> Methods = {
+    "DELETE", "GET", "HEAD", "POST", "PUT", "CONNECT", "OPTIONS", "TRACE", "COPY", "LOCK", "MKCOL",
+    "MOVE", "PROPFIND", "PROPPATCH", "SEARCH", "UNLOCK", "BIND", "REBIND", "UNBIND", "ACL",
+    "REPORT", "MKACTIVITY", "CHECKOUT", "MERGE", "M-SEARCH", "NOTIFY", "SUBSCRIBE", "UNSUBSCRIBE",
+    "PATCH", "PURGE", "MKCALENDAR", "LINK", "UNLINK", "SOURCE"};
+constexpr size_t MaxMethodLength = 11;
+constexpr absl::string_view ConnectMethod = "CONNECT";
+
+// Version tokens are always "HTTP/x.y".
+constexpr size_t VersionLength = 8;
+
+struct CharTables {
+  constexpr CharTables() {
+    for (int8_t& value : hex) {
+      value = -1;
+    }
+    for (const char c : absl::string_view("!#$%&'*+-.^_`|~")) {
+      token[static_cast<uint8_t>(c)] = true;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+      token[c] = true;
+      hex[c] = c - '0';
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+      token[c] = true;
+      token[c - 'a' + 'A'] = true;
+    }
+    for (int c = 'a'; c <= 'f'; ++c) {
+      hex[c] = c - 'a' + 10;
+      hex[c - 'a' + 'A'] = c - 'a' + 10;
+    }
+  }
+
+  // RFC 7230 tchar.
+  bool token[256]{};
+  // Value of a hex digit, or -1.
+  int8_t hex[256]{};
+};
+constexpr CharTables Chars;
+
+bool isToken(char c) { return Chars.token[static_cast<uint8_t>(c)]; }
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+bool isMethodChar(char c) { return (c >= 'A' && c <= 'Z') || c == '-'; }
+
+/**
+ * @return a pointer to the first byte in [p, end) that is lower than `Low`, is DEL, or, if
+ * StopOnHigh is set, has the high bit set. Returns end if there is no such byte.
+ *
+ * This is the only scan on the hot path which touches every byte of request targets and header
+ * values, so it examines 16 bytes per iteration where SSE2 is available.
+ */
+template <uint8_t Low, bool StopOnHigh> const char* findDelimiter(const char* p, const char* end) {
+#if defined(__SSE2__)
+  const __m128i low = _mm_set1_epi8(static_cast<char>(Low - 1));
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (end - p >= 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // v <= Low - 1 as unsigned bytes.
+    __m128i stop = _mm_cmpeq_epi8(_mm_min_epu8(v, low), v);
+    stop = _mm_or_si128(stop, _mm_cmpeq_epi8(v, del));
+    if (StopOnHigh) {
+      // Bytes with the high bit set are negative as signed bytes.
+      stop = _mm_or_si128(stop, _mm_cmplt_epi8(v, _mm_setzero_si128()));
+    }
+    const int mask = _mm_movemask_epi8(stop);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  for (; p < end; ++p) {
+    const uint8_t c = static_cast<uint8_t>(*p);
+    if (c < Low || c == 0x7f || (StopOnHigh && c >= 0x80)) {
+      return p;
+    }
+  }
+  return end;
+}
+
+// Request targets end at the first space. Control characters and non-ASCII bytes are invalid.
+const char* findUrlEnd(const char* p, const char* end) { return findDelimiter<0x21, true>(p, end); }
+
+// Header values and reason phrases end at CR or LF. HTAB is allowed and other control characters
+// are invalid, so those are left to the caller.
+const char* findValueEnd(const char* p, const char* end) {
+  return findDelimiter<0x20, false>(p, end);
+}
+
+absl::string_view trimWhitespace(absl::string_view value) {
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  return value;
+}
+
+} // namespace
+
+VectorizedHttpParserImpl::VectorizedHttpParserImpl(MessageType type, ParserCallbacks* callbacks)
+    : type_(type), callbacks_(callbacks) {}
+
+void VectorizedHttpParserImpl::startMessage() {
+  token_.clear();
+  header_name_.clear();
+  header_value_.clear();
+  method_ = {};
+  status_code_ = 0;
+  http_major_ = 0;
+  http_minor_ = 0;
+  content_length_ = absl::nullopt;
+  remaining_ = 0;
+  chunked_ = false;
+  uses_transfer_encoding_ = false;
+  connection_close_ = false;
+  connection_keep_alive_ = false;
+  connection_upgrade_ = false;
+  upgrade_header_ = false;
+  upgrade_ = false;
+  skip_body_ = false;
+  in_trailers_ = false;
+}
+
+bool VectorizedHttpParserImpl::checkCallback(int rc, int error_code) {
+  if (rc != statusToInt(ParserStatus::Success)) {
+    errno_ = error_code;
+    return false;
+  }
+  return errno_ == Ok;
+}
+
+bool VectorizedHttpParserImpl::parseVersion() {
+  const absl::string_view version = token_;
+  if (version.size() != VersionLength || !absl::StartsWith(version, "HTTP/") ||
+      !isDigit(version[5]) || version[6] != '.' || !isDigit(version[7])) {
+    return false;
+  }
+  http_major_ = version[5] - '0';
+  http_minor_ = version[7] - '0';
+  return true;
+}
+
+bool VectorizedHttpParserImpl::shouldKeepAlive() const {
+  if (http_major_ > 0 && http_minor_ > 0) {
+    if (connection_close_) {
+      return false;
+    }
+  } else if (!connection_keep_alive_) {
+    return false;
+  }
+  return !messageNeedsEof();
+}
+
+bool VectorizedHttpParserImpl::messageNeedsEof() const {
+  if (type_ == MessageType::Request) {
+    return false;
+  }
+  // See RFC 7230 section 3.3.3.
+  if (status_code_ / 100 == 1 || status_code_ == 204 || status_code_ == 304 || skip_body_) {
+    return false;
+  }
+  if ((uses_transfer_encoding_ && chunked_) || content_length_.has_value()) {
+    return false;
+  }
+  return true;
+}
+
+bool VectorizedHttpParserImpl::onHeaderComplete(const char* at) {
+  if (!header_value_seen_) {
+    // Empty values are still reported so that the callbacks see a value for every field.
+    if (!checkCallback(callbacks_->setAndCheckCallbackStatus(callbacks_->onHeaderValue(at, 0)),
+                       CbHeaderValue)) {
+      return false;
+    }
+  }
+  if (in_trailers_ || header_kind_ == HeaderKind::Other) {
+    return true;
+  }
+
+  const absl::string_view value = trimWhitespace(header_value_);
+  switch (header_kind_) {
+  case HeaderKind::ContentLength: {
+    if (content_length_.has_value()) {
+      errno_ = UnexpectedContentLength;
+      return false;
+    }
+    if (value.empty()) {
+      errno_ = InvalidContentLength;
+      return false;
+    }
+    uint64_t length = 0;
+    for (const char c : value) {
+      if (!isDigit(c) || length > (UINT64_MAX - 9) / 10) {
+        errno_ = InvalidContentLength;
+        return false;
+      }
+      length = length * 10 + (c - '0');
+    }
+    content_length_ = length;
+    break;
+  }
+  case HeaderKind::TransferEncoding: {
+    uses_transfer_encoding_ = true;
+    // Only a final "chunked" coding frames the message as chunked.
+    const size_t last_comma = value.rfind(',');
+    const absl::string_view last_coding =
+        last_comma == absl::string_view::npos ? value : value.substr(last_comma + 1);
+    chunked_ = absl::EqualsIgnoreCase(trimWhitespace(last_coding), "chunked");
+    break;
+  }
+  case HeaderKind::Connection:
+    for (const absl::string_view token : absl::StrSplit(value, ',')) {
+      const absl::string_view option = trimWhitespace(token);
+      if (absl::EqualsIgnoreCase(option, "close")) {
+        connection_close_ = true;
+      } else if (absl::EqualsIgnoreCase(option, "keep-alive")) {
+        connection_keep_alive_ = true;
+      } else if (absl::EqualsIgnoreCase(option, "upgrade")) {
+        connection_upgrade_ = true;
+      }
+    }
+    break;
+  case HeaderKind::Upgrade:
+    upgrade_header_ = true;
+    break;
+  case HeaderKind::Other:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+  return true;
+}
+
+bool VectorizedHttpParserImpl::onHeadersEnd() {
+  if (in_trailers_) {
+    return onMessageComplete();
+  }
+
+  if (upgrade_header_ && connection_upgrade_) {
+    // For responses, Upgrade only takes effect with 101 Switching Protocols; otherwise it merely
+    // announces support.
+    upgrade_ = type_ == MessageType::Request || status_code_ == 101;
+  } else {
+    upgrade_ = method_ == ConnectMethod;
+  }
+
+  state_ = State::HeadersDone;
+  const int rc = callbacks_->setAndCheckCallbackStatusOr(callbacks_->onHeadersComplete());
+  if (rc == statusToInt(ParserStatus::NoBodyData)) {
+    upgrade_ = true;
+    skip_body_ = true;
+  } else if (rc == statusToInt(ParserStatus::NoBody)) {
+    skip_body_ = true;
+  } else if (rc != statusToInt(ParserStatus::Success)) {
+    errno_ = CbHeadersComplete;
+    return false;
+  }
+  if (errno_ != Ok) {
+    return false;
+  }
+  return onHeadersDone();
+}
+
+bool VectorizedHttpParserImpl::onHeadersDone() {
+  ASSERT(state_ == State::HeadersDone);
+  const bool has_body = chunked_ || (content_length_.has_value() && content_length_.value() > 0);
+  if (upgrade_ && (method_ == ConnectMethod || skip_body_ || !has_body)) {
+    // The rest of the data belongs to a different protocol, so stop parsing.
+    onMessageComplete();
+    return false;
+  }
+
+  if (skip_body_) {
+    return onMessageComplete();
+  }
+  if (chunked_) {
+    state_ = State::ChunkSizeStart;
+    return true;
+  }
+  if (uses_transfer_encoding_) {
+    if (type_ == MessageType::Request) {
+      errno_ = InvalidTransferEncoding;
+      return false;
+    }
+    state_ = State::BodyIdentityEof;
+    return true;
+  }
+  if (content_length_.has_value()) {
+    if (content_length_.value() == 0) {
+      return onMessageComplete();
+    }
+    remaining_ = content_length_.value();
+    state_ = State::BodyIdentity;
+    return true;
+  }
+  if (messageNeedsEof()) {
+    state_ = State::BodyIdentityEof;
+    return true;
+  }
+  return onMessageComplete();
+}
+
+bool VectorizedHttpParserImpl::onMessageComplete() {
+  state_ = shouldKeepAlive() ? State::MessageStart : State::Dead;
+  if (!checkCallback(callbacks_->setAndCheckCallbackStatusOr(callbacks_->onMessageComplete()),
+                     CbMessageComplete)) {
+    return false;
+  }
+  // Data after the body of an upgrade request belongs to the protocol upgraded to.
+  return !upgrade_;
+}
+
+Parser::RcVal VectorizedHttpParserImpl::execute(const char* data, int len) {
+  if (errno_ != Ok) {
+    return {0, errno_};
+  }
+
+  const char* p = data;
+  const char* const end = data + len;
+
+  if (state_ == State::HeadersDone && !onHeadersDone()) {
+    return stop(data, p);
+  }
+
+  if (len == 0) {
+    switch (state_) {
+    case State::MessageStart:
+    case State::Dead:
+      return {0, errno_};
+    case State::BodyIdentityEof:
+      onMessageComplete();
+      return {0, errno_};
+    default:
+      return fail(data, p, InvalidEofState);
+    }
+  }
+
+  while (p < end) {
+    switch (state_) {
+    case State::MessageStart: {
+      // Skip empty lines between messages.
+      while (p < end && (*p == '\r' || *p == '\n')) {
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      startMessage();
+      state_ = type_ == MessageType::Request ? State::Method : State::ResponseVersion;
+      if (!checkCallback(callbacks_->setAndCheckCallbackStatus(callbacks_->onMessageBegin()),
+                         CbMessageBegin)) {
+        return stop(data, p);
+      }
+      break;
+    }
+
+    case State::Method: {
+      const char* start = p;
+      while (p < end && isMethodChar(*p)) {
+        ++p;
+      }
+      token_.append(start, p - start);
+      if (token_.size() > MaxMethodLength) {
+        return fail(data, p, InvalidMethod);
+      }
+      if (p == end) {
+        break;
+      }
+      if (*p != ' ') {
+        return fail(data, p, InvalidMethod);
+      }
+      for (const absl::string_view method : Methods) {
+        if (method == token_) {
+          method_ = method;
+          break;
+        }
+      }
+      if (method_.empty()) {
+        return fail(data, p, InvalidMethod);
+      }
+      token_.clear();
+      ++p;
+      state_ = State::UrlStart;
+      break;
+    }
+
+    case State::UrlStart:
+      while (p < end && *p == ' ') {
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      if (*p == '\r' || *p == '\n') {
+        return fail(data, p, InvalidUrl);
+      }
+      // As with http_parser, a target is in origin-form, asterisk-form or absolute-form, except
+      // for CONNECT, whose target is an authority.
+      if (method_ == ConnectMethod || *p == '/' || *p == '*') {
+        state_ = State::Url;
+      } else if (absl::ascii_isalpha(*p)) {
+        state_ = State::UrlScheme;
+      } else {
+        return fail(data, p, InvalidUrl);
+      }
+      break;
+
+    case State::UrlScheme: {
+      // The scheme of an absolute-form target must be followed by "://". It is short, so it is
+      // checked a byte at a time, and kept in token_ in case it spans slices.
+      const char* start = p;
+      while (p < end && !absl::EndsWith(token_, "://")) {
+        const bool valid = token_.find(':') == std::string::npos
+                               ? absl::ascii_isalpha(*p) || *p == ':'
+                               : *p == '/';
+        if (!valid) {
+          return fail(data, p, InvalidUrl);
+        }
+        token_.push_back(*p);
+        ++p;
+      }
+      if (p != start && !checkCallback(callbacks_->setAndCheckCallbackStatus(
+                                           callbacks_->onUrl(start, p - start)),
+                                       CbUrl)) {
+        return stop(data, p);
+      }
+      if (absl::EndsWith(token_, "://")) {
+        token_.clear();
+        state_ = State::Url;
+      }
+      break;
+    }
+
+    case State::Url: {
+      const char* start = p;
+      p = findUrlEnd(p, end);
+      if (p != start && !checkCallback(callbacks_->setAndCheckCallbackStatus(
+                                           callbacks_->onUrl(start, p - start)),
+                                       CbUrl)) {
+        return stop(data, p);
+      }
+      if (p == end) {
+        break;
+      }
+      switch (*p) {
+      case ' ':
+        state_ = State::RequestVersionStart;
+        break;
+      case '\r':
+      case '\n':
+        // HTTP/0.9 request line.
+        http_major_ = 0;
+        http_minor_ = 9;
+        state_ = *p == '\r' ? State::StartLineLf : State::HeaderLineStart;
+        break;
+      default:
+        return fail(data, p, InvalidUrl);
+      }
+      ++p;
+      break;
+    }
+
+    case State::RequestVersionStart:
+      while (p < end && *p == ' ') {
+        ++p;
+      }
+      if (p != end) {
+        state_ = State::RequestVersion;
+      }
+      break;
+
+    case State::RequestVersion: {
+      const char* start = p;
+      while (p < end && *p != '\r' && *p != '\n') {
+        ++p;
+      }
+      token_.append(start, p - start);
+      if (token_.size() > VersionLength) {
+        return fail(data, p, InvalidVersion);
+      }
+      if (p == end) {
+        break;
+      }
+      if (!parseVersion()) {
+        return fail(data, p, InvalidVersion);
+      }
+      token_.clear();
+      state_ = *p == '\r' ? State::StartLineLf : State::HeaderLineStart;
+      ++p;
+      break;
+    }
+
+    case State::ResponseVersion: {
+      const char* start = p;
+      while (p < end && *p != ' ' && token_.size() + (p - start) < VersionLength) {
+        ++p;
+      }
+      token_.append(start, p - start);
+      if (p == end) {
+        break;
+      }
+      if (*p != ' ' || !parseVersion()) {
+        return fail(data, p, InvalidVersion);
+      }
+      token_.clear();
+      ++p;
+      state_ = State::StatusCodeStart;
+      break;
+    }
+
+    case State::StatusCodeStart:
+      while (p < end && *p == ' ') {
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      if (!isDigit(*p)) {
+        return fail(data, p, InvalidStatus);
+      }
+      state_ = State::StatusCode;
+      break;
+
+    case State::StatusCode:
+      while (p < end && isDigit(*p)) {
+        status_code_ = status_code_ * 10 + (*p - '0');
+        if (status_code_ > 999) {
+          return fail(data, p, InvalidStatus);
+        }
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      switch (*p) {
+      case ' ':
+        state_ = State::ReasonPhrase;
+        break;
+      case '\r':
+        state_ = State::StartLineLf;
+        break;
+      case '\n':
+        state_ = State::HeaderLineStart;
+        break;
+      default:
+        return fail(data, p, InvalidStatus);
+      }
+      ++p;
+      break;
+
+    case State::ReasonPhrase:
+      // The reason phrase is not reported, only its end matters.
+      while ((p = findValueEnd(p, end)) < end && *p != '\r' && *p != '\n') {
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      state_ = *p == '\r' ? State::StartLineLf : State::HeaderLineStart;
+      ++p;
+      break;
+
+    case State::StartLineLf:
+      if (*p != '\n') {
+        return fail(data, p, LfExpected);
+      }
+      ++p;
+      state_ = State::HeaderLineStart;
+      break;
+
+    case State::HeaderLineStart:
+      if (*p == '\r') {
+        ++p;
+        state_ = State::HeadersLf;
+        break;
+      }
+      if (*p == '\n') {
+        ++p;
+        if (!onHeadersEnd()) {
+          return stop(data, p);
+        }
+        break;
+      }
+      // Obsolete line folding is rejected, as RFC 7230 section 3.2.4 allows.
+      if (!isToken(*p)) {
+        return fail(data, p, InvalidHeaderToken);
+      }
+      header_name_.clear();
+      state_ = State::HeaderField;
+      break;
+
+    case State::HeaderField: {
+      const char* start = p;
+      while (p < end && isToken(*p)) {
+        ++p;
+      }
+      if (p != start && !checkCallback(callbacks_->setAndCheckCallbackStatus(
+                                           callbacks_->onHeaderField(start, p - start)),
+                                       CbHeaderField)) {
+        return stop(data, p);
+      }
+      if (p == end) {
+        header_name_.append(start, p - start);
+        break;
+      }
+      if (*p != ':') {
+        return fail(data, p, InvalidHeaderToken);
+      }
+
+      absl::string_view name(start, p - start);
+      if (!header_name_.empty()) {
+        header_name_.append(start, p - start);
+        name = header_name_;
+      }
+      header_kind_ = HeaderKind::Other;
+      if (absl::EqualsIgnoreCase(name, "content-length")) {
+        header_kind_ = HeaderKind::ContentLength;
+      } else if (absl::EqualsIgnoreCase(name, "transfer-encoding")) {
+        header_kind_ = HeaderKind::TransferEncoding;
+      } else if (absl::EqualsIgnoreCase(name, "connection")) {
+        header_kind_ = HeaderKind::Connection;
+      } else if (absl::EqualsIgnoreCase(name, "upgrade")) {
+        header_kind_ = HeaderKind::Upgrade;
+      }
+      header_value_.clear();
+      header_value_seen_ = false;
+      ++p;
+      state_ = State::HeaderValueStart;
+      break;
+    }
+
+    case State::HeaderValueStart:
+      while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+      }
+      if (p != end) {
+        state_ = State::HeaderValue;
+      }
+      break;
+
+    case State::HeaderValue: {
+      const char* start = p;
+      while ((p = findValueEnd(p, end)) < end && *p == '\t') {
+        ++p;
+      }
+      if (p != start) {
+        if (!checkCallback(callbacks_->setAndCheckCallbackStatus(
+                               callbacks_->onHeaderValue(start, p - start)),
+                           CbHeaderValue)) {
+          return stop(data, p);
+        }
+        header_value_seen_ = true;
+        if (header_kind_ != HeaderKind::Other) {
+          header_value_.append(start, p - start);
+        }
+      }
+      if (p == end) {
+        break;
+      }
+      if (*p != '\r' && *p != '\n') {
+        return fail(data, p, InvalidHeaderToken);
+      }
+      if (!onHeaderComplete(p)) {
+        return stop(data, p);
+      }
+      state_ = *p == '\r' ? State::HeaderValueLf : State::HeaderLineStart;
+      ++p;
+      break;
+    }
+
+    case State::HeaderValueLf:
+      if (*p != '\n') {
+        return fail(data, p, Strict);
+      }
+      ++p;
+      state_ = State::HeaderLineStart;
+      break;
+
+    case State::HeadersLf:
+      if (*p != '\n') {
+        return fail(data, p, Strict);
+      }
+      ++p;
+      if (!onHeadersEnd()) {
+        return stop(data, p);
+      }
+      break;
+
+    case State::HeadersDone:
+      // Only entered between slices, when a callback paused the parser.
+      NOT_REACHED_GCOVR_EXCL_LINE;
+
+    case State::BodyIdentity: {
+      const uint64_t length = std::min<uint64_t>(remaining_, end - p);
+      callbacks_->bufferBody(p, length);
+      p += length;
+      remaining_ -= length;
+      if (remaining_ == 0 && !onMessageComplete()) {
+        return stop(data, p);
+      }
+      break;
+    }
+
+    case State::BodyIdentityEof:
+      callbacks_->bufferBody(p, end - p);
+      p = end;
+      break;
+
+    case State::ChunkSizeStart:
+      if (Chars.hex[static_cast<uint8_t>(*p)] < 0) {
+        return fail(data, p, InvalidChunkSize);
+      }
+      remaining_ = 0;
+      state_ = State::ChunkSize;
+      break;
+
+    case State::ChunkSize: {
+      int8_t digit;
+      while (p < end && (digit = Chars.hex[static_cast<uint8_t>(*p)]) >= 0) {
+        if (remaining_ > (UINT64_MAX >> 4)) {
+          return fail(data, p, InvalidChunkSize);
+        }
+        remaining_ = (remaining_ << 4) | digit;
+        ++p;
+      }
+      if (p == end) {
+        break;
+      }
+      if (*p == '\r') {
+        state_ = State::ChunkSizeLf;
+      } else if (*p == ';' || *p == ' ') {
+        state_ = State::ChunkExtension;
+      } else {
+        return fail(data, p, InvalidChunkSize);
+      }
+      ++p;
+      break;
+    }
+
+    case State::ChunkExtension: {
+      // Chunk extensions are ignored.
+      const void* cr = memchr(p, '\r', end - p);
+      if (cr == nullptr) {
+        p = end;
+        break;
+      }
+      p = static_cast<const char*>(cr) + 1;
+      state_ = State::ChunkSizeLf;
+      break;
+    }
+
+    case State::ChunkSizeLf:
+      if (*p != '\n') {
+        return fail(data, p, Strict);
+      }
+      ++p;
+      callbacks_->onChunkHeader(remaining_ == 0);
+      if (remaining_ == 0) {
+        in_trailers_ = true;
+        state_ = State::HeaderLineStart;
+      } else {
+        state_ = State::ChunkData;
+      }
+      break;
+
+    case State::ChunkData: {
+      const uint64_t length = std::min<uint64_t>(remaining_, end - p);
+      callbacks_->bufferBody(p, length);
+      p += length;
+      remaining_ -= length;
+      if (remaining_ == 0) {
+        state_ = State::ChunkDataCr;
+      }
+      break;
+    }
+
+    case State::ChunkDataCr:
+      if (*p != '\r') {
+        return fail(data, p, Strict);
+      }
+      ++p;
+      state_ = State::ChunkDataLf;
+      break;
+
+    case State::ChunkDataLf:
+      if (*p != '\n') {
+        return fail(data, p, Strict);
+      }
+      ++p;
+      state_ = State::ChunkSizeStart;
+      break;
+
+    case State::Dead:
+      // Nothing but empty lines may follow a message on a connection that is not kept alive.
+      if (*p != '\r' && *p != '\n') {
+        return fail(data, p, ClosedConnection);
+      }
+      ++p;
+      break;
+    }
+  }
+
+  return stop(data, p);
+}
+
+void VectorizedHttpParserImpl::resume() {
+  if (errno_ == Paused) {
+    errno_ = Ok;
+  }
+}
+
+ParserStatus VectorizedHttpParserImpl::pause() {
+  if (errno_ == Ok) {
+    errno_ = Paused;
+  }
+  return ParserStatus::Success;
+}
+
+ParserStatus VectorizedHttpParserImpl::getStatus() {
+  switch (errno_) {
+  case Ok:
+    return ParserStatus::Success;
+  case Paused:
+    return ParserStatus::Paused;
+  default:
+    return ParserStatus::Unknown;
+  }
+}
+
+absl::string_view VectorizedHttpParserImpl::errnoName(int rc) const { return errorName(rc); }
+
+int VectorizedHttpParserImpl::statusToInt(const ParserStatus code) const {
+  switch (code) {
+  case ParserStatus::Error:
+    return -1;
+  case ParserStatus::Success:
+    return 0;
+  case ParserStatus::NoBody:
+    return 1;
+  case ParserStatus::NoBodyData:
+    return 2;
+  case ParserStatus::Paused:
+    return Paused;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
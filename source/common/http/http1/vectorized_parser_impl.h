@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "source/common/http/http1/parser.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * HTTP/1 parser which locates the delimiters of request targets, header values and reason phrases
+ * a block of bytes at a time (SSE2 where available) instead of driving a state machine byte by
+ * byte. All data passed to ParserCallbacks points directly into the slice given to execute().
+ *
+ * The parser follows the semantics of the strict http_parser build wrapped by
+ * LegacyHttpParserImpl, and reports errors with the same codes and names, so the codec behaves the
+ * same regardless of which implementation is selected. The notable differences are that
+ * obsolete line folding in header values is rejected and that only single digit HTTP versions are
+ * accepted.
+ */
+class VectorizedHttpParserImpl : public Parser {
+public:
+  VectorizedHttpParserImpl(MessageType type, ParserCallbacks* callbacks);
+
+  // Http1::Parser
+  RcVal execute(const char* data, int len) override;
+  void resume() override;
+  ParserStatus pause() override;
+  ParserStatus getStatus() override;
+  uint16_t statusCode() const override { return status_code_; }
+  int httpMajor() const override { return http_major_; }
+  int httpMinor() const override { return http_minor_; }
+  absl::optional<uint64_t> contentLength() const override { return content_length_; }
+  bool isChunked() const override { return chunked_; }
+  absl::string_view methodName() const override { return method_; }
+  absl::string_view errnoName(int rc) const override;
+  int hasTransferEncoding() const override { return uses_transfer_encoding_; }
+  int statusToInt(const ParserStatus code) const override;
+
+private:
+  enum class State : uint8_t {
+    MessageStart,
+    Method,
+    UrlStart,
+    UrlScheme,
+    Url,
+    RequestVersionStart,
+    RequestVersion,
+    ResponseVersion,
+    StatusCodeStart,
+    StatusCode,
+    ReasonPhrase,
+    StartLineLf,
+    HeaderLineStart,
+    HeaderField,
+    HeaderValueStart,
+    HeaderValue,
+    HeaderValueLf,
+    HeadersLf,
+    HeadersDone,
+    BodyIdentity,
+    BodyIdentityEof,
+    ChunkSizeStart,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeLf,
+    ChunkData,
+    ChunkDataCr,
+    ChunkDataLf,
+    Dead,
+  };
+
+  enum class HeaderKind : uint8_t { Other, ContentLength, TransferEncoding, Connection, Upgrade };
+
+  // Resets all per message state.
+  void startMessage();
+  // Validates and records the version stored in token_.
+  bool parseVersion();
+  // Called once a header line has been fully received.
+  bool onHeaderComplete(const char* at);
+  // Called on the empty line terminating the headers or trailers.
+  bool onHeadersEnd();
+  // Decides how the body is framed once headers have been delivered. Returns false if parsing of
+  // the current slice must stop.
+  bool onHeadersDone();
+  bool onMessageComplete();
+  bool shouldKeepAlive() const;
+  bool messageNeedsEof() const;
+  // Returns false if the callback return code signals an error, in which case error_code is
+  // recorded, or if the callback paused the parser.
+  bool checkCallback(int rc, int error_code);
+  RcVal stop(const char* data, const char* at) const {
+    return {static_cast<size_t>(at - data), errno_};
+  }
+  RcVal fail(const char* data, const char* at, int error_code) {
+    errno_ = error_code;
+    return stop(data, at);
+  }
+
+  const MessageType type_;
+  ParserCallbacks* const callbacks_;
+  State state_{State::MessageStart};
+  int errno_{};
+
+  // Scratch space for the method and version tokens, which may span slices.
+  std::string token_;
+  // Header names and values needed for framing, accumulated only when they span slices or when
+  // they belong to one of the headers the parser has to interpret.
+  std::string header_name_;
+  std::string header_value_;
+  HeaderKind header_kind_{HeaderKind::Other};
+  bool header_value_seen_{};
+
+  absl::string_view method_;
+  uint16_t status_code_{};
+  uint8_t http_major_{};
+  uint8_t http_minor_{};
+  absl::optional<uint64_t> content_length_;
+  uint64_t remaining_{};
+  bool chunked_{};
+  bool uses_transfer_encoding_{};
+  bool connection_close_{};
+  bool connection_keep_alive_{};
+  bool connection_upgrade_{};
+  bool upgrade_header_{};
+  bool upgrade_{};
+  bool skip_body_{};
+  bool in_trailers_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -462,7 +462,7 @@ void ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t
 
   parent_.stats_.pending_send_bytes_.sub(length);
   output.move(*pending_send_data_, length);
-  parent_.connection_.write(output, false);
+  parent_.writeOutboundFrames(output);
 }
 
 void ConnectionImpl::ClientStreamImpl::submitHeaders(const HeaderMap& headers,
@@ -614,6 +614,11 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       stream_error_on_invalid_http_messaging_(
           http2_options.override_stream_error_on_invalid_http_message().value()),
       protocol_constraints_(stats, http2_options),
+      coalesce_outbound_frames_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http2_coalesce_outbound_frames")),
+      max_outbound_data_frame_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          http2_options, max_outbound_data_frame_size,
+          ::Envoy::Http2::Utility::OptionsLimits::DEFAULT_MAX_DATA_FRAME_SIZE)),
       skip_dispatching_frames_for_closed_connection_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.skip_dispatching_frames_for_closed_connection")),
       dispatching_(false), raised_goaway_(false), random_(random_generator),
@@ -1085,10 +1090,33 @@ ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   // deleted before the codec object is deleted. This is presently guaranteed by the
   // destruction order of the Network::ConnectionImpl object where write_buffer_ is
   // destroyed before the filter_manager_ which owns the codec through Http::ConnectionManagerImpl.
-  connection_.write(buffer, false);
+  writeOutboundFrames(buffer);
   return length;
 }
 
+void ConnectionImpl::writeOutboundFrames(Buffer::OwnedImpl& output) {
+  if (!coalesce_outbound_frames_) {
+    connection_.write(output, false);
+    return;
+  }
+  // Small frames such as frame headers, WINDOW_UPDATE and HEADERS are copied into the tail slice
+  // by move(), so a burst of frames from many streams ends up in a handful of slices. That keeps
+  // the writev() vector short and lets TLS pack them into full records.
+  outbound_frames_.move(output);
+}
+
+void ConnectionImpl::flushOutboundFrames() {
+  if (outbound_frames_.length() == 0) {
+    return;
+  }
+  if (connection_.state() == Network::Connection::State::Closed) {
+    // Draining runs the frame releasors so that the outbound frame accounting stays balanced.
+    outbound_frames_.drain(outbound_frames_.length());
+    return;
+  }
+  connection_.write(outbound_frames_, false);
+}
+
 int ConnectionImpl::onStreamClose(int32_t stream_id, uint32_t error_code) {
   StreamImpl* stream = getStream(stream_id);
   if (stream) {
@@ -1219,6 +1247,8 @@ Status ConnectionImpl::sendPendingFrames() {
   }
 
   const int rc = nghttp2_session_send(session_);
+  // Frames serialized before a failure, such as a GOAWAY, are still written out.
+  flushOutboundFrames();
   if (rc != 0) {
     ASSERT(rc == NGHTTP2_ERR_CALLBACK_FAILURE);
     return codecProtocolError(nghttp2_strerror(rc));
@@ -1356,6 +1386,25 @@ void ConnectionImpl::onProtocolConstraintViolation() {
   connection_.close(Envoy::Network::ConnectionCloseType::NoFlush);
 }
 
+namespace {
+
+// Names and values that the peer sent as references into the HPACK static table are backed by
+// nghttp2's static storage, which outlives every header map, so they can be referenced rather than
+// copied. This also lets the encoder skip copying those names when the headers are proxied.
+HeaderString headerStringFromRcbuf(nghttp2_rcbuf* rcbuf) {
+  const nghttp2_vec buf = nghttp2_rcbuf_get_buf(rcbuf);
+  const absl::string_view view(reinterpret_cast<const char*>(buf.base), buf.len);
+  HeaderString header_string;
+  if (nghttp2_rcbuf_is_static(rcbuf)) {
+    header_string.setReference(view);
+  } else {
+    header_string.setCopy(view);
+  }
+  return header_string;
+}
+
+} // namespace
+
 ConnectionImpl::Http2Callbacks::Http2Callbacks() {
   nghttp2_session_callbacks_new(&callbacks_);
   nghttp2_session_callbacks_set_send_callback(
@@ -1364,6 +1413,14 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
         return static_cast<ConnectionImpl*>(user_data)->onSend(data, length);
       });
 
+  nghttp2_session_callbacks_set_data_source_read_length_callback(
+      callbacks_,
+      [](nghttp2_session*, uint8_t, int32_t, int32_t, int32_t, uint32_t,
+         void* user_data) -> ssize_t {
+        // nghttp2 clamps this to the peer's SETTINGS_MAX_FRAME_SIZE and the flow control windows.
+        return static_cast<ConnectionImpl*>(user_data)->max_outbound_data_frame_size_;
+      });
+
   nghttp2_session_callbacks_set_send_data_callback(
       callbacks_,
       [](nghttp2_session*, nghttp2_frame* frame, const uint8_t* framehd, size_t length,
@@ -1380,17 +1437,12 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
             std::move(status));
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
+  nghttp2_session_callbacks_set_on_header_callback2(
       callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
-        HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
-        HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
-        return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
-                                                                 std::move(value));
+      [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* name, nghttp2_rcbuf* value,
+         uint8_t, void* user_data) -> int {
+        return static_cast<ConnectionImpl*>(user_data)->onHeader(
+            frame, headerStringFromRcbuf(name), headerStringFromRcbuf(value));
       });
 
   nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
@@ -1782,7 +1834,7 @@ Status ServerConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
   if (connection_.aboveHighWatermark()) {
     stream->runHighWatermarkCallbacks();
   }
-  stream->request_decoder_ = &callbacks_.newStream(*stream);
+  stream->setRequestDecoder(callbacks_.newStream(*stream));
   stream->stream_id_ = frame->hd.stream_id;
   LinkedList::moveIntoList(std::move(stream), active_streams_);
   nghttp2_session_set_stream_user_data(session_, frame->hd.stream_id,
@@ -128,7 +128,9 @@ public:
   Protocol protocol() override { return Protocol::Http2; }
   void shutdownNotice() override;
   Status protocolErrorForTest(); // Used in tests to simulate errors.
-  bool wantsToWrite() override { return nghttp2_session_want_write(session_); }
+  bool wantsToWrite() override {
+    return nghttp2_session_want_write(session_) || outbound_frames_.length() > 0;
+  }
   // Propagate network connection watermark events to each stream on the connection.
   void onUnderlyingConnectionAboveWriteBufferHighWatermark() override {
     for (auto& stream : active_streams_) {
@@ -383,7 +385,16 @@ protected:
    */
   struct ServerStreamImpl : public StreamImpl, public ResponseEncoder {
     ServerStreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
-        : StreamImpl(parent, buffer_limit), headers_or_trailers_(RequestHeaderMapImpl::create()) {}
+        : StreamImpl(parent, buffer_limit) {}
+
+    // Sets the decoder of the stream and allocates the request headers, from the arena supplied
+    // by the decoder if there is one.
+    void setRequestDecoder(RequestDecoder& request_decoder) {
+      request_decoder_ = &request_decoder;
+      header_map_arena_ = request_decoder.headerMapArena();
+      headers_or_trailers_.emplace<RequestHeaderMapPtr>(
+          RequestHeaderMapImpl::create(header_map_arena_));
+    }
 
     // StreamImpl
     void destroy() override;
@@ -403,7 +414,8 @@ protected:
       }
     }
     void allocTrailers() override {
-      headers_or_trailers_.emplace<RequestTrailerMapPtr>(RequestTrailerMapImpl::create());
+      headers_or_trailers_.emplace<RequestTrailerMapPtr>(
+          RequestTrailerMapImpl::create(header_map_arena_));
     }
     HeaderMapPtr cloneTrailers(const HeaderMap& trailers) override {
       return createHeaderMap<ResponseTrailerMapImpl>(trailers);
@@ -421,6 +433,7 @@ protected:
     void dumpState(std::ostream& os, int indent_level) const override;
 
     RequestDecoder* request_decoder_{};
+    HeaderMapArenaSharedPtr header_map_arena_;
     absl::variant<RequestHeaderMapPtr, RequestTrailerMapPtr> headers_or_trailers_;
 
     bool streamErrorOnInvalidHttpMessage() const override {
@@ -525,6 +538,13 @@ protected:
   // nghttp2 library will keep calling this callback to write the rest of the frame.
   ssize_t onSend(const uint8_t* data, size_t length);
 
+  // Frames serialized by a single nghttp2_session_send() call are gathered here and handed to the
+  // connection with one write once the call returns. This must be declared after
+  // protocol_constraints_, since the frames hold releasors that reference it.
+  Buffer::OwnedImpl outbound_frames_;
+  const bool coalesce_outbound_frames_;
+  const uint32_t max_outbound_data_frame_size_;
+
   const bool skip_dispatching_frames_for_closed_connection_;
 
   // dumpState helper method.
@@ -555,6 +575,10 @@ private:
 
   // Adds buffer fragment for a new outbound frame to the supplied Buffer::OwnedImpl.
   void addOutboundFrameFragment(Buffer::OwnedImpl& output, const uint8_t* data, size_t length);
+  // Writes serialized frames to the connection, or queues them for a single write at the end of
+  // the current nghttp2_session_send() call when outbound frames are coalesced.
+  void writeOutboundFrames(Buffer::OwnedImpl& output);
+  void flushOutboundFrames();
   virtual ProtocolConstraints::ReleasorProc
   trackOutboundFrames(bool is_outbound_flood_monitored_control_frame) PURE;
   virtual Status trackInboundFrames(const nghttp2_frame_hd* hd, uint32_t padding_length) PURE;
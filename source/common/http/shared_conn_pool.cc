@@ -0,0 +1,488 @@
+#include "source/common/http/shared_conn_pool.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/dump_state_utils.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+MetadataMapVector copyMetadataMapVector(const MetadataMapVector& metadata_map_vector) {
+  MetadataMapVector copy;
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy.push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  return copy;
+}
+
+} // namespace
+
+bool WorkerMailbox::post(Event::PostCb callback) {
+  Thread::LockGuard lock(mutex_);
+  if (closed_) {
+    return false;
+  }
+  dispatcher_.post(std::move(callback));
+  return true;
+}
+
+void WorkerMailbox::close() {
+  Thread::LockGuard lock(mutex_);
+  closed_ = true;
+}
+
+SharedPoolLocalStream::SharedPoolLocalStream(SharedConnPoolProxy& parent,
+                                             ResponseDecoder& response_decoder,
+                                             ConnectionPool::Callbacks& callbacks)
+    : parent_(parent), response_decoder_(response_decoder), callbacks_(callbacks),
+      link_(std::make_shared<SharedPoolStreamLink>()) {
+  link_->local_ = this;
+}
+
+SharedPoolLocalStream::~SharedPoolLocalStream() { ASSERT(done_); }
+
+void SharedPoolLocalStream::postToHome(std::function<void(SharedPoolHomeStream&)> callback) {
+  parent_.homeMailbox()->post([link = link_, callback = std::move(callback)]() {
+    if (link->home_ != nullptr) {
+      callback(*link->home_);
+    }
+  });
+}
+
+void SharedPoolLocalStream::onPoolDestroyed() {
+  postToHome([](SharedPoolHomeStream& home) { home.abandon(); });
+  if (ready_) {
+    runResetCallbacks(StreamResetReason::ConnectionTermination);
+  } else {
+    callbacks_.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                             "shared connection pool destroyed", parent_.host());
+  }
+  done();
+}
+
+void SharedPoolLocalStream::onPoolReady(const SharedPoolReadyInfo& info) {
+  ASSERT(!ready_);
+  ready_ = true;
+  buffer_limit_ = info.buffer_limit_;
+  auto connection_info = std::make_shared<Network::ConnectionInfoSetterImpl>(
+      info.local_address_, info.remote_address_);
+  if (info.connection_id_.has_value()) {
+    connection_info->setConnectionID(info.connection_id_.value());
+  }
+  connection_info_ = connection_info;
+  // The upstream connection's own stream info lives on the worker which owns the pool, so hand
+  // out a snapshot of its addresses instead.
+  stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(parent_.dispatcher().timeSource(),
+                                                              connection_info_);
+  callbacks_.onPoolReady(*this, info.host_, *stream_info_, info.protocol_);
+}
+
+void SharedPoolLocalStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                          absl::string_view transport_failure_reason,
+                                          Upstream::HostDescriptionConstSharedPtr host) {
+  ASSERT(!ready_);
+  callbacks_.onPoolFailure(reason, transport_failure_reason, std::move(host));
+  done();
+}
+
+void SharedPoolLocalStream::on1xxHeaders(ResponseHeaderMapPtr&& headers) {
+  response_decoder_.decode100ContinueHeaders(std::move(headers));
+}
+
+void SharedPoolLocalStream::onHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) {
+  response_decoder_.decodeHeaders(std::move(headers), end_stream);
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void SharedPoolLocalStream::onData(Buffer::Instance& data, bool end_stream) {
+  response_decoder_.decodeData(data, end_stream);
+  if (end_stream) {
+    onRemoteComplete();
+  }
+}
+
+void SharedPoolLocalStream::onTrailers(ResponseTrailerMapPtr&& trailers) {
+  response_decoder_.decodeTrailers(std::move(trailers));
+  onRemoteComplete();
+}
+
+void SharedPoolLocalStream::onMetadata(MetadataMapPtr&& metadata_map) {
+  response_decoder_.decodeMetadata(std::move(metadata_map));
+}
+
+void SharedPoolLocalStream::onReset(StreamResetReason reason) {
+  runResetCallbacks(reason);
+  done();
+}
+
+void SharedPoolLocalStream::onRemoteComplete() {
+  remote_complete_ = true;
+  // If the request is still being sent, the owning worker resets the stream and relays that.
+  if (local_end_stream_ && !done_) {
+    done();
+  }
+}
+
+void SharedPoolLocalStream::cancel(Envoy::ConnectionPool::CancelPolicy) {
+  ASSERT(!ready_);
+  postToHome([](SharedPoolHomeStream& home) { home.abandon(); });
+  done();
+}
+
+Status SharedPoolLocalStream::encodeHeaders(const RequestHeaderMap& headers, bool end_stream) {
+  local_end_stream_ = end_stream;
+  // Copy the headers, as they may be backed by memory which is local to this worker.
+  std::shared_ptr<RequestHeaderMap> copy = createHeaderMap<RequestHeaderMapImpl>(headers);
+  postToHome([copy, end_stream](SharedPoolHomeStream& home) {
+    home.encodeHeaders(*copy, end_stream);
+  });
+  if (end_stream && remote_complete_) {
+    done();
+  }
+  return okStatus();
+}
+
+void SharedPoolLocalStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  local_end_stream_ = end_stream;
+  // Copy rather than move the slices, since they may be charged to a memory account of this
+  // worker.
+  auto copy = std::make_shared<Buffer::OwnedImpl>();
+  copy->add(data);
+  data.drain(data.length());
+  postToHome([copy, end_stream](SharedPoolHomeStream& home) {
+    home.encodeData(*copy, end_stream);
+  });
+  if (end_stream && remote_complete_) {
+    done();
+  }
+}
+
+void SharedPoolLocalStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  local_end_stream_ = true;
+  std::shared_ptr<RequestTrailerMap> copy = createHeaderMap<RequestTrailerMapImpl>(trailers);
+  postToHome([copy](SharedPoolHomeStream& home) { home.encodeTrailers(*copy); });
+  if (remote_complete_) {
+    done();
+  }
+}
+
+void SharedPoolLocalStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  auto copy = std::make_shared<MetadataMapVector>(copyMetadataMapVector(metadata_map_vector));
+  postToHome([copy](SharedPoolHomeStream& home) { home.encodeMetadata(*copy); });
+}
+
+void SharedPoolLocalStream::enableTcpTunneling() {
+  postToHome([](SharedPoolHomeStream& home) { home.enableTcpTunneling(); });
+}
+
+void SharedPoolLocalStream::resetStream(StreamResetReason reason) {
+  postToHome([](SharedPoolHomeStream& home) { home.abandon(); });
+  runResetCallbacks(reason);
+  done();
+}
+
+void SharedPoolLocalStream::readDisable(bool disable) {
+  postToHome([disable](SharedPoolHomeStream& home) { home.readDisable(disable); });
+}
+
+void SharedPoolLocalStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  postToHome([timeout](SharedPoolHomeStream& home) { home.setFlushTimeout(timeout); });
+}
+
+void SharedPoolLocalStream::done() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  link_->local_ = nullptr;
+  parent_.onStreamDone(*this);
+}
+
+void SharedPoolHomeStream::start(const SharedConnPoolLookup& lookup,
+                                 SharedPoolStreamLinkSharedPtr link,
+                                 WorkerMailboxSharedPtr home_mailbox,
+                                 WorkerMailboxSharedPtr local_mailbox) {
+  ConnectionPool::Instance* pool = lookup();
+  if (pool == nullptr) {
+    local_mailbox->post([link]() {
+      if (link->local_ != nullptr) {
+        link->local_->onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                    "no shared connection pool", nullptr);
+      }
+    });
+    return;
+  }
+
+  auto* stream =
+      new SharedPoolHomeStream(std::move(link), std::move(home_mailbox), std::move(local_mailbox));
+  ConnectionPool::Cancellable* handle = pool->newStream(*stream, *stream);
+  if (handle != nullptr) {
+    stream->handle_ = handle;
+  }
+}
+
+SharedPoolHomeStream::SharedPoolHomeStream(SharedPoolStreamLinkSharedPtr link,
+                                           WorkerMailboxSharedPtr home_mailbox,
+                                           WorkerMailboxSharedPtr local_mailbox)
+    : link_(std::move(link)), home_mailbox_(std::move(home_mailbox)),
+      local_mailbox_(std::move(local_mailbox)) {
+  link_->home_ = this;
+}
+
+SharedPoolHomeStream::~SharedPoolHomeStream() { ASSERT(done_); }
+
+void SharedPoolHomeStream::postToLocal(std::function<void(SharedPoolLocalStream&)> callback) {
+  local_mailbox_->post([link = link_, callback = std::move(callback)]() {
+    if (link->local_ != nullptr) {
+      callback(*link->local_);
+    }
+  });
+}
+
+void SharedPoolHomeStream::encodeHeaders(const RequestHeaderMap& headers, bool end_stream) {
+  ASSERT(request_encoder_ != nullptr);
+  const Status status = request_encoder_->encodeHeaders(headers, end_stream);
+  if (!status.ok()) {
+    ENVOY_LOG(debug, "failed to encode relayed request headers: {}", status.message());
+    request_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+    return;
+  }
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void SharedPoolHomeStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->encodeData(data, end_stream);
+  if (end_stream) {
+    onLocalComplete();
+  }
+}
+
+void SharedPoolHomeStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->encodeTrailers(trailers);
+  onLocalComplete();
+}
+
+void SharedPoolHomeStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->encodeMetadata(metadata_map_vector);
+}
+
+void SharedPoolHomeStream::enableTcpTunneling() {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->enableTcpTunneling();
+}
+
+void SharedPoolHomeStream::readDisable(bool disable) {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->getStream().readDisable(disable);
+}
+
+void SharedPoolHomeStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  ASSERT(request_encoder_ != nullptr);
+  request_encoder_->getStream().setFlushTimeout(timeout);
+}
+
+void SharedPoolHomeStream::abandon() {
+  if (handle_ != nullptr) {
+    handle_->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+    handle_ = nullptr;
+  } else if (request_encoder_ != nullptr) {
+    Stream& stream = request_encoder_->getStream();
+    stream.removeCallbacks(*this);
+    request_encoder_ = nullptr;
+    stream.resetStream(StreamResetReason::LocalReset);
+  }
+  done();
+}
+
+void SharedPoolHomeStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                         absl::string_view transport_failure_reason,
+                                         Upstream::HostDescriptionConstSharedPtr host) {
+  handle_ = nullptr;
+  postToLocal([reason, details = std::string(transport_failure_reason),
+               host = std::move(host)](SharedPoolLocalStream& local) {
+    local.onPoolFailure(reason, details, host);
+  });
+  done();
+}
+
+void SharedPoolHomeStream::onPoolReady(RequestEncoder& encoder,
+                                       Upstream::HostDescriptionConstSharedPtr host,
+                                       const StreamInfo::StreamInfo& info,
+                                       absl::optional<Protocol> protocol) {
+  handle_ = nullptr;
+  request_encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+
+  SharedPoolReadyInfo ready_info;
+  ready_info.host_ = std::move(host);
+  ready_info.local_address_ = info.downstreamAddressProvider().localAddress();
+  ready_info.remote_address_ = info.downstreamAddressProvider().remoteAddress();
+  ready_info.connection_id_ = info.downstreamAddressProvider().connectionID();
+  ready_info.protocol_ = protocol;
+  ready_info.buffer_limit_ = encoder.getStream().bufferLimit();
+  postToLocal([ready_info](SharedPoolLocalStream& local) { local.onPoolReady(ready_info); });
+}
+
+void SharedPoolHomeStream::decode100ContinueHeaders(ResponseHeaderMapPtr&& headers) {
+  // Post callbacks have to be copyable, so the header map is held through a shared pointer until
+  // its ownership is handed to the decoder on the other side.
+  auto moved = std::make_shared<ResponseHeaderMapPtr>(std::move(headers));
+  postToLocal([moved](SharedPoolLocalStream& local) { local.on1xxHeaders(std::move(*moved)); });
+}
+
+void SharedPoolHomeStream::decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) {
+  auto moved = std::make_shared<ResponseHeaderMapPtr>(std::move(headers));
+  postToLocal([moved, end_stream](SharedPoolLocalStream& local) {
+    local.onHeaders(std::move(*moved), end_stream);
+  });
+  if (end_stream) {
+    remote_complete_ = true;
+    if (local_complete_) {
+      done();
+    }
+  }
+}
+
+void SharedPoolHomeStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  // The response data is not charged to any account, so its slices can be moved to the worker
+  // which created the stream.
+  auto moved = std::make_shared<Buffer::OwnedImpl>();
+  moved->move(data);
+  postToLocal([moved, end_stream](SharedPoolLocalStream& local) {
+    local.onData(*moved, end_stream);
+  });
+  if (end_stream) {
+    remote_complete_ = true;
+    if (local_complete_) {
+      done();
+    }
+  }
+}
+
+void SharedPoolHomeStream::decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  auto moved = std::make_shared<ResponseTrailerMapPtr>(std::move(trailers));
+  postToLocal([moved](SharedPoolLocalStream& local) { local.onTrailers(std::move(*moved)); });
+  remote_complete_ = true;
+  if (local_complete_) {
+    done();
+  }
+}
+
+void SharedPoolHomeStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  auto moved = std::make_shared<MetadataMapPtr>(std::move(metadata_map));
+  postToLocal([moved](SharedPoolLocalStream& local) { local.onMetadata(std::move(*moved)); });
+}
+
+void SharedPoolHomeStream::dumpState(std::ostream& os, int indent_level) const {
+  const char* spaces = spacesForLevel(indent_level);
+  os << spaces << "SharedPoolHomeStream " << this << DUMP_MEMBER(local_complete_)
+     << DUMP_MEMBER(remote_complete_) << DUMP_MEMBER(done_) << "\n";
+}
+
+void SharedPoolHomeStream::onResetStream(StreamResetReason reason, absl::string_view) {
+  request_encoder_ = nullptr;
+  postToLocal([reason](SharedPoolLocalStream& local) { local.onReset(reason); });
+  done();
+}
+
+void SharedPoolHomeStream::onAboveWriteBufferHighWatermark() {
+  postToLocal([](SharedPoolLocalStream& local) { local.runHighWatermarkCallbacks(); });
+}
+
+void SharedPoolHomeStream::onBelowWriteBufferLowWatermark() {
+  postToLocal([](SharedPoolLocalStream& local) { local.runLowWatermarkCallbacks(); });
+}
+
+void SharedPoolHomeStream::onLocalComplete() {
+  local_complete_ = true;
+  if (remote_complete_) {
+    done();
+  }
+}
+
+void SharedPoolHomeStream::done() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  link_->home_ = nullptr;
+  if (request_encoder_ != nullptr) {
+    request_encoder_->getStream().removeCallbacks(*this);
+    request_encoder_ = nullptr;
+  }
+  home_mailbox_->dispatcher().deferredDelete(Event::DeferredDeletablePtr{this});
+}
+
+SharedConnPoolProxy::SharedConnPoolProxy(Event::Dispatcher& dispatcher,
+                                         WorkerMailboxSharedPtr local_mailbox,
+                                         WorkerMailboxSharedPtr home_mailbox,
+                                         Upstream::HostConstSharedPtr host,
+                                         SharedConnPoolLookup lookup)
+    : dispatcher_(dispatcher), local_mailbox_(std::move(local_mailbox)),
+      home_mailbox_(std::move(home_mailbox)), host_(std::move(host)), lookup_(std::move(lookup)) {}
+
+SharedConnPoolProxy::~SharedConnPoolProxy() {
+  while (!streams_.empty()) {
+    streams_.front()->onPoolDestroyed();
+  }
+  dispatcher_.clearDeferredDeleteList();
+}
+
+ConnectionPool::Cancellable* SharedConnPoolProxy::newStream(ResponseDecoder& response_decoder,
+                                                            ConnectionPool::Callbacks& callbacks) {
+  ASSERT(!is_draining_for_deletion_);
+  auto stream = std::make_unique<SharedPoolLocalStream>(*this, response_decoder, callbacks);
+  SharedPoolLocalStream& local = *stream;
+  LinkedList::moveIntoList(std::move(stream), streams_);
+  Event::PostCb start = [lookup = lookup_, link = local.link(), home = home_mailbox_,
+                         local = local_mailbox_]() {
+    SharedPoolHomeStream::start(lookup, link, home, local);
+  };
+  if (!home_mailbox_->post(std::move(start))) {
+    // The worker which owns the pool has stopped, so the stream would never hear back from it.
+    local.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                        "shared connection pool stopped", host_);
+    return nullptr;
+  }
+  return &local;
+}
+
+void SharedConnPoolProxy::drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) {
+  // The connections themselves are drained by the owning worker, which sees the same host and
+  // cluster events as this one.
+  if (drain_behavior == Envoy::ConnectionPool::DrainBehavior::DrainAndDelete) {
+    is_draining_for_deletion_ = true;
+    checkForIdle();
+  }
+}
+
+void SharedConnPoolProxy::onStreamDone(SharedPoolLocalStream& stream) {
+  dispatcher_.deferredDelete(stream.removeFromList(streams_));
+  checkForIdle();
+}
+
+void SharedConnPoolProxy::checkForIdle() {
+  if (isIdle()) {
+    ENVOY_LOG(debug, "invoking idle callbacks - is_draining_for_deletion_={}",
+              is_draining_for_deletion_);
+    for (const IdleCb& cb : idle_callbacks_) {
+      cb();
+    }
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/network/address.h"
+#include "envoy/stream_info/stream_info.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+#include "source/common/common/thread.h"
+#include "source/common/http/codec_helper.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * Posts callbacks to a worker's dispatcher for as long as the worker is running. Other workers
+ * may hold on to a mailbox without tracking the lifetime of the worker: once the worker has
+ * stopped, callbacks posted to it are dropped.
+ */
+class WorkerMailbox {
+public:
+  explicit WorkerMailbox(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  /**
+   * Posts a callback to the worker's dispatcher. May be called from any thread.
+   * @return whether the callback was posted, which it is not once the worker has stopped.
+   */
+  bool post(Event::PostCb callback);
+
+  /**
+   * Stops delivering callbacks. Called on the worker's thread before its dispatcher goes away.
+   */
+  void close();
+
+  /**
+   * @return the worker's dispatcher. Only to be used on the worker's thread.
+   */
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  Thread::MutexBasicLockable mutex_;
+  bool closed_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using WorkerMailboxSharedPtr = std::shared_ptr<WorkerMailbox>;
+
+/**
+ * Returns the pool which carries the shared connections to a host, or nullptr if the host can no
+ * longer be served. Only called on the worker which owns the pool.
+ */
+using SharedConnPoolLookup = std::function<ConnectionPool::Instance*()>;
+
+class SharedConnPoolProxy;
+class SharedPoolLocalStream;
+class SharedPoolHomeStream;
+
+/**
+ * Links the two halves of a relayed stream. Each pointer is only read and written on the thread
+ * of the worker which owns the object it points to, and is cleared once that object is done, so
+ * callbacks posted to a worker can tell whether their half of the stream is still around.
+ */
+struct SharedPoolStreamLink {
+  SharedPoolLocalStream* local_{};
+  SharedPoolHomeStream* home_{};
+};
+
+using SharedPoolStreamLinkSharedPtr = std::shared_ptr<SharedPoolStreamLink>;
+
+/**
+ * What the worker which created a stream needs to know about the upstream connection the stream
+ * was assigned to.
+ */
+struct SharedPoolReadyInfo {
+  Upstream::HostDescriptionConstSharedPtr host_;
+  Network::Address::InstanceConstSharedPtr local_address_;
+  Network::Address::InstanceConstSharedPtr remote_address_;
+  absl::optional<uint64_t> connection_id_;
+  absl::optional<Protocol> protocol_;
+  uint32_t buffer_limit_{};
+};
+
+/**
+ * The half of a relayed stream which lives on the worker which created it. It stands in for the
+ * upstream stream, forwarding encoder calls to the owning worker and replaying the response
+ * events relayed back from it.
+ */
+class SharedPoolLocalStream : public LinkedObject<SharedPoolLocalStream>,
+                              public Event::DeferredDeletable,
+                              public ConnectionPool::Cancellable,
+                              public RequestEncoder,
+                              public Stream,
+                              public StreamCallbackHelper,
+                              Logger::Loggable<Logger::Id::pool> {
+public:
+  SharedPoolLocalStream(SharedConnPoolProxy& parent, ResponseDecoder& response_decoder,
+                        ConnectionPool::Callbacks& callbacks);
+  ~SharedPoolLocalStream() override;
+
+  const SharedPoolStreamLinkSharedPtr& link() const { return link_; }
+
+  // Fails the stream or resets it, as appropriate, when the pool goes away underneath it.
+  void onPoolDestroyed();
+
+  // Events relayed from the worker which owns the shared pool.
+  void onPoolReady(const SharedPoolReadyInfo& info);
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host);
+  void on1xxHeaders(ResponseHeaderMapPtr&& headers);
+  void onHeaders(ResponseHeaderMapPtr&& headers, bool end_stream);
+  void onData(Buffer::Instance& data, bool end_stream);
+  void onTrailers(ResponseTrailerMapPtr&& trailers);
+  void onMetadata(MetadataMapPtr&& metadata_map);
+  void onReset(StreamResetReason reason);
+
+  // ConnectionPool::Cancellable
+  void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) override;
+
+  // Http::RequestEncoder
+  Status encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
+  void encodeTrailers(const RequestTrailerMap& trailers) override;
+  void enableTcpTunneling() override;
+
+  // Http::StreamEncoder
+  void encodeData(Buffer::Instance& data, bool end_stream) override;
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+  Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+
+  // Http::Stream
+  void addCallbacks(StreamCallbacks& callbacks) override { addCallbacksHelper(callbacks); }
+  void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
+  void resetStream(StreamResetReason reason) override;
+  void readDisable(bool disable) override;
+  uint32_t bufferLimit() override { return buffer_limit_; }
+  const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
+    return connection_info_->localAddress();
+  }
+  void setFlushTimeout(std::chrono::milliseconds timeout) override;
+  // Buffers are handed over to the owning worker, which does not charge them to accounts created
+  // on other workers.
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {}
+  const StreamInfo::BytesMeterSharedPtr& bytesMeter() override { return bytes_meter_; }
+
+private:
+  void postToHome(std::function<void(SharedPoolHomeStream&)> callback);
+  void onRemoteComplete();
+  void done();
+
+  SharedConnPoolProxy& parent_;
+  ResponseDecoder& response_decoder_;
+  ConnectionPool::Callbacks& callbacks_;
+  const SharedPoolStreamLinkSharedPtr link_;
+  Network::ConnectionInfoProviderSharedPtr connection_info_;
+  std::unique_ptr<StreamInfo::StreamInfo> stream_info_;
+  StreamInfo::BytesMeterSharedPtr bytes_meter_{std::make_shared<StreamInfo::BytesMeter>()};
+  uint32_t buffer_limit_{};
+  bool ready_{};
+  bool remote_complete_{};
+  bool done_{};
+};
+
+using SharedPoolLocalStreamPtr = std::unique_ptr<SharedPoolLocalStream>;
+
+/**
+ * The half of a relayed stream which lives on the worker which owns the shared pool. It is the
+ * client of a real stream on the shared pool, relaying the pool and response events to the
+ * worker which created the stream. It owns itself and is deferred deleted once the stream is done.
+ */
+class SharedPoolHomeStream : public Event::DeferredDeletable,
+                             public ConnectionPool::Callbacks,
+                             public ResponseDecoder,
+                             public StreamCallbacks,
+                             Logger::Loggable<Logger::Id::pool> {
+public:
+  /**
+   * Creates the home half of a stream and starts it on the shared pool. Runs on the worker which
+   * owns the pool.
+   */
+  static void start(const SharedConnPoolLookup& lookup, SharedPoolStreamLinkSharedPtr link,
+                    WorkerMailboxSharedPtr home_mailbox, WorkerMailboxSharedPtr local_mailbox);
+
+  ~SharedPoolHomeStream() override;
+
+  // Requests relayed from the worker which created the stream.
+  void encodeHeaders(const RequestHeaderMap& headers, bool end_stream);
+  void encodeData(Buffer::Instance& data, bool end_stream);
+  void encodeTrailers(const RequestTrailerMap& trailers);
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+  void enableTcpTunneling();
+  void readDisable(bool disable);
+  void setFlushTimeout(std::chrono::milliseconds timeout);
+  // Cancels the stream if it is still waiting for a connection and resets it otherwise.
+  void abandon();
+
+  // Http::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                   const StreamInfo::StreamInfo& info, absl::optional<Protocol> protocol) override;
+
+  // Http::StreamDecoder
+  void decodeData(Buffer::Instance& data, bool end_stream) override;
+  void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+  // Http::ResponseDecoder
+  void decode100ContinueHeaders(ResponseHeaderMapPtr&& headers) override;
+  void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) override;
+  void decodeTrailers(ResponseTrailerMapPtr&& trailers) override;
+  void dumpState(std::ostream& os, int indent_level) const override;
+
+  // Http::StreamCallbacks
+  void onResetStream(StreamResetReason reason,
+                     absl::string_view transport_failure_reason) override;
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
+private:
+  SharedPoolHomeStream(SharedPoolStreamLinkSharedPtr link, WorkerMailboxSharedPtr home_mailbox,
+                       WorkerMailboxSharedPtr local_mailbox);
+
+  void postToLocal(std::function<void(SharedPoolLocalStream&)> callback);
+  void onLocalComplete();
+  void done();
+
+  const SharedPoolStreamLinkSharedPtr link_;
+  const WorkerMailboxSharedPtr home_mailbox_;
+  const WorkerMailboxSharedPtr local_mailbox_;
+  ConnectionPool::Cancellable* handle_{};
+  RequestEncoder* request_encoder_{};
+  bool local_complete_{};
+  bool remote_complete_{};
+  bool done_{};
+};
+
+/**
+ * A connection pool for a host whose connections are owned by the pool of another worker. Each
+ * stream is created on that pool, and its events are relayed between the two workers, so that
+ * all workers share the same connections to the host.
+ */
+class SharedConnPoolProxy : public ConnectionPool::Instance, Logger::Loggable<Logger::Id::pool> {
+public:
+  SharedConnPoolProxy(Event::Dispatcher& dispatcher, WorkerMailboxSharedPtr local_mailbox,
+                      WorkerMailboxSharedPtr home_mailbox, Upstream::HostConstSharedPtr host,
+                      SharedConnPoolLookup lookup);
+  ~SharedConnPoolProxy() override;
+
+  // Http::ConnectionPool::Instance
+  bool hasActiveConnections() const override { return !streams_.empty(); }
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override;
+  absl::string_view protocolDescription() const override { return "HTTP/2 (shared)"; }
+
+  // Envoy::ConnectionPool::Instance
+  void addIdleCallback(IdleCb cb) override { idle_callbacks_.push_back(cb); }
+  bool isIdle() const override { return streams_.empty(); }
+  void drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) override;
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  // Preconnecting is up to the pool which owns the connections.
+  bool maybePreconnect(float) override { return false; }
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+  const WorkerMailboxSharedPtr& homeMailbox() const { return home_mailbox_; }
+  void onStreamDone(SharedPoolLocalStream& stream);
+
+private:
+  void checkForIdle();
+
+  Event::Dispatcher& dispatcher_;
+  const WorkerMailboxSharedPtr local_mailbox_;
+  const WorkerMailboxSharedPtr home_mailbox_;
+  const Upstream::HostConstSharedPtr host_;
+  const SharedConnPoolLookup lookup_;
+  std::list<SharedPoolLocalStreamPtr> streams_;
+  std::list<IdleCb> idle_callbacks_;
+  bool is_draining_for_deletion_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,63 @@
+#include "source/common/http/timing_breakdown_stats.h"
+
+#include <chrono>
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+void recordDuration(Stats::Histogram& histogram, std::chrono::nanoseconds duration) {
+  if (duration.count() > 0) {
+    histogram.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  }
+}
+
+} // namespace
+
+TimingBreakdownStats::TimingBreakdownStats(const std::vector<std::string>& filter_names,
+                                           const std::string& prefix, Stats::Scope& scope)
+    : named_{TIMING_BREAKDOWN_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))} {
+  for (const std::string& name : filter_names) {
+    if (filters_.contains(name)) {
+      continue;
+    }
+    auto histogram = [&](absl::string_view suffix) -> Stats::Histogram& {
+      return scope.histogramFromString(absl::StrCat(prefix, "filter.", name, suffix),
+                                       Stats::Histogram::Unit::Microseconds);
+    };
+    filters_.emplace(name, FilterStats{histogram(".decode_time"), histogram(".encode_time")});
+  }
+}
+
+void TimingBreakdownStats::record(const StreamInfo::StreamInfo& stream_info) {
+  const StreamInfo::TimingBreakdown* timing_breakdown = stream_info.timingBreakdown();
+  if (timing_breakdown == nullptr) {
+    return;
+  }
+
+  recordDuration(named_.codec_encode_time_, timing_breakdown->codec_encode_);
+  recordDuration(named_.conn_pool_wait_time_, timing_breakdown->connection_pool_wait_);
+  recordDuration(named_.host_selection_time_, timing_breakdown->host_selection_);
+  recordDuration(named_.route_selection_time_, timing_breakdown->route_selection_);
+  const absl::optional<std::chrono::nanoseconds> first_upstream_rx_byte =
+      stream_info.firstUpstreamRxByteReceived();
+  if (first_upstream_rx_byte.has_value()) {
+    recordDuration(named_.first_upstream_rx_byte_time_, first_upstream_rx_byte.value());
+  }
+
+  for (const StreamInfo::TimingBreakdown::FilterTiming& filter : timing_breakdown->filters_) {
+    // Filters added outside of the filter configs of the connection manager are not recorded.
+    auto it = filters_.find(filter.name_);
+    if (it == filters_.end()) {
+      continue;
+    }
+    recordDuration(it->second.decode_time_, filter.decode_);
+    recordDuration(it->second.encode_time_, filter.encode_);
+  }
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/stream_info/stream_info.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * All timing breakdown stats. @see stats_macros.h
+ */
+#define TIMING_BREAKDOWN_STATS(HISTOGRAM)                                                          \
+  HISTOGRAM(codec_encode_time, Microseconds)                                                       \
+  HISTOGRAM(conn_pool_wait_time, Microseconds)                                                     \
+  HISTOGRAM(first_upstream_rx_byte_time, Microseconds)                                             \
+  HISTOGRAM(host_selection_time, Microseconds)                                                     \
+  HISTOGRAM(route_selection_time, Microseconds)
+
+/**
+ * Struct definition for all timing breakdown stats. @see stats_macros.h
+ */
+struct TimingBreakdownNamedStats {
+  TIMING_BREAKDOWN_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * The histograms of the timing breakdowns of the streams of a connection manager. The histograms
+ * of the filters are created up front, for the filter configs of the connection manager, so that
+ * recording a stream never creates stats. A timing point which a stream never reaches is not
+ * recorded.
+ */
+class TimingBreakdownStats {
+public:
+  /**
+   * @param filter_names supplies the names of the filter configs of the connection manager.
+   * @param prefix supplies the prefix of the stats.
+   * @param scope supplies the scope of the stats.
+   */
+  TimingBreakdownStats(const std::vector<std::string>& filter_names, const std::string& prefix,
+                       Stats::Scope& scope);
+
+  /**
+   * Records the timing breakdown of a completed stream, if it has one.
+   */
+  void record(const StreamInfo::StreamInfo& stream_info);
+
+private:
+  struct FilterStats {
+    Stats::Histogram& decode_time_;
+    Stats::Histogram& encode_time_;
+  };
+
+  TimingBreakdownNamedStats named_;
+  absl::flat_hash_map<std::string, FilterStats> filters_;
+};
+
+using TimingBreakdownStatsPtr = std::unique_ptr<TimingBreakdownStats>;
+
+} // namespace Http
+} // namespace Envoy
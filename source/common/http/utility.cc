@@ -117,6 +117,9 @@ const uint32_t OptionsLimits::MAX_INITIAL_STREAM_WINDOW_SIZE;
 const uint32_t OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE;
 const uint32_t OptionsLimits::DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE;
 const uint32_t OptionsLimits::MAX_INITIAL_CONNECTION_WINDOW_SIZE;
+const uint32_t OptionsLimits::MIN_MAX_DATA_FRAME_SIZE;
+const uint32_t OptionsLimits::DEFAULT_MAX_DATA_FRAME_SIZE;
+const uint32_t OptionsLimits::MAX_MAX_DATA_FRAME_SIZE;
 const uint32_t OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES;
 const uint32_t OptionsLimits::DEFAULT_MAX_OUTBOUND_CONTROL_FRAMES;
 const uint32_t OptionsLimits::DEFAULT_MAX_CONSECUTIVE_INBOUND_FRAMES_WITH_EMPTY_PAYLOAD;
@@ -173,6 +176,11 @@ initializeAndValidateOptions(const envoy::config::core::v3::Http2ProtocolOptions
              OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE &&
          options_clone.initial_connection_window_size().value() <=
              OptionsLimits::MAX_INITIAL_CONNECTION_WINDOW_SIZE);
+  ASSERT(!options_clone.has_max_outbound_data_frame_size() ||
+         (options_clone.max_outbound_data_frame_size().value() >=
+              OptionsLimits::MIN_MAX_DATA_FRAME_SIZE &&
+          options_clone.max_outbound_data_frame_size().value() <=
+              OptionsLimits::MAX_MAX_DATA_FRAME_SIZE));
   if (!options_clone.has_max_outbound_frames()) {
     options_clone.mutable_max_outbound_frames()->set_value(
         OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES);
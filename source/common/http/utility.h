@@ -91,6 +91,13 @@ struct OptionsLimits {
   static const uint32_t DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE = 256 * 1024 * 1024;
   static const uint32_t MAX_INITIAL_CONNECTION_WINDOW_SIZE = (1U << 31) - 1;
 
+  // initial value of SETTINGS_MAX_FRAME_SIZE from HTTP/2 spec, same as NGHTTP2_DATA_PAYLOADLEN
+  // from nghttp2
+  static const uint32_t MIN_MAX_DATA_FRAME_SIZE = (1 << 14);
+  static const uint32_t DEFAULT_MAX_DATA_FRAME_SIZE = (1 << 14);
+  // maximum from HTTP/2 spec, same as NGHTTP2_MAX_FRAME_SIZE_MAX from nghttp2
+  static const uint32_t MAX_MAX_DATA_FRAME_SIZE = (1 << 24) - 1;
+
   // Default limit on the number of outbound frames of all types.
   static const uint32_t DEFAULT_MAX_OUTBOUND_FRAMES = 10000;
   // Default limit on the number of outbound frames of types PING, SETTINGS and RST_STREAM.
@@ -0,0 +1,127 @@
+#include "source/common/json/json_writer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+
+#include "source/common/common/fmt.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Json {
+
+namespace {
+
+// Integral doubles below this magnitude convert to int64_t exactly.
+constexpr double MaxExactInteger = 9007199254740992.0; // 2^53
+
+bool needsEscape(unsigned char c) { return c < 0x20 || c == '"' || c == '\\' || c == 0x7f; }
+
+void appendEscaped(unsigned char c, std::string& output) {
+  switch (c) {
+  case '"':
+    output.append("\\\"");
+    break;
+  case '\\':
+    output.append("\\\\");
+    break;
+  case '\b':
+    output.append("\\b");
+    break;
+  case '\f':
+    output.append("\\f");
+    break;
+  case '\n':
+    output.append("\\n");
+    break;
+  case '\r':
+    output.append("\\r");
+    break;
+  case '\t':
+    output.append("\\t");
+    break;
+  default:
+    fmt::format_to(std::back_inserter(output), "\\u{:04x}", c);
+    break;
+  }
+}
+
+} // namespace
+
+void Writer::appendString(absl::string_view value, std::string& output) {
+  output.reserve(output.size() + value.size() + 2);
+  output.push_back('"');
+  // Append the runs of characters which need no escaping in one go.
+  size_t run_start = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = value[i];
+    if (needsEscape(c)) {
+      output.append(value.data() + run_start, i - run_start);
+      appendEscaped(c, output);
+      run_start = i + 1;
+    }
+  }
+  output.append(value.data() + run_start, value.size() - run_start);
+  output.push_back('"');
+}
+
+void Writer::appendNumber(double value, std::string& output) {
+  if (!std::isfinite(value)) {
+    output.append("null");
+  } else if (std::trunc(value) == value && std::fabs(value) < MaxExactInteger) {
+    absl::StrAppend(&output, static_cast<int64_t>(value));
+  } else {
+    // The shortest representation which reads back as the same double.
+    fmt::format_to(std::back_inserter(output), "{}", value);
+  }
+}
+
+void Writer::appendValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    appendString(value.string_value(), output);
+    break;
+  case ProtobufWkt::Value::kNumberValue:
+    appendNumber(value.number_value(), output);
+    break;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kStructValue: {
+    output.push_back('{');
+    bool first = true;
+    for (const auto& field : value.struct_value().fields()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendString(field.first, output);
+      output.push_back(':');
+      appendValue(field.second, output);
+    }
+    output.push_back('}');
+    break;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendValue(element, output);
+    }
+    output.push_back(']');
+    break;
+  }
+  case ProtobufWkt::Value::kNullValue:
+  case ProtobufWkt::Value::KIND_NOT_SET:
+    output.append("null");
+    break;
+  }
+}
+
+} // namespace Json
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "source/common/protobuf/protobuf.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Json {
+
+/**
+ * Appends JSON text straight to a string, for hot paths which would otherwise build a protobuf or
+ * JSON object only to serialize it.
+ */
+class Writer {
+public:
+  /**
+   * Append a quoted and escaped JSON string.
+   * @param value supplies the string to append.
+   * @param output supplies the string to append to.
+   */
+  static void appendString(absl::string_view value, std::string& output);
+
+  /**
+   * Append a JSON number. Integral values are written without a fraction or exponent. Infinities
+   * and NaN have no JSON representation and are written as null.
+   * @param value supplies the number to append.
+   * @param output supplies the string to append to.
+   */
+  static void appendNumber(double value, std::string& output);
+
+  /**
+   * Append the JSON representation of a protobuf Value, in the same form as the protobuf JSON
+   * printer, apart from the order of struct fields.
+   * @param value supplies the value to append.
+   * @param output supplies the string to append to.
+   */
+  static void appendValue(const ProtobufWkt::Value& value, std::string& output);
+};
+
+} // namespace Json
+} // namespace Envoy
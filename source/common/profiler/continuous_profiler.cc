@@ -0,0 +1,345 @@
+#include "source/common/profiler/continuous_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/empty_string.h"
+#include "source/common/common/macros.h"
+#include "source/common/profiler/profiler.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#endif
+
+namespace Envoy {
+namespace Profiler {
+
+SampleRing::SampleRing(uint32_t capacity)
+    : capacity_(capacity), slots_(std::make_unique<Slot[]>(capacity)) {
+  ASSERT(capacity_ > 0);
+}
+
+void SampleRing::record(MonotonicTime time, int32_t thread_id, void* const* frames, int depth) {
+  const uint64_t position = next_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[position % capacity_];
+  slot.sequence_.store(2 * position + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  depth = std::min<int>(depth, MaxFrames);
+  slot.time_ns_.store(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count(),
+      std::memory_order_relaxed);
+  slot.thread_id_.store(thread_id, std::memory_order_relaxed);
+  slot.depth_.store(depth, std::memory_order_relaxed);
+  for (int i = 0; i < depth; ++i) {
+    slot.frames_[i].store(frames[i], std::memory_order_relaxed);
+  }
+  slot.sequence_.store(2 * position + 2, std::memory_order_release);
+}
+
+std::vector<StackSample> SampleRing::samplesSince(MonotonicTime since) const {
+  std::vector<StackSample> samples;
+  const uint64_t end = next_.load(std::memory_order_acquire);
+  const uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+  for (uint64_t position = begin; position < end; ++position) {
+    const Slot& slot = slots_[position % capacity_];
+    // Skip slots which are still being written, or which were already reused for a later sample.
+    const uint64_t sequence = 2 * position + 2;
+    if (slot.sequence_.load(std::memory_order_acquire) != sequence) {
+      continue;
+    }
+
+    StackSample sample;
+    sample.time_ = MonotonicTime(std::chrono::duration_cast<MonotonicTime::duration>(
+        std::chrono::nanoseconds(slot.time_ns_.load(std::memory_order_relaxed))));
+    sample.thread_id_ = slot.thread_id_.load(std::memory_order_relaxed);
+    const int depth = slot.depth_.load(std::memory_order_relaxed);
+    sample.frames_.reserve(depth);
+    for (int i = 0; i < depth; ++i) {
+      sample.frames_.push_back(slot.frames_[i].load(std::memory_order_relaxed));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence_.load(std::memory_order_relaxed) != sequence || sample.time_ < since) {
+      continue;
+    }
+    samples.push_back(std::move(sample));
+  }
+  return samples;
+}
+
+namespace {
+
+// The samples of the running profiler, which are only replaced on the main thread.
+std::unique_ptr<SampleRing> sample_ring;
+std::chrono::microseconds sampling_period;
+
+#ifdef __linux__
+
+// The ring the signal handler records into, and the number of handlers which may be using it, so
+// that the profiler can wait for them before releasing the ring.
+std::atomic<SampleRing*> active_ring{nullptr};
+std::atomic<uint32_t> running_handlers{0};
+struct sigaction previous_action;
+
+void* interruptedPc(const void* context) {
+  const auto* ucontext = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return reinterpret_cast<void*>(ucontext->uc_mcontext.pc);
+#else
+  UNREFERENCED_PARAMETER(ucontext);
+  return nullptr;
+#endif
+}
+
+void onProfilingSignal(int, siginfo_t*, void* context) {
+  const int saved_errno = errno;
+  running_handlers.fetch_add(1);
+  SampleRing* ring = active_ring.load();
+  if (ring != nullptr) {
+    // Frame pointer unwinding from the handler starts at its return address in the signal
+    // trampoline, and then follows the frames of the interrupted function. The trampoline is
+    // replaced with the program counter of the context, which is the interrupted instruction.
+    void* frames[SampleRing::MaxFrames];
+    int depth = absl::GetStackTraceWithContext(frames, SampleRing::MaxFrames,
+                                               /* skip_count = */ 0, context,
+                                               /* min_dropped_frames = */ nullptr);
+    void* pc = interruptedPc(context);
+    if (pc != nullptr) {
+      frames[0] = pc;
+      depth = std::max(depth, 1);
+    }
+    // This is the clock of MonotonicTime, which is read directly as the handler has no time
+    // source.
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ring->record(MonotonicTime(std::chrono::duration_cast<MonotonicTime::duration>(
+                     std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec))),
+                 static_cast<int32_t>(syscall(SYS_gettid)), frames, depth);
+  }
+  running_handlers.fetch_sub(1);
+  errno = saved_errno;
+}
+
+// Reads a file of procfs, which the filesystem API refuses to read.
+std::string readProcFile(const std::string& path) {
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+bool setTimer(std::chrono::microseconds period) {
+  itimerval timer{};
+  timer.it_interval.tv_sec = period.count() / 1000000;
+  timer.it_interval.tv_usec = period.count() % 1000000;
+  timer.it_value = timer.it_interval;
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+#endif
+
+std::string hexAddress(void* pc) {
+  return absl::StrCat("0x", absl::Hex(reinterpret_cast<uintptr_t>(pc)));
+}
+
+// Symbolizes the most frequent frames of the samples. Each lookup scans the symbol table of the
+// binary, so the number of lookups is bounded.
+absl::flat_hash_map<void*, std::string> symbolizeFrames(const std::vector<StackSample>& samples,
+                                                        uint32_t max_symbolized_frames) {
+  absl::flat_hash_map<void*, uint64_t> counts;
+  for (const StackSample& sample : samples) {
+    for (void* frame : sample.frames_) {
+      ++counts[frame];
+    }
+  }
+  std::vector<std::pair<uint64_t, void*>> frames;
+  frames.reserve(counts.size());
+  for (const auto& [frame, count] : counts) {
+    frames.emplace_back(count, frame);
+  }
+  const size_t symbolized = std::min<size_t>(frames.size(), max_symbolized_frames);
+  std::partial_sort(frames.begin(), frames.begin() + symbolized, frames.end(),
+                    std::greater<std::pair<uint64_t, void*>>());
+
+  absl::flat_hash_map<void*, std::string> symbols;
+  char symbol[1024];
+  for (size_t i = 0; i < symbolized; ++i) {
+    void* pc = frames[i].second;
+    symbols.emplace(pc, absl::Symbolize(pc, symbol, sizeof(symbol)) ? std::string(symbol)
+                                                                     : hexAddress(pc));
+  }
+  return symbols;
+}
+
+} // namespace
+
+#ifdef __linux__
+
+bool ContinuousCpu::profilerSupported() { return true; }
+
+bool ContinuousCpu::startProfiler(uint32_t frequency, uint32_t max_samples) {
+  // The gperftools CPU profiler also samples on SIGPROF.
+  if (sample_ring != nullptr || frequency == 0 || max_samples == 0 || Cpu::profilerEnabled()) {
+    return false;
+  }
+
+  sample_ring = std::make_unique<SampleRing>(max_samples);
+  sampling_period = std::chrono::microseconds(std::max<uint32_t>(1, 1000000 / frequency));
+  active_ring.store(sample_ring.get());
+
+  struct sigaction action {};
+  action.sa_sigaction = onProfilingSignal;
+  action.sa_flags = SA_RESTART | SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+    active_ring.store(nullptr);
+    sample_ring.reset();
+    return false;
+  }
+  if (!setTimer(sampling_period)) {
+    stopProfiler();
+    return false;
+  }
+  return true;
+}
+
+void ContinuousCpu::stopProfiler() {
+  if (sample_ring == nullptr) {
+    return;
+  }
+
+  setTimer(std::chrono::microseconds(0));
+  active_ring.store(nullptr);
+  while (running_handlers.load() != 0) {
+    std::this_thread::yield();
+  }
+  // A signal raised before the timer was disarmed may still be pending, and SIGPROF terminates the
+  // process by default.
+  if ((previous_action.sa_flags & SA_SIGINFO) == 0 && previous_action.sa_handler == SIG_DFL) {
+    previous_action.sa_handler = SIG_IGN;
+  }
+  sigaction(SIGPROF, &previous_action, nullptr);
+  sample_ring.reset();
+}
+
+absl::flat_hash_map<int32_t, std::string>
+ContinuousCpu::threadNames(const std::vector<StackSample>& samples) {
+  absl::flat_hash_set<int32_t> thread_ids;
+  for (const StackSample& sample : samples) {
+    thread_ids.insert(sample.thread_id_);
+  }
+
+  absl::flat_hash_map<int32_t, std::string> names;
+  for (const int32_t thread_id : thread_ids) {
+    std::string name = readProcFile(absl::StrCat("/proc/self/task/", thread_id, "/comm"));
+    absl::StripTrailingAsciiWhitespace(&name);
+    // Nothing is read once the thread has exited.
+    if (!name.empty()) {
+      names.emplace(thread_id, std::move(name));
+    }
+  }
+  return names;
+}
+
+std::string ContinuousCpu::memoryMappings() { return readProcFile("/proc/self/maps"); }
+
+#else
+
+bool ContinuousCpu::profilerSupported() { return false; }
+bool ContinuousCpu::startProfiler(uint32_t, uint32_t) { return false; }
+void ContinuousCpu::stopProfiler() {}
+absl::flat_hash_map<int32_t, std::string>
+ContinuousCpu::threadNames(const std::vector<StackSample>&) {
+  return {};
+}
+std::string ContinuousCpu::memoryMappings() { return EMPTY_STRING; }
+
+#endif
+
+bool ContinuousCpu::isProfilerStarted() { return sample_ring != nullptr; }
+
+std::chrono::microseconds ContinuousCpu::samplingPeriod() { return sampling_period; }
+
+std::vector<StackSample> ContinuousCpu::samplesSince(MonotonicTime since) {
+  if (sample_ring == nullptr) {
+    return {};
+  }
+  return sample_ring->samplesSince(since);
+}
+
+std::string foldStacks(const std::vector<StackSample>& samples,
+                       const absl::flat_hash_map<int32_t, std::string>& thread_names,
+                       uint32_t max_symbolized_frames) {
+  const absl::flat_hash_map<void*, std::string> symbols =
+      symbolizeFrames(samples, max_symbolized_frames);
+  // Ordered, so that the stacks of a thread are listed together.
+  std::map<std::string, uint64_t> stacks;
+  for (const StackSample& sample : samples) {
+    auto name = thread_names.find(sample.thread_id_);
+    std::string stack = name != thread_names.end() ? name->second
+                                                   : absl::StrCat("thread_", sample.thread_id_);
+    for (auto frame = sample.frames_.rbegin(); frame != sample.frames_.rend(); ++frame) {
+      auto symbol = symbols.find(*frame);
+      absl::StrAppend(&stack, ";", symbol != symbols.end() ? symbol->second : hexAddress(*frame));
+    }
+    ++stacks[stack];
+  }
+
+  std::string output;
+  for (const auto& [stack, count] : stacks) {
+    absl::StrAppend(&output, stack, " ", count, "\n");
+  }
+  return output;
+}
+
+std::string legacyCpuProfile(const std::vector<StackSample>& samples,
+                             std::chrono::microseconds period, absl::string_view mappings) {
+  std::map<std::vector<void*>, uint64_t> stacks;
+  for (const StackSample& sample : samples) {
+    if (!sample.frames_.empty()) {
+      ++stacks[sample.frames_];
+    }
+  }
+
+  // The header holds the header size, the format version, the sampling period in microseconds and
+  // padding. Each record then holds a sample count, the stack depth and the stack, and the profile
+  // ends with a record of a single zero frame.
+  std::vector<uintptr_t> words{0, 3, 0, static_cast<uintptr_t>(period.count()), 0};
+  for (const auto& [frames, count] : stacks) {
+    words.push_back(count);
+    words.push_back(frames.size());
+    for (void* frame : frames) {
+      words.push_back(reinterpret_cast<uintptr_t>(frame));
+    }
+  }
+  words.insert(words.end(), {0, 1, 0});
+
+  std::string output(reinterpret_cast<const char*>(words.data()),
+                     words.size() * sizeof(uintptr_t));
+  output.append(mappings.data(), mappings.size());
+  return output;
+}
+
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * A call stack sampled by the continuous CPU profiler.
+ */
+struct StackSample {
+  MonotonicTime time_;
+  int32_t thread_id_;
+  // The innermost frame comes first.
+  std::vector<void*> frames_;
+};
+
+/**
+ * A fixed size ring of stack samples, which overwrites the oldest samples once it is full.
+ * record() neither allocates nor locks, so that it can be called from a signal handler on any
+ * thread. Readers copy the samples out without blocking the writers, skipping any sample that is
+ * overwritten while it is being copied.
+ */
+class SampleRing {
+public:
+  static constexpr uint32_t MaxFrames = 32;
+
+  explicit SampleRing(uint32_t capacity);
+
+  /**
+   * Records a sample, keeping at most MaxFrames frames.
+   * @param time supplies the time of the sample.
+   * @param thread_id supplies the ID of the sampled thread.
+   * @param frames supplies the frames of the stack, innermost first.
+   * @param depth supplies the number of frames.
+   */
+  void record(MonotonicTime time, int32_t thread_id, void* const* frames, int depth);
+
+  /**
+   * @param since supplies the time from which samples are returned.
+   * @return the samples recorded at or after the given time, oldest first.
+   */
+  std::vector<StackSample> samplesSince(MonotonicTime since) const;
+
+  uint32_t capacity() const { return capacity_; }
+
+private:
+  struct Slot {
+    // Odd while the slot is being written. Once written, it is twice the position of the sample
+    // plus two, so that readers can tell a slot which was rewritten while they copied it.
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<int64_t> time_ns_{0};
+    std::atomic<int32_t> thread_id_{0};
+    std::atomic<int32_t> depth_{0};
+    std::atomic<void*> frames_[MaxFrames];
+  };
+
+  const uint32_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_{0};
+};
+
+/**
+ * Process wide, always-on sampling CPU profiling. A profiling timer interrupts the process at a
+ * low frequency of its CPU time, and the stack of the interrupted thread is recorded into a ring
+ * of samples, which can be aggregated at any time. This is only supported on Linux.
+ *
+ * The profiler shares SIGPROF with the gperftools CPU profiler, so only one of them can run at a
+ * time.
+ */
+class ContinuousCpu {
+public:
+  /**
+   * @return whether the profiler is supported on this platform.
+   */
+  static bool profilerSupported();
+
+  /**
+   * @return whether the profiler is started or not.
+   */
+  static bool isProfilerStarted();
+
+  /**
+   * Start the profiler.
+   * @param frequency supplies the number of samples to take per second of CPU time.
+   * @param max_samples supplies the number of most recent samples that are kept.
+   * @return bool whether the call to start the profiler succeeded.
+   */
+  static bool startProfiler(uint32_t frequency, uint32_t max_samples);
+
+  /**
+   * Stop the profiler and release its samples.
+   */
+  static void stopProfiler();
+
+  /**
+   * @return the sampling period of the running profiler.
+   */
+  static std::chrono::microseconds samplingPeriod();
+
+  /**
+   * @param since supplies the time from which samples are returned.
+   * @return the samples of the running profiler taken at or after the given time, oldest first.
+   */
+  static std::vector<StackSample> samplesSince(MonotonicTime since);
+
+  /**
+   * @param samples supplies the samples whose threads are named.
+   * @return the names of the sampled threads which are still running, by thread ID. Envoy names
+   * its threads, e.g. wrk:worker_0 for the first worker.
+   */
+  static absl::flat_hash_map<int32_t, std::string>
+  threadNames(const std::vector<StackSample>& samples);
+
+  /**
+   * @return the memory mappings of the process, in the format of /proc/self/maps.
+   */
+  static std::string memoryMappings();
+};
+
+/**
+ * Renders samples in the folded stack format read by flame graph tools: one line per distinct
+ * stack of a thread, with the thread name and the symbolized frames from the outermost, separated
+ * by semicolons, followed by the number of samples of the stack.
+ * @param samples supplies the samples.
+ * @param thread_names supplies the names of the sampled threads. Threads without a name are named
+ * after their ID.
+ * @param max_symbolized_frames supplies the number of distinct frames which are symbolized, the
+ * most frequent first. Symbolizing a frame scans the symbol table of the binary, so the other
+ * frames are rendered as addresses.
+ */
+std::string foldStacks(const std::vector<StackSample>& samples,
+                       const absl::flat_hash_map<int32_t, std::string>& thread_names,
+                       uint32_t max_symbolized_frames);
+
+/**
+ * Renders samples in the legacy binary CPU profile format of gperftools, which pprof reads.
+ * @param samples supplies the samples.
+ * @param period supplies the sampling period.
+ * @param mappings supplies the memory mappings of the process, in the format of /proc/self/maps,
+ * which pprof uses to symbolize the profile.
+ */
+std::string legacyCpuProfile(const std::vector<StackSample>& samples,
+                             std::chrono::microseconds period, absl::string_view mappings);
+
+} // namespace Profiler
+} // namespace Envoy
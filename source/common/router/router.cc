@@ -40,6 +40,7 @@
 #include "source/common/router/upstream_request.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stream_info/uint32_accessor_impl.h"
+#include "source/common/stream_info/utility.h"
 #include "source/common/tracing/http_tracer_impl.h"
 
 namespace Envoy {
@@ -712,6 +713,9 @@ Filter::createConnPool(Upstream::ThreadLocalCluster& thread_local_cluster) {
       should_tcp_proxy = (method == Http::Headers::get().MethodValues.Post);
     }
   }
+  // The load balancer picks the upstream host when the connection pool is created.
+  StreamInfo::ScopedTimingPoint timing(config_.timeSource(), callbacks_->streamInfo(),
+                                       &StreamInfo::TimingBreakdown::host_selection_);
   return factory->createGenericConnPool(thread_local_cluster, should_tcp_proxy, *route_entry_,
                                         callbacks_->streamInfo().protocol(), this);
 }
@@ -235,6 +235,9 @@ void UpstreamRequest::encodeHeaders(bool end_stream) {
   ASSERT(!encode_complete_);
   encode_complete_ = end_stream;
 
+  if (parent_.callbacks()->streamInfo().timingBreakdown() != nullptr) {
+    conn_pool_wait_start_ = parent_.timeSource().monotonicTime();
+  }
   conn_pool_->newStream(this);
 }
 
@@ -379,9 +382,25 @@ void UpstreamRequest::onPerTryTimeout() {
   }
 }
 
+void UpstreamRequest::recordConnectionPoolWait() {
+  if (!conn_pool_wait_start_.has_value()) {
+    return;
+  }
+  // The pool may be ready before newStream() returns, in which case the wait is nested in the
+  // timing point of the router's decoder callback.
+  StreamInfo::TimingBreakdown* timing_breakdown =
+      parent_.callbacks()->streamInfo().timingBreakdown();
+  const std::chrono::nanoseconds wait =
+      parent_.timeSource().monotonicTime() - conn_pool_wait_start_.value();
+  timing_breakdown->connection_pool_wait_ += wait;
+  timing_breakdown->timed_ += wait;
+  conn_pool_wait_start_.reset();
+}
+
 void UpstreamRequest::onPoolFailure(ConnectionPool::PoolFailureReason reason,
                                     absl::string_view transport_failure_reason,
                                     Upstream::HostDescriptionConstSharedPtr host) {
+  recordConnectionPoolWait();
   Http::StreamResetReason reset_reason = Http::StreamResetReason::ConnectionFailure;
   switch (reason) {
   case ConnectionPool::PoolFailureReason::Overflow:
@@ -408,6 +427,7 @@ void UpstreamRequest::onPoolReady(
   // This may be called under an existing ScopeTrackerScopeState but it will unwind correctly.
   ScopeTrackerScopeState scope(&parent_.callbacks()->scope(), parent_.callbacks()->dispatcher());
   ENVOY_STREAM_LOG(debug, "pool ready", *parent_.callbacks());
+  recordConnectionPoolWait();
   upstream_ = std::move(upstream);
   // Have the upstream use the account of the downstream.
   upstream_->setAccount(parent_.callbacks()->account());
@@ -134,6 +134,8 @@ private:
   void resetPerTryIdleTimer();
   void onPerTryTimeout();
   void onPerTryIdleTimeout();
+  // Adds the time spent waiting for the connection pool to the timing breakdown of the stream.
+  void recordConnectionPoolWait();
 
   RouterFilterInterface& parent_;
   std::unique_ptr<GenericConnPool> conn_pool_;
@@ -149,6 +151,8 @@ private:
   StreamInfo::StreamInfoImpl stream_info_;
   StreamInfo::UpstreamTiming upstream_timing_;
   const MonotonicTime start_time_;
+  // Set while waiting for the connection pool, if the stream records its timing breakdown.
+  absl::optional<MonotonicTime> conn_pool_wait_start_;
   // This is wrapped in an optional, since we want to avoid computing zero size headers when in
   // reality we just didn't get a response back.
   absl::optional<uint64_t> response_headers_size_{};
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
 
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -309,6 +310,16 @@ struct StreamInfoImpl : public StreamInfo {
     ASSERT(downstream_bytes_meter_.get() == downstream_bytes_meter.get());
   }
 
+  void enableTimingBreakdown() override {
+    if (timing_breakdown_ == nullptr) {
+      timing_breakdown_ = std::make_unique<TimingBreakdown>();
+    }
+  }
+
+  TimingBreakdown* timingBreakdown() override { return timing_breakdown_.get(); }
+
+  const TimingBreakdown* timingBreakdown() const override { return timing_breakdown_.get(); }
+
   TimeSource& time_source_;
   const SystemTime start_time_;
   const MonotonicTime start_time_monotonic_;
@@ -332,6 +343,7 @@ struct StreamInfoImpl : public StreamInfo {
   std::string route_name_;
   absl::optional<uint64_t> upstream_connection_id_;
   absl::optional<uint32_t> attempt_count_;
+  std::unique_ptr<TimingBreakdown> timing_breakdown_;
 
 private:
   static Network::ConnectionInfoProviderSharedPtr emptyDownstreamAddressProvider() {
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 
+#include "envoy/common/time.h"
 #include "envoy/stream_info/stream_info.h"
 
 namespace Envoy {
@@ -103,5 +104,46 @@ public:
   formatDownstreamAddressJustPort(const Network::Address::Instance& address);
 };
 
+/**
+ * Adds the time spent in its scope to a duration of the timing breakdown of a stream, leaving out
+ * the time of the timing points nested in it. The clock is not read when there is no duration to
+ * add to, i.e. when the breakdown is not recorded.
+ */
+class ScopedTimingPoint {
+public:
+  ScopedTimingPoint(TimeSource& time_source, StreamInfo& stream_info,
+                    std::chrono::nanoseconds* duration)
+      : time_source_(time_source), timing_breakdown_(stream_info.timingBreakdown()),
+        duration_(duration) {
+    if (duration_ != nullptr) {
+      start_ = time_source_.monotonicTime();
+      timed_at_start_ = timing_breakdown_->timed_;
+    }
+  }
+
+  ScopedTimingPoint(TimeSource& time_source, StreamInfo& stream_info,
+                    std::chrono::nanoseconds TimingBreakdown::*point)
+      : ScopedTimingPoint(time_source, stream_info,
+                          stream_info.timingBreakdown() != nullptr
+                              ? &(stream_info.timingBreakdown()->*point)
+                              : nullptr) {}
+
+  ~ScopedTimingPoint() {
+    if (duration_ != nullptr) {
+      const std::chrono::nanoseconds nested = timing_breakdown_->timed_ - timed_at_start_;
+      const std::chrono::nanoseconds exclusive = time_source_.monotonicTime() - start_ - nested;
+      *duration_ += exclusive;
+      timing_breakdown_->timed_ += exclusive;
+    }
+  }
+
+private:
+  TimeSource& time_source_;
+  TimingBreakdown* const timing_breakdown_;
+  std::chrono::nanoseconds* const duration_;
+  MonotonicTime start_;
+  std::chrono::nanoseconds timed_at_start_{};
+};
+
 } // namespace StreamInfo
 } // namespace Envoy
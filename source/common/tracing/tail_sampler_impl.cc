@@ -0,0 +1,149 @@
+#include "source/common/tracing/tail_sampler_impl.h"
+
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/null_span_impl.h"
+
+namespace Envoy {
+namespace Tracing {
+
+namespace {
+
+// Discards a span without finishing it. Drivers whose spans report themselves when they are
+// destroyed drop unsampled spans instead.
+void discard(SpanPtr&& span) {
+  span->setSampled(false);
+  span.reset();
+}
+
+} // namespace
+
+TailSampler::TailSampler(std::chrono::milliseconds latency_threshold, bool keep_errors,
+                         uint32_t max_buffered_spans, TimeSource& time_source,
+                         Stats::Scope& scope, const std::string& prefix)
+    : latency_threshold_(latency_threshold), keep_errors_(keep_errors),
+      max_buffered_spans_(max_buffered_spans), time_source_(time_source),
+      stats_{TAIL_SAMPLING_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                 POOL_GAUGE_PREFIX(scope, prefix))} {}
+
+SpanPtr TailSampler::wrapSpan(SpanPtr&& span, MonotonicTime start_time, bool sampled) {
+  return std::make_unique<TailSampledSpan>(
+      std::move(span), std::make_shared<TailSampledTrace>(*this, start_time, sampled), true);
+}
+
+bool TailSampler::reserveSpan() {
+  uint64_t buffered = buffered_spans_.load(std::memory_order_relaxed);
+  do {
+    if (buffered >= max_buffered_spans_) {
+      stats_.spans_overflowed_.inc();
+      return false;
+    }
+  } while (!buffered_spans_.compare_exchange_weak(buffered, buffered + 1,
+                                                  std::memory_order_relaxed));
+  stats_.spans_buffered_.inc();
+  return true;
+}
+
+void TailSampler::releaseSpans(uint64_t count) {
+  buffered_spans_.fetch_sub(count, std::memory_order_relaxed);
+  stats_.spans_buffered_.sub(count);
+}
+
+bool TailSampler::exceedsLatencyThreshold(MonotonicTime start_time) const {
+  return latency_threshold_.count() > 0 &&
+         time_source_.monotonicTime() - start_time >= latency_threshold_;
+}
+
+TailSampledTrace::TailSampledTrace(TailSampler& sampler, MonotonicTime start_time,
+                                   bool sampled)
+    : sampler_(sampler), start_time_(start_time), sampled_(sampled), decided_(sampled),
+      keep_(sampled) {}
+
+TailSampledTrace::~TailSampledTrace() {
+  // The downstream span was destroyed without finishing, so nothing is kept.
+  discardPending();
+}
+
+void TailSampledTrace::finishChild(SpanPtr&& span) {
+  if (decided_) {
+    if (keep_) {
+      span->finishSpan();
+    } else {
+      discard(std::move(span));
+    }
+    return;
+  }
+
+  if (!sampler_.reserveSpan()) {
+    discard(std::move(span));
+    return;
+  }
+  pending_.push_back(std::move(span));
+}
+
+void TailSampledTrace::finishDownstream(SpanPtr&& span) {
+  if (!decided_) {
+    decided_ = true;
+    keep_ = (sampler_.keep_errors_ && error_) || sampler_.exceedsLatencyThreshold(start_time_);
+  }
+
+  if (!keep_) {
+    sampler_.stats_.traces_discarded_.inc();
+    discardPending();
+    discard(std::move(span));
+    return;
+  }
+
+  sampler_.stats_.traces_kept_.inc();
+  for (SpanPtr& pending : pending_) {
+    pending->finishSpan();
+  }
+  sampler_.releaseSpans(pending_.size());
+  pending_.clear();
+  span->finishSpan();
+}
+
+void TailSampledTrace::discardPending() {
+  if (pending_.empty()) {
+    return;
+  }
+  for (SpanPtr& pending : pending_) {
+    discard(std::move(pending));
+  }
+  sampler_.releaseSpans(pending_.size());
+  pending_.clear();
+}
+
+void TailSampledSpan::setTag(absl::string_view name, absl::string_view value) {
+  if (name == Tags::get().Error && value == Tags::get().True) {
+    trace_->onError();
+  }
+  span_->setTag(name, value);
+}
+
+void TailSampledSpan::finishSpan() {
+  SpanPtr span = std::move(span_);
+  // The span is handed over to the trace, and any later calls on this span are ignored.
+  span_ = std::make_unique<NullSpan>();
+  if (downstream_) {
+    trace_->finishDownstream(std::move(span));
+  } else {
+    trace_->finishChild(std::move(span));
+  }
+}
+
+void TailSampledSpan::injectContext(TraceContext& trace_context) {
+  // The span is recorded whatever the decision made up front, but upstreams are only asked to
+  // record the trace if it was sampled up front, as they cannot learn the decision of this sampler.
+  span_->setSampled(trace_->sampled());
+  span_->injectContext(trace_context);
+  span_->setSampled(true);
+}
+
+SpanPtr TailSampledSpan::spawnChild(const Config& config, const std::string& name,
+                                    SystemTime start_time) {
+  return std::make_unique<TailSampledSpan>(span_->spawnChild(config, name, start_time), trace_,
+                                           false);
+}
+
+} // namespace Tracing
+} // namespace Envoy
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/tracing/trace_driver.h"
+
+namespace Envoy {
+namespace Tracing {
+
+constexpr uint32_t DefaultTailSamplingMaxBufferedSpans = 10000;
+
+/**
+ * All tail sampling stats. @see stats_macros.h
+ */
+#define TAIL_SAMPLING_STATS(COUNTER, GAUGE)                                                        \
+  COUNTER(spans_overflowed)                                                                        \
+  COUNTER(traces_discarded)                                                                        \
+  COUNTER(traces_kept)                                                                             \
+  GAUGE(spans_buffered, Accumulate)
+
+/**
+ * Struct definition for all tail sampling stats. @see stats_macros.h
+ */
+struct TailSamplingStats {
+  TAIL_SAMPLING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class TailSampledTrace;
+
+/**
+ * Decides which traces are exported once their downstream span finishes, rather than when the
+ * request starts. Every request is recorded, and the finished spans of a trace are buffered until
+ * its downstream span finishes. The trace is then exported if it was sampled up front, if it took
+ * at least the latency threshold, or, if configured, if any of its spans is tagged as an error.
+ * The spans of other traces are discarded without being finished, so that the tracer never
+ * serializes or exports them.
+ *
+ * The buffered spans of all the traces are bounded by a pool shared by all workers. Spans which
+ * finish while the pool is full are discarded.
+ */
+class TailSampler {
+public:
+  /**
+   * @param latency_threshold supplies the duration from which traces are kept. Zero disables the
+   * latency predicate.
+   * @param keep_errors supplies whether traces with a span tagged as an error are kept.
+   * @param max_buffered_spans supplies the size of the pool of buffered spans.
+   */
+  TailSampler(std::chrono::milliseconds latency_threshold, bool keep_errors,
+              uint32_t max_buffered_spans, TimeSource& time_source, Stats::Scope& scope,
+              const std::string& prefix);
+
+  /**
+   * Wraps the downstream span of a request. The span and its children are buffered and exported,
+   * or discarded, as a whole when the downstream span finishes. The sampler must outlive the span.
+   * @param span supplies the downstream span, which the driver was asked to record.
+   * @param start_time supplies the monotonic start time of the request, from which its latency is
+   * measured.
+   * @param sampled supplies whether the request was sampled up front, in which case the trace is
+   * kept without being buffered.
+   */
+  SpanPtr wrapSpan(SpanPtr&& span, MonotonicTime start_time, bool sampled);
+
+  TailSamplingStats& stats() { return stats_; }
+
+private:
+  friend class TailSampledTrace;
+
+  // Reserves room in the pool for a span, returning false if the pool is full.
+  bool reserveSpan();
+  void releaseSpans(uint64_t count);
+  bool exceedsLatencyThreshold(MonotonicTime start_time) const;
+
+  const std::chrono::milliseconds latency_threshold_;
+  const bool keep_errors_;
+  const uint32_t max_buffered_spans_;
+  TimeSource& time_source_;
+  TailSamplingStats stats_;
+  std::atomic<uint64_t> buffered_spans_{};
+};
+
+using TailSamplerSharedPtr = std::shared_ptr<TailSampler>;
+
+/**
+ * The spans of a trace which await the decision of the tail sampler. It is shared by the spans of
+ * the trace, which all live on the worker of the request.
+ */
+class TailSampledTrace {
+public:
+  TailSampledTrace(TailSampler& sampler, MonotonicTime start_time, bool sampled);
+  ~TailSampledTrace();
+
+  // Whether the trace was sampled up front, which is the decision propagated upstream.
+  bool sampled() const { return sampled_; }
+  void onError() { error_ = true; }
+  // Buffers a finished child span until the decision, or applies the decision if it was made.
+  void finishChild(SpanPtr&& span);
+  // Decides whether the trace is kept and finishes or discards all of its spans.
+  void finishDownstream(SpanPtr&& span);
+
+private:
+  void discardPending();
+
+  TailSampler& sampler_;
+  const MonotonicTime start_time_;
+  const bool sampled_;
+  std::vector<SpanPtr> pending_;
+  bool decided_;
+  bool keep_;
+  bool error_{};
+};
+
+using TailSampledTraceSharedPtr = std::shared_ptr<TailSampledTrace>;
+
+/**
+ * A span of a trace sampled by the tail sampler. It forwards to the span of the driver, but hands
+ * it over to the trace when it finishes.
+ */
+class TailSampledSpan : public Span {
+public:
+  TailSampledSpan(SpanPtr&& span, TailSampledTraceSharedPtr trace, bool downstream)
+      : span_(std::move(span)), trace_(std::move(trace)), downstream_(downstream) {}
+
+  // Tracing::Span
+  void setOperation(absl::string_view operation) override { span_->setOperation(operation); }
+  void setTag(absl::string_view name, absl::string_view value) override;
+  void log(SystemTime timestamp, const std::string& event) override {
+    span_->log(timestamp, event);
+  }
+  void finishSpan() override;
+  void injectContext(TraceContext& trace_context) override;
+  SpanPtr spawnChild(const Config& config, const std::string& name,
+                     SystemTime start_time) override;
+  void setSampled(bool sampled) override { span_->setSampled(sampled); }
+  std::string getBaggage(absl::string_view key) override { return span_->getBaggage(key); }
+  void setBaggage(absl::string_view key, absl::string_view value) override {
+    span_->setBaggage(key, value);
+  }
+  std::string getTraceIdAsHex() const override { return span_->getTraceIdAsHex(); }
+
+private:
+  SpanPtr span_;
+  TailSampledTraceSharedPtr trace_;
+  const bool downstream_;
+};
+
+} // namespace Tracing
+} // namespace Envoy
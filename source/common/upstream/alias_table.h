@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Walker/Vose alias table (https://en.wikipedia.org/wiki/Alias_method) for sampling an index
+ * proportionally to a fixed set of integer weights. Building the table is O(N); each pick consumes
+ * a single random number and is O(1) without allocation, independent of the number of entries.
+ *
+ * All arithmetic is integral so the sampled distribution matches the weights exactly: over all
+ * random values in [0, size() * totalWeight()) index i is picked exactly weights[i] * size() times.
+ */
+class AliasTable {
+public:
+  /**
+   * Rebuild the table from a set of weights. Storage is reused across rebuilds.
+   * @param weights the relative weight of each index. Zero weight indexes are never picked.
+   */
+  void build(const std::vector<uint64_t>& weights) {
+    const size_t size = weights.size();
+    total_weight_ = 0;
+    for (const uint64_t weight : weights) {
+      total_weight_ += weight;
+    }
+
+    // Every column has a capacity of total_weight_. Weights are scaled by the number of columns so
+    // that the scaled weights add up to exactly size * total_weight_ and no rounding is needed.
+    probability_.resize(size);
+    alias_.resize(size);
+    small_.clear();
+    large_.clear();
+    for (size_t i = 0; i < size; ++i) {
+      probability_[i] = weights[i] * size;
+      alias_[i] = i;
+      if (probability_[i] < total_weight_) {
+        small_.push_back(i);
+      } else {
+        large_.push_back(i);
+      }
+    }
+
+    // Fill each under-full column with the excess of an over-full one.
+    while (!small_.empty() && !large_.empty()) {
+      const uint32_t less = small_.back();
+      small_.pop_back();
+      const uint32_t more = large_.back();
+      large_.pop_back();
+
+      alias_[less] = more;
+      probability_[more] = probability_[more] + probability_[less] - total_weight_;
+      if (probability_[more] < total_weight_) {
+        small_.push_back(more);
+      } else {
+        large_.push_back(more);
+      }
+    }
+
+    // Whatever is left is exactly full.
+    for (const uint32_t i : large_) {
+      probability_[i] = total_weight_;
+    }
+    ASSERT(total_weight_ == 0 || small_.empty());
+  }
+
+  /**
+   * Pick an index.
+   * @param random a uniformly distributed random number.
+   * @return an index in [0, size()), selected proportionally to its weight. Must only be called
+   *         when totalWeight() is non-zero.
+   */
+  uint32_t pick(uint64_t random) const {
+    ASSERT(total_weight_ > 0);
+    const uint64_t size = probability_.size();
+    const uint32_t column = random % size;
+    const uint64_t coin = (random / size) % total_weight_;
+    return coin < probability_[column] ? column : alias_[column];
+  }
+
+  /**
+   * @return the sum of all weights the table was built with.
+   */
+  uint64_t totalWeight() const { return total_weight_; }
+
+  /**
+   * @return the number of entries in the table.
+   */
+  size_t size() const { return probability_.size(); }
+
+private:
+  uint64_t total_weight_{};
+  // Portion of each column (out of total_weight_) which selects the column itself; the rest of the
+  // column selects alias_[column].
+  std::vector<uint64_t> probability_;
+  std::vector<uint32_t> alias_;
+  // Work lists used while building, kept to avoid reallocating on every rebuild.
+  std::vector<uint32_t> small_;
+  std::vector<uint32_t> large_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
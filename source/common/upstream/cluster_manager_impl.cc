@@ -1,8 +1,10 @@
 #include "source/common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -20,6 +22,8 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
+#include "source/common/common/hash.h"
+#include "source/common/common/lock_guard.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/new_grpc_mux_impl.h"
 #include "source/common/config/utility.h"
@@ -426,6 +430,13 @@ ClusterManagerImpl::ClusterManagerImpl(
   tls_.set([this, local_cluster_params](Event::Dispatcher& dispatcher) {
     return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params);
   });
+  // Workers register for shared pools as they create their thread local cluster managers, which
+  // they do at their own pace. Hosts are only given a home once every worker has registered, so
+  // that all workers agree on which of them owns the shared pool of a host.
+  tls_.runOnAllThreads([](OptRef<ThreadLocalClusterManagerImpl>) {}, [this]() {
+    Thread::LockGuard lock(shared_pool_workers_lock_);
+    shared_pool_workers_settled_ = true;
+  });
 
   // We can now potentially create the CDS API once the backing cluster exists.
   if (dyn_resources.has_cds_config() || !dyn_resources.cds_resources_locator().empty()) {
@@ -1013,9 +1024,12 @@ void ClusterManagerImpl::checkActiveStaticCluster(const std::string& cluster) {
 
 void ClusterManagerImpl::postThreadLocalRemoveHosts(const Cluster& cluster,
                                                     const HostVector& hosts_removed) {
+  // Share a single copy of the removed hosts across all workers. See
+  // postThreadLocalClusterUpdate().
   tls_.runOnAllThreads([name = cluster.info()->name(),
-                        hosts_removed](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
-    cluster_manager->removeHosts(name, hosts_removed);
+                        hosts_removed = std::make_shared<const HostVector>(hosts_removed)](
+                           OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+    cluster_manager->removeHosts(name, *hosts_removed);
   });
 }
 
@@ -1042,7 +1056,13 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
 
   HostMapConstSharedPtr host_map = cm_cluster.cluster().prioritySet().crossPriorityHostMap();
 
-  tls_.runOnAllThreads([info = cm_cluster.cluster().info(), params = std::move(params),
+  // The post callback is copied once per worker, so capturing the params by value would copy the
+  // added and removed host vectors, and bump the ref count of each of their hosts, once per worker.
+  // The params are shared by the workers instead. Each worker still builds its own priority set
+  // from them, but the host vectors it holds are the ones built on the main thread.
+  auto snapshot = std::make_shared<const ThreadLocalClusterUpdateParams>(std::move(params));
+
+  tls_.runOnAllThreads([info = cm_cluster.cluster().info(), params = std::move(snapshot),
                         add_or_update_cluster, load_balancer_factory, map = std::move(host_map)](
                            OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     ThreadLocalClusterManagerImpl::ClusterEntry* new_cluster = nullptr;
@@ -1058,7 +1078,7 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
       cluster_manager->thread_local_clusters_[info->name()].reset(new_cluster);
     }
 
-    for (const auto& per_priority : params.per_priority_update_params_) {
+    for (const auto& per_priority : params->per_priority_update_params_) {
       cluster_manager->updateClusterMembership(
           info->name(), per_priority.priority_, per_priority.update_hosts_params_,
           per_priority.locality_weights_, per_priority.hosts_added_, per_priority.hosts_removed_,
@@ -1073,6 +1093,20 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
   });
 }
 
+void ClusterManagerImpl::addSharedPoolWorker(const Http::WorkerMailboxSharedPtr& mailbox) {
+  Thread::LockGuard lock(shared_pool_workers_lock_);
+  shared_pool_workers_.push_back(mailbox);
+}
+
+Http::WorkerMailboxSharedPtr ClusterManagerImpl::sharedPoolHome(const Host& host) {
+  Thread::LockGuard lock(shared_pool_workers_lock_);
+  if (!shared_pool_workers_settled_ || shared_pool_workers_.empty()) {
+    return nullptr;
+  }
+  return shared_pool_workers_[HashUtil::xxHash64(host.address()->asStringView()) %
+                              shared_pool_workers_.size()];
+}
+
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
   tls_.runOnAllThreads([host](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     cluster_manager->onHostHealthFailure(host);
@@ -1177,6 +1211,11 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
     const absl::optional<LocalClusterParams>& local_cluster_params)
     : parent_(parent), thread_local_dispatcher_(dispatcher) {
+  if (&dispatcher != &parent_.dispatcher_) {
+    shared_pool_mailbox_ = std::make_shared<Http::WorkerMailbox>(dispatcher);
+    parent_.addSharedPoolWorker(shared_pool_mailbox_);
+  }
+
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_params.has_value()) {
     const auto& local_cluster_name = local_cluster_params->info_->name();
@@ -1194,6 +1233,10 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
   // member update callback registered with the local cluster.
   ENVOY_LOG(debug, "shutting down thread local cluster manager");
   destroying_ = true;
+  // The mailbox stays registered, so that the homes of hosts do not move while workers stop.
+  if (shared_pool_mailbox_ != nullptr) {
+    shared_pool_mailbox_->close();
+  }
   host_http_conn_pool_map_.clear();
   host_tcp_conn_pool_map_.clear();
   ASSERT(host_tcp_conn_map_.empty());
@@ -1532,6 +1575,37 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
     context->downstreamConnection()->hashKey(hash_key);
   }
 
+  // Pools keyed on per request state are never shared, as the worker owning the shared pool
+  // would have to create a pool for every such key.
+  if (cluster_info_->shareHttp2ConnectionPoolAcrossWorkers() && upstream_options->empty() &&
+      !have_transport_socket_options && upstream_protocols.size() == 1 &&
+      upstream_protocols[0] == Http::Protocol::Http2 && parent_.shared_pool_mailbox_ != nullptr) {
+    ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+    if (container.shared_pool_home_ == nullptr) {
+      container.shared_pool_home_ = parent_.parent_.sharedPoolHome(*host);
+    }
+    // Until the host has a home, each worker uses a pool of its own.
+    if (container.shared_pool_home_ != nullptr &&
+        container.shared_pool_home_ != parent_.shared_pool_mailbox_) {
+      return sharedHttpConnPoolProxy(container, host, priority, upstream_protocols, hash_key);
+    }
+  }
+
+  return httpConnPoolForHost(
+      host, priority, upstream_protocols, alternate_protocol_options, hash_key,
+      !upstream_options->empty() ? upstream_options : nullptr,
+      have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr);
+}
+
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolForHost(
+    const HostConstSharedPtr& host, ResourcePriority priority,
+    std::vector<Http::Protocol>& upstream_protocols,
+    const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+        alternate_protocol_options,
+    const std::vector<uint8_t>& hash_key,
+    const Network::Socket::OptionsSharedPtr& upstream_options,
+    const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options) {
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
@@ -1540,8 +1614,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
       container.pools_->getPool(priority, hash_key, [&]() {
         auto pool = parent_.parent_.factory_.allocateConnPool(
             parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
-            alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
-            have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
+            alternate_protocol_options, upstream_options, transport_socket_options,
             parent_.parent_.time_source_, parent_.cluster_manager_state_);
 
         pool->addIdleCallback([&parent = parent_, host, priority, hash_key]() {
@@ -1558,6 +1631,66 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
   }
 }
 
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::sharedHttpConnPoolProxy(
+    ConnPoolsContainer& container, const HostConstSharedPtr& host, ResourcePriority priority,
+    const std::vector<Http::Protocol>& upstream_protocols, const std::vector<uint8_t>& hash_key) {
+  // Keep the proxy apart from any pool this worker owns for the host itself.
+  std::vector<uint8_t> proxy_hash_key = hash_key;
+  proxy_hash_key.push_back(std::numeric_limits<uint8_t>::max());
+
+  ConnPoolsContainer::ConnPools::PoolOptRef pool =
+      container.pools_->getPool(priority, proxy_hash_key, [&]() {
+        Http::SharedConnPoolLookup lookup = [&cluster_manager = parent_.parent_,
+                                             cluster_name = cluster_info_->name(), host, priority,
+                                             upstream_protocols,
+                                             hash_key]() -> Http::ConnectionPool::Instance* {
+          ThreadLocalClusterManagerImpl& home = *cluster_manager.tls_;
+          return home.sharedHttpConnPool(cluster_name, host, priority, upstream_protocols,
+                                         hash_key);
+        };
+        auto pool = std::make_unique<Http::SharedConnPoolProxy>(
+            parent_.thread_local_dispatcher_, parent_.shared_pool_mailbox_,
+            container.shared_pool_home_, host, std::move(lookup));
+
+        pool->addIdleCallback([&parent = parent_, host, priority, proxy_hash_key]() {
+          parent.httpConnPoolIsIdle(host, priority, proxy_hash_key);
+        });
+
+        return pool;
+      });
+
+  if (pool.has_value()) {
+    return &(pool.value().get());
+  } else {
+    return nullptr;
+  }
+}
+
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::sharedHttpConnPool(
+    const std::string& cluster_name, const HostConstSharedPtr& host, ResourcePriority priority,
+    std::vector<Http::Protocol> upstream_protocols, const std::vector<uint8_t>& hash_key) {
+  auto entry = thread_local_clusters_.find(cluster_name);
+  if (entry == thread_local_clusters_.end()) {
+    return nullptr;
+  }
+
+  // Don't create pools for hosts which this worker has already removed, as nothing would drain
+  // them.
+  const HostMapConstSharedPtr host_map = entry->second->prioritySet().crossPriorityHostMap();
+  if (host_map == nullptr) {
+    return nullptr;
+  }
+  const auto host_iter = host_map->find(host->address()->asString());
+  if (host_iter == host_map->end() || host_iter->second != host) {
+    return nullptr;
+  }
+
+  return entry->second->httpConnPoolForHost(host, priority, upstream_protocols, absl::nullopt,
+                                            hash_key, nullptr, nullptr);
+}
+
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::httpConnPoolIsIdle(
     HostConstSharedPtr host, ResourcePriority priority, const std::vector<uint8_t>& hash_key) {
   if (destroying_) {
@@ -32,6 +32,7 @@
 #include "source/common/http/alternate_protocols_cache_impl.h"
 #include "source/common/http/alternate_protocols_cache_manager_impl.h"
 #include "source/common/http/async_client_impl.h"
+#include "source/common/http/shared_conn_pool.h"
 #include "source/common/quic/quic_stat_names.h"
 #include "source/common/upstream/load_stats_reporter.h"
 #include "source/common/upstream/priority_conn_pool_map.h"
@@ -368,6 +369,10 @@ private:
       // Protect from deletion while iterating through pools_. See comments and usage
       // in `ClusterManagerImpl::ThreadLocalClusterManagerImpl::drainConnPools()`.
       bool do_not_delete_{false};
+
+      // The worker which owns the shared pool for this host, if the cluster shares its pools
+      // across workers.
+      Http::WorkerMailboxSharedPtr shared_pool_home_;
     };
 
     struct TcpConnPoolsContainer {
@@ -437,11 +442,27 @@ private:
       // Drain all clients in connection pools for all hosts.
       void drainAllConnPools();
 
+      // Returns this worker's pool for the given host and pool key, creating it if needed.
+      Http::ConnectionPool::Instance* httpConnPoolForHost(
+          const HostConstSharedPtr& host, ResourcePriority priority,
+          std::vector<Http::Protocol>& upstream_protocols,
+          const absl::optional<envoy::config::core::v3::AlternateProtocolsCacheOptions>&
+              alternate_protocol_options,
+          const std::vector<uint8_t>& hash_key,
+          const Network::Socket::OptionsSharedPtr& upstream_options,
+          const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options);
+
     private:
       Http::ConnectionPool::Instance*
       httpConnPoolImpl(ResourcePriority priority,
                        absl::optional<Http::Protocol> downstream_protocol,
                        LoadBalancerContext* context, bool peek);
+      // Returns a pool which hands streams off to the worker owning the shared pool for the host.
+      Http::ConnectionPool::Instance*
+      sharedHttpConnPoolProxy(ConnPoolsContainer& container, const HostConstSharedPtr& host,
+                              ResourcePriority priority,
+                              const std::vector<Http::Protocol>& upstream_protocols,
+                              const std::vector<uint8_t>& hash_key);
 
       Tcp::ConnectionPool::Instance* tcpConnPoolImpl(ResourcePriority priority,
                                                      LoadBalancerContext* context, bool peek);
@@ -492,6 +513,12 @@ private:
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
+    // Returns the pool this worker owns on behalf of all workers for a host of a cluster which
+    // shares its pools across workers, or nullptr if the host is no longer part of the cluster.
+    Http::ConnectionPool::Instance*
+    sharedHttpConnPool(const std::string& cluster_name, const HostConstSharedPtr& host,
+                       ResourcePriority priority, std::vector<Http::Protocol> upstream_protocols,
+                       const std::vector<uint8_t>& hash_key);
 
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
@@ -508,6 +535,9 @@ private:
     std::list<Envoy::Upstream::ClusterUpdateCallbacks*> update_callbacks_;
     const PrioritySet* local_priority_set_{};
     bool destroying_{};
+    // Set on workers, which can own the shared pools of clusters sharing their pools across
+    // workers. Not set on the main thread.
+    Http::WorkerMailboxSharedPtr shared_pool_mailbox_;
   };
 
   struct ClusterData : public ClusterManagerCluster {
@@ -616,12 +646,20 @@ private:
   static void maybePreconnect(ThreadLocalClusterManagerImpl::ClusterEntry& cluster_entry,
                               const ClusterConnectivityState& cluster_manager_state,
                               std::function<ConnectionPool::Instance*()> preconnect_pool);
+  void addSharedPoolWorker(const Http::WorkerMailboxSharedPtr& mailbox);
+  // Picks the worker which owns the shared pool for a host by hashing its address. Returns nullptr
+  // until every worker has registered.
+  Http::WorkerMailboxSharedPtr sharedPoolHome(const Host& host);
 
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
   ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl> tls_;
   Random::RandomGenerator& random_;
+  Thread::MutexBasicLockable shared_pool_workers_lock_;
+  std::vector<Http::WorkerMailboxSharedPtr>
+      shared_pool_workers_ ABSL_GUARDED_BY(shared_pool_workers_lock_);
+  bool shared_pool_workers_settled_ ABSL_GUARDED_BY(shared_pool_workers_lock_){};
 
 protected:
   ClusterMap active_clusters_;
@@ -24,9 +24,15 @@ EdsClusterImpl::EdsClusterImpl(
       factory_context_(factory_context), local_info_(factory_context.localInfo()),
       cluster_name_(cluster.eds_cluster_config().service_name().empty()
                         ? cluster.name()
-                        : cluster.eds_cluster_config().service_name()) {
+                        : cluster.eds_cluster_config().service_name()),
+      update_coalescing_window_(PROTOBUF_GET_MS_OR_DEFAULT(cluster.eds_cluster_config(),
+                                                           update_coalescing_window, 0)) {
   Event::Dispatcher& dispatcher = factory_context.mainThreadDispatcher();
   assignment_timeout_ = dispatcher.createTimer([this]() -> void { onAssignmentTimeout(); });
+  if (update_coalescing_window_.count() > 0) {
+    update_coalescing_timer_ =
+        dispatcher.createTimer([this]() -> void { onUpdateCoalescingTimeout(); });
+  }
   const auto& eds_config = cluster.eds_cluster_config().eds_config();
   if (eds_config.config_source_specifier_case() ==
       envoy::config::core::v3::ConfigSource::ConfigSourceSpecifierCase::kPath) {
@@ -180,6 +186,44 @@ void EdsClusterImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef
     assignment_timeout_->enableTimer(std::chrono::milliseconds(stale_after_ms));
   }
 
+  // If an assignment was applied less than one coalescing window ago, hold on to this one. It
+  // replaces any assignment already waiting, as each assignment carries the complete state of the
+  // cluster, and is applied when the window expires.
+  if (update_coalescing_timer_ != nullptr && update_coalescing_timer_->enabled()) {
+    ENVOY_LOG(debug, "coalescing EDS assignment for cluster {}", cluster_name_);
+    info_->stats().update_coalesced_.inc();
+    pending_cluster_load_assignment_ = std::move(cluster_load_assignment);
+    return;
+  }
+
+  applyClusterLoadAssignment(cluster_load_assignment);
+}
+
+void EdsClusterImpl::onUpdateCoalescingTimeout() {
+  if (!pending_cluster_load_assignment_.has_value()) {
+    return;
+  }
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment =
+      std::move(pending_cluster_load_assignment_.value());
+  pending_cluster_load_assignment_ = absl::nullopt;
+  // The deferred assignment has already been acknowledged to the management server, so an error
+  // found while applying it can only be reported locally.
+  TRY_ASSERT_MAIN_THREAD { applyClusterLoadAssignment(cluster_load_assignment); }
+  END_TRY
+  catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "failed to apply coalesced EDS assignment for cluster {}: {}", cluster_name_,
+              e.what());
+    info_->stats().update_failure_.inc();
+  }
+}
+
+void EdsClusterImpl::applyClusterLoadAssignment(
+    envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment) {
+  // Open a new coalescing window. Any assignment received before it expires is deferred until then.
+  if (update_coalescing_timer_ != nullptr) {
+    update_coalescing_timer_->enableTimer(update_coalescing_window_);
+  }
+
   // Pause LEDS messages until the EDS config is finished processing.
   Config::ScopedResume maybe_resume_leds;
   if (factory_context_.clusterManager().adsMux()) {
@@ -282,6 +326,12 @@ void EdsClusterImpl::onAssignmentTimeout() {
   auto decoded_resource =
       Config::DecodedResourceImpl::fromResource(resource_decoder_, any_resource, "");
   std::vector<Config::DecodedResourceRef> resource_refs = {*decoded_resource};
+  // The stale assignments are removed right away rather than at the end of the coalescing window.
+  // An assignment waiting for the window, if any, is the one which went stale.
+  pending_cluster_load_assignment_ = absl::nullopt;
+  if (update_coalescing_timer_ != nullptr) {
+    update_coalescing_timer_->disableTimer();
+  }
   onConfigUpdate(resource_refs, "");
   // Stat to track how often we end up with stale assignments.
   info_->stats().assignment_stale_.inc();
@@ -55,6 +55,9 @@ private:
                               const HostMap& all_hosts,
                               const absl::flat_hash_set<std::string>& all_new_hosts);
   bool validateUpdateSize(int num_resources);
+  void applyClusterLoadAssignment(
+      envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment);
+  void onUpdateCoalescingTimeout();
 
   // ClusterImplBase
   void reloadHealthyHostsHelper(const HostSharedPtr& host) override;
@@ -91,6 +94,13 @@ private:
   const std::string cluster_name_;
   std::vector<LocalityWeightsMap> locality_weights_map_;
   Event::TimerPtr assignment_timeout_;
+  // Window during which successive assignments are coalesced. Only set if non-zero.
+  const std::chrono::milliseconds update_coalescing_window_;
+  Event::TimerPtr update_coalescing_timer_;
+  // The most recent assignment received while the coalescing window was open. It supersedes any
+  // assignment previously stored here and is applied when the window expires.
+  absl::optional<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      pending_cluster_load_assignment_;
   InitializePhase initialize_phase_;
   using LedsConfigSet = absl::flat_hash_set<envoy::config::endpoint::v3::LedsClusterLocalityConfig,
                                             MessageUtil, MessageUtil>;
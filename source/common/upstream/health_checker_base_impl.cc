@@ -29,6 +29,7 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
       no_traffic_healthy_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, no_traffic_healthy_interval,
                                                               no_traffic_interval_.count())),
       initial_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, initial_jitter, 0)),
+      spread_initial_checks_(config.spread_initial_checks()),
       interval_jitter_(PROTOBUF_GET_MS_OR_DEFAULT(config, interval_jitter, 0)),
       interval_jitter_percent_(config.interval_jitter_percent()),
       unhealthy_interval_(
@@ -97,8 +98,8 @@ void HealthCheckerImplBase::incHealthy() { stats_.healthy_.add(1); }
 
 void HealthCheckerImplBase::incDegraded() { stats_.degraded_.add(1); }
 
-std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
-                                                          HealthTransition changed_state) const {
+uint64_t HealthCheckerImplBase::baseInterval(HealthState state,
+                                             HealthTransition changed_state) const {
   // See if the cluster has ever made a connection. If not, we use a much slower interval to keep
   // the host info relatively up to date in case we suddenly start sending traffic to this cluster.
   // In general host updates are rare and this should greatly smooth out needless health checking.
@@ -133,7 +134,12 @@ std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
             ? no_traffic_healthy_interval_.count()
             : no_traffic_interval_.count();
   }
-  return intervalWithJitter(base_time_ms, interval_jitter_);
+  return base_time_ms;
+}
+
+std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
+                                                          HealthTransition changed_state) const {
+  return intervalWithJitter(baseInterval(state, changed_state), interval_jitter_);
 }
 
 std::chrono::milliseconds
@@ -159,11 +165,16 @@ HealthCheckerImplBase::intervalWithJitter(uint64_t base_time_ms,
 }
 
 void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
-  for (const HostSharedPtr& host : hosts) {
+  // If configured, the first checks of the new hosts are spread evenly over the interval that will
+  // apply to them afterwards, rather than all being sent at once.
+  const uint64_t spread_interval_ms =
+      spread_initial_checks_ ? baseInterval(HealthState::Healthy, HealthTransition::Unchanged) : 0;
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    const HostSharedPtr& host = hosts[i];
     active_sessions_[host] = makeSession(host);
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
-    active_sessions_[host]->start();
+    active_sessions_[host]->start(std::chrono::milliseconds(i * spread_interval_ms / hosts.size()));
   }
 }
 
@@ -421,11 +432,17 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
   handleFailure(envoy::data::core::v3::NETWORK_TIMEOUT);
 }
 
-void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
+void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval(
+    std::chrono::milliseconds initial_offset) {
   if (parent_.initial_jitter_.count() == 0) {
-    onIntervalBase();
+    if (initial_offset.count() == 0) {
+      onIntervalBase();
+    } else {
+      interval_timer_->enableTimer(initial_offset);
+    }
   } else {
     interval_timer_->enableTimer(
+        initial_offset +
         std::chrono::milliseconds(parent_.intervalWithJitter(0, parent_.initial_jitter_)));
   }
 }
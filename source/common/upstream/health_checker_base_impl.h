@@ -79,7 +79,7 @@ protected:
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type,
                                   bool retriable);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start(std::chrono::milliseconds initial_offset) { onInitialInterval(initial_offset); }
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -100,7 +100,7 @@ protected:
     virtual void onTimeout() PURE;
     void onTimeoutBase();
     virtual void onDeferredDelete() PURE;
-    void onInitialInterval();
+    void onInitialInterval(std::chrono::milliseconds initial_offset);
 
     HealthCheckerImplBase& parent_;
     Event::TimerPtr interval_timer_;
@@ -151,6 +151,7 @@ private:
   HealthCheckerStats generateStats(Stats::Scope& scope);
   void incHealthy();
   void incDegraded();
+  uint64_t baseInterval(HealthState state, HealthTransition changed_state) const;
   std::chrono::milliseconds interval(HealthState state, HealthTransition changed_state) const;
   std::chrono::milliseconds intervalWithJitter(uint64_t base_time_ms,
                                                std::chrono::milliseconds interval_jitter) const;
@@ -170,6 +171,7 @@ private:
   const std::chrono::milliseconds no_traffic_interval_;
   const std::chrono::milliseconds no_traffic_healthy_interval_;
   const std::chrono::milliseconds initial_jitter_;
+  const bool spread_initial_checks_;
   const std::chrono::milliseconds interval_jitter_;
   const uint32_t interval_jitter_percent_;
   const std::chrono::milliseconds unhealthy_interval_;
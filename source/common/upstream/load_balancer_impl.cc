@@ -85,9 +85,9 @@ LoadBalancerBase::choosePriority(uint64_t hash, const HealthyLoad& healthy_per_p
                                  const DegradedLoad& degraded_per_priority_load) {
   hash = hash % 100 + 1; // 1-100
   uint32_t aggregate_percentage_load = 0;
-  // As with tryChooseLocalLocalityHosts, this can be refactored for efficiency
-  // but O(N) is good enough for now given the expected number of priorities is
-  // small.
+  // This can be refactored for efficiency but O(N) is good enough for now given the expected
+  // number of priorities is small. Unlike locality selection the mapping from hash to priority
+  // must stay stable, so it is kept as a cumulative scan.
 
   // We first attempt to select a priority based on healthy availability.
   for (size_t priority = 0; priority < healthy_per_priority_load.get().size(); ++priority) {
@@ -447,32 +447,25 @@ void ZoneAwareLoadBalancerBase::regenerateLocalityRoutingStructures() {
   // locality we should route. Percentage of requests routed cross locality to a specific locality
   // needed be proportional to the residual capacity upstream locality has.
   //
-  // residual_capacity contains capacity left in a given locality, we keep accumulating residual
-  // capacity to make search for sampled value easier.
+  // residual_capacity contains capacity left in a given locality.
   // For example, if we have the following upstream and local percentage:
   // local_percentage: 40000 40000 20000
   // upstream_percentage: 25000 50000 25000
   // Residual capacity would look like: 0 10000 5000. Now we need to sample proportionally to
-  // bucket sizes (residual capacity). For simplicity of finding where specific
-  // sampled value is, we accumulate values in residual capacity. This is what it will look like:
-  // residual_capacity: 0 10000 15000
-  // Now to find a locality to route (bucket) we could simply iterate over residual_capacity
-  // searching where sampled value is placed.
-  state.residual_capacity_.resize(num_localities);
+  // bucket sizes (residual capacity). The residual capacities are folded into an alias table so
+  // that picking a locality takes constant time regardless of the number of localities.
+  std::vector<uint64_t>& residual_capacity = state.residual_capacity_;
+  residual_capacity.resize(num_localities);
 
   // Local locality (index 0) does not have residual capacity as we have routed all we could.
-  state.residual_capacity_[0] = 0;
+  residual_capacity[0] = 0;
   for (size_t i = 1; i < num_localities; ++i) {
     // Only route to the localities that have additional capacity.
-    if (upstream_percentage[i] > local_percentage[i]) {
-      state.residual_capacity_[i] =
-          state.residual_capacity_[i - 1] + upstream_percentage[i] - local_percentage[i];
-    } else {
-      // Locality with index "i" does not have residual capacity, but we keep accumulating previous
-      // values to make search easier on the next step.
-      state.residual_capacity_[i] = state.residual_capacity_[i - 1];
-    }
+    residual_capacity[i] = upstream_percentage[i] > local_percentage[i]
+                               ? upstream_percentage[i] - local_percentage[i]
+                               : 0;
   }
+  state.residual_capacity_table_.build(residual_capacity);
 }
 
 void ZoneAwareLoadBalancerBase::resizePerPriorityState() {
@@ -646,25 +639,15 @@ uint32_t ZoneAwareLoadBalancerBase::tryChooseLocalLocalityHosts(const HostSet& h
 
   // This is *extremely* unlikely but possible due to rounding errors when calculating
   // locality percentages. In this case just select random locality.
-  if (state.residual_capacity_[number_of_localities - 1] == 0) {
+  if (state.residual_capacity_table_.totalWeight() == 0) {
     stats_.lb_zone_no_capacity_left_.inc();
     return random_.random() % number_of_localities;
   }
 
   // Random sampling to select specific locality for cross locality traffic based on the additional
   // capacity in localities.
-  uint64_t threshold = random_.random() % state.residual_capacity_[number_of_localities - 1];
-
-  // This potentially can be optimized to be O(log(N)) where N is the number of localities.
-  // Linear scan should be faster for smaller N, in most of the scenarios N will be small.
-  // TODO(htuch): is there a bug here when threshold == 0? Seems like we pick
-  // local locality in that situation. Probably should start iterating at 1.
-  int i = 0;
-  while (threshold > state.residual_capacity_[i]) {
-    i++;
-  }
-
-  return i;
+  ASSERT(state.residual_capacity_table_.size() == number_of_localities);
+  return state.residual_capacity_table_.pick(random_.random());
 }
 
 absl::optional<ZoneAwareLoadBalancerBase::HostsSource>
@@ -16,6 +16,7 @@
 
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_protos.h"
+#include "source/common/upstream/alias_table.h"
 #include "source/common/upstream/edf_scheduler.h"
 
 namespace Envoy {
@@ -374,6 +375,8 @@ private:
     // for each of the non-local localities to determine what traffic should be
     // routed where.
     std::vector<uint64_t> residual_capacity_;
+    // Alias table built from residual_capacity_ for O(1) cross locality picks.
+    AliasTable residual_capacity_table_;
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
   // Routing state broken out for each priority level in priority_set_.
@@ -13,6 +13,7 @@
 #include "envoy/stats/scope.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/cleanup.h"
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/fmt.h"
 #include "source/common/common/utility.h"
@@ -570,9 +571,10 @@ void DetectorImpl::onConsecutiveErrorWorker(HostSharedPtr host,
   }
 }
 
-DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
-    double success_rate_sum, const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-    double success_rate_stdev_factor) {
+DetectorImpl::EjectionPair
+DetectorImpl::successRateEjectionThreshold(double success_rate_sum,
+                                           const std::vector<double>& success_rates,
+                                           double success_rate_stdev_factor) {
   // This function is using mean and standard deviation as statistical measures for outlier
   // detection. First the mean is calculated by dividing the sum of success rate data over the
   // number of data points. Then variance is calculated by taking the mean of the
@@ -588,14 +590,29 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // variance = 400
   // stdev = 20
   // threshold returned = 52
-  double mean = success_rate_sum / valid_success_rate_hosts.size();
-  double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
-  variance /= valid_success_rate_hosts.size();
-  double stdev = std::sqrt(variance);
+  const size_t size = success_rates.size();
+  const double* data = success_rates.data();
+  const double mean = success_rate_sum / size;
+
+  // Accumulate the squared differences in independent lanes. Floating point addition is not
+  // associative, so the compiler will not reorder a single running sum; with separate lanes the
+  // loop body has no cross-iteration dependency and can be vectorized.
+  constexpr size_t Lanes = 4;
+  double lane_variance[Lanes] = {0, 0, 0, 0};
+  size_t i = 0;
+  for (; i + Lanes <= size; i += Lanes) {
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+      const double diff = data[i + lane] - mean;
+      lane_variance[lane] += diff * diff;
+    }
+  }
+  for (; i < size; ++i) {
+    const double diff = data[i] - mean;
+    lane_variance[0] += diff * diff;
+  }
+  double variance = (lane_variance[0] + lane_variance[1]) + (lane_variance[2] + lane_variance[3]);
+  variance /= size;
+  const double stdev = std::sqrt(variance);
 
   return {mean, (mean - (success_rate_stdev_factor * stdev))};
 }
@@ -611,8 +628,6 @@ void DetectorImpl::processSuccessRateEjections(
   uint64_t failure_percentage_request_volume = runtime_.snapshot().getInteger(
       FailurePercentageRequestVolumeRuntime, config_.failurePercentageRequestVolume());
 
-  std::vector<HostSuccessRatePair> valid_success_rate_hosts;
-  std::vector<HostSuccessRatePair> valid_failure_percentage_hosts;
   double success_rate_sum = 0;
 
   // Reset the Detector's success rate mean and stdev.
@@ -624,78 +639,95 @@ void DetectorImpl::processSuccessRateEjections(
     return;
   }
 
+  // The columns hold references to the hosts, so drop them once this interval has been processed.
+  // Clearing keeps the capacity for the next interval.
+  SuccessRateColumns& columns = success_rate_columns_;
+  ASSERT(columns.hosts_.empty());
+  Cleanup clear_columns([&columns]() { columns.clear(); });
+
   // reserve upper bound of vector size to avoid reallocation.
-  valid_success_rate_hosts.reserve(host_monitors_.size());
-  valid_failure_percentage_hosts.reserve(host_monitors_.size());
+  columns.reserve(host_monitors_.size());
 
-  for (const auto& host : host_monitors_) {
+  const uint64_t minimum_request_volume =
+      std::min(success_rate_request_volume, failure_percentage_request_volume);
+  for (const auto& [host, monitor] : host_monitors_) {
     // Don't do work if the host is already ejected.
-    if (!host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
-      absl::optional<std::pair<double, uint64_t>> host_success_rate_and_volume =
-          host.second->getSRMonitor(monitor_type)
-              .successRateAccumulator()
-              .getSuccessRateAndVolume();
-
-      if (!host_success_rate_and_volume) {
-        continue;
-      }
-      double success_rate = host_success_rate_and_volume.value().first;
-      double request_volume = host_success_rate_and_volume.value().second;
+    if (host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      continue;
+    }
+    absl::optional<std::pair<double, uint64_t>> host_success_rate_and_volume =
+        monitor->getSRMonitor(monitor_type).successRateAccumulator().getSuccessRateAndVolume();
 
-      if (request_volume >=
-          std::min(success_rate_request_volume, failure_percentage_request_volume)) {
-        host.second->successRate(monitor_type, success_rate);
-      }
+    if (!host_success_rate_and_volume) {
+      continue;
+    }
+    const double success_rate = host_success_rate_and_volume.value().first;
+    const uint64_t request_volume = host_success_rate_and_volume.value().second;
 
-      if (request_volume >= success_rate_request_volume) {
-        valid_success_rate_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
-        success_rate_sum += success_rate;
-      }
-      if (request_volume >= failure_percentage_request_volume) {
-        valid_failure_percentage_hosts.emplace_back(HostSuccessRatePair(host.first, success_rate));
-      }
+    if (request_volume < minimum_request_volume) {
+      continue;
+    }
+    monitor->successRate(monitor_type, success_rate);
+
+    columns.hosts_.push_back(host);
+    columns.success_rates_.push_back(success_rate);
+    columns.request_volumes_.push_back(request_volume);
+    if (request_volume >= success_rate_request_volume) {
+      columns.valid_success_rates_.push_back(success_rate);
+      success_rate_sum += success_rate;
     }
   }
 
-  if (!valid_success_rate_hosts.empty() &&
-      valid_success_rate_hosts.size() >= success_rate_minimum_hosts) {
+  const size_t num_hosts = columns.hosts_.size();
+
+  if (!columns.valid_success_rates_.empty() &&
+      columns.valid_success_rates_.size() >= success_rate_minimum_hosts) {
     const double success_rate_stdev_factor =
         runtime_.snapshot().getInteger(SuccessRateStdevFactorRuntime,
                                        config_.successRateStdevFactor()) /
         1000.0;
     getSRNums(monitor_type) = successRateEjectionThreshold(
-        success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
+        success_rate_sum, columns.valid_success_rates_, success_rate_stdev_factor);
     const double success_rate_ejection_threshold = getSRNums(monitor_type).ejection_threshold_;
-    for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
-      if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold) {
+    // This matches the ejection type of the host's SuccessRateMonitor for this monitor type.
+    const envoy::data::cluster::v3::OutlierEjectionType type =
+        (monitor_type == DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin)
+            ? envoy::data::cluster::v3::SUCCESS_RATE
+            : envoy::data::cluster::v3::SUCCESS_RATE_LOCAL_ORIGIN;
+    for (size_t i = 0; i < num_hosts; ++i) {
+      if (columns.request_volumes_[i] >= success_rate_request_volume &&
+          columns.success_rates_[i] < success_rate_ejection_threshold) {
         stats_.ejections_success_rate_.inc(); // Deprecated.
-        const envoy::data::cluster::v3::OutlierEjectionType type =
-            host_monitors_[host_success_rate_pair.host_]
-                ->getSRMonitor(monitor_type)
-                .getEjectionType();
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(columns.hosts_[i], type);
       }
     }
   }
 
-  if (!valid_failure_percentage_hosts.empty() &&
-      valid_failure_percentage_hosts.size() >= failure_percentage_minimum_hosts) {
+  // Count the hosts eligible for failure percentage detection without branching on each host.
+  size_t num_failure_percentage_hosts = 0;
+  for (size_t i = 0; i < num_hosts; ++i) {
+    num_failure_percentage_hosts +=
+        columns.request_volumes_[i] >= failure_percentage_request_volume;
+  }
+
+  if (num_failure_percentage_hosts > 0 &&
+      num_failure_percentage_hosts >= failure_percentage_minimum_hosts) {
     const double failure_percentage_threshold = runtime_.snapshot().getInteger(
         FailurePercentageThresholdRuntime, config_.failurePercentageThreshold());
 
-    for (const auto& host_success_rate_pair : valid_failure_percentage_hosts) {
-      if ((100.0 - host_success_rate_pair.success_rate_) >= failure_percentage_threshold) {
+    // The ejection type returned by the SuccessRateMonitor's getEjectionType() will be a
+    // SUCCESS_RATE type, so we need to figure it out for ourselves.
+    const envoy::data::cluster::v3::OutlierEjectionType type =
+        (monitor_type == DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin)
+            ? envoy::data::cluster::v3::FAILURE_PERCENTAGE
+            : envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN;
+    for (size_t i = 0; i < num_hosts; ++i) {
+      if (columns.request_volumes_[i] >= failure_percentage_request_volume &&
+          (100.0 - columns.success_rates_[i]) >= failure_percentage_threshold) {
         // We should eject.
-
-        // The ejection type returned by the SuccessRateMonitor's getEjectionType() will be a
-        // SUCCESS_RATE type, so we need to figure it out for ourselves.
-        const envoy::data::cluster::v3::OutlierEjectionType type =
-            (monitor_type == DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin)
-                ? envoy::data::cluster::v3::FAILURE_PERCENTAGE
-                : envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN;
         updateDetectedEjectionStats(type);
-        ejectHost(host_success_rate_pair.host_, type);
+        ejectHost(columns.hosts_[i], type);
       }
     }
   }
@@ -704,7 +736,7 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
+  for (const auto& host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
     // Need to update the writer bucket to keep the data valid.
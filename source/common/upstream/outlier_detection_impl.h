@@ -58,13 +58,34 @@ public:
 };
 
 /**
- * Thin struct to facilitate calculations for success rate outlier detection.
+ * Columnar per-interval data for success rate and failure percentage outlier detection. Hosts,
+ * success rates and request volumes are kept in parallel arrays so that the statistics are computed
+ * by tight loops over contiguous values. The columns are owned by the detector and reused across
+ * intervals so that their storage is only allocated once.
  */
-struct HostSuccessRatePair {
-  HostSuccessRatePair(HostSharedPtr host, double success_rate)
-      : host_(host), success_rate_(success_rate) {}
-  HostSharedPtr host_;
-  double success_rate_;
+struct SuccessRateColumns {
+  void reserve(size_t size) {
+    hosts_.reserve(size);
+    success_rates_.reserve(size);
+    request_volumes_.reserve(size);
+    valid_success_rates_.reserve(size);
+  }
+
+  void clear() {
+    hosts_.clear();
+    success_rates_.clear();
+    request_volumes_.clear();
+    valid_success_rates_.clear();
+  }
+
+  // Hosts that have enough request volume for at least one of success rate or failure percentage
+  // detection, with their success rate and request volume at the same index.
+  std::vector<HostSharedPtr> hosts_;
+  std::vector<double> success_rates_;
+  std::vector<uint64_t> request_volumes_;
+  // Success rates of the subset of hosts that have enough request volume for success rate
+  // detection. Used to compute the mean and standard deviation.
+  std::vector<double> valid_success_rates_;
 };
 
 struct SuccessRateAccumulatorBucket {
@@ -398,19 +419,17 @@ public:
    * This function returns pair of double values for success rate outlier detection. The pair
    * contains the average success rate of all valid hosts in the cluster and the ejection threshold.
    * If a host's success rate is under this threshold, the host is an outlier.
-   * @param success_rate_sum is the sum of the data in the success_rate_data vector.
-   * @param valid_success_rate_hosts is the vector containing the individual success rate data
-   *        points.
+   * @param success_rate_sum is the sum of the data in the success_rates vector.
+   * @param success_rates is the vector containing the individual success rate data points.
    * @return EjectionPair
    */
   struct EjectionPair {
     double success_rate_average_; // average success rate of all valid hosts in the cluster
     double ejection_threshold_;   // ejection threshold for the cluster
   };
-  static EjectionPair
-  successRateEjectionThreshold(double success_rate_sum,
-                               const std::vector<HostSuccessRatePair>& valid_success_rate_hosts,
-                               double success_rate_stdev_factor);
+  static EjectionPair successRateEjectionThreshold(double success_rate_sum,
+                                                   const std::vector<double>& success_rates,
+                                                   double success_rate_stdev_factor);
 
 private:
   DetectorImpl(const Cluster& cluster, const envoy::config::cluster::v3::OutlierDetection& config,
@@ -460,6 +479,8 @@ private:
   Event::TimerPtr interval_timer_;
   std::list<ChangeStateCb> callbacks_;
   absl::node_hash_map<HostSharedPtr, DetectorHostMonitorImpl*> host_monitors_;
+  // Scratch space for processSuccessRateEjections(). Empty outside of that function.
+  SuccessRateColumns success_rate_columns_;
   EventLoggerSharedPtr event_logger_;
   Common::CallbackHandlePtr member_update_cb_;
 
@@ -821,6 +821,8 @@ ClusterInfoImpl::ClusterInfoImpl(
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
           config.connection_pool_per_downstream_connection()),
+      share_http2_connection_pool_across_workers_(
+          config.share_http2_connection_pool_across_workers()),
       warm_hosts_(!config.health_checks().empty() &&
                   common_lb_config_.ignore_new_hosts_until_first_hc()),
       cluster_type_(
@@ -836,6 +838,13 @@ ClusterInfoImpl::ClusterInfoImpl(
                          "HttpProtocolOptions can be specified");
   }
 
+  if (connection_pool_per_downstream_connection_ && share_http2_connection_pool_across_workers_) {
+    throw EnvoyException(fmt::format("cluster: connection_pool_per_downstream_connection and "
+                                     "share_http2_connection_pool_across_workers may not both be "
+                                     "set for cluster {}",
+                                     name_));
+  }
+
   // If load_balancing_policy is set we will use it directly, ignoring lb_policy.
   if (config.has_load_balancing_policy()) {
     configureLbPolicies(config);
@@ -901,6 +910,11 @@ ClusterInfoImpl::ClusterInfoImpl(
     max_connection_duration_ = absl::nullopt;
   }
 
+  if (config.preconnect_policy().has_demand_time_constant()) {
+    preconnect_demand_time_constant_ = std::chrono::milliseconds(
+        DurationUtil::durationToMilliseconds(config.preconnect_policy().demand_time_constant()));
+  }
+
   if (config.has_eds_cluster_config()) {
     if (config.type() != envoy::config::cluster::v3::Cluster::EDS) {
       throw EnvoyException("eds_cluster_config set in a non-EDS cluster");
@@ -0,0 +1,277 @@
+#include "source/extensions/access_loggers/aggregate/aggregate_access_log_impl.h"
+
+#include <array>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/utility.h"
+#include "source/common/json/json_writer.h"
+#include "source/common/protobuf/utility.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+namespace {
+
+std::vector<Key> keysFromConfig(const AggregateAccessLogConfig& config) {
+  std::vector<Key> keys;
+  for (const int key : config.keys()) {
+    keys.push_back(static_cast<Key>(key));
+  }
+  return keys;
+}
+
+// Appends the value of a key, followed by the NUL character which terminates it.
+void appendKeyValue(Key key, const Http::RequestHeaderMap& request_headers,
+                    const StreamInfo::StreamInfo& stream_info, std::string& output) {
+  switch (key) {
+  case AggregateAccessLogConfig::ROUTE_NAME:
+    output.append(stream_info.getRouteName());
+    break;
+  case AggregateAccessLogConfig::UPSTREAM_CLUSTER: {
+    const absl::optional<Upstream::ClusterInfoConstSharedPtr> cluster_info =
+        stream_info.upstreamClusterInfo();
+    if (cluster_info.has_value() && cluster_info.value() != nullptr) {
+      output.append(cluster_info.value()->name());
+    }
+    break;
+  }
+  case AggregateAccessLogConfig::RESPONSE_CODE_CLASS: {
+    const absl::optional<uint32_t> response_code = stream_info.responseCode();
+    if (response_code.has_value() && response_code.value() > 0) {
+      absl::StrAppend(&output, response_code.value() / 100, "xx");
+    }
+    break;
+  }
+  case AggregateAccessLogConfig::RESPONSE_CODE: {
+    const absl::optional<uint32_t> response_code = stream_info.responseCode();
+    if (response_code.has_value() && response_code.value() > 0) {
+      absl::StrAppend(&output, response_code.value());
+    }
+    break;
+  }
+  case AggregateAccessLogConfig::REQUEST_METHOD:
+    absl::StrAppend(&output, request_headers.getMethodValue());
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+  output.push_back('\0');
+}
+
+} // namespace
+
+void Aggregate::merge(Aggregate& other, uint32_t max_exemplars) {
+  requests_ += other.requests_;
+  bytes_received_ += other.bytes_received_;
+  bytes_sent_ += other.bytes_sent_;
+  const histogram_t* other_durations = other.durations_.get();
+  hist_accumulate(durations_.get(), &other_durations, 1);
+  for (std::string& exemplar : other.exemplars_) {
+    if (exemplars_.size() >= max_exemplars) {
+      break;
+    }
+    exemplars_.push_back(std::move(exemplar));
+  }
+}
+
+Aggregate& AggregateTable::get(absl::string_view key, uint32_t max_keys) {
+  auto it = aggregates_.find(key);
+  if (it != aggregates_.end()) {
+    return it->second;
+  }
+  if (aggregates_.size() >= max_keys) {
+    return overflow_;
+  }
+  return aggregates_.try_emplace(std::string(key)).first->second;
+}
+
+void AggregateTable::merge(AggregateTable& other, uint32_t max_keys, uint32_t max_exemplars) {
+  if (empty()) {
+    std::swap(aggregates_, other.aggregates_);
+    std::swap(overflow_, other.overflow_);
+    return;
+  }
+  for (auto& [key, aggregate] : other.aggregates_) {
+    get(key, max_keys).merge(aggregate, max_exemplars);
+  }
+  overflow_.merge(other.overflow_, max_exemplars);
+  other.aggregates_.clear();
+  other.overflow_ = Aggregate();
+}
+
+Aggregator::Aggregator(AccessLog::AccessLogFileSharedPtr log_file, const std::vector<Key>& keys,
+                       uint32_t max_keys, uint32_t max_exemplars, TimeSource& time_source)
+    : log_file_(std::move(log_file)), max_keys_(max_keys), max_exemplars_(max_exemplars),
+      time_source_(time_source) {
+  for (const Key key : keys) {
+    key_names_.push_back(absl::AsciiStrToLower(AggregateAccessLogConfig::Key_Name(key)));
+  }
+}
+
+Aggregator::~Aggregator() { flush(); }
+
+void Aggregator::merge(AggregateTable& table) {
+  Thread::LockGuard lock(mutex_);
+  table_.merge(table, max_keys_, max_exemplars_);
+}
+
+void Aggregator::flush() {
+  AggregateTable table;
+  {
+    Thread::LockGuard lock(mutex_);
+    table.merge(table_, max_keys_, max_exemplars_);
+  }
+  if (table.empty()) {
+    return;
+  }
+
+  const std::string timestamp = AccessLogDateTimeFormatter::fromTime(time_source_.systemTime());
+  std::string output;
+  for (const auto& [key, aggregate] : table.aggregates_) {
+    writeSummary(timestamp, key, aggregate, false, output);
+  }
+  if (table.overflow_.requests_ > 0) {
+    writeSummary(timestamp, "", table.overflow_, true, output);
+  }
+  log_file_->write(output);
+}
+
+void Aggregator::writeSummary(const std::string& timestamp, absl::string_view key,
+                              const Aggregate& aggregate, bool overflow,
+                              std::string& output) const {
+  output.append("{\"timestamp\":");
+  Json::Writer::appendString(timestamp, output);
+  if (overflow) {
+    output.append(",\"overflow\":true");
+  } else {
+    const std::vector<absl::string_view> values = absl::StrSplit(key, '\0');
+    ASSERT(values.size() == key_names_.size() + 1);
+    for (size_t i = 0; i < key_names_.size(); i++) {
+      output.push_back(',');
+      Json::Writer::appendString(key_names_[i], output);
+      output.push_back(':');
+      Json::Writer::appendString(values[i], output);
+    }
+  }
+  absl::StrAppend(&output, ",\"requests\":", aggregate.requests_,
+                  ",\"bytes_received\":", aggregate.bytes_received_,
+                  ",\"bytes_sent\":", aggregate.bytes_sent_);
+
+  if (hist_sample_count(aggregate.durations_.get()) > 0) {
+    static constexpr std::array<double, 4> quantiles = {0.5, 0.9, 0.99, 1.0};
+    static constexpr std::array<absl::string_view, 4> names = {"p50", "p90", "p99", "max"};
+    std::array<double, 4> values;
+    hist_approx_quantile(aggregate.durations_.get(), quantiles.data(), quantiles.size(),
+                         values.data());
+    output.append(",\"duration_ms\":{");
+    for (size_t i = 0; i < values.size(); i++) {
+      absl::StrAppend(&output, i > 0 ? "," : "", "\"", names[i], "\":");
+      Json::Writer::appendNumber(values[i], output);
+    }
+    output.push_back('}');
+  }
+
+  if (!aggregate.exemplars_.empty()) {
+    output.append(",\"exemplars\":[");
+    for (size_t i = 0; i < aggregate.exemplars_.size(); i++) {
+      if (i > 0) {
+        output.push_back(',');
+      }
+      Json::Writer::appendString(aggregate.exemplars_[i], output);
+    }
+    output.push_back(']');
+  }
+  output.append("}\n");
+}
+
+AggregateAccessLog::AggregateAccessLog(AccessLog::FilterPtr&& filter,
+                                       const AggregateAccessLogConfig& config,
+                                       Formatter::FormatterPtr&& exemplar_formatter,
+                                       AccessLog::AccessLogManager& log_manager,
+                                       ThreadLocal::SlotAllocator& tls,
+                                       Event::Dispatcher& main_thread_dispatcher,
+                                       Random::RandomGenerator& random_generator,
+                                       TimeSource& time_source)
+    : Common::ImplBase(std::move(filter)), keys_(keysFromConfig(config)),
+      exemplar_formatter_(std::move(exemplar_formatter)), random_generator_(random_generator),
+      flush_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, flush_interval, 10000)),
+      aggregator_(std::make_shared<Aggregator>(
+          log_manager.createAccessLog(
+              Filesystem::FilePathAndType{Filesystem::DestinationType::File, config.path()}),
+          keys_, PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_keys, 1000),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, exemplars_per_key, 1), time_source)),
+      tls_slot_(tls), flush_timer_(main_thread_dispatcher.createTimer([this]() { collect(); })) {
+  tls_slot_.set([aggregator = aggregator_](Event::Dispatcher&) {
+    return std::make_shared<ThreadLocalAggregates>(aggregator);
+  });
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+void AggregateAccessLog::collect() {
+  // The aggregator is flushed once every worker has handed over its aggregates. It outlives this
+  // access log if the access log goes away in the meantime.
+  tls_slot_.runOnAllThreads(
+      [aggregator = aggregator_](OptRef<ThreadLocalAggregates> aggregates) {
+        if (aggregates.has_value()) {
+          aggregator->merge(aggregates->table_);
+        }
+      },
+      [aggregator = aggregator_]() { aggregator->flush(); });
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+void AggregateAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info) {
+  ThreadLocalAggregates& aggregates = *tls_slot_;
+  aggregates.key_.clear();
+  for (const Key key : keys_) {
+    appendKeyValue(key, request_headers, stream_info, aggregates.key_);
+  }
+
+  Aggregate& aggregate = aggregates.table_.get(aggregates.key_, aggregator_->maxKeys());
+  aggregate.requests_++;
+  aggregate.bytes_received_ += stream_info.bytesReceived();
+  aggregate.bytes_sent_ += stream_info.bytesSent();
+  const absl::optional<std::chrono::nanoseconds> duration = stream_info.requestComplete();
+  if (duration.has_value()) {
+    hist_insert(aggregate.durations_.get(),
+                std::chrono::duration<double, std::milli>(duration.value()).count(), 1);
+  }
+
+  // Reservoir sampling: every entry of the interval is equally likely to end up as an exemplar,
+  // and only the entries which are kept are formatted.
+  const uint32_t max_exemplars = aggregator_->maxExemplars();
+  if (max_exemplars == 0) {
+    return;
+  }
+  uint64_t index = aggregate.exemplars_.size();
+  if (index >= max_exemplars) {
+    index = random_generator_.random() % aggregate.requests_;
+    if (index >= max_exemplars) {
+      return;
+    }
+  }
+  std::string exemplar = exemplar_formatter_->format(request_headers, response_headers,
+                                                     response_trailers, stream_info,
+                                                     absl::string_view());
+  exemplar.erase(exemplar.find_last_not_of('\n') + 1);
+  if (index == aggregate.exemplars_.size()) {
+    aggregate.exemplars_.push_back(std::move(exemplar));
+  } else {
+    aggregate.exemplars_[index] = std::move(exemplar);
+  }
+}
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+#include "envoy/formatter/substitution_formatter.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/thread.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "circllhist.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+using AggregateAccessLogConfig =
+    envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog;
+using Key = AggregateAccessLogConfig::Key;
+
+/**
+ * The request count, byte totals, duration distribution and exemplars of the entries logged with
+ * one key.
+ */
+struct Aggregate {
+  Aggregate() : durations_(hist_alloc(), hist_free) {}
+
+  /**
+   * Adds the totals and moves the exemplars of another aggregate into this one, keeping at most
+   * max_exemplars exemplars.
+   */
+  void merge(Aggregate& other, uint32_t max_exemplars);
+
+  uint64_t requests_{};
+  uint64_t bytes_received_{};
+  uint64_t bytes_sent_{};
+  // Durations in milliseconds.
+  std::unique_ptr<histogram_t, decltype(&hist_free)> durations_;
+  std::vector<std::string> exemplars_;
+};
+
+/**
+ * The aggregates of an interval, indexed by key. A key is the concatenation of its values, each
+ * followed by a NUL character.
+ */
+class AggregateTable {
+public:
+  /**
+   * @return the aggregate of a key. Once the table holds max_keys keys, entries with other keys are
+   *         aggregated into the overflow aggregate instead.
+   */
+  Aggregate& get(absl::string_view key, uint32_t max_keys);
+
+  /**
+   * Moves the aggregates of another table into this one, leaving the other table empty.
+   */
+  void merge(AggregateTable& other, uint32_t max_keys, uint32_t max_exemplars);
+
+  bool empty() const { return aggregates_.empty() && overflow_.requests_ == 0; }
+
+  absl::flat_hash_map<std::string, Aggregate> aggregates_;
+  Aggregate overflow_;
+};
+
+/**
+ * Collects the aggregates of all workers and writes out their summaries. Shared by the access log,
+ * its per-worker tables and the callbacks which collect them, so that whatever has been aggregated
+ * is written even when the access log goes away during a collection.
+ */
+class Aggregator {
+public:
+  Aggregator(AccessLog::AccessLogFileSharedPtr log_file, const std::vector<Key>& keys,
+             uint32_t max_keys, uint32_t max_exemplars, TimeSource& time_source);
+  ~Aggregator();
+
+  /**
+   * Moves the aggregates of a worker into the aggregates of the interval. May be called from any
+   * thread.
+   */
+  void merge(AggregateTable& table);
+
+  /**
+   * Writes out a summary of each key aggregated since the last flush.
+   */
+  void flush();
+
+  uint32_t maxKeys() const { return max_keys_; }
+  uint32_t maxExemplars() const { return max_exemplars_; }
+
+private:
+  void writeSummary(const std::string& timestamp, absl::string_view key, const Aggregate& aggregate,
+                    bool overflow, std::string& output) const;
+
+  const AccessLog::AccessLogFileSharedPtr log_file_;
+  // The names of the keys in the summaries.
+  std::vector<std::string> key_names_;
+  const uint32_t max_keys_;
+  const uint32_t max_exemplars_;
+  TimeSource& time_source_;
+  Thread::MutexBasicLockable mutex_;
+  AggregateTable table_ ABSL_GUARDED_BY(mutex_);
+};
+
+using AggregatorSharedPtr = std::shared_ptr<Aggregator>;
+
+/**
+ * Access log Instance that aggregates entries by key on each worker. A timer on the main thread
+ * collects the aggregates of all workers and writes out their summaries.
+ */
+class AggregateAccessLog : public Common::ImplBase {
+public:
+  AggregateAccessLog(AccessLog::FilterPtr&& filter, const AggregateAccessLogConfig& config,
+                     Formatter::FormatterPtr&& exemplar_formatter,
+                     AccessLog::AccessLogManager& log_manager, ThreadLocal::SlotAllocator& tls,
+                     Event::Dispatcher& main_thread_dispatcher,
+                     Random::RandomGenerator& random_generator, TimeSource& time_source);
+
+private:
+  /**
+   * Per-thread aggregates of the current interval. Hands them over to the aggregator when it is
+   * destroyed.
+   */
+  struct ThreadLocalAggregates : public ThreadLocal::ThreadLocalObject {
+    explicit ThreadLocalAggregates(AggregatorSharedPtr aggregator)
+        : aggregator_(std::move(aggregator)) {}
+    ~ThreadLocalAggregates() override { aggregator_->merge(table_); }
+
+    const AggregatorSharedPtr aggregator_;
+    AggregateTable table_;
+    // Scratch space for building keys, to avoid an allocation per entry.
+    std::string key_;
+  };
+
+  void collect();
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  const std::vector<Key> keys_;
+  const Formatter::FormatterPtr exemplar_formatter_;
+  Random::RandomGenerator& random_generator_;
+  const std::chrono::milliseconds flush_interval_;
+  const AggregatorSharedPtr aggregator_;
+  ThreadLocal::TypedSlot<ThreadLocalAggregates> tls_slot_;
+  const Event::TimerPtr flush_timer_;
+};
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
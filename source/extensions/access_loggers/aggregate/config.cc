@@ -0,0 +1,52 @@
+#include "source/extensions/access_loggers/aggregate/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/formatter/substitution_format_string.h"
+#include "source/common/formatter/substitution_formatter.h"
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/access_loggers/aggregate/aggregate_access_log_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+
+AccessLog::InstanceSharedPtr AggregateAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::CommonFactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<const AggregateAccessLogConfig&>(
+      config, context.messageValidationVisitor());
+  Formatter::FormatterPtr exemplar_formatter;
+  if (proto_config.has_exemplar_format()) {
+    exemplar_formatter =
+        Formatter::SubstitutionFormatStringUtils::fromProtoConfig(proto_config.exemplar_format(),
+                                                                  context);
+  } else {
+    exemplar_formatter = Formatter::SubstitutionFormatUtils::defaultSubstitutionFormatter();
+  }
+  return std::make_shared<AggregateAccessLog>(
+      std::move(filter), proto_config, std::move(exemplar_formatter), context.accessLogManager(),
+      context.threadLocal(), context.mainThreadDispatcher(), context.api().randomGenerator(),
+      context.timeSource());
+}
+
+ProtobufTypes::MessagePtr AggregateAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<AggregateAccessLogConfig>();
+}
+
+std::string AggregateAccessLogFactory::name() const { return "envoy.access_loggers.aggregate"; }
+
+/**
+ * Static registration for the aggregate access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(AggregateAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
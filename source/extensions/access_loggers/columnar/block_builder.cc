@@ -0,0 +1,254 @@
+#include "source/extensions/access_loggers/columnar/block_builder.h"
+
+#include <chrono>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/http/utility.h"
+#include "source/common/stream_info/utility.h"
+#include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+namespace {
+
+void appendVarint(std::string& output, uint64_t value) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+absl::optional<absl::string_view> headerValue(absl::string_view value) {
+  if (value.empty()) {
+    return absl::nullopt;
+  }
+  return value;
+}
+
+uint64_t toMicroseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+} // namespace
+
+ColumnType columnType(Field field) {
+  switch (field) {
+  case ColumnarAccessLogConfig::START_TIME:
+    return ColumnType::Delta;
+  case ColumnarAccessLogConfig::DURATION:
+  case ColumnarAccessLogConfig::RESPONSE_CODE:
+  case ColumnarAccessLogConfig::BYTES_RECEIVED:
+  case ColumnarAccessLogConfig::BYTES_SENT:
+    return ColumnType::Integer;
+  case ColumnarAccessLogConfig::REQUEST_PATH:
+  case ColumnarAccessLogConfig::DOWNSTREAM_REMOTE_ADDRESS:
+    return ColumnType::String;
+  case ColumnarAccessLogConfig::RESPONSE_FLAGS:
+  case ColumnarAccessLogConfig::RESPONSE_CODE_DETAILS:
+  case ColumnarAccessLogConfig::UPSTREAM_CLUSTER:
+  case ColumnarAccessLogConfig::UPSTREAM_HOST:
+  case ColumnarAccessLogConfig::ROUTE_NAME:
+  case ColumnarAccessLogConfig::PROTOCOL:
+  case ColumnarAccessLogConfig::REQUEST_METHOD:
+  case ColumnarAccessLogConfig::REQUEST_AUTHORITY:
+    return ColumnType::Dictionary;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+BlockBuilder::BlockBuilder(const std::vector<Field>& fields) {
+  columns_.reserve(fields.size());
+  for (const Field field : fields) {
+    columns_.emplace_back(field);
+  }
+}
+
+void BlockBuilder::add(const Http::RequestHeaderMap& request_headers,
+                       const StreamInfo::StreamInfo& stream_info) {
+  for (Column& column : columns_) {
+    addValue(column, request_headers, stream_info);
+  }
+  entries_++;
+}
+
+void BlockBuilder::addValue(Column& column, const Http::RequestHeaderMap& request_headers,
+                            const StreamInfo::StreamInfo& stream_info) {
+  switch (column.field_) {
+  case ColumnarAccessLogConfig::START_TIME:
+    addDelta(column, toMicroseconds(stream_info.startTime().time_since_epoch()));
+    break;
+  case ColumnarAccessLogConfig::DURATION: {
+    const absl::optional<std::chrono::nanoseconds> duration = stream_info.requestComplete();
+    addInteger(column, duration.has_value() ? absl::make_optional(toMicroseconds(duration.value()))
+                                            : absl::nullopt);
+    break;
+  }
+  case ColumnarAccessLogConfig::RESPONSE_CODE: {
+    const absl::optional<uint32_t> response_code = stream_info.responseCode();
+    addInteger(column, response_code.has_value() ? absl::make_optional<uint64_t>(*response_code)
+                                                 : absl::nullopt);
+    break;
+  }
+  case ColumnarAccessLogConfig::RESPONSE_FLAGS:
+    addDictionary(column, StreamInfo::ResponseFlagUtils::toShortString(stream_info));
+    break;
+  case ColumnarAccessLogConfig::RESPONSE_CODE_DETAILS: {
+    const absl::optional<std::string>& details = stream_info.responseCodeDetails();
+    addDictionary(column, details.has_value() ? absl::make_optional<absl::string_view>(*details)
+                                              : absl::nullopt);
+    break;
+  }
+  case ColumnarAccessLogConfig::UPSTREAM_CLUSTER: {
+    const absl::optional<Upstream::ClusterInfoConstSharedPtr> cluster_info =
+        stream_info.upstreamClusterInfo();
+    if (cluster_info.has_value() && cluster_info.value() != nullptr) {
+      addDictionary(column, cluster_info.value()->name());
+    } else {
+      addDictionary(column, absl::nullopt);
+    }
+    break;
+  }
+  case ColumnarAccessLogConfig::UPSTREAM_HOST: {
+    const Upstream::HostDescriptionConstSharedPtr host = stream_info.upstreamHost();
+    if (host != nullptr && host->address() != nullptr) {
+      addDictionary(column, host->address()->asStringView());
+    } else {
+      addDictionary(column, absl::nullopt);
+    }
+    break;
+  }
+  case ColumnarAccessLogConfig::ROUTE_NAME:
+    addDictionary(column, headerValue(stream_info.getRouteName()));
+    break;
+  case ColumnarAccessLogConfig::PROTOCOL: {
+    const absl::optional<Http::Protocol> protocol = stream_info.protocol();
+    addDictionary(column, protocol.has_value()
+                              ? absl::make_optional<absl::string_view>(
+                                    Http::Utility::getProtocolString(protocol.value()))
+                              : absl::nullopt);
+    break;
+  }
+  case ColumnarAccessLogConfig::REQUEST_METHOD:
+    addDictionary(column, headerValue(request_headers.getMethodValue()));
+    break;
+  case ColumnarAccessLogConfig::REQUEST_AUTHORITY:
+    addDictionary(column, headerValue(request_headers.getHostValue()));
+    break;
+  case ColumnarAccessLogConfig::REQUEST_PATH:
+    addString(column, headerValue(request_headers.getPathValue()));
+    break;
+  case ColumnarAccessLogConfig::BYTES_RECEIVED:
+    addInteger(column, stream_info.bytesReceived());
+    break;
+  case ColumnarAccessLogConfig::BYTES_SENT:
+    addInteger(column, stream_info.bytesSent());
+    break;
+  case ColumnarAccessLogConfig::DOWNSTREAM_REMOTE_ADDRESS: {
+    const Network::Address::InstanceConstSharedPtr& address =
+        stream_info.downstreamAddressProvider().remoteAddress();
+    addString(column, address != nullptr ? absl::make_optional(address->asStringView())
+                                         : absl::nullopt);
+    break;
+  }
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+void BlockBuilder::addInteger(Column& column, absl::optional<uint64_t> value) {
+  appendVarint(column.data_, value.has_value() ? value.value() + 1 : 0);
+}
+
+void BlockBuilder::addDelta(Column& column, int64_t value) {
+  appendVarint(column.data_, zigzag(value - column.last_value_));
+  column.last_value_ = value;
+}
+
+void BlockBuilder::addString(Column& column, absl::optional<absl::string_view> value) {
+  if (!value.has_value()) {
+    appendVarint(column.data_, 0);
+    return;
+  }
+  appendVarint(column.data_, value->size() + 1);
+  column.data_.append(value->data(), value->size());
+}
+
+void BlockBuilder::addDictionary(Column& column, absl::optional<absl::string_view> value) {
+  if (!value.has_value()) {
+    appendVarint(column.data_, 0);
+    return;
+  }
+  auto it = column.dictionary_index_.find(value.value());
+  if (it == column.dictionary_index_.end()) {
+    it = column.dictionary_index_.emplace(std::string(value.value()), column.dictionary_.size())
+             .first;
+    column.dictionary_.push_back(&it->first);
+  }
+  appendVarint(column.data_, it->second + 1);
+}
+
+void BlockBuilder::finish(Buffer::Instance& output) {
+  std::string header;
+  appendVarint(header, entries_);
+  appendVarint(header, columns_.size());
+  output.add(header);
+
+  for (Column& column : columns_) {
+    std::string dictionary;
+    if (column.type_ == ColumnType::Dictionary) {
+      appendVarint(dictionary, column.dictionary_.size());
+      for (const std::string* value : column.dictionary_) {
+        appendVarint(dictionary, value->size());
+        dictionary.append(*value);
+      }
+    }
+
+    header.clear();
+    appendVarint(header, column.field_);
+    header.push_back(static_cast<char>(column.type_));
+    appendVarint(header, dictionary.size() + column.data_.size());
+    output.add(header);
+    output.add(dictionary);
+    output.add(column.data_);
+
+    column.data_.clear();
+    column.last_value_ = 0;
+    column.dictionary_index_.clear();
+    column.dictionary_.clear();
+  }
+  entries_ = 0;
+}
+
+void BlockWriter::write(Buffer::Instance& payload) {
+  if (compression_ == ColumnarAccessLogConfig::GZIP) {
+    using Compression::Gzip::Compressor::ZlibCompressorImpl;
+    // Each block is a gzip member of its own, so that blocks can be read independently.
+    ZlibCompressorImpl compressor;
+    compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                    ZlibCompressorImpl::CompressionStrategy::Standard, 15 | 16, 8);
+    compressor.compress(payload, Envoy::Compression::Compressor::State::Finish);
+  }
+
+  std::string header(MAGIC);
+  header.push_back(static_cast<char>(compression_));
+  appendVarint(header, payload.length());
+
+  Buffer::OwnedImpl block(header);
+  block.move(payload);
+  log_file_->write(block.toString());
+}
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/stream_info/stream_info.h"
+
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+using ColumnarAccessLogConfig = envoy::extensions::access_loggers::columnar::v3::ColumnarAccessLog;
+using Field = ColumnarAccessLogConfig::Field;
+
+/**
+ * How the values of a column are encoded. All integers are unsigned LEB128 varints.
+ */
+enum class ColumnType : uint8_t {
+  // Each value is stored as the value plus one, with zero meaning that it was not set.
+  Integer = 0,
+  // Each value is stored as the zigzag encoded difference from the previous value of the column.
+  // The first value is stored as the difference from zero.
+  Delta = 1,
+  // Each value is stored as its length plus one followed by its bytes, with a length of zero
+  // meaning that it was not set.
+  String = 2,
+  // The column starts with the number of distinct values, each stored as a String without the plus
+  // one. Each value is then stored as its index in the dictionary plus one, with zero meaning that
+  // it was not set.
+  Dictionary = 3,
+};
+
+/**
+ * @return the type of the column a field is stored in.
+ */
+ColumnType columnType(Field field);
+
+/**
+ * Builds the payload of a block of the columnar access log, one entry at a time. A payload is laid
+ * out as:
+ *
+ *   entry count, column count
+ *   for each column: field, type (one byte), column length, column
+ *
+ * where a column holds the values of a field for all of the entries of the block, encoded as
+ * described in ColumnType. The column length allows readers to skip the columns they do not need.
+ * Not thread safe: each worker builds blocks of its own.
+ */
+class BlockBuilder {
+public:
+  explicit BlockBuilder(const std::vector<Field>& fields);
+
+  /**
+   * Add an entry to the block.
+   */
+  void add(const Http::RequestHeaderMap& request_headers,
+           const StreamInfo::StreamInfo& stream_info);
+
+  /**
+   * @return the number of entries added to the block so far.
+   */
+  uint32_t entries() const { return entries_; }
+
+  /**
+   * Append the payload of the block to the output and start a new, empty, block.
+   */
+  void finish(Buffer::Instance& output);
+
+private:
+  struct Column {
+    Column(Field field) : field_(field), type_(columnType(field)) {}
+
+    const Field field_;
+    const ColumnType type_;
+    std::string data_;
+    // Only used by Delta columns.
+    int64_t last_value_{};
+    // Only used by Dictionary columns. The index of each value, and the values in index order.
+    absl::node_hash_map<std::string, uint32_t> dictionary_index_;
+    std::vector<const std::string*> dictionary_;
+  };
+
+  static void addInteger(Column& column, absl::optional<uint64_t> value);
+  static void addDelta(Column& column, int64_t value);
+  static void addString(Column& column, absl::optional<absl::string_view> value);
+  static void addDictionary(Column& column, absl::optional<absl::string_view> value);
+  static void addValue(Column& column, const Http::RequestHeaderMap& request_headers,
+                       const StreamInfo::StreamInfo& stream_info);
+
+  std::vector<Column> columns_;
+  uint32_t entries_{};
+};
+
+/**
+ * Frames block payloads and writes them to the access log file. A file is a sequence of blocks,
+ * each laid out as:
+ *
+ *   magic ("EACL"), compression (one byte), payload length, payload
+ *
+ * where the compression is the value of ColumnarAccessLog.Compression which the payload is
+ * compressed with. Thread safe.
+ */
+class BlockWriter {
+public:
+  BlockWriter(AccessLog::AccessLogFileSharedPtr log_file,
+              ColumnarAccessLogConfig::Compression compression)
+      : log_file_(std::move(log_file)), compression_(compression) {}
+
+  /**
+   * Write a block with the given payload. The payload is drained.
+   */
+  void write(Buffer::Instance& payload);
+
+  static constexpr absl::string_view MAGIC = "EACL";
+
+private:
+  const AccessLog::AccessLogFileSharedPtr log_file_;
+  const ColumnarAccessLogConfig::Compression compression_;
+};
+
+using BlockWriterSharedPtr = std::shared_ptr<BlockWriter>;
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
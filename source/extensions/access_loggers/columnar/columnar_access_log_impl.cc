@@ -0,0 +1,74 @@
+#include "source/extensions/access_loggers/columnar/columnar_access_log_impl.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+ColumnarAccessLog::ThreadLocalBlock::ThreadLocalBlock(const std::vector<Field>& fields,
+                                                      uint32_t max_entries_per_block,
+                                                      std::chrono::milliseconds flush_interval,
+                                                      BlockWriterSharedPtr writer,
+                                                      Event::Dispatcher& dispatcher)
+    : builder_(fields), max_entries_per_block_(max_entries_per_block),
+      flush_interval_(flush_interval), writer_(std::move(writer)),
+      flush_timer_(dispatcher.createTimer([this]() {
+        flush();
+        flush_timer_->enableTimer(flush_interval_);
+      })) {
+  flush_timer_->enableTimer(flush_interval_);
+}
+
+ColumnarAccessLog::ThreadLocalBlock::~ThreadLocalBlock() { flush(); }
+
+void ColumnarAccessLog::ThreadLocalBlock::flush() {
+  if (builder_.entries() == 0) {
+    return;
+  }
+  Buffer::OwnedImpl payload;
+  builder_.finish(payload);
+  writer_->write(payload);
+}
+
+ColumnarAccessLog::ColumnarAccessLog(AccessLog::FilterPtr&& filter,
+                                     const ColumnarAccessLogConfig& config,
+                                     AccessLog::AccessLogManager& log_manager,
+                                     ThreadLocal::SlotAllocator& tls)
+    : Common::ImplBase(std::move(filter)), tls_slot_(tls.allocateSlot()) {
+  std::vector<Field> fields;
+  for (const int field : config.fields()) {
+    fields.push_back(static_cast<Field>(field));
+  }
+  const uint32_t max_entries_per_block =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries_per_block, 1024);
+  const std::chrono::milliseconds flush_interval(
+      PROTOBUF_GET_MS_OR_DEFAULT(config, flush_interval, 1000));
+  auto writer = std::make_shared<BlockWriter>(
+      log_manager.createAccessLog(
+          Filesystem::FilePathAndType{Filesystem::DestinationType::File, config.path()}),
+      config.compression());
+
+  tls_slot_->set([fields, max_entries_per_block, flush_interval,
+                  writer](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalBlock>(fields, max_entries_per_block, flush_interval,
+                                              writer, dispatcher);
+  });
+}
+
+void ColumnarAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
+                                const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
+                                const StreamInfo::StreamInfo& stream_info) {
+  auto& block = tls_slot_->getTyped<ThreadLocalBlock>();
+  block.builder_.add(request_headers, stream_info);
+  if (block.builder_.entries() >= block.max_entries_per_block_) {
+    block.flush();
+  }
+}
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/extensions/access_loggers/columnar/block_builder.h"
+#include "source/extensions/access_loggers/common/access_log_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+/**
+ * Access log Instance that batches the entries of each worker into columnar blocks, which are
+ * written to a file once they are full or the flush interval has passed.
+ */
+class ColumnarAccessLog : public Common::ImplBase {
+public:
+  ColumnarAccessLog(AccessLog::FilterPtr&& filter, const ColumnarAccessLogConfig& config,
+                    AccessLog::AccessLogManager& log_manager, ThreadLocal::SlotAllocator& tls);
+
+private:
+  /**
+   * Per-thread block which is being built. Writes out what it has buffered when it is destroyed.
+   */
+  struct ThreadLocalBlock : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalBlock(const std::vector<Field>& fields, uint32_t max_entries_per_block,
+                     std::chrono::milliseconds flush_interval, BlockWriterSharedPtr writer,
+                     Event::Dispatcher& dispatcher);
+    ~ThreadLocalBlock() override;
+
+    void flush();
+
+    BlockBuilder builder_;
+    const uint32_t max_entries_per_block_;
+    const std::chrono::milliseconds flush_interval_;
+    const BlockWriterSharedPtr writer_;
+    const Event::TimerPtr flush_timer_;
+  };
+
+  // Common::ImplBase
+  void emitLog(const Http::RequestHeaderMap& request_headers,
+               const Http::ResponseHeaderMap& response_headers,
+               const Http::ResponseTrailerMap& response_trailers,
+               const StreamInfo::StreamInfo& stream_info) override;
+
+  const ThreadLocal::SlotPtr tls_slot_;
+};
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
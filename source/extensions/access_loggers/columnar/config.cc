@@ -0,0 +1,40 @@
+#include "source/extensions/access_loggers/columnar/config.h"
+
+#include <memory>
+
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/access_loggers/columnar/columnar_access_log_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+
+AccessLog::InstanceSharedPtr ColumnarAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter,
+    Server::Configuration::CommonFactoryContext& context) {
+  const auto& proto_config = MessageUtil::downcastAndValidate<const ColumnarAccessLogConfig&>(
+      config, context.messageValidationVisitor());
+  return std::make_shared<ColumnarAccessLog>(std::move(filter), proto_config,
+                                             context.accessLogManager(), context.threadLocal());
+}
+
+ProtobufTypes::MessagePtr ColumnarAccessLogFactory::createEmptyConfigProto() {
+  return std::make_unique<ColumnarAccessLogConfig>();
+}
+
+std::string ColumnarAccessLogFactory::name() const { return "envoy.access_loggers.columnar"; }
+
+/**
+ * Static registration for the columnar access log. @see RegisterFactory.
+ */
+REGISTER_FACTORY(ColumnarAccessLogFactory, Server::Configuration::AccessLogInstanceFactory);
+
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
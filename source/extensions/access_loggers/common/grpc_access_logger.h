@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/config/core/v3/config_source.pb.h"
 #include "envoy/event/dispatcher.h"
@@ -10,6 +11,8 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/lock_guard.h"
+#include "source/common/common/thread.h"
 #include "source/common/grpc/typed_async_client.h"
 #include "source/common/protobuf/utility.h"
 
@@ -38,6 +41,8 @@ namespace Detail {
 template <typename HttpLogProto, typename TcpLogProto> class GrpcAccessLogger {
 public:
   using SharedPtr = std::shared_ptr<GrpcAccessLogger>;
+  using HttpLogProtoType = HttpLogProto;
+  using TcpLogProtoType = TcpLogProto;
 
   virtual ~GrpcAccessLogger() = default;
 
@@ -239,6 +244,117 @@ private:
   GrpcAccessLoggerStats stats_;
 };
 
+/**
+ * Logger shared by all threads when the entries are exported from the main thread. It queues the
+ * entries logged on any thread and hands them over to the logger which batches and sends them on
+ * the main thread, so that the workers do not spend time encoding and sending messages.
+ */
+template <typename HttpLogProto, typename TcpLogProto>
+class SharedGrpcAccessLogger
+    : public Detail::GrpcAccessLogger<HttpLogProto, TcpLogProto>,
+      public std::enable_shared_from_this<SharedGrpcAccessLogger<HttpLogProto, TcpLogProto>> {
+public:
+  using Interface = Detail::GrpcAccessLogger<HttpLogProto, TcpLogProto>;
+
+  SharedGrpcAccessLogger(Event::Dispatcher& main_thread_dispatcher, uint32_t max_queued_entries,
+                         GrpcAccessLoggerStats stats)
+      : main_thread_dispatcher_(main_thread_dispatcher), max_queued_entries_(max_queued_entries),
+        stats_(stats) {}
+
+  /**
+   * Sets the logger which sends the entries, and hands it the entries queued so far. Called on the
+   * main thread.
+   * @param logger supplies the logger.
+   */
+  void setLogger(typename Interface::SharedPtr logger) {
+    ASSERT(main_thread_dispatcher_.isThreadSafe());
+    logger_ = std::move(logger);
+    drain();
+  }
+
+  void log(HttpLogProto&& entry) override {
+    bool first = false;
+    {
+      Thread::LockGuard lock(mutex_);
+      if (!reserveLocked(first)) {
+        return;
+      }
+      http_entries_.push_back(std::move(entry));
+    }
+    if (first) {
+      postDrain();
+    }
+  }
+
+  void log(TcpLogProto&& entry) override {
+    bool first = false;
+    {
+      Thread::LockGuard lock(mutex_);
+      if (!reserveLocked(first)) {
+        return;
+      }
+      tcp_entries_.push_back(std::move(entry));
+    }
+    if (first) {
+      postDrain();
+    }
+  }
+
+private:
+  // Makes room for an entry in the queue, or counts it as dropped if the queue is full. Sets first
+  // if the entry is the first one since the queue was last drained.
+  bool reserveLocked(bool& first) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (queued_entries_ >= max_queued_entries_) {
+      stats_.logs_dropped_.inc();
+      return false;
+    }
+    first = queued_entries_ == 0;
+    queued_entries_++;
+    return true;
+  }
+
+  // Only the first entry of a batch posts a drain. Entries queued before it runs are handed over
+  // by the same drain.
+  void postDrain() {
+    main_thread_dispatcher_.post([weak_this = this->weak_from_this()]() {
+      if (auto shared_this = weak_this.lock()) {
+        shared_this->drain();
+      }
+    });
+  }
+
+  void drain() {
+    if (logger_ == nullptr) {
+      // The entries are handed over once the main thread has set up the logger.
+      return;
+    }
+    std::vector<HttpLogProto> http_entries;
+    std::vector<TcpLogProto> tcp_entries;
+    {
+      Thread::LockGuard lock(mutex_);
+      http_entries.swap(http_entries_);
+      tcp_entries.swap(tcp_entries_);
+      queued_entries_ = 0;
+    }
+    for (HttpLogProto& entry : http_entries) {
+      logger_->log(std::move(entry));
+    }
+    for (TcpLogProto& entry : tcp_entries) {
+      logger_->log(std::move(entry));
+    }
+  }
+
+  Event::Dispatcher& main_thread_dispatcher_;
+  const uint32_t max_queued_entries_;
+  GrpcAccessLoggerStats stats_;
+  // Only used on the main thread.
+  typename Interface::SharedPtr logger_;
+  Thread::MutexBasicLockable mutex_;
+  std::vector<HttpLogProto> http_entries_ ABSL_GUARDED_BY(mutex_);
+  std::vector<TcpLogProto> tcp_entries_ ABSL_GUARDED_BY(mutex_);
+  uint32_t queued_entries_ ABSL_GUARDED_BY(mutex_){};
+};
+
 /**
  * Class for defining logger cache with the `GrpcAccessLogger` interface and
  * `ConfigProto` configuration.
@@ -250,8 +366,11 @@ public:
   using Interface = Detail::GrpcAccessLoggerCache<GrpcAccessLogger, ConfigProto>;
 
   GrpcAccessLoggerCache(Grpc::AsyncClientManager& async_client_manager, Stats::Scope& scope,
-                        ThreadLocal::SlotAllocator& tls)
-      : scope_(scope), async_client_manager_(async_client_manager), tls_slot_(tls.allocateSlot()) {
+                        ThreadLocal::SlotAllocator& tls, Event::Dispatcher& main_thread_dispatcher,
+                        std::string access_log_prefix)
+      : scope_(scope), async_client_manager_(async_client_manager),
+        main_thread_dispatcher_(main_thread_dispatcher),
+        access_log_prefix_(std::move(access_log_prefix)), tls_slot_(tls.allocateSlot()) {
     tls_slot_->set([](Event::Dispatcher& dispatcher) {
       return std::make_shared<ThreadLocalCache>(dispatcher);
     });
@@ -266,24 +385,59 @@ public:
     if (it != cache.access_loggers_.end()) {
       return it->second;
     }
+    const auto logger = config.has_shared_export_queue_size()
+                            ? getOrCreateSharedLogger(config, cache_key, cache.dispatcher_)
+                            : createThreadLogger(config, cache.dispatcher_);
+    cache.access_loggers_.emplace(cache_key, logger);
+    return logger;
+  }
+
+protected:
+  Stats::Scope& scope_;
+
+private:
+  using CacheKey = std::pair<std::size_t, Common::GrpcAccessLoggerType>;
+  using SharedLogger =
+      SharedGrpcAccessLogger<typename GrpcAccessLogger::Interface::HttpLogProtoType,
+                             typename GrpcAccessLogger::Interface::TcpLogProtoType>;
+
+  typename GrpcAccessLogger::SharedPtr createThreadLogger(const ConfigProto& config,
+                                                          Event::Dispatcher& dispatcher) {
     // We pass skip_cluster_check=true to factoryForGrpcService in order to avoid throwing
     // exceptions in worker threads. Call sites of this getOrCreateLogger must check the cluster
     // availability via ClusterManager::checkActiveStaticCluster beforehand, and throw exceptions in
     // the main thread if necessary.
     auto client = async_client_manager_.factoryForGrpcService(config.grpc_service(), scope_, true)
                       ->createUncachedRawAsyncClient();
-    const auto logger = createLogger(
+    return createLogger(
         config, std::move(client),
         std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
-        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_);
-    cache.access_loggers_.emplace(cache_key, logger);
-    return logger;
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), dispatcher);
   }
 
-protected:
-  Stats::Scope& scope_;
+  typename GrpcAccessLogger::SharedPtr getOrCreateSharedLogger(const ConfigProto& config,
+                                                               const CacheKey& cache_key,
+                                                               Event::Dispatcher& dispatcher) {
+    std::shared_ptr<SharedLogger> shared_logger;
+    {
+      Thread::LockGuard lock(shared_loggers_mutex_);
+      auto& entry = shared_loggers_[cache_key];
+      if (entry == nullptr) {
+        entry = std::make_shared<SharedLogger>(
+            main_thread_dispatcher_, config.shared_export_queue_size().value(),
+            GrpcAccessLoggerStats{
+                ALL_GRPC_ACCESS_LOGGER_STATS(POOL_COUNTER_PREFIX(scope_, access_log_prefix_))});
+      }
+      shared_logger = entry;
+    }
+    // The thread local slot is set up on the main thread for every configuration, so this is where
+    // the logger which sends the entries of all threads is created.
+    if (&dispatcher == &main_thread_dispatcher_) {
+      shared_logger->setLogger(createThreadLogger(config, dispatcher));
+    }
+    return shared_logger;
+  }
 
-private:
   /**
    * Per-thread cache.
    */
@@ -292,9 +446,7 @@ private:
 
     Event::Dispatcher& dispatcher_;
     // Access loggers indexed by the hash of logger's configuration and logger type.
-    absl::flat_hash_map<std::pair<std::size_t, Common::GrpcAccessLoggerType>,
-                        typename GrpcAccessLogger::SharedPtr>
-        access_loggers_;
+    absl::flat_hash_map<CacheKey, typename GrpcAccessLogger::SharedPtr> access_loggers_;
   };
 
   // Create the specific logger type for this cache.
@@ -304,6 +456,12 @@ private:
                Event::Dispatcher& dispatcher) PURE;
 
   Grpc::AsyncClientManager& async_client_manager_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  const std::string access_log_prefix_;
+  Thread::MutexBasicLockable shared_loggers_mutex_;
+  // Loggers shared by all threads, indexed by the hash of logger's configuration and logger type.
+  absl::flat_hash_map<CacheKey, std::shared_ptr<SharedLogger>>
+      shared_loggers_ ABSL_GUARDED_BY(shared_loggers_mutex_);
   ThreadLocal::SlotPtr tls_slot_;
 };
 
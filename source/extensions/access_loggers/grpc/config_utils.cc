@@ -16,7 +16,7 @@ getGrpcAccessLoggerCacheSingleton(Server::Configuration::CommonFactoryContext& c
       SINGLETON_MANAGER_REGISTERED_NAME(grpc_access_logger_cache), [&context] {
         return std::make_shared<GrpcCommon::GrpcAccessLoggerCacheImpl>(
             context.clusterManager().grpcAsyncClientManager(), context.serverScope(),
-            context.threadLocal(), context.localInfo());
+            context.threadLocal(), context.mainThreadDispatcher(), context.localInfo());
       });
 }
 } // namespace GrpcCommon
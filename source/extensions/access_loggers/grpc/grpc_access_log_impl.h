@@ -46,6 +46,7 @@ class GrpcAccessLoggerCacheImpl
 public:
   GrpcAccessLoggerCacheImpl(Grpc::AsyncClientManager& async_client_manager, Stats::Scope& scope,
                             ThreadLocal::SlotAllocator& tls,
+                            Event::Dispatcher& main_thread_dispatcher,
                             const LocalInfo::LocalInfo& local_info);
 
 private:
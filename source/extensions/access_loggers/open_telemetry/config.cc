@@ -27,7 +27,7 @@ getAccessLoggerCacheSingleton(Server::Configuration::CommonFactoryContext& conte
       SINGLETON_MANAGER_REGISTERED_NAME(open_telemetry_access_logger_cache), [&context] {
         return std::make_shared<GrpcAccessLoggerCacheImpl>(
             context.clusterManager().grpcAsyncClientManager(), context.scope(),
-            context.threadLocal(), context.localInfo());
+            context.threadLocal(), context.mainThreadDispatcher(), context.localInfo());
       });
 }
 
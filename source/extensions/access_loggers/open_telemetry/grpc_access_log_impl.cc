@@ -69,8 +69,11 @@ void GrpcAccessLoggerImpl::clearMessage() { root_->clear_logs(); }
 GrpcAccessLoggerCacheImpl::GrpcAccessLoggerCacheImpl(Grpc::AsyncClientManager& async_client_manager,
                                                      Stats::Scope& scope,
                                                      ThreadLocal::SlotAllocator& tls,
+                                                     Event::Dispatcher& main_thread_dispatcher,
                                                      const LocalInfo::LocalInfo& local_info)
-    : GrpcAccessLoggerCache(async_client_manager, scope, tls), local_info_(local_info) {}
+    : GrpcAccessLoggerCache(async_client_manager, scope, tls, main_thread_dispatcher,
+                            GRPC_LOG_STATS_PREFIX),
+      local_info_(local_info) {}
 
 GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
@@ -28,6 +28,8 @@ struct FactoryCallbacksWrapper : public Http::FilterChainFactoryCallbacks {
                        Matcher::MatchTreeSharedPtr<Http::HttpMatchingData>) override;
   void addAccessLogHandler(AccessLog::InstanceSharedPtr) override;
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  // The injected filter is timed as part of the composite filter.
+  void setFilterConfigName(absl::string_view) override {}
 
   Filter& filter_;
   Event::Dispatcher& dispatcher_;
@@ -35,6 +35,7 @@
 #include "source/common/router/scoped_rds.h"
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/tracing/http_tracer_manager_impl.h"
+#include "source/common/tracing/tail_sampler_impl.h"
 #include "source/common/tracing/tracer_config_impl.h"
 
 #ifdef ENVOY_ENABLE_QUIC
@@ -517,10 +518,22 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     const uint32_t max_path_tag_length = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
         tracing_config, max_path_tag_length, Tracing::DefaultMaxPathTagLength);
 
+    Tracing::TailSamplerSharedPtr tail_sampler;
+    if (tracing_config.has_tail_sampling()) {
+      const auto& tail_sampling = tracing_config.tail_sampling();
+      tail_sampler = std::make_shared<Tracing::TailSampler>(
+          std::chrono::milliseconds(
+              PROTOBUF_GET_MS_OR_DEFAULT(tail_sampling, latency_threshold, 0)),
+          tail_sampling.keep_errors(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(tail_sampling, max_buffered_spans,
+                                          Tracing::DefaultTailSamplingMaxBufferedSpans),
+          context_.timeSource(), context_.scope(), stats_prefix_ + "tracing.tail_sampling.");
+    }
+
     tracing_config_ =
         std::make_unique<Http::TracingConnectionManagerConfig>(Http::TracingConnectionManagerConfig{
             tracing_operation_name, custom_tags, client_sampling, random_sampling, overall_sampling,
-            tracing_config.verbose(), max_path_tag_length});
+            tracing_config.verbose(), max_path_tag_length, std::move(tail_sampler)});
   }
 
   for (const auto& access_log : config.access_log()) {
@@ -614,6 +627,23 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
           std::make_pair(name, FilterConfig{std::move(factories), enabled}));
     }
   }
+
+  if (config.record_timing_breakdown()) {
+    std::vector<std::string> filter_names;
+    for (const auto& filter_config_provider : filter_factories_) {
+      filter_names.push_back(filter_config_provider->name());
+    }
+    for (const auto& upgrade_filter_factories : upgrade_filter_factories_) {
+      if (upgrade_filter_factories.second.filter_factories != nullptr) {
+        for (const auto& filter_config_provider :
+             *upgrade_filter_factories.second.filter_factories) {
+          filter_names.push_back(filter_config_provider->name());
+        }
+      }
+    }
+    timing_breakdown_stats_ = std::make_unique<Http::TimingBreakdownStats>(
+        filter_names, stats_prefix_ + "timing_breakdown.", context_.scope());
+  }
 }
 
 void HttpConnectionManagerConfig::processFilter(
@@ -725,6 +755,7 @@ void HttpConnectionManagerConfig::createFilterChainForFactories(
     Http::FilterChainFactoryCallbacks& callbacks, const FilterFactoriesList& filter_factories) {
   bool added_missing_config_filter = false;
   for (const auto& filter_config_provider : filter_factories) {
+    callbacks.setFilterConfigName(filter_config_provider->name());
     auto config = filter_config_provider->config();
     if (config.has_value()) {
       config.value()(callbacks);
@@ -25,6 +25,7 @@
 #include "source/common/http/http1/codec_stats.h"
 #include "source/common/http/http2/codec_stats.h"
 #include "source/common/http/http3/codec_stats.h"
+#include "source/common/http/timing_breakdown_stats.h"
 #include "source/common/json/json_loader.h"
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/router/rds_impl.h"
@@ -177,6 +178,9 @@ public:
   const absl::optional<std::string>& schemeToSet() const override { return scheme_to_set_; }
   Http::ConnectionManagerStats& stats() override { return stats_; }
   Http::ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  Http::TimingBreakdownStats* timingBreakdownStats() override {
+    return timing_breakdown_stats_.get();
+  }
   bool useRemoteAddress() const override { return use_remote_address_; }
   const Http::InternalAddressConfig& internalAddressConfig() const override {
     return *internal_address_config_;
@@ -257,6 +261,7 @@ private:
   mutable Http::Http2::CodecStats::AtomicPtr http2_codec_stats_;
   mutable Http::Http3::CodecStats::AtomicPtr http3_codec_stats_;
   Http::ConnectionManagerTracingStats tracing_stats_;
+  Http::TimingBreakdownStatsPtr timing_breakdown_stats_;
   const bool use_remote_address_{};
   const std::unique_ptr<Http::InternalAddressConfig> internal_address_config_;
   const uint32_t xff_num_trusted_hops_;
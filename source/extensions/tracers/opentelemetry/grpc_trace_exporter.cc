@@ -0,0 +1,54 @@
+#include "source/extensions/tracers/opentelemetry/grpc_trace_exporter.h"
+
+#include "source/common/tracing/null_span_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+OpenTelemetryGrpcTraceExporter::OpenTelemetryGrpcTraceExporter(Grpc::RawAsyncClientPtr&& client,
+                                                               OpenTelemetryTracerStats& stats)
+    : client_(std::move(client)),
+      service_method_(*Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
+          "opentelemetry.proto.collector.trace.v1.TraceService.Export")),
+      stats_(stats) {}
+
+OpenTelemetryGrpcTraceExporter::~OpenTelemetryGrpcTraceExporter() {
+  if (in_flight_ != nullptr) {
+    in_flight_->cancel();
+  }
+}
+
+void OpenTelemetryGrpcTraceExporter::exportSpans(const ExportTraceServiceRequest& request) {
+  ASSERT(!busy_);
+  busy_ = true;
+  stats_.exports_sent_.inc();
+  // The callbacks have already run if the request failed to start, in which case nullptr is
+  // returned.
+  Grpc::AsyncRequest* in_flight = client_->send(service_method_, request, *this,
+                                                Tracing::NullSpan::instance(),
+                                                Http::AsyncClient::RequestOptions());
+  if (in_flight != nullptr) {
+    in_flight_ = in_flight;
+  }
+}
+
+void OpenTelemetryGrpcTraceExporter::onSuccess(Grpc::ResponsePtr<ExportTraceServiceResponse>&&,
+                                               Tracing::Span&) {
+  in_flight_ = nullptr;
+  busy_ = false;
+}
+
+void OpenTelemetryGrpcTraceExporter::onFailure(Grpc::Status::GrpcStatus status,
+                                               const std::string& message, Tracing::Span&) {
+  ENVOY_LOG(debug, "{} gRPC request failed: {}, {}", service_method_.name(), status, message);
+  stats_.exports_failed_.inc();
+  in_flight_ = nullptr;
+  busy_ = false;
+}
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/grpc/async_client.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/grpc/typed_async_client.h"
+#include "source/extensions/tracers/opentelemetry/opentelemetry_stats.h"
+
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+using ExportTraceServiceRequest =
+    opentelemetry::proto::collector::trace::v1::ExportTraceServiceRequest;
+using ExportTraceServiceResponse =
+    opentelemetry::proto::collector::trace::v1::ExportTraceServiceResponse;
+
+/**
+ * Exports spans to an OTLP collector with unary TraceService.Export calls. Only one export is in
+ * flight at a time: the tracer keeps queueing the spans which finish in the meantime.
+ */
+class OpenTelemetryGrpcTraceExporter
+    : public Grpc::AsyncRequestCallbacks<ExportTraceServiceResponse>,
+      Logger::Loggable<Logger::Id::tracing> {
+public:
+  OpenTelemetryGrpcTraceExporter(Grpc::RawAsyncClientPtr&& client,
+                                 OpenTelemetryTracerStats& stats);
+  ~OpenTelemetryGrpcTraceExporter() override;
+
+  /**
+   * Sends an export request. Must not be called while busy().
+   * @param request supplies the spans to export.
+   */
+  void exportSpans(const ExportTraceServiceRequest& request);
+
+  /**
+   * @return whether an export is in flight.
+   */
+  bool busy() const { return busy_; }
+
+  // Grpc::AsyncRequestCallbacks
+  void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+  void onSuccess(Grpc::ResponsePtr<ExportTraceServiceResponse>&&, Tracing::Span&) override;
+  void onFailure(Grpc::Status::GrpcStatus status, const std::string& message,
+                 Tracing::Span&) override;
+
+private:
+  Grpc::AsyncClient<ExportTraceServiceRequest, ExportTraceServiceResponse> client_;
+  const Protobuf::MethodDescriptor& service_method_;
+  OpenTelemetryTracerStats& stats_;
+  Grpc::AsyncRequest* in_flight_{};
+  bool busy_{};
+};
+
+using OpenTelemetryGrpcTraceExporterPtr = std::unique_ptr<OpenTelemetryGrpcTraceExporter>;
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
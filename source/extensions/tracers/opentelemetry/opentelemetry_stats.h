@@ -0,0 +1,24 @@
+#pragma once
+
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+#define OPENTELEMETRY_TRACER_STATS(COUNTER)                                                        \
+  COUNTER(exports_failed)                                                                          \
+  COUNTER(exports_sent)                                                                            \
+  COUNTER(spans_dropped)                                                                           \
+  COUNTER(spans_sent)                                                                              \
+  COUNTER(timer_flushed)
+
+struct OpenTelemetryTracerStats {
+  OPENTELEMETRY_TRACER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#include "source/extensions/tracers/opentelemetry/opentelemetry_tracer_impl.h"
+
+#include "source/extensions/tracers/opentelemetry/span_context.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+Driver::Driver(const envoy::config::trace::v3::OpenTelemetryConfig& config,
+               Server::Configuration::TracerFactoryContext& context)
+    : tracing_stats_{OPENTELEMETRY_TRACER_STATS(
+          POOL_COUNTER_PREFIX(context.serverFactoryContext().scope(), "tracing.opentelemetry."))},
+      tls_slot_ptr_(context.serverFactoryContext().threadLocal().allocateSlot()) {
+  auto& factory_context = context.serverFactoryContext();
+  const std::string service_name = !config.service_name().empty()
+                                       ? config.service_name()
+                                       : factory_context.localInfo().clusterName();
+  tls_slot_ptr_->set([config, service_name, &factory_context, this](Event::Dispatcher& dispatcher) {
+    auto exporter = std::make_unique<OpenTelemetryGrpcTraceExporter>(
+        factory_context.clusterManager()
+            .grpcAsyncClientManager()
+            .factoryForGrpcService(config.grpc_service(), factory_context.scope(), true)
+            ->createUncachedRawAsyncClient(),
+        tracing_stats_);
+    return std::make_shared<TlsTracer>(std::make_unique<Tracer>(
+        config, service_name, std::move(exporter), dispatcher, factory_context.timeSource(),
+        factory_context.api().randomGenerator(), tracing_stats_));
+  });
+}
+
+Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config,
+                                   Tracing::TraceContext& trace_context,
+                                   const std::string& operation_name, SystemTime start_time,
+                                   const Tracing::Decision decision) {
+  // A remote parent decides whether its trace is sampled.
+  return tls_slot_ptr_->getTyped<TlsTracer>().tracer().startSpan(
+      operation_name, start_time,
+      config.operationName() == Tracing::OperationName::Egress
+          ? opentelemetry::proto::trace::v1::Span::SPAN_KIND_CLIENT
+          : opentelemetry::proto::trace::v1::Span::SPAN_KIND_SERVER,
+      SpanContext::extract(trace_context), decision.traced);
+}
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
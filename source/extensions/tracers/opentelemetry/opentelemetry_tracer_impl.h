@@ -0,0 +1,51 @@
+#pragma once
+
+#include "envoy/config/trace/v3/opentelemetry.pb.h"
+#include "envoy/server/tracer_config.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/tracing/trace_driver.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/tracers/opentelemetry/opentelemetry_stats.h"
+#include "source/extensions/tracers/opentelemetry/tracer.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+/**
+ * OpenTelemetry tracing driver. Each worker has its own tracer, which batches the spans of the
+ * worker and exports them over its own gRPC client.
+ */
+class Driver : public Tracing::Driver, public Logger::Loggable<Logger::Id::tracing> {
+public:
+  Driver(const envoy::config::trace::v3::OpenTelemetryConfig& config,
+         Server::Configuration::TracerFactoryContext& context);
+
+  // Tracing::Driver
+  Tracing::SpanPtr startSpan(const Tracing::Config& config, Tracing::TraceContext& trace_context,
+                             const std::string& operation_name, SystemTime start_time,
+                             const Tracing::Decision decision) override;
+
+private:
+  class TlsTracer : public ThreadLocal::ThreadLocalObject {
+  public:
+    TlsTracer(TracerPtr tracer) : tracer_(std::move(tracer)) {}
+
+    Tracer& tracer() { return *tracer_; }
+
+  private:
+    TracerPtr tracer_;
+  };
+
+  OpenTelemetryTracerStats tracing_stats_;
+  ThreadLocal::SlotPtr tls_slot_ptr_;
+};
+
+using DriverPtr = std::unique_ptr<Driver>;
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#include "source/extensions/tracers/opentelemetry/span_context.h"
+
+#include "source/common/common/hex.h"
+#include "source/common/common/macros.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+namespace {
+
+// version "-" trace-id "-" parent-id "-" trace-flags
+constexpr size_t TraceParentSize = 2 + 1 + 32 + 1 + 16 + 1 + 2;
+constexpr uint64_t SampledFlag = 0x01;
+
+// Parses lowercase hex digits, as the traceparent header requires.
+bool parseHex(absl::string_view hex, uint64_t& out) {
+  out = 0;
+  for (const char c : hex) {
+    uint64_t digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else {
+      return false;
+    }
+    out = (out << 4) | digit;
+  }
+  return true;
+}
+
+} // namespace
+
+const Http::LowerCaseString& traceParentHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "traceparent");
+}
+
+const Http::LowerCaseString& traceStateHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "tracestate");
+}
+
+absl::optional<SpanContext> SpanContext::extract(const Tracing::TraceContext& trace_context) {
+  const auto trace_parent = trace_context.getByKey(traceParentHeader());
+  if (!trace_parent.has_value()) {
+    return absl::nullopt;
+  }
+
+  // Later versions may only append fields, so their first fields are parsed the same way.
+  const absl::string_view value = trace_parent.value();
+  uint64_t version;
+  if (value.size() < TraceParentSize || !parseHex(value.substr(0, 2), version) || version == 0xff ||
+      (version == 0 && value.size() != TraceParentSize) ||
+      (value.size() > TraceParentSize && value[TraceParentSize] != '-') || value[2] != '-' ||
+      value[35] != '-' || value[52] != '-') {
+    return absl::nullopt;
+  }
+
+  uint64_t trace_id_high;
+  uint64_t trace_id_low;
+  uint64_t span_id;
+  uint64_t flags;
+  if (!parseHex(value.substr(3, 16), trace_id_high) ||
+      !parseHex(value.substr(19, 16), trace_id_low) || !parseHex(value.substr(36, 16), span_id) ||
+      !parseHex(value.substr(53, 2), flags) || (trace_id_high == 0 && trace_id_low == 0) ||
+      span_id == 0) {
+    return absl::nullopt;
+  }
+
+  const auto trace_state = trace_context.getByKey(traceStateHeader());
+  return SpanContext(trace_id_high, trace_id_low, span_id, (flags & SampledFlag) != 0,
+                     std::string(trace_state.value_or(absl::string_view())));
+}
+
+void SpanContext::inject(Tracing::TraceContext& trace_context) const {
+  trace_context.setByReferenceKey(traceParentHeader(), traceParent());
+  if (!trace_state_.empty()) {
+    trace_context.setByReferenceKey(traceStateHeader(), trace_state_);
+  }
+}
+
+std::string SpanContext::traceIdAsHex() const {
+  return absl::StrCat(Hex::uint64ToHex(trace_id_high_), Hex::uint64ToHex(trace_id_low_));
+}
+
+std::string SpanContext::traceParent() const {
+  return absl::StrCat("00-", traceIdAsHex(), "-", Hex::uint64ToHex(span_id_),
+                      sampled_ ? "-01" : "-00");
+}
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
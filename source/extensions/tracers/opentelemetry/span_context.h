@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/http/header_map.h"
+#include "envoy/tracing/trace_context.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+const Http::LowerCaseString& traceParentHeader();
+const Http::LowerCaseString& traceStateHeader();
+
+/**
+ * The W3C trace context of a span (https://www.w3.org/TR/trace-context/): its trace and span IDs,
+ * whether its trace is sampled and the vendor-specific trace state.
+ */
+class SpanContext {
+public:
+  SpanContext() = default;
+  SpanContext(uint64_t trace_id_high, uint64_t trace_id_low, uint64_t span_id, bool sampled,
+              std::string trace_state)
+      : trace_id_high_(trace_id_high), trace_id_low_(trace_id_low), span_id_(span_id),
+        sampled_(sampled), trace_state_(std::move(trace_state)) {}
+
+  /**
+   * Extracts the context of a remote parent span from the traceparent and tracestate entries of a
+   * trace context.
+   * @param trace_context supplies the trace context of the request.
+   * @return the context of the parent span, or absl::nullopt if there is no valid traceparent.
+   */
+  static absl::optional<SpanContext> extract(const Tracing::TraceContext& trace_context);
+
+  /**
+   * Propagates this context, as the parent of the next hop, in the traceparent and tracestate
+   * entries of a trace context.
+   * @param trace_context supplies the trace context of the request.
+   */
+  void inject(Tracing::TraceContext& trace_context) const;
+
+  uint64_t traceIdHigh() const { return trace_id_high_; }
+  uint64_t traceIdLow() const { return trace_id_low_; }
+  uint64_t spanId() const { return span_id_; }
+  bool sampled() const { return sampled_; }
+  const std::string& traceState() const { return trace_state_; }
+
+  void setSpanId(uint64_t span_id) { span_id_ = span_id; }
+  void setSampled(bool sampled) { sampled_ = sampled; }
+
+  /**
+   * @return the 128-bit trace ID as 32 lowercase hex digits.
+   */
+  std::string traceIdAsHex() const;
+
+  /**
+   * @return the value of the traceparent header for this context.
+   */
+  std::string traceParent() const;
+
+private:
+  uint64_t trace_id_high_{};
+  uint64_t trace_id_low_{};
+  uint64_t span_id_{};
+  bool sampled_{};
+  std::string trace_state_;
+};
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,235 @@
+#include "source/extensions/tracers/opentelemetry/tracer.h"
+
+#include <algorithm>
+
+#include "source/common/protobuf/protobuf.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/tracing/common_values.h"
+
+#include "opentelemetry/proto/common/v1/common.pb.h"
+#include "opentelemetry/proto/resource/v1/resource.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+namespace {
+
+constexpr uint32_t DefaultMaxQueueSize = 2048;
+constexpr uint32_t DefaultMaxExportBatchSize = 512;
+constexpr uint64_t DefaultExportIntervalMs = 5000;
+// Spans mostly carry the tags Envoy sets itself, plus the configured custom tags.
+constexpr uint32_t MaxAttributeKeys = 1024;
+
+uint64_t toUnixNano(SystemTime time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// OTLP IDs are the bytes of the ID in network order.
+void writeId(uint64_t id, char* out) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = static_cast<char>(id & 0xff);
+    id >>= 8;
+  }
+}
+
+void toProto(SpanData&& data, opentelemetry::proto::trace::v1::Span& span) {
+  char trace_id[16];
+  writeId(data.context_.traceIdHigh(), trace_id);
+  writeId(data.context_.traceIdLow(), trace_id + 8);
+  span.set_trace_id(trace_id, sizeof(trace_id));
+
+  char span_id[8];
+  writeId(data.context_.spanId(), span_id);
+  span.set_span_id(span_id, sizeof(span_id));
+  if (data.parent_span_id_ != 0) {
+    writeId(data.parent_span_id_, span_id);
+    span.set_parent_span_id(span_id, sizeof(span_id));
+  }
+
+  if (!data.context_.traceState().empty()) {
+    span.set_trace_state(data.context_.traceState());
+  }
+  span.set_name(std::move(data.name_));
+  span.set_kind(data.kind_);
+  span.set_start_time_unix_nano(data.start_time_unix_nano_);
+  span.set_end_time_unix_nano(data.end_time_unix_nano_);
+
+  for (SpanAttribute& attribute : data.attributes_) {
+    auto* key_value = span.add_attributes();
+    key_value->set_key(attribute.key_.data(), attribute.key_.size());
+    key_value->mutable_value()->set_string_value(std::move(attribute.value_));
+  }
+
+  for (SpanEvent& event : data.events_) {
+    auto* span_event = span.add_events();
+    span_event->set_time_unix_nano(event.time_unix_nano_);
+    span_event->set_name(std::move(event.name_));
+  }
+
+  if (data.error_) {
+    span.mutable_status()->set_code(opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR);
+  }
+}
+
+} // namespace
+
+absl::optional<absl::string_view> AttributeKeyPool::intern(absl::string_view key) {
+  auto it = keys_.find(key);
+  if (it != keys_.end()) {
+    return absl::string_view(*it);
+  }
+  if (keys_.size() >= max_keys_) {
+    return absl::nullopt;
+  }
+  return absl::string_view(*keys_.emplace(key).first);
+}
+
+Span::Span(Tracer& tracer, SpanContext context, uint64_t parent_span_id, const std::string& name,
+           SpanKind kind, SystemTime start_time)
+    : tracer_(tracer) {
+  data_.context_ = std::move(context);
+  data_.parent_span_id_ = parent_span_id;
+  data_.name_ = name;
+  data_.kind_ = kind;
+  data_.start_time_unix_nano_ = toUnixNano(start_time);
+}
+
+void Span::setOperation(absl::string_view operation) { data_.name_ = std::string(operation); }
+
+void Span::setTag(absl::string_view name, absl::string_view value) {
+  // Errors are reported through the status of the span rather than as an attribute.
+  if (name == Tracing::Tags::get().Error) {
+    data_.error_ = value == Tracing::Tags::get().True;
+    return;
+  }
+
+  for (SpanAttribute& attribute : data_.attributes_) {
+    if (attribute.key_ == name) {
+      attribute.value_ = std::string(value);
+      return;
+    }
+  }
+
+  absl::optional<absl::string_view> key = tracer_.attributeKeys().intern(name);
+  if (!key.has_value()) {
+    key = data_.owned_keys_.emplace_back(name);
+  }
+  data_.attributes_.push_back({key.value(), std::string(value)});
+}
+
+void Span::log(SystemTime timestamp, const std::string& event) {
+  data_.events_.push_back({toUnixNano(timestamp), event});
+}
+
+void Span::finishSpan() {
+  data_.end_time_unix_nano_ = toUnixNano(tracer_.timeSource().systemTime());
+  if (data_.context_.sampled()) {
+    tracer_.sendSpan(std::move(data_));
+  }
+}
+
+void Span::injectContext(Tracing::TraceContext& trace_context) {
+  data_.context_.inject(trace_context);
+}
+
+Tracing::SpanPtr Span::spawnChild(const Tracing::Config&, const std::string& name,
+                                  SystemTime start_time) {
+  // Envoy spawns child spans for the requests it makes upstream.
+  const SpanContext& context = data_.context_;
+  return std::make_unique<Span>(
+      tracer_,
+      SpanContext(context.traceIdHigh(), context.traceIdLow(), tracer_.generateId(),
+                  context.sampled(), context.traceState()),
+      context.spanId(), name, opentelemetry::proto::trace::v1::Span::SPAN_KIND_CLIENT, start_time);
+}
+
+void Span::setSampled(bool sampled) { data_.context_.setSampled(sampled); }
+
+Tracer::Tracer(const envoy::config::trace::v3::OpenTelemetryConfig& config,
+               std::string service_name, OpenTelemetryGrpcTraceExporterPtr exporter,
+               Event::Dispatcher& dispatcher, TimeSource& time_source,
+               Random::RandomGenerator& random, OpenTelemetryTracerStats& stats)
+    : service_name_(std::move(service_name)),
+      max_queue_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_queue_size, DefaultMaxQueueSize)),
+      max_export_batch_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_export_batch_size,
+                                                             DefaultMaxExportBatchSize)),
+      export_interval_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, export_interval, DefaultExportIntervalMs)),
+      exporter_(std::move(exporter)), time_source_(time_source), random_(random), stats_(stats),
+      attribute_keys_(MaxAttributeKeys),
+      export_timer_(dispatcher.createTimer([this] { onTimer(); })) {
+  export_timer_->enableTimer(export_interval_);
+}
+
+Tracing::SpanPtr Tracer::startSpan(const std::string& operation_name, SystemTime start_time,
+                                   SpanKind kind, const absl::optional<SpanContext>& parent,
+                                   bool sampled) {
+  if (parent.has_value()) {
+    return std::make_unique<Span>(*this,
+                                  SpanContext(parent->traceIdHigh(), parent->traceIdLow(),
+                                              generateId(), parent->sampled(),
+                                              parent->traceState()),
+                                  parent->spanId(), operation_name, kind, start_time);
+  }
+  return std::make_unique<Span>(
+      *this, SpanContext(generateId(), generateId(), generateId(), sampled, EMPTY_STRING), 0,
+      operation_name, kind, start_time);
+}
+
+void Tracer::sendSpan(SpanData&& span) {
+  if (queue_.size() >= max_queue_size_) {
+    stats_.spans_dropped_.inc();
+    return;
+  }
+  queue_.push_back(std::move(span));
+  if (queue_.size() >= max_export_batch_size_) {
+    exportSpans();
+  }
+}
+
+uint64_t Tracer::generateId() {
+  // Zero is not a valid trace or span ID.
+  const uint64_t id = random_.random();
+  return id != 0 ? id : 1;
+}
+
+void Tracer::exportSpans() {
+  if (queue_.empty() || exporter_->busy()) {
+    return;
+  }
+
+  // The request is built in place on an arena, which releases all of it at once after it is sent.
+  Protobuf::Arena arena;
+  auto* request = Protobuf::Arena::CreateMessage<ExportTraceServiceRequest>(&arena);
+  auto* resource_spans = request->add_resource_spans();
+  if (!service_name_.empty()) {
+    auto* attribute = resource_spans->mutable_resource()->add_attributes();
+    attribute->set_key("service.name");
+    attribute->mutable_value()->set_string_value(service_name_);
+  }
+  auto* library_spans = resource_spans->add_instrumentation_library_spans();
+  library_spans->mutable_instrumentation_library()->set_name("envoy");
+
+  const size_t batch_size = std::min<size_t>(queue_.size(), max_export_batch_size_);
+  for (size_t i = 0; i < batch_size; ++i) {
+    toProto(std::move(queue_.front()), *library_spans->add_spans());
+    queue_.pop_front();
+  }
+
+  ENVOY_LOG(trace, "exporting {} spans", batch_size);
+  stats_.spans_sent_.add(batch_size);
+  exporter_->exportSpans(*request);
+}
+
+void Tracer::onTimer() {
+  stats_.timer_flushed_.inc();
+  exportSpans();
+  export_timer_->enableTimer(export_interval_);
+}
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/random_generator.h"
+#include "envoy/common/time.h"
+#include "envoy/config/trace/v3/opentelemetry.pb.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/tracing/trace_driver.h"
+
+#include "source/common/common/empty_string.h"
+#include "source/common/common/logger.h"
+#include "source/extensions/tracers/opentelemetry/grpc_trace_exporter.h"
+#include "source/extensions/tracers/opentelemetry/opentelemetry_stats.h"
+#include "source/extensions/tracers/opentelemetry/span_context.h"
+
+#include "absl/container/node_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "opentelemetry/proto/trace/v1/trace.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+
+using SpanKind = opentelemetry::proto::trace::v1::Span::SpanKind;
+
+/**
+ * Interns the attribute keys of the spans of a worker. The keys are mostly the same few tag names,
+ * so spans refer to a shared copy of each key rather than each allocating their own. The number
+ * of keys is bounded, so that spans tagged with ever new keys cannot grow the pool without limit.
+ */
+class AttributeKeyPool {
+public:
+  explicit AttributeKeyPool(uint32_t max_keys) : max_keys_(max_keys) {}
+
+  /**
+   * @param key supplies the attribute key.
+   * @return a view of the interned copy of the key, which lives as long as the pool, or
+   * absl::nullopt if the key is not in the pool and the pool is full.
+   */
+  absl::optional<absl::string_view> intern(absl::string_view key);
+
+  size_t size() const { return keys_.size(); }
+
+private:
+  const uint32_t max_keys_;
+  // The addresses of the nodes are stable, so views of the keys stay valid as the set grows.
+  absl::node_hash_set<std::string> keys_;
+};
+
+struct SpanAttribute {
+  absl::string_view key_;
+  std::string value_;
+};
+
+struct SpanEvent {
+  uint64_t time_unix_nano_;
+  std::string name_;
+};
+
+/**
+ * The data of a span, which is handed over to the tracer of the worker when the span finishes and
+ * converted to OTLP when it is exported.
+ */
+struct SpanData {
+  SpanContext context_;
+  uint64_t parent_span_id_{};
+  std::string name_;
+  SpanKind kind_{};
+  uint64_t start_time_unix_nano_{};
+  uint64_t end_time_unix_nano_{};
+  // Attribute keys point into the attribute key pool of the tracer or, if it is full, into
+  // owned_keys_, whose nodes do not move when the data is moved.
+  std::vector<SpanAttribute> attributes_;
+  std::list<std::string> owned_keys_;
+  std::vector<SpanEvent> events_;
+  bool error_{};
+};
+
+class Tracer;
+
+/**
+ * An OpenTelemetry span. It must not outlive the tracer of the worker which started it.
+ */
+class Span : public Tracing::Span {
+public:
+  Span(Tracer& tracer, SpanContext context, uint64_t parent_span_id, const std::string& name,
+       SpanKind kind, SystemTime start_time);
+
+  // Tracing::Span
+  void setOperation(absl::string_view operation) override;
+  void setTag(absl::string_view name, absl::string_view value) override;
+  void log(SystemTime timestamp, const std::string& event) override;
+  void finishSpan() override;
+  void injectContext(Tracing::TraceContext& trace_context) override;
+  Tracing::SpanPtr spawnChild(const Tracing::Config& config, const std::string& name,
+                              SystemTime start_time) override;
+  void setSampled(bool sampled) override;
+  // Baggage is not supported.
+  std::string getBaggage(absl::string_view) override { return EMPTY_STRING; }
+  void setBaggage(absl::string_view, absl::string_view) override {}
+  std::string getTraceIdAsHex() const override { return data_.context_.traceIdAsHex(); }
+
+  const SpanData& data() const { return data_; }
+
+private:
+  Tracer& tracer_;
+  SpanData data_;
+};
+
+/**
+ * The tracer of a worker. It starts the spans of the worker and runs its batch span processor:
+ * finished spans are queued, up to a bound, and exported in batches, either as soon as a batch is
+ * full or on a timer.
+ */
+class Tracer : Logger::Loggable<Logger::Id::tracing> {
+public:
+  Tracer(const envoy::config::trace::v3::OpenTelemetryConfig& config, std::string service_name,
+         OpenTelemetryGrpcTraceExporterPtr exporter, Event::Dispatcher& dispatcher,
+         TimeSource& time_source, Random::RandomGenerator& random,
+         OpenTelemetryTracerStats& stats);
+
+  /**
+   * Starts a span, as the child of a remote parent if there is one, or as the root of a new trace.
+   * @param operation_name supplies the name of the span.
+   * @param start_time supplies the start time of the span.
+   * @param kind supplies the kind of the span.
+   * @param parent supplies the context of the remote parent, if any.
+   * @param sampled supplies whether a new trace is sampled.
+   */
+  Tracing::SpanPtr startSpan(const std::string& operation_name, SystemTime start_time,
+                             SpanKind kind, const absl::optional<SpanContext>& parent,
+                             bool sampled);
+
+  /**
+   * Queues a finished span for export, or drops it if the queue is full.
+   */
+  void sendSpan(SpanData&& span);
+
+  AttributeKeyPool& attributeKeys() { return attribute_keys_; }
+  TimeSource& timeSource() { return time_source_; }
+  uint64_t generateId();
+
+  /**
+   * @return the number of spans waiting to be exported.
+   */
+  size_t pendingSpans() const { return queue_.size(); }
+
+private:
+  // Exports the next batch of queued spans, unless an export is already in flight.
+  void exportSpans();
+  void onTimer();
+
+  const std::string service_name_;
+  const uint32_t max_queue_size_;
+  const uint32_t max_export_batch_size_;
+  const std::chrono::milliseconds export_interval_;
+  OpenTelemetryGrpcTraceExporterPtr exporter_;
+  TimeSource& time_source_;
+  Random::RandomGenerator& random_;
+  OpenTelemetryTracerStats& stats_;
+  AttributeKeyPool attribute_keys_;
+  std::deque<SpanData> queue_;
+  Event::TimerPtr export_timer_;
+};
+
+using TracerPtr = std::unique_ptr<Tracer>;
+
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -2,11 +2,14 @@
 
 #include "envoy/config/trace/v3/zipkin.pb.h"
 
+#include "source/common/json/json_writer.h"
 #include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/extensions/tracers/zipkin/util.h"
 #include "source/extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "source/extensions/tracers/zipkin/zipkin_json_field_names.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 
@@ -15,6 +18,24 @@ namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
 
+namespace {
+
+void appendFieldName(absl::string_view name, std::string& output) {
+  Json::Writer::appendString(name, output);
+  output.push_back(':');
+}
+
+// Closes an object or array whose members are each followed by a comma.
+void closeWith(char close, std::string& output) {
+  if (output.back() == ',') {
+    output.back() = close;
+  } else {
+    output.push_back(close);
+  }
+}
+
+} // namespace
+
 SpanBuffer::SpanBuffer(
     const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
     const bool shared_span_context)
@@ -62,9 +83,147 @@ SerializerPtr SpanBuffer::makeSerializer(
 }
 
 JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
-    : shared_span_context_{shared_span_context} {}
+    : shared_span_context_{shared_span_context},
+      direct_serialization_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.zipkin_direct_json_serialization")) {}
 
 std::string JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans) {
+  if (!direct_serialization_) {
+    return serializeThroughStruct(zipkin_spans);
+  }
+
+  std::string output = "[";
+  for (const Span& zipkin_span : zipkin_spans) {
+    appendSpans(zipkin_span, output);
+  }
+  closeWith(']', output);
+  return output;
+}
+
+void JsonV2Serializer::appendSpans(const Span& zipkin_span, std::string& output) const {
+  const auto& annotations = zipkin_span.annotations();
+
+  // The annotation entries from logs are the same for every span, so they are rendered once.
+  std::string annotation_entries;
+  for (const auto& annotation : annotations) {
+    if (annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV) {
+      continue;
+    }
+    annotation_entries.push_back(annotation_entries.empty() ? '[' : ',');
+    annotation_entries.push_back('{');
+    appendFieldName(ANNOTATION_VALUE, annotation_entries);
+    Json::Writer::appendString(annotation.value(), annotation_entries);
+    annotation_entries.push_back(',');
+    appendFieldName(ANNOTATION_TIMESTAMP, annotation_entries);
+    absl::StrAppend(&annotation_entries, annotation.timestamp());
+    annotation_entries.push_back('}');
+  }
+  if (!annotation_entries.empty()) {
+    annotation_entries.push_back(']');
+  }
+
+  // Timestamps and durations are written as integers, as the Zipkin API V2 specification mandates,
+  // without the string replacements the Struct path needs (see serializeThroughStruct()).
+  for (const auto& annotation : annotations) {
+    const bool client = annotation.value() == CLIENT_SEND;
+    if (!client && annotation.value() != SERVER_RECV) {
+      continue;
+    }
+
+    output.push_back('{');
+    if (!client && shared_span_context_ && annotations.size() > 1) {
+      appendFieldName(SPAN_SHARED, output);
+      output.append("true,");
+    }
+    appendFieldName(SPAN_KIND, output);
+    Json::Writer::appendString(client ? KIND_CLIENT : KIND_SERVER, output);
+    output.push_back(',');
+
+    if (annotation.isSetEndpoint()) {
+      appendFieldName(SPAN_TIMESTAMP, output);
+      absl::StrAppend(&output, annotation.timestamp(), ",");
+      appendFieldName(SPAN_LOCAL_ENDPOINT, output);
+      appendEndpoint(annotation.endpoint(), output);
+      output.push_back(',');
+    }
+
+    appendFieldName(SPAN_TRACE_ID, output);
+    Json::Writer::appendString(zipkin_span.traceIdAsHexString(), output);
+    output.push_back(',');
+    if (zipkin_span.isSetParentId()) {
+      appendFieldName(SPAN_PARENT_ID, output);
+      Json::Writer::appendString(zipkin_span.parentIdAsHexString(), output);
+      output.push_back(',');
+    }
+
+    appendFieldName(SPAN_ID, output);
+    Json::Writer::appendString(zipkin_span.idAsHexString(), output);
+    output.push_back(',');
+
+    const auto& span_name = zipkin_span.name();
+    if (!span_name.empty()) {
+      appendFieldName(SPAN_NAME, output);
+      Json::Writer::appendString(span_name, output);
+      output.push_back(',');
+    }
+
+    if (zipkin_span.isSetDuration()) {
+      appendFieldName(SPAN_DURATION, output);
+      absl::StrAppend(&output, zipkin_span.duration(), ",");
+    }
+
+    const auto& binary_annotations = zipkin_span.binaryAnnotations();
+    if (!binary_annotations.empty()) {
+      // Like the Struct path, a repeated key keeps its last value.
+      absl::flat_hash_map<absl::string_view, absl::string_view> tags;
+      for (const auto& binary_annotation : binary_annotations) {
+        tags[binary_annotation.key()] = binary_annotation.value();
+      }
+      appendFieldName(SPAN_TAGS, output);
+      output.push_back('{');
+      for (const auto& [key, value] : tags) {
+        appendFieldName(key, output);
+        Json::Writer::appendString(value, output);
+        output.push_back(',');
+      }
+      closeWith('}', output);
+      output.push_back(',');
+    }
+
+    if (!annotation_entries.empty()) {
+      appendFieldName(ANNOTATIONS, output);
+      absl::StrAppend(&output, annotation_entries, ",");
+    }
+
+    closeWith('}', output);
+    output.push_back(',');
+  }
+}
+
+void JsonV2Serializer::appendEndpoint(const Endpoint& zipkin_endpoint, std::string& output) const {
+  output.push_back('{');
+
+  Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
+  if (address) {
+    appendFieldName(address->ip()->version() == Network::Address::IpVersion::v4 ? ENDPOINT_IPV4
+                                                                                 : ENDPOINT_IPV6,
+                    output);
+    Json::Writer::appendString(address->ip()->addressAsString(), output);
+    output.push_back(',');
+    appendFieldName(ENDPOINT_PORT, output);
+    absl::StrAppend(&output, address->ip()->port(), ",");
+  }
+
+  const std::string& service_name = zipkin_endpoint.serviceName();
+  if (!service_name.empty()) {
+    appendFieldName(ENDPOINT_SERVICE_NAME, output);
+    Json::Writer::appendString(service_name, output);
+  }
+
+  closeWith('}', output);
+}
+
+std::string JsonV2Serializer::serializeThroughStruct(const std::vector<Span>& zipkin_spans) const {
   Util::Replacements replacements;
   const std::string serialized_elements = absl::StrJoin(
       zipkin_spans, ",", [this, &replacements](std::string* out, const Span& zipkin_span) {
@@ -214,36 +373,42 @@ ProtobufSerializer::ProtobufSerializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
 std::string ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans) {
-  zipkin::proto3::ListOfSpans spans;
+  // The spans are built in place on an arena, which releases all of them at once after
+  // serialization.
+  Protobuf::Arena arena;
+  auto* spans = Protobuf::Arena::CreateMessage<zipkin::proto3::ListOfSpans>(&arena);
   for (const Span& zipkin_span : zipkin_spans) {
-    spans.MergeFrom(toListOfSpans(zipkin_span));
+    addSpans(zipkin_span, *spans);
   }
   std::string serialized;
-  spans.SerializeToString(&serialized);
+  spans->SerializeToString(&serialized);
   return serialized;
 }
 
-const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span& zipkin_span) const {
-  zipkin::proto3::ListOfSpans spans;
+void ProtobufSerializer::addSpans(const Span& zipkin_span,
+                                  zipkin::proto3::ListOfSpans& spans) const {
+  const int first_span = spans.spans_size();
 
   // This holds the annotation entries from logs.
-  std::vector<Annotation> annotation_entries;
+  std::vector<const Annotation*> annotation_entries;
 
   for (const auto& annotation : zipkin_span.annotations()) {
-    zipkin::proto3::Span span;
+    if (annotation.value() != CLIENT_SEND && annotation.value() != SERVER_RECV) {
+      annotation_entries.push_back(&annotation);
+      continue;
+    }
+
+    auto& span = *spans.add_spans();
     if (annotation.value() == CLIENT_SEND) {
       span.set_kind(zipkin::proto3::Span::CLIENT);
-    } else if (annotation.value() == SERVER_RECV) {
+    } else {
       span.set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
       span.set_kind(zipkin::proto3::Span::SERVER);
-    } else {
-      annotation_entries.push_back(annotation);
-      continue;
     }
 
     if (annotation.isSetEndpoint()) {
       span.set_timestamp(annotation.timestamp());
-      span.mutable_local_endpoint()->MergeFrom(toProtoEndpoint(annotation.endpoint()));
+      setEndpoint(annotation.endpoint(), *span.mutable_local_endpoint());
     }
 
     span.set_trace_id(zipkin_span.traceIdAsByteString());
@@ -262,26 +427,21 @@ const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span&
     for (const auto& binary_annotation : zipkin_span.binaryAnnotations()) {
       tags[binary_annotation.key()] = binary_annotation.value();
     }
-
-    auto* mutable_span = spans.add_spans();
-    mutable_span->MergeFrom(span);
   }
 
   // Fill up annotation entries from logs.
-  for (auto& span : *spans.mutable_spans()) {
-    for (const auto& annotation_entry : annotation_entries) {
+  for (int i = first_span; i < spans.spans_size(); ++i) {
+    auto& span = *spans.mutable_spans(i);
+    for (const Annotation* annotation_entry : annotation_entries) {
       const auto entry = span.mutable_annotations()->Add();
-      entry->set_value(annotation_entry.value());
-      entry->set_timestamp(annotation_entry.timestamp());
+      entry->set_value(annotation_entry->value());
+      entry->set_timestamp(annotation_entry->timestamp());
     }
   }
-
-  return spans;
 }
 
-const zipkin::proto3::Endpoint
-ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  zipkin::proto3::Endpoint endpoint;
+void ProtobufSerializer::setEndpoint(const Endpoint& zipkin_endpoint,
+                                     zipkin::proto3::Endpoint& endpoint) const {
   Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
   if (address) {
     if (address->ip()->version() == Network::Address::IpVersion::v4) {
@@ -296,8 +456,6 @@ ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
   if (!service_name.empty()) {
     endpoint.set_service_name(service_name);
   }
-
-  return endpoint;
 }
 
 } // namespace Zipkin
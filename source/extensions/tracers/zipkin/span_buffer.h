@@ -107,11 +107,19 @@ public:
   std::string serialize(const std::vector<Span>& pending_spans) override;
 
 private:
+  // Builds the spans as ProtobufWkt::Struct objects and serializes them through the protobuf JSON
+  // printer. Only used when envoy.reloadable_features.zipkin_direct_json_serialization is false.
+  std::string serializeThroughStruct(const std::vector<Span>& pending_spans) const;
   const std::vector<ProtobufWkt::Struct> toListOfSpans(const Span& zipkin_span,
                                                        Util::Replacements& replacements) const;
   const ProtobufWkt::Struct toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
 
+  // Appends the Zipkin v2 JSON objects of a span, each followed by a comma, to the output.
+  void appendSpans(const Span& zipkin_span, std::string& output) const;
+  void appendEndpoint(const Endpoint& zipkin_endpoint, std::string& output) const;
+
   const bool shared_span_context_;
+  const bool direct_serialization_;
 };
 
 /**
@@ -129,8 +137,9 @@ public:
   std::string serialize(const std::vector<Span>& pending_spans) override;
 
 private:
-  const zipkin::proto3::ListOfSpans toListOfSpans(const Span& zipkin_span) const;
-  const zipkin::proto3::Endpoint toProtoEndpoint(const Endpoint& zipkin_endpoint) const;
+  // Adds the Zipkin v2 spans of a span to the list, in place.
+  void addSpans(const Span& zipkin_span, zipkin::proto3::ListOfSpans& spans) const;
+  void setEndpoint(const Endpoint& zipkin_endpoint, zipkin::proto3::Endpoint& endpoint) const;
 
   const bool shared_span_context_;
 };
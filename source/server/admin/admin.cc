@@ -156,7 +156,7 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
       route_config_provider_(server.timeSource()),
       scoped_route_config_provider_(server.timeSource()), clusters_handler_(server),
       config_dump_handler_(config_tracker_, server), init_dump_handler_(server),
-      stats_handler_(server), logs_handler_(server), profiling_handler_(profile_path),
+      stats_handler_(server), logs_handler_(server), profiling_handler_(profile_path, server),
       runtime_handler_(server), listeners_handler_(server), server_cmd_handler_(server),
       server_info_handler_(server),
       // TODO(jsedgwick) add /runtime_reset endpoint that removes all admin-set values
@@ -176,6 +176,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerCpuProfiler), false, true},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerHeapProfiler), false, true},
+          {"/profile", "print the stacks sampled by the continuous CPU profiler",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerProfile), false, false},
           {"/healthcheck/fail", "cause the server to fail health checks",
            MAKE_ADMIN_HANDLER(server_cmd_handler_.handlerHealthcheckFail), false, true},
           {"/healthcheck/ok", "cause the server to pass health checks",
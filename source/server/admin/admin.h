@@ -75,6 +75,11 @@ public:
                          AdminStream& admin_stream);
   const Network::Socket& socket() override { return *socket_; }
   Network::Socket& mutableSocket() { return *socket_; }
+  // Starts the continuous CPU profiler, whose samples are served by /profile.
+  void startContinuousProfiler(
+      const envoy::config::bootstrap::v3::Admin::ContinuousProfiling& config) {
+    profiling_handler_.startContinuousProfiler(config);
+  }
 
   // Server::Admin
   // TODO(jsedgwick) These can be managed with a generic version of ConfigTracker.
@@ -153,6 +158,7 @@ public:
   }
   Http::ConnectionManagerStats& stats() override { return stats_; }
   Http::ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  Http::TimingBreakdownStats* timingBreakdownStats() override { return nullptr; }
   bool useRemoteAddress() const override { return true; }
   const Http::InternalAddressConfig& internalAddressConfig() const override {
     return internal_address_config_;
@@ -1,12 +1,48 @@
 #include "source/server/admin/profiling_handler.h"
 
+#include "envoy/common/exception.h"
+
+#include "source/common/profiler/continuous_profiler.h"
 #include "source/common/profiler/profiler.h"
+#include "source/common/protobuf/utility.h"
 #include "source/server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 
-ProfilingHandler::ProfilingHandler(const std::string& profile_path) : profile_path_(profile_path) {}
+namespace {
+
+constexpr uint32_t DefaultSamplingFrequency = 19;
+constexpr uint32_t DefaultMaxSamples = 8192;
+constexpr uint32_t DefaultProfileSeconds = 30;
+// Bounds the time the main thread spends symbolizing the frames of a folded profile.
+constexpr uint32_t MaxSymbolizedFrames = 256;
+
+} // namespace
+
+ProfilingHandler::ProfilingHandler(const std::string& profile_path, Server::Instance& server)
+    : HandlerContextBase(server), profile_path_(profile_path) {}
+
+ProfilingHandler::~ProfilingHandler() {
+  if (continuous_profiler_started_) {
+    Profiler::ContinuousCpu::stopProfiler();
+  }
+}
+
+void ProfilingHandler::startContinuousProfiler(
+    const envoy::config::bootstrap::v3::Admin::ContinuousProfiling& config) {
+  if (!Profiler::ContinuousCpu::profilerSupported()) {
+    throw EnvoyException("continuous profiling is only supported on Linux");
+  }
+  if (!Profiler::ContinuousCpu::startProfiler(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, sampling_frequency, DefaultSamplingFrequency),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_samples, DefaultMaxSamples))) {
+    throw EnvoyException("failed to start the continuous profiler");
+  }
+  continuous_profiler_started_ = true;
+}
 
 Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::ResponseHeaderMap&,
                                                 Buffer::Instance& response, AdminStream&) {
@@ -18,6 +54,11 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
   }
 
   bool enable = query_params.begin()->second == "y";
+  if (enable && Profiler::ContinuousCpu::isProfilerStarted()) {
+    // Both profilers sample on SIGPROF.
+    response.add("The CPU profiler cannot run with the continuous profiler\n");
+    return Http::Code::BadRequest;
+  }
   if (enable && !Profiler::Cpu::profilerEnabled()) {
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
@@ -79,5 +120,44 @@ Http::Code ProfilingHandler::handlerHeapProfiler(absl::string_view url, Http::Re
   return res;
 }
 
+Http::Code ProfilingHandler::handlerProfile(absl::string_view url,
+                                            Http::ResponseHeaderMap& response_headers,
+                                            Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::ContinuousCpu::profilerSupported()) {
+    response.add("The current platform does not support continuous profiling");
+    return Http::Code::NotImplemented;
+  }
+  if (!Profiler::ContinuousCpu::isProfilerStarted()) {
+    response.add("Continuous profiling is not configured\n");
+    return Http::Code::BadRequest;
+  }
+
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  uint32_t seconds = DefaultProfileSeconds;
+  auto it = query_params.find("seconds");
+  if (it != query_params.end() && (!absl::SimpleAtoi(it->second, &seconds) || seconds == 0)) {
+    response.add("?seconds=<positive integer>\n");
+    return Http::Code::BadRequest;
+  }
+  it = query_params.find("format");
+  const std::string format = it != query_params.end() ? it->second : "folded";
+  if (format != "folded" && format != "pprof") {
+    response.add("?format=<folded|pprof>\n");
+    return Http::Code::BadRequest;
+  }
+
+  const std::vector<Profiler::StackSample> samples = Profiler::ContinuousCpu::samplesSince(
+      server_.timeSource().monotonicTime() - std::chrono::seconds(seconds));
+  if (format == "pprof") {
+    response_headers.setContentType("application/octet-stream");
+    response.add(Profiler::legacyCpuProfile(samples, Profiler::ContinuousCpu::samplingPeriod(),
+                                            Profiler::ContinuousCpu::memoryMappings()));
+    return Http::Code::OK;
+  }
+  response.add(Profiler::foldStacks(samples, Profiler::ContinuousCpu::threadNames(samples),
+                                    MaxSymbolizedFrames));
+  return Http::Code::OK;
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,19 +1,31 @@
 #pragma once
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
 #include "envoy/server/admin.h"
+#include "envoy/server/instance.h"
+
+#include "source/server/admin/handler_ctx.h"
 
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
 namespace Server {
 
-class ProfilingHandler {
+class ProfilingHandler : public HandlerContextBase {
 
 public:
-  ProfilingHandler(const std::string& profile_path);
+  ProfilingHandler(const std::string& profile_path, Server::Instance& server);
+  ~ProfilingHandler();
+
+  /**
+   * Starts the continuous CPU profiler, whose samples are served by handlerProfile().
+   * @throw EnvoyException if the profiler cannot be started.
+   */
+  void startContinuousProfiler(
+      const envoy::config::bootstrap::v3::Admin::ContinuousProfiling& config);
 
   Http::Code handlerCpuProfiler(absl::string_view path_and_query,
                                 Http::ResponseHeaderMap& response_headers,
@@ -23,8 +35,13 @@ public:
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
 
+  Http::Code handlerProfile(absl::string_view path_and_query,
+                            Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
+                            AdminStream&);
+
 private:
   const std::string profile_path_;
+  bool continuous_profiler_started_{};
 };
 
 } // namespace Server
@@ -119,6 +119,11 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<std::string> access_log_overflow_policy(
+      "", "access-log-overflow-policy",
+      "What to do with access log writes when the disk falls behind, one of 'buffer' (default), "
+      "'block' or 'drop'.",
+      false, "buffer", "string", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s",
                                          "Hot restart and LDS removal drain time in seconds", false,
                                          600, "uint32_t", cmd);
@@ -250,6 +255,16 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   service_node_ = service_node.getValue();
   service_zone_ = service_zone.getValue();
   file_flush_interval_msec_ = std::chrono::milliseconds(file_flush_interval_msec.getValue());
+  if (access_log_overflow_policy.getValue() == "buffer") {
+    access_log_overflow_policy_ = Server::AccessLogOverflowPolicy::Buffer;
+  } else if (access_log_overflow_policy.getValue() == "block") {
+    access_log_overflow_policy_ = Server::AccessLogOverflowPolicy::Block;
+  } else if (access_log_overflow_policy.getValue() == "drop") {
+    access_log_overflow_policy_ = Server::AccessLogOverflowPolicy::Drop;
+  } else {
+    throw MalformedArgvException(fmt::format("error: unknown access-log-overflow-policy '{}'",
+                                             access_log_overflow_policy.getValue()));
+  }
   drain_time_ = std::chrono::seconds(drain_time_s.getValue());
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   socket_path_ = socket_path.getValue();
@@ -378,6 +393,20 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   }
   command_line_options->mutable_file_flush_interval()->MergeFrom(
       Protobuf::util::TimeUtil::MillisecondsToDuration(fileFlushIntervalMsec().count()));
+  switch (accessLogOverflowPolicy()) {
+  case Server::AccessLogOverflowPolicy::Buffer:
+    command_line_options->set_access_log_overflow_policy(
+        envoy::admin::v3::CommandLineOptions::Buffer);
+    break;
+  case Server::AccessLogOverflowPolicy::Block:
+    command_line_options->set_access_log_overflow_policy(
+        envoy::admin::v3::CommandLineOptions::Block);
+    break;
+  case Server::AccessLogOverflowPolicy::Drop:
+    command_line_options->set_access_log_overflow_policy(
+        envoy::admin::v3::CommandLineOptions::Drop);
+    break;
+  }
 
   command_line_options->mutable_drain_time()->MergeFrom(
       Protobuf::util::TimeUtil::SecondsToDuration(drainTime().count()));
@@ -78,6 +78,9 @@ public:
   void setFileFlushIntervalMsec(std::chrono::milliseconds file_flush_interval_msec) {
     file_flush_interval_msec_ = file_flush_interval_msec;
   }
+  void setAccessLogOverflowPolicy(Server::AccessLogOverflowPolicy access_log_overflow_policy) {
+    access_log_overflow_policy_ = access_log_overflow_policy;
+  }
   void setServiceClusterName(const std::string& service_cluster) {
     service_cluster_ = service_cluster;
   }
@@ -139,6 +142,9 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() const override {
     return file_flush_interval_msec_;
   }
+  Server::AccessLogOverflowPolicy accessLogOverflowPolicy() const override {
+    return access_log_overflow_policy_;
+  }
   const std::string& serviceClusterName() const override { return service_cluster_; }
   const std::string& serviceNodeName() const override { return service_node_; }
   const std::string& serviceZone() const override { return service_zone_; }
@@ -197,6 +203,8 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_{10000};
+  Server::AccessLogOverflowPolicy access_log_overflow_policy_{
+      Server::AccessLogOverflowPolicy::Buffer};
   std::chrono::seconds drain_time_{600};
   std::chrono::seconds parent_shutdown_time_{900};
   Server::DrainStrategy drain_strategy_{Server::DrainStrategy::Gradual};
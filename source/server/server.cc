@@ -85,7 +85,7 @@ InstanceImpl::InstanceImpl(
       handler_(new ConnectionHandlerImpl(*dispatcher_, absl::nullopt)),
       listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.accessLogOverflowPolicy()),
       terminated_(false),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
                                                   : nullptr),
@@ -252,6 +252,16 @@ void InstanceImpl::updateServerStats() {
                                        parent_stats.parent_memory_allocated_);
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
+  const Buffer::SliceStoragePool::Stats slice_pool_stats =
+      Buffer::SliceStoragePool::aggregateStats();
+  server_stats_->buffer_slice_pool_cached_bytes_.set(slice_pool_stats.cached_bytes_);
+  server_stats_->buffer_slice_pool_hits_.add(slice_pool_stats.hits_ -
+                                             last_slice_pool_stats_.hits_);
+  server_stats_->buffer_slice_pool_misses_.add(slice_pool_stats.misses_ -
+                                               last_slice_pool_stats_.misses_);
+  server_stats_->buffer_slice_pool_watermark_releases_.add(
+      slice_pool_stats.watermark_releases_ - last_slice_pool_stats_.watermark_releases_);
+  last_slice_pool_stats_ = slice_pool_stats;
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
@@ -488,6 +498,9 @@ void InstanceImpl::initialize(Network::Address::InstanceConstSharedPtr local_add
     enable_reuse_port_default_ = ReusePortDefault::Runtime;
   }
   admin_ = std::make_unique<AdminImpl>(initial_config.admin().profilePath(), *this);
+  if (bootstrap_.admin().has_continuous_profiling()) {
+    admin_->startContinuousProfiler(bootstrap_.admin().continuous_profiling());
+  }
 
   loadServerFlags(initial_config.flagsPath());
 
@@ -24,6 +24,7 @@
 #include "envoy/tracing/http_tracer.h"
 
 #include "source/common/access_log/access_log_manager_impl.h"
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 #include "source/common/common/cleanup.h"
 #include "source/common/common/logger_delegates.h"
@@ -73,6 +74,10 @@ struct ServerCompilationSettingsStats {
   COUNTER(static_unknown_fields)                                                                   \
   COUNTER(wip_protos)                                                                              \
   COUNTER(dropped_stat_flushes)                                                                    \
+  COUNTER(buffer_slice_pool_hits)                                                                  \
+  COUNTER(buffer_slice_pool_misses)                                                                \
+  COUNTER(buffer_slice_pool_watermark_releases)                                                    \
+  GAUGE(buffer_slice_pool_cached_bytes, NeverImport)                                               \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, NeverImport)                                               \
   GAUGE(seconds_until_first_ocsp_response_expiring, NeverImport)                                   \
@@ -341,6 +346,9 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // The buffer slice pool totals as of the last stats update, so that the counters can be bumped
+  // by the change since then.
+  Buffer::SliceStoragePool::Stats last_slice_pool_stats_;
   std::unique_ptr<CompilationSettings::ServerCompilationSettingsStats>
       server_compilation_settings_stats_;
   Assert::ActionRegistrationPtr assert_action_registration_;
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "source/common/access_log/access_log_manager_impl.h"
 #include "source/common/filesystem/file_shared_impl.h"
@@ -11,6 +14,7 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -460,6 +464,218 @@ TEST_F(AccessLogManagerImplTest, BigDataChunkShouldBeFlushedWithoutTimer) {
   EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, WritesFromManyThreadsAreAllFlushed) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  std::string written;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        written.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  // Each thread writes to a ring buffer of its own.
+  const uint32_t num_threads = 4;
+  const uint32_t writes_per_thread = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (uint32_t j = 0; j < writes_per_thread; j++) {
+        log_file->write(absl::StrCat(i, "\n"));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  log_file->flush();
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    for (uint32_t i = 0; i < num_threads; i++) {
+      EXPECT_EQ(writes_per_thread,
+                static_cast<uint32_t>(std::count(written.begin(), written.end(), '0' + i)));
+    }
+  }
+  EXPECT_EQ(num_threads * writes_per_thread, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(0UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, WriteLargerThanRingBuffer) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  const std::string big_string(1024 * 1024, 'b');
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(big_string, data);
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log_file->write(big_string);
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST(AccessLogRingBufferTest, GrowKeepsBufferedData) {
+  AccessLogRingBuffer ring_buffer(8);
+  std::string output;
+  // Leave the buffered data wrapped around the end of the ring.
+  EXPECT_TRUE(ring_buffer.write("abcdef"));
+  EXPECT_EQ(6UL, ring_buffer.drainTo(output));
+  EXPECT_TRUE(ring_buffer.write("ghijkl"));
+  EXPECT_FALSE(ring_buffer.write("mnop"));
+
+  AccessLogRingBufferPtr grown = ring_buffer.grow();
+  EXPECT_EQ(16UL, grown->capacity());
+  EXPECT_EQ(6UL, grown->length());
+  EXPECT_TRUE(grown->write("mnop"));
+  output.clear();
+  EXPECT_EQ(10UL, grown->drainTo(output));
+  EXPECT_EQ("ghijklmnop", output);
+}
+
+class AccessLogOverflowPolicyTest : public AccessLogManagerImplTest {
+protected:
+  AccessLogFileSharedPtr createAccessLog(Server::AccessLogOverflowPolicy overflow_policy) {
+    new NiceMock<Event::MockTimer>(&dispatcher_);
+    manager_ = std::make_unique<AccessLogManagerImpl>(timeout_40ms_, api_, dispatcher_, lock_,
+                                                      store_, overflow_policy);
+    EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    return manager_->createAccessLog(
+        Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+  }
+
+  // Stalls the disk until unblock() is called, so that the ring buffer of the test thread fills up.
+  void blockWrites() {
+    EXPECT_CALL(*file_, write_(_))
+        .WillRepeatedly(Invoke([this](absl::string_view data) -> Api::IoCallSizeResult {
+          Thread::LockGuard lock(disk_lock_);
+          disk_entered_ = true;
+          disk_event_.notifyAll();
+          while (disk_blocked_) {
+            disk_event_.wait(disk_lock_);
+          }
+          bytes_written_ += data.size();
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+  }
+
+  void unblockWrites() {
+    Thread::LockGuard lock(disk_lock_);
+    disk_blocked_ = false;
+    disk_event_.notifyAll();
+  }
+
+  uint64_t bytesWritten() {
+    Thread::LockGuard lock(disk_lock_);
+    return bytes_written_;
+  }
+
+  // The first write is flushed right away. Waits for the flush thread to get stuck writing it.
+  void stallFlushThread(AccessLogFile& log_file) {
+    log_file.write("first");
+    Thread::LockGuard lock(disk_lock_);
+    while (!disk_entered_) {
+      disk_event_.wait(disk_lock_);
+    }
+  }
+
+  std::unique_ptr<AccessLogManagerImpl> manager_;
+  Thread::MutexBasicLockable disk_lock_;
+  Thread::CondVar disk_event_;
+  bool disk_entered_ ABSL_GUARDED_BY(disk_lock_){};
+  bool disk_blocked_ ABSL_GUARDED_BY(disk_lock_){true};
+  uint64_t bytes_written_ ABSL_GUARDED_BY(disk_lock_){};
+};
+
+TEST_F(AccessLogOverflowPolicyTest, Drop) {
+  AccessLogFileSharedPtr log_file = createAccessLog(Server::AccessLogOverflowPolicy::Drop);
+  blockWrites();
+  stallFlushThread(*log_file);
+
+  // 256KiB of writes grow the ring buffer to its largest size and fill it up while the disk is
+  // stalled, so the last one is dropped.
+  const std::string line(1024, 'a');
+  for (uint32_t i = 0; i < 256 + 1; i++) {
+    log_file->write(line);
+  }
+  EXPECT_EQ(1UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_blocked").value());
+
+  unblockWrites();
+  log_file->flush();
+  EXPECT_EQ(5UL + 256 * 1024, bytesWritten());
+  EXPECT_EQ(0UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  log_file.reset();
+  manager_.reset();
+}
+
+TEST_F(AccessLogOverflowPolicyTest, Buffer) {
+  AccessLogFileSharedPtr log_file = createAccessLog(Server::AccessLogOverflowPolicy::Buffer);
+  blockWrites();
+  stallFlushThread(*log_file);
+
+  const std::string line(1024, 'a');
+  for (uint32_t i = 0; i < 256 + 1; i++) {
+    log_file->write(line);
+  }
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_blocked").value());
+
+  unblockWrites();
+  log_file->flush();
+  EXPECT_EQ(5UL + (256 + 1) * 1024, bytesWritten());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  log_file.reset();
+  manager_.reset();
+}
+
+TEST_F(AccessLogOverflowPolicyTest, Block) {
+  AccessLogFileSharedPtr log_file = createAccessLog(Server::AccessLogOverflowPolicy::Block);
+  blockWrites();
+  stallFlushThread(*log_file);
+
+  const std::string line(1024, 'a');
+  for (uint32_t i = 0; i < 256; i++) {
+    log_file->write(line);
+  }
+
+  // The ring buffer is full, so the next write waits until the disk catches up.
+  Thread::ThreadPtr unblock_thread = thread_factory_.createThread([this]() {
+    waitForCounterEq("filesystem.write_blocked", 1);
+    unblockWrites();
+  });
+  log_file->write(line);
+  unblock_thread->join();
+  EXPECT_EQ(0UL, store_.counter("filesystem.write_dropped").value());
+
+  log_file->flush();
+  EXPECT_EQ(5UL + (256 + 1) * 1024, bytesWritten());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  log_file.reset();
+  manager_.reset();
+}
+
 TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
 
@@ -181,6 +181,11 @@ public:
     return asStringView().find({static_cast<const char*>(data), size}, start);
   }
 
+  ssize_t findFirstOf(absl::string_view bytes, size_t start, size_t length) const override {
+    UNREFERENCED_PARAMETER(length);
+    return asStringView().find_first_of(bytes, start);
+  }
+
   bool startsWith(absl::string_view data) const override {
     return absl::StartsWith(asStringView(), data);
   }
@@ -419,6 +424,13 @@ uint32_t bufferAction(Context& ctxt, char insert_value, uint32_t max_alloc, Buff
                 static_cast<ssize_t>(target_buffer.toString().find(content, offset)));
     break;
   }
+  case test::common::buffer::Action::kFindFirstOf: {
+    const std::string& bytes = action.find_first_of().bytes();
+    const uint32_t offset = action.find_first_of().offset();
+    FUZZ_ASSERT(target_buffer.findFirstOf(bytes, offset) ==
+                static_cast<ssize_t>(target_buffer.toString().find_first_of(bytes, offset)));
+    break;
+  }
   case test::common::buffer::Action::kStartsWith: {
     const std::string data = target_buffer.toString();
     FUZZ_ASSERT(target_buffer.startsWith(action.starts_with()) ==
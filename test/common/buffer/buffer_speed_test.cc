@@ -1,6 +1,7 @@
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/assert.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 
@@ -258,6 +259,64 @@ BENCHMARK(bufferReserveCommitPartial)
     ->Arg(64 * 1024)
     ->Arg(128 * 1024);
 
+// Create and destroy buffers whose sizes cycle through every slice size class and beyond, so that
+// each iteration allocates and frees slice storage of a different size. Run with several threads
+// to expose contention in the allocator.
+static void bufferAllocateMixedSizes(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+  uint64_t length = 0;
+  uint64_t size = 1;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    Buffer::OwnedImpl buffer(absl::string_view(data).substr(0, size));
+    length += buffer.length();
+    size = (size + 4093) % data.size() + 1;
+  }
+  benchmark::DoNotOptimize(length);
+}
+BENCHMARK(bufferAllocateMixedSizes)->Arg(65536)->Arg(128 * 1024)->Threads(1)->Threads(4);
+
+// Stream a large body through a pair of buffers in odd-sized chunks, the way a proxied body moves
+// from a read buffer to a write buffer, draining the write buffer as it fills up.
+static void bufferStreamLargeBody(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+  const absl::string_view input(data);
+  Buffer::OwnedImpl read_buffer;
+  Buffer::OwnedImpl write_buffer;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    read_buffer.add(input);
+    write_buffer.move(read_buffer);
+    if (write_buffer.length() >= MaxBufferLength) {
+      write_buffer.drain(write_buffer.length());
+    }
+  }
+  benchmark::DoNotOptimize(write_buffer.length());
+}
+BENCHMARK(bufferStreamLargeBody)
+    ->Arg(1000)
+    ->Arg(5000)
+    ->Arg(20000)
+    ->Arg(50000)
+    ->Arg(100000)
+    ->Threads(1)
+    ->Threads(4);
+
+// Reserve a single slice of an odd size, commit part of it, and drain the buffer, so that the
+// slice storage is freed on every iteration.
+static void bufferReserveSingleSliceDrain(benchmark::State& state) {
+  Buffer::OwnedImpl buffer;
+  const uint64_t size = state.range(0);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    auto reservation = buffer.reserveSingleSlice(size);
+    reservation.commit(size / 2);
+    buffer.drain(buffer.length());
+  }
+  benchmark::DoNotOptimize(buffer.length());
+}
+BENCHMARK(bufferReserveSingleSliceDrain)->Arg(1000)->Arg(10000)->Arg(40000)->Arg(100000);
+
 // Test the linearization of a buffer in the best case where the data is in one slice.
 static void bufferLinearizeSimple(benchmark::State& state) {
   const std::string data(state.range(0), 'a');
@@ -338,6 +397,47 @@ static void bufferSearchPartialMatch(benchmark::State& state) {
 }
 BENCHMARK(bufferSearchPartialMatch)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
 
+// Test buffer search in a large buffer made of many slices, such as a streamed body, for a
+// boundary string which shares its first byte with much of the content.
+static void bufferSearchMultiSlice(benchmark::State& state) {
+  const std::string Pattern("\r\n--boundary");
+  const std::string chunk = absl::StrCat(std::string(1000, 'a'), "\r\n");
+  Buffer::OwnedImpl buffer;
+  while (buffer.length() < static_cast<uint64_t>(state.range(0))) {
+    buffer.appendSliceForTest(chunk);
+  }
+  buffer.add(Pattern);
+  ssize_t result = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    result += buffer.search(Pattern.c_str(), Pattern.length(), 0, 0);
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(bufferSearchMultiSlice)->Arg(16384)->Arg(1024 * 1024);
+
+// Test scanning a buffer for the first of a set of bytes, with sets which are compared one member
+// at a time and sets which use a lookup table.
+static void bufferFindFirstOf(benchmark::State& state) {
+  const std::string Bytes = std::string("\r\n\"\\<>{}[]|^`").substr(0, state.range(1));
+  std::string data(state.range(0), 'a');
+  data += Bytes.back();
+  Buffer::OwnedImpl buffer(data);
+  ssize_t result = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    result += buffer.findFirstOf(Bytes, 0, 0);
+  }
+  benchmark::DoNotOptimize(result);
+}
+BENCHMARK(bufferFindFirstOf)
+    ->Args({4096, 1})
+    ->Args({4096, 2})
+    ->Args({4096, 8})
+    ->Args({4096, 14})
+    ->Args({65536, 2})
+    ->Args({65536, 14});
+
 // Test buffer startsWith, for the simple case where there is no match for the pattern at the start
 // of the buffer.
 static void bufferStartsWith(benchmark::State& state) {
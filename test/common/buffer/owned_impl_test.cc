@@ -9,6 +9,7 @@
 #include "test/common/buffer/utility.h"
 #include "test/mocks/api/mocks.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
@@ -899,6 +900,85 @@ TEST_F(OwnedImplTest, SliceFreeList) {
   }
 }
 
+TEST_F(OwnedImplTest, SliceStoragePoolSizeClasses) {
+  SliceStoragePool pool;
+
+  // Each page-sized size class has its own free list.
+  auto storage_4k = pool.allocate(4096);
+  auto storage_12k = pool.allocate(12288);
+  uint8_t* mem_4k = storage_4k.get();
+  uint8_t* mem_12k = storage_12k.get();
+  pool.release(std::move(storage_4k), 4096);
+  pool.release(std::move(storage_12k), 12288);
+  EXPECT_EQ(16384, pool.stats().cached_bytes_);
+
+  EXPECT_EQ(mem_12k, pool.allocate(12288).get());
+  EXPECT_EQ(mem_4k, pool.allocate(4096).get());
+  EXPECT_EQ(2, pool.stats().hits_);
+  EXPECT_EQ(2, pool.stats().misses_);
+  EXPECT_EQ(0, pool.stats().cached_bytes_);
+
+  // Storage larger than the largest size class is never cached.
+  const uint64_t large = SliceStoragePool::max_pooled_size_ + SliceStoragePool::page_size_;
+  pool.release(pool.allocate(large), large);
+  EXPECT_EQ(0, pool.stats().cached_bytes_);
+  EXPECT_EQ(3, pool.stats().misses_);
+
+  // Each free list holds a bounded number of entries.
+  std::vector<SliceStoragePool::StoragePtr> storage;
+  for (uint32_t i = 0; i < SliceStoragePool::free_list_max_ + 1; i++) {
+    storage.push_back(pool.allocate(4096));
+  }
+  for (auto& s : storage) {
+    pool.release(std::move(s), 4096);
+  }
+  EXPECT_EQ(SliceStoragePool::free_list_max_ * 4096, pool.stats().cached_bytes_);
+
+  pool.clear();
+  EXPECT_EQ(0, pool.stats().cached_bytes_);
+}
+
+TEST_F(OwnedImplTest, SliceStoragePoolWatermarks) {
+  SliceStoragePool pool;
+
+  // Fill the free lists of the largest size classes until the cache goes over the high watermark.
+  std::vector<std::pair<SliceStoragePool::StoragePtr, uint64_t>> storage;
+  uint64_t total = 0;
+  for (uint64_t capacity = SliceStoragePool::max_pooled_size_;
+       total <= SliceStoragePool::high_watermark_bytes_; capacity -= SliceStoragePool::page_size_) {
+    for (uint32_t i = 0; i < SliceStoragePool::free_list_max_; i++) {
+      storage.emplace_back(pool.allocate(capacity), capacity);
+      total += capacity;
+    }
+  }
+  for (auto& entry : storage) {
+    pool.release(std::move(entry.first), entry.second);
+  }
+
+  const SliceStoragePool::Stats stats = pool.stats();
+  EXPECT_LE(stats.cached_bytes_, SliceStoragePool::high_watermark_bytes_);
+  EXPECT_GT(stats.cached_bytes_, 0);
+  EXPECT_GT(stats.watermark_releases_, 0);
+}
+
+TEST_F(OwnedImplTest, SliceStoragePoolAggregateStats) {
+  const SliceStoragePool::Stats before = SliceStoragePool::aggregateStats();
+
+  // Stats survive the exit of the thread whose pool they were collected by.
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([]() {
+    OwnedImpl buffer(std::string(5000, 'a'));
+    buffer.drain(buffer.length());
+    OwnedImpl other(std::string(5000, 'a'));
+  });
+  thread->join();
+
+  const SliceStoragePool::Stats after = SliceStoragePool::aggregateStats();
+  EXPECT_EQ(before.misses_ + 1, after.misses_);
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+  // The exiting thread hands its cached storage back to the allocator.
+  EXPECT_EQ(before.cached_bytes_, after.cached_bytes_);
+}
+
 TEST_F(OwnedImplTest, Search) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the search implementation.
@@ -961,6 +1041,59 @@ TEST_F(OwnedImplTest, SearchWithLengthLimit) {
   EXPECT_EQ(12, buffer.search("ba", 2, 11, 10e6));
 }
 
+TEST_F(OwnedImplTest, SearchLargeSlices) {
+  // Slices long enough to be scanned a block at a time, with near misses on both sides of the
+  // slice boundaries.
+  const std::string first = std::string(40, 'x') + "needlx" + std::string(20, 'x') + "nee";
+  const std::string second = "dle" + std::string(30, 'n') + "eedle";
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(first);
+  buffer.appendSliceForTest(second);
+
+  // The first match spans the two slices.
+  EXPECT_EQ(66, buffer.search("needle", 6, 0, 0));
+  EXPECT_EQ(66, buffer.search("needle", 6, 66, 6));
+  EXPECT_EQ(-1, buffer.search("needle", 6, 66, 5));
+  // The second match is within the second slice.
+  EXPECT_EQ(101, buffer.search("needle", 6, 67, 0));
+  EXPECT_EQ(-1, buffer.search("needle", 6, 102, 0));
+  EXPECT_EQ(40, buffer.search("needlx", 6, 0, 0));
+  EXPECT_EQ(-1, buffer.search("needles", 7, 0, 0));
+}
+
+TEST_F(OwnedImplTest, FindFirstOf) {
+  static const char* Inputs[] = {"ab", "a", "", "aaa", "b", "a", "aaa", "ab", "a"};
+  Buffer::OwnedImpl buffer;
+  for (const auto& input : Inputs) {
+    buffer.appendSliceForTest(input);
+  }
+  EXPECT_STREQ("abaaaabaaaaaba", buffer.toString().c_str());
+
+  EXPECT_EQ(-1, buffer.findFirstOf("", 0, 0));
+  EXPECT_EQ(-1, buffer.findFirstOf("c", 0, 0));
+  EXPECT_EQ(0, buffer.findFirstOf("a", 0, 0));
+  EXPECT_EQ(1, buffer.findFirstOf("b", 0, 0));
+  EXPECT_EQ(6, buffer.findFirstOf("b", 2, 0));
+  EXPECT_EQ(6, buffer.findFirstOf("cb", 2, 0));
+  EXPECT_EQ(12, buffer.findFirstOf("b", 7, 0));
+  EXPECT_EQ(-1, buffer.findFirstOf("b", 13, 0));
+  EXPECT_EQ(-1, buffer.findFirstOf("a", buffer.length(), 0));
+  EXPECT_EQ(-1, buffer.findFirstOf("a", buffer.length() + 1, 0));
+  // Limit the search length.
+  EXPECT_EQ(-1, buffer.findFirstOf("b", 2, 4));
+  EXPECT_EQ(6, buffer.findFirstOf("b", 2, 5));
+
+  // Large slices and sets of bytes too large to be compared one member at a time.
+  Buffer::OwnedImpl large;
+  large.appendSliceForTest(std::string(100, 'a'));
+  large.appendSliceForTest(std::string(50, 'a') + "\r\n");
+  EXPECT_EQ(150, large.findFirstOf("\r\n", 0, 0));
+  EXPECT_EQ(151, large.findFirstOf("\n", 0, 0));
+  EXPECT_EQ(150, large.findFirstOf("0123456789\r\n", 10, 0));
+  EXPECT_EQ(-1, large.findFirstOf("0123456789\r\n", 10, 140));
+  EXPECT_EQ(-1, large.findFirstOf("\r\n", 0, 150));
+}
+
 TEST_F(OwnedImplTest, StartsWith) {
   // Populate a buffer with a string split across many small slices, to
   // exercise edge cases in the startsWith implementation.
@@ -1,5 +1,7 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <cmath>
+
 #include "test/common/upstream/utility.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/cluster_info.h"
@@ -473,5 +475,75 @@ TEST_F(ConnPoolImplBaseTest, PoolIdleCallbackTriggeredLocalClose) {
   pool_.drainConnectionsImpl(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
 }
 
+TEST(DemandEstimatorTest, NoEstimateBeforeFirstConnection) {
+  DemandEstimator estimator(std::chrono::seconds(1));
+  const MonotonicTime now{std::chrono::seconds(10)};
+  for (int i = 0; i < 100; ++i) {
+    estimator.onStreamArrival(now);
+  }
+  EXPECT_EQ(0, estimator.anticipatedStreams(now));
+}
+
+TEST(DemandEstimatorTest, AnticipatedStreams) {
+  DemandEstimator estimator(std::chrono::seconds(1));
+  MonotonicTime now{std::chrono::seconds(10)};
+  estimator.onConnected(std::chrono::milliseconds(100));
+
+  // 1000 streams per second over many time constants converges on 1000 * 0.1s = 100 streams.
+  for (int i = 0; i < 10000; ++i) {
+    now += std::chrono::milliseconds(1);
+    estimator.onStreamArrival(now);
+  }
+  EXPECT_NEAR(100, estimator.anticipatedStreams(now), 1);
+
+  // The rate estimate decays once streams stop arriving.
+  EXPECT_NEAR(100 * std::exp(-1), estimator.anticipatedStreams(now + std::chrono::seconds(1)), 1);
+
+  // Connect latency samples are smoothed rather than replacing the estimate.
+  estimator.onConnected(std::chrono::milliseconds(900));
+  EXPECT_NEAR(200, estimator.anticipatedStreams(now), 2);
+}
+
+TEST_F(ConnPoolImplDispatcherBaseTest, PreconnectForAnticipatedDemand) {
+  ON_CALL(*cluster_, preconnectDemandTimeConstant)
+      .WillByDefault(Return(absl::make_optional(std::chrono::milliseconds(1000))));
+  TestConnPoolImplBase pool(host_, Upstream::ResourcePriority::Default, *dispatcher_, nullptr,
+                            nullptr, state_);
+  std::vector<TestActiveClient*> clients;
+  ON_CALL(pool, instantiateActiveClient).WillByDefault(Invoke([&]() -> ActiveClientPtr {
+    auto ret = std::make_unique<NiceMock<TestActiveClient>>(pool, 100, 100);
+    clients.push_back(ret.get());
+    ret->real_host_description_ = descr_;
+    return ret;
+  }));
+  ON_CALL(pool, onPoolReady(_, _))
+      .WillByDefault(Invoke([](ActiveClient& client, AttachContext&) {
+        TestActiveClient::incrementActiveStreams(client);
+      }));
+
+  // The first connection takes 100ms to establish.
+  pool.newStreamImpl(context_);
+  ASSERT_EQ(1, clients.size());
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  clients[0]->onEvent(Network::ConnectionEvent::Connected);
+
+  // At 1000 streams per second about 9 streams are expected per connection establishment time,
+  // which the first connection absorbs until it is within that many streams of its limit.
+  for (int i = 0; i < 80; ++i) {
+    time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+    pool.newStreamImpl(context_);
+  }
+  EXPECT_EQ(1, clients.size());
+  for (int i = 0; i < 15; ++i) {
+    time_system_.advanceTimeWait(std::chrono::milliseconds(1));
+    pool.newStreamImpl(context_);
+  }
+  EXPECT_EQ(2, clients.size());
+  EXPECT_EQ(ActiveClient::State::READY, clients[0]->state());
+  EXPECT_EQ(ActiveClient::State::CONNECTING, clients[1]->state());
+
+  pool.destructAllConnections();
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
@@ -1,5 +1,6 @@
 #include "source/common/formatter/substitution_formatter.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/protobuf/utility.h"
 
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
@@ -53,6 +54,15 @@ std::unique_ptr<Envoy::TestStreamInfo> makeStreamInfo() {
   return stream_info;
 }
 
+Http::TestRequestHeaderMapImpl makeRequestHeaders() {
+  return {{":method", "GET"},
+          {":authority", "www.example.com"},
+          {":path", "/api/v1/resources/1234567890?query=value&other=value"},
+          {"x-forwarded-proto", "https"},
+          {"referer", "https://www.example.com/index.html"},
+          {"user-agent", "Mozilla/5.0 (X11; Linux x86_64; rv:93.0) Gecko/20100101 Firefox/93.0"}};
+}
+
 } // namespace
 
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -81,6 +91,33 @@ static void BM_AccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_AccessLogFormatter);
 
+// Like BM_AccessLogFormatter, with the logged request headers present.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_AccessLogFormatterWithHeaders(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  static const char* LogFormat =
+      "%DOWNSTREAM_REMOTE_ADDRESS_WITHOUT_PORT% %START_TIME(%Y/%m/%dT%H:%M:%S%z %s)% "
+      "%REQ(:METHOD)% "
+      "%REQ(X-FORWARDED-PROTO)%://%REQ(:AUTHORITY)%%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)% %PROTOCOL% "
+      "s%RESPONSE_CODE% %BYTES_SENT% %DURATION% %REQ(REFERER)% \"%REQ(USER-AGENT)%\" - - -\n";
+
+  std::unique_ptr<Envoy::Formatter::FormatterImpl> formatter =
+      std::make_unique<Envoy::Formatter::FormatterImpl>(LogFormat, false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes +=
+        formatter->format(request_headers, response_headers, response_trailers, *stream_info, body)
+            .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_AccessLogFormatterWithHeaders);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_StructAccessLogFormatter(benchmark::State& state) {
   std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
@@ -163,6 +200,48 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// Like BM_JsonAccessLogFormatter, with the logged request headers present.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonAccessLogFormatterWithHeaders(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> json_formatter = makeJsonFormatter(false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes +=
+        json_formatter
+            ->format(request_headers, response_headers, response_trailers, *stream_info, body)
+            .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_JsonAccessLogFormatterWithHeaders);
+
+// The JSON formatting BM_JsonAccessLogFormatterWithHeaders replaces, which builds a Struct and
+// serializes it.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_StructToJsonAccessLogFormatterWithHeaders(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  std::unique_ptr<Envoy::Formatter::StructFormatter> struct_formatter = makeStructFormatter(false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers = makeRequestHeaders();
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const ProtobufWkt::Struct output_struct = struct_formatter->format(
+        request_headers, response_headers, response_trailers, *stream_info, body);
+    output_bytes += MessageUtil::getJsonStringFromMessageOrDie(output_struct, false, true).length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_StructToJsonAccessLogFormatterWithHeaders);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_FormatterCommandParsing(benchmark::State& state) {
   const std::string token = "(Listener:namespace:key):100";
@@ -1636,6 +1636,62 @@ TEST(SubstitutionFormatterTest, FilterStateFormatter) {
   }
 }
 
+TEST(SubstitutionFormatterTest, TimingBreakdownFormatter) {
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  std::string body;
+
+  {
+    // The timing breakdown is not recorded.
+    TimingBreakdownFormatter formatter("ROUTE_SELECTION", "", "");
+    EXPECT_EQ(absl::nullopt, formatter.format(request_headers, response_headers, response_trailers,
+                                              stream_info, body));
+    EXPECT_THAT(formatter.formatValue(request_headers, response_headers, response_trailers,
+                                      stream_info, body),
+                ProtoEq(ValueUtil::nullValue()));
+  }
+
+  stream_info.enableTimingBreakdown();
+  StreamInfo::TimingBreakdown& timing_breakdown = *stream_info.timingBreakdown();
+  timing_breakdown.route_selection_ = std::chrono::microseconds(12);
+  timing_breakdown.host_selection_ = std::chrono::microseconds(34);
+  timing_breakdown.connection_pool_wait_ = std::chrono::microseconds(5600);
+  timing_breakdown.codec_encode_ = std::chrono::nanoseconds(78999);
+  timing_breakdown.filters_[timing_breakdown.addFilter("envoy.filters.http.buffer")].decode_ =
+      std::chrono::microseconds(9);
+  timing_breakdown.filters_[timing_breakdown.addFilter("envoy.filters.http.router")].encode_ =
+      std::chrono::microseconds(10);
+
+  const std::vector<std::pair<std::string, uint64_t>> test_cases = {
+      {"%TIMING_BREAKDOWN(ROUTE_SELECTION)%", 12},
+      {"%TIMING_BREAKDOWN(HOST_SELECTION)%", 34},
+      {"%TIMING_BREAKDOWN(CONNECTION_POOL_WAIT)%", 5600},
+      {"%TIMING_BREAKDOWN(CODEC_ENCODE)%", 78},
+      {"%TIMING_BREAKDOWN(FILTER:envoy.filters.http.buffer:DECODE)%", 9},
+      {"%TIMING_BREAKDOWN(FILTER:envoy.filters.http.buffer:ENCODE)%", 0},
+      {"%TIMING_BREAKDOWN(FILTER:envoy.filters.http.router:ENCODE)%", 10}};
+  for (const auto& test_case : test_cases) {
+    std::vector<FormatterProviderPtr> formatters = SubstitutionFormatParser::parse(test_case.first);
+    ASSERT_EQ(1U, formatters.size());
+    EXPECT_EQ(std::to_string(test_case.second),
+              formatters[0]->format(request_headers, response_headers, response_trailers,
+                                    stream_info, body))
+        << test_case.first;
+    EXPECT_THAT(formatters[0]->formatValue(request_headers, response_headers, response_trailers,
+                                           stream_info, body),
+                ProtoEq(ValueUtil::numberValue(test_case.second)));
+  }
+
+  {
+    // The filter is not in the filter chain of the stream.
+    TimingBreakdownFormatter formatter("FILTER", "envoy.filters.http.lua", "DECODE");
+    EXPECT_EQ(absl::nullopt, formatter.format(request_headers, response_headers, response_trailers,
+                                              stream_info, body));
+  }
+}
+
 TEST(SubstitutionFormatterTest, DownstreamPeerCertVStartFormatter) {
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
   Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/"}};
@@ -2638,6 +2694,66 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterDirectSerialization) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{"first", "a\"b\\c\td"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    plain: 'plain "quoted" \ value'
+    protocol: '%PROTOCOL%'
+    missing: '%REQ(missing)%'
+    multi: '%REQ(first)% and %REQ(missing)%'
+    request_duration: '%REQUEST_DURATION%'
+    nested:
+      header: '%REQ(first):3%'
+      missing: '%RESP(missing)%'
+    list:
+      - '%REQ(first)%'
+      - '%RESP(missing)%'
+      - nested_in_list: '%PROTOCOL%'
+  )EOF",
+                            key_mapping);
+
+  {
+    // Fields are written in the order of their keys.
+    JsonFormatterImpl formatter(key_mapping, false, true);
+    EXPECT_EQ(
+        R"({"list":["a\"b\\c\td",{"nested_in_list":"HTTP/1.1"}],)"
+        R"("multi":"a\"b\\c\td and ","nested":{"header":"a\"b"},)"
+        R"("plain":"plain \"quoted\" \\ value","protocol":"HTTP/1.1","request_duration":"5"})"
+        "\n",
+        formatter.format(request_header, response_header, response_trailer, stream_info, body));
+  }
+
+  // The output matches the one which goes through a Struct, whatever the options.
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      const std::string direct =
+          JsonFormatterImpl(key_mapping, preserve_types, omit_empty_values)
+              .format(request_header, response_header, response_trailer, stream_info, body);
+
+      TestScopedRuntime scoped_runtime;
+      Runtime::LoaderSingleton::getExisting()->mergeValues(
+          {{"envoy.reloadable_features.direct_json_access_log_serialization", "false"}});
+      const std::string legacy =
+          JsonFormatterImpl(key_mapping, preserve_types, omit_empty_values)
+              .format(request_header, response_header, response_trailer, stream_info, body);
+
+      EXPECT_TRUE(TestUtility::jsonStringEqual(direct, legacy)) << direct << " vs " << legacy;
+      EXPECT_EQ('\n', direct.back());
+    }
+  }
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   NiceMock<StreamInfo::MockStreamInfo> stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
@@ -2941,6 +3057,12 @@ TEST(SubstitutionFormatterTest, ParserFailures) {
       "%DYNAMIC_METADATA(TEST",
       "%FILTER_STATE(TEST",
       "%FILTER_STATE()%",
+      "%TIMING_BREAKDOWN()%",
+      "%TIMING_BREAKDOWN(UNKNOWN)%",
+      "%TIMING_BREAKDOWN(ROUTE_SELECTION:envoy.filters.http.router)%",
+      "%TIMING_BREAKDOWN(FILTER)%",
+      "%TIMING_BREAKDOWN(FILTER:envoy.filters.http.router)%",
+      "%TIMING_BREAKDOWN(FILTER:envoy.filters.http.router:RESPONSE)%",
       "%START_TIME(%85n)%",
       "%START_TIME(%#__88n)%",
       "%START_TIME(%En%)%",
@@ -176,6 +176,7 @@ public:
   const absl::optional<std::string>& schemeToSet() const override { return scheme_; }
   ConnectionManagerStats& stats() override { return stats_; }
   ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  TimingBreakdownStats* timingBreakdownStats() override { return nullptr; }
   bool useRemoteAddress() const override { return use_remote_address_; }
   const Http::InternalAddressConfig& internalAddressConfig() const override {
     return internal_address_config_;
@@ -1923,6 +1923,292 @@ TEST_F(HttpConnectionManagerImplTest,
   conn_manager_->onData(fake_input, false);
 }
 
+TEST_F(HttpConnectionManagerImplTest, TailSamplingRecordsAndDiscardsUnsampledRequest) {
+  setup(false, "");
+  envoy::type::v3::FractionalPercent percent1;
+  percent1.set_numerator(100);
+  envoy::type::v3::FractionalPercent percent2;
+  percent2.set_numerator(10000);
+  percent2.set_denominator(envoy::type::v3::FractionalPercent::TEN_THOUSAND);
+  auto tail_sampler = std::make_shared<Tracing::TailSampler>(
+      std::chrono::milliseconds(1000), true, 100, test_time_.timeSystem(), fake_stats_,
+      "tracing.tail_sampling.");
+  tracing_config_ = std::make_unique<TracingConnectionManagerConfig>(
+      TracingConnectionManagerConfig{Tracing::OperationName::Ingress,
+                                     {},
+                                     percent1,
+                                     percent2,
+                                     percent1,
+                                     false,
+                                     256,
+                                     tail_sampler});
+
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .WillOnce(Return(false));
+
+  // The request is not sampled, but it is recorded for the tail sampler.
+  auto* span = new NiceMock<Tracing::MockSpan>();
+  EXPECT_CALL(*tracer_, startSpan_(_, _, _, _))
+      .WillOnce(Invoke([&](const Tracing::Config&, const RequestHeaderMap&,
+                           const StreamInfo::StreamInfo&,
+                           const Tracing::Decision decision) -> Tracing::Span* {
+        EXPECT_TRUE(decision.traced);
+        return span;
+      }));
+  // The request is fast and succeeds, so its span is discarded.
+  EXPECT_CALL(*span, finishSpan()).Times(0);
+  EXPECT_CALL(*span, setSampled(false));
+  EXPECT_CALL(*route_config_provider_.route_config_->route_, decorator())
+      .WillRepeatedly(Return(nullptr));
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(filter);
+      }));
+
+  // Treat request as internal, otherwise x-request-id header will be overwritten.
+  use_remote_address_ = false;
+  EXPECT_CALL(random_, uuid()).Times(0);
+
+  EXPECT_CALL(*codec_, dispatch(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Http::Status {
+        decoder_ = &conn_manager_->newStream(response_encoder_);
+
+        RequestHeaderMapPtr headers{
+            new TestRequestHeaderMapImpl{{":method", "GET"},
+                                         {":authority", "host"},
+                                         {":path", "/"},
+                                         {"x-request-id", "125a4afb-6f55-a4ba-ad80-413f09f48a28"}}};
+        decoder_->decodeHeaders(std::move(headers), true);
+
+        filter->callbacks_->streamInfo().setResponseCodeDetails("");
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+        data.drain(4);
+        return Http::okStatus();
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  EXPECT_EQ(1U, tail_sampler->stats().traces_discarded_.value());
+  EXPECT_EQ(0U, tail_sampler->stats().traces_kept_.value());
+}
+
+TEST_F(HttpConnectionManagerImplTest, TimingBreakdownRecordsFiltersAndCodec) {
+  setup(false, "");
+  timing_breakdown_stats_ = std::make_unique<TimingBreakdownStats>(
+      std::vector<std::string>{"decoder", "encoder"}, "timing_breakdown.", fake_stats_);
+  auto advance_time = [this](std::chrono::milliseconds duration) {
+    test_time_.setMonotonicTime(test_time_.timeSystem().monotonicTime() + duration);
+  };
+
+  std::shared_ptr<MockStreamDecoderFilter> decoder_filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamEncoderFilter> encoder_filter(new NiceMock<MockStreamEncoderFilter>());
+  std::shared_ptr<AccessLog::MockInstance> handler(new NiceMock<AccessLog::MockInstance>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterConfigName("decoder");
+        callbacks.addStreamDecoderFilter(decoder_filter);
+        callbacks.setFilterConfigName("encoder");
+        callbacks.addStreamEncoderFilter(encoder_filter);
+        callbacks.addAccessLogHandler(handler);
+      }));
+
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        advance_time(std::chrono::milliseconds(5));
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        advance_time(std::chrono::milliseconds(3));
+        return FilterHeadersStatus::Continue;
+      }));
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() { advance_time(std::chrono::milliseconds(2)); }));
+
+  EXPECT_CALL(*handler, log(_, _, _, _))
+      .WillOnce(Invoke([](const HeaderMap*, const HeaderMap*, const HeaderMap*,
+                          const StreamInfo::StreamInfo& stream_info) {
+        const StreamInfo::TimingBreakdown* timing_breakdown = stream_info.timingBreakdown();
+        ASSERT_NE(nullptr, timing_breakdown);
+        ASSERT_EQ(2U, timing_breakdown->filters_.size());
+        EXPECT_EQ("decoder", timing_breakdown->filters_[0].name_);
+        EXPECT_EQ(std::chrono::milliseconds(5), timing_breakdown->filters_[0].decode_);
+        EXPECT_EQ(std::chrono::nanoseconds(0), timing_breakdown->filters_[0].encode_);
+        EXPECT_EQ("encoder", timing_breakdown->filters_[1].name_);
+        EXPECT_EQ(std::chrono::nanoseconds(0), timing_breakdown->filters_[1].decode_);
+        EXPECT_EQ(std::chrono::milliseconds(3), timing_breakdown->filters_[1].encode_);
+        EXPECT_EQ(std::chrono::milliseconds(2), timing_breakdown->codec_encode_);
+      }));
+
+  EXPECT_CALL(*codec_, dispatch(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Http::Status {
+        decoder_ = &conn_manager_->newStream(response_encoder_);
+
+        RequestHeaderMapPtr headers{new TestRequestHeaderMapImpl{
+            {":method", "GET"}, {":authority", "host"}, {":path", "/"}}};
+        decoder_->decodeHeaders(std::move(headers), true);
+
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        decoder_filter->callbacks_->streamInfo().setResponseCodeDetails("");
+        decoder_filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+        data.drain(4);
+        return Http::okStatus();
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+}
+
+TEST_F(HttpConnectionManagerImplTest, TimingBreakdownLeavesOutNestedTimingPoints) {
+  setup(false, "");
+  timing_breakdown_stats_ = std::make_unique<TimingBreakdownStats>(
+      std::vector<std::string>{"decoder", "encoder"}, "timing_breakdown.", fake_stats_);
+  auto advance_time = [this](std::chrono::milliseconds duration) {
+    test_time_.setMonotonicTime(test_time_.timeSystem().monotonicTime() + duration);
+  };
+
+  std::shared_ptr<MockStreamDecoderFilter> decoder_filter(new NiceMock<MockStreamDecoderFilter>());
+  std::shared_ptr<MockStreamEncoderFilter> encoder_filter(new NiceMock<MockStreamEncoderFilter>());
+  std::shared_ptr<AccessLog::MockInstance> handler(new NiceMock<AccessLog::MockInstance>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterConfigName("decoder");
+        callbacks.addStreamDecoderFilter(decoder_filter);
+        callbacks.setFilterConfigName("encoder");
+        callbacks.addStreamEncoderFilter(encoder_filter);
+        callbacks.addAccessLogHandler(handler);
+      }));
+
+  // The local reply runs the encoder filters and the codec within the decoder callback, whose
+  // time leaves theirs out.
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        advance_time(std::chrono::milliseconds(5));
+        decoder_filter->callbacks_->sendLocalReply(Code::Forbidden, "", nullptr, absl::nullopt,
+                                                   "");
+        advance_time(std::chrono::milliseconds(1));
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() -> FilterHeadersStatus {
+        advance_time(std::chrono::milliseconds(3));
+        return FilterHeadersStatus::Continue;
+      }));
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true))
+      .WillOnce(InvokeWithoutArgs([&]() { advance_time(std::chrono::milliseconds(2)); }));
+
+  EXPECT_CALL(*handler, log(_, _, _, _))
+      .WillOnce(Invoke([](const HeaderMap*, const HeaderMap*, const HeaderMap*,
+                          const StreamInfo::StreamInfo& stream_info) {
+        const StreamInfo::TimingBreakdown* timing_breakdown = stream_info.timingBreakdown();
+        ASSERT_NE(nullptr, timing_breakdown);
+        ASSERT_EQ(2U, timing_breakdown->filters_.size());
+        EXPECT_EQ(std::chrono::milliseconds(6), timing_breakdown->filters_[0].decode_);
+        EXPECT_EQ(std::chrono::milliseconds(3), timing_breakdown->filters_[1].encode_);
+        EXPECT_EQ(std::chrono::milliseconds(2), timing_breakdown->codec_encode_);
+      }));
+
+  EXPECT_CALL(*codec_, dispatch(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Http::Status {
+        decoder_ = &conn_manager_->newStream(response_encoder_);
+
+        RequestHeaderMapPtr headers{new TestRequestHeaderMapImpl{
+            {":method", "GET"}, {":authority", "host"}, {":path", "/"}}};
+        decoder_->decodeHeaders(std::move(headers), true);
+
+        data.drain(4);
+        return Http::okStatus();
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+}
+
+TEST_F(HttpConnectionManagerImplTest, TailSamplingPropagatesUnsampledRequest) {
+  setup(false, "");
+  envoy::type::v3::FractionalPercent percent1;
+  percent1.set_numerator(100);
+  envoy::type::v3::FractionalPercent percent2;
+  percent2.set_numerator(10000);
+  percent2.set_denominator(envoy::type::v3::FractionalPercent::TEN_THOUSAND);
+  auto tail_sampler = std::make_shared<Tracing::TailSampler>(
+      std::chrono::milliseconds(1000), true, 100, test_time_.timeSystem(), fake_stats_,
+      "tracing.tail_sampling.");
+  tracing_config_ = std::make_unique<TracingConnectionManagerConfig>(
+      TracingConnectionManagerConfig{Tracing::OperationName::Ingress,
+                                     {},
+                                     percent1,
+                                     percent2,
+                                     percent1,
+                                     false,
+                                     256,
+                                     tail_sampler});
+
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .WillOnce(Return(false));
+
+  // The span is recorded, but the context injected upstream carries the decision made up front.
+  auto* span = new NiceMock<Tracing::MockSpan>();
+  bool sampled = true;
+  ON_CALL(*span, setSampled(_)).WillByDefault(Invoke([&](bool value) { sampled = value; }));
+  absl::optional<bool> injected_sampled;
+  EXPECT_CALL(*span, injectContext(_)).WillOnce(Invoke([&](Tracing::TraceContext&) {
+    injected_sampled = sampled;
+  }));
+  EXPECT_CALL(*tracer_, startSpan_(_, _, _, _)).WillOnce(Return(span));
+  EXPECT_CALL(*route_config_provider_.route_config_->route_, decorator())
+      .WillRepeatedly(Return(nullptr));
+
+  std::shared_ptr<MockStreamDecoderFilter> filter(new NiceMock<MockStreamDecoderFilter>());
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillRepeatedly(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(filter);
+      }));
+
+  // Treat request as internal, otherwise x-request-id header will be overwritten.
+  use_remote_address_ = false;
+  EXPECT_CALL(random_, uuid()).Times(0);
+
+  EXPECT_CALL(*codec_, dispatch(_))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Http::Status {
+        decoder_ = &conn_manager_->newStream(response_encoder_);
+
+        RequestHeaderMapPtr headers{
+            new TestRequestHeaderMapImpl{{":method", "GET"},
+                                         {":authority", "host"},
+                                         {":path", "/"},
+                                         {"x-request-id", "125a4afb-6f55-a4ba-ad80-413f09f48a28"}}};
+        decoder_->decodeHeaders(std::move(headers), true);
+
+        TestRequestHeaderMapImpl upstream_headers;
+        filter->callbacks_->activeSpan().injectContext(upstream_headers);
+        EXPECT_TRUE(sampled);
+
+        filter->callbacks_->streamInfo().setResponseCodeDetails("");
+        ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+        filter->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+
+        data.drain(4);
+        return Http::okStatus();
+      }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+
+  ASSERT_TRUE(injected_sampled.has_value());
+  EXPECT_FALSE(injected_sampled.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, TestAccessLog) {
   static constexpr char remote_address[] = "0.0.0.0";
   static constexpr char xff_address[] = "1.2.3.4";
@@ -2848,5 +2848,37 @@ TEST_F(HttpConnectionManagerImplTest, RequestRejectedViaIPDetection) {
   EXPECT_EQ(1U, stats_.named_.downstream_rq_rejected_via_ip_detection_.value());
 }
 
+TEST_F(HttpConnectionManagerImplTest, HeaderMapArenaDisabledByDefault) {
+  setup(false, "");
+  setupFilterChain(1, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[0], decodeComplete());
+  startRequest(true);
+  EXPECT_EQ(nullptr, decoder_->headerMapArena());
+
+  expectOnDestroy();
+  filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+}
+
+// With the runtime guard enabled each stream supplies the codec with its own header map arena.
+TEST_F(HttpConnectionManagerImplTest, HeaderMapArena) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.header_map_arena", "true"}});
+  setup(false, "");
+  setupFilterChain(1, 0);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filters_[0], decodeComplete());
+  startRequest(true);
+  EXPECT_NE(nullptr, decoder_->headerMapArena());
+
+  expectOnDestroy();
+  filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+}
+
 } // namespace Http
 } // namespace Envoy
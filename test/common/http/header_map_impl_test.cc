@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <string>
 
 #include "source/common/http/header_list_view.h"
+#include "source/common/http/header_map_arena_impl.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/header_utility.h"
 
@@ -1433,5 +1435,101 @@ TEST_P(HeaderMapImplTest, HttpTraceContextTest) {
   }
 }
 
+TEST(HeaderMapArenaImplTest, Allocate) {
+  HeaderMapArenaImpl arena;
+  EXPECT_EQ(0, arena.bytesReserved());
+
+  void* a = arena.allocate(10, 1);
+  void* b = arena.allocate(16, 16);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b) % 16);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(26, arena.bytesAllocated());
+  EXPECT_EQ(HeaderMapArenaImpl::InitialBlockSize, arena.bytesReserved());
+
+  // Only the most recent allocation is reused.
+  arena.deallocate(b, 16);
+  EXPECT_EQ(b, arena.allocate(16, 16));
+  arena.deallocate(a, 10);
+  EXPECT_EQ(16, arena.bytesAllocated());
+
+  // Allocations which do not fit in the current block get a new, larger block.
+  void* large = arena.allocate(HeaderMapArenaImpl::InitialBlockSize * 4, 8);
+  memset(large, 0, HeaderMapArenaImpl::InitialBlockSize * 4);
+  EXPECT_EQ(HeaderMapArenaImpl::InitialBlockSize * 5 + 8, arena.bytesReserved());
+}
+
+TEST_P(HeaderMapImplTest, Arena) {
+  auto arena = std::make_shared<HeaderMapArenaImpl>();
+  auto headers = RequestHeaderMapImpl::create(arena);
+  headers->setMethod("GET");
+  headers->setPath("/");
+  headers->addCopy(LowerCaseString("foo"), "bar");
+  headers->addCopy(LowerCaseString("foo"), "baz");
+  headers->addCopy(LowerCaseString("hello"), std::string(200, 'a'));
+  EXPECT_GT(arena->bytesAllocated(), 0);
+  EXPECT_EQ(2, headers->get(LowerCaseString("foo")).size());
+
+  EXPECT_EQ(2, headers->remove(LowerCaseString("foo")));
+  headers->removePath();
+  EXPECT_EQ(2, headers->size());
+  headers->verifyByteSizeInternalForTest();
+
+  auto copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+  EXPECT_EQ(*copy, *headers);
+
+  // Header maps keep the arena alive after the stream releases it.
+  std::weak_ptr<HeaderMapArena> weak_arena = arena;
+  arena.reset();
+  EXPECT_FALSE(weak_arena.expired());
+  EXPECT_EQ("GET", headers->getMethodValue());
+  headers.reset();
+  EXPECT_TRUE(weak_arena.expired());
+}
+
+// Removing the entry that backs the lazy map key must not lose the remaining values for the key.
+TEST_P(HeaderMapImplTest, RemoveIfFirstOfRepeatedKey) {
+  TestRequestHeaderMapImpl headers;
+  headers.addCopy(LowerCaseString("foo"), "1");
+  headers.addCopy(LowerCaseString("foo"), "2");
+  headers.addCopy(LowerCaseString("bar"), "3");
+  EXPECT_EQ(2, headers.get(LowerCaseString("foo")).size());
+
+  EXPECT_EQ(1, headers.removeIf([](const HeaderEntry& entry) { return entry.value() == "1"; }));
+  const auto result = headers.get(LowerCaseString("foo"));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("2", result[0]->value().getStringView());
+  headers.verifyByteSizeInternalForTest();
+}
+
+// Inline headers keep their address while other headers are added and removed around them, and
+// removed entries are compacted away without disturbing the iteration order.
+TEST_P(HeaderMapImplTest, ChurnKeepsInlineHeadersAndOrder) {
+  TestRequestHeaderMapImpl headers;
+  headers.setPath("/");
+  const HeaderEntry* path = headers.Path();
+  for (int i = 0; i < 100; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-", i)), "a");
+    if (i % 3 != 0) {
+      headers.remove(LowerCaseString(absl::StrCat("x-", i)));
+    }
+  }
+  headers.setMethod("GET");
+  EXPECT_EQ(path, headers.Path());
+  EXPECT_EQ(36, headers.size());
+
+  std::vector<std::string> keys;
+  headers.iterate([&keys](const HeaderEntry& entry) -> HeaderMap::Iterate {
+    keys.emplace_back(entry.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  ASSERT_EQ(36, keys.size());
+  EXPECT_EQ(":path", keys[0]);
+  EXPECT_EQ(":method", keys[1]);
+  for (int i = 0; i < 34; i++) {
+    EXPECT_EQ(absl::StrCat("x-", i * 3), keys[i + 2]);
+  }
+  headers.verifyByteSizeInternalForTest();
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -68,7 +68,13 @@ Buffer::OwnedImpl createBufferWithNByteSlices(absl::string_view input, size_t ma
 }
 } // namespace
 
-class Http1CodecTestBase : public testing::Test {
+// The codec tests run against both parsers, parametrized on whether the vectorized parser is used.
+class Http1CodecTestBase : public testing::TestWithParam<bool> {
+public:
+  static std::string parserToString(const testing::TestParamInfo<bool>& params) {
+    return params.param ? "VectorizedParser" : "HttpParser";
+  }
+
 protected:
   Http::Http1::CodecStats& http1CodecStats() {
     return Http::Http1::CodecStats::atomicGet(http1_codec_stats_, store_);
@@ -80,6 +86,8 @@ protected:
 
 class Http1ServerConnectionImplTest : public Http1CodecTestBase {
 public:
+  Http1ServerConnectionImplTest() { codec_settings_.use_vectorized_parser_ = GetParam(); }
+
   void initialize() {
     codec_ = std::make_unique<Http1::ServerConnectionImpl>(
         connection_, http1CodecStats(), callbacks_, codec_settings_, max_request_headers_kb_,
@@ -138,6 +146,9 @@ protected:
       headers_with_underscores_action_{envoy::config::core::v3::HttpProtocolOptions::ALLOW};
 };
 
+INSTANTIATE_TEST_SUITE_P(Parsers, Http1ServerConnectionImplTest, testing::Bool(),
+                         Http1CodecTestBase::parserToString);
+
 void Http1ServerConnectionImplTest::expect400(Protocol p, bool allow_absolute_url,
                                               Buffer::OwnedImpl& buffer,
                                               absl::string_view details) {
@@ -367,7 +378,7 @@ void Http1ServerConnectionImplTest::testServerAllowChunkedContentLength(uint32_t
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, EmptyHeader) {
+TEST_P(Http1ServerConnectionImplTest, EmptyHeader) {
   initialize();
 
   InSequence sequence;
@@ -391,7 +402,7 @@ TEST_F(Http1ServerConnectionImplTest, EmptyHeader) {
 
 // We support the identity encoding, but because it does not end in chunked encoding we reject it
 // per RFC 7230 Section 3.3.3
-TEST_F(Http1ServerConnectionImplTest, IdentityEncodingNoChunked) {
+TEST_P(Http1ServerConnectionImplTest, IdentityEncodingNoChunked) {
   initialize();
 
   InSequence sequence;
@@ -406,7 +417,7 @@ TEST_F(Http1ServerConnectionImplTest, IdentityEncodingNoChunked) {
   EXPECT_EQ(status.message(), "http/1.1 protocol error: unsupported transfer encoding");
 }
 
-TEST_F(Http1ServerConnectionImplTest, UnsupportedEncoding) {
+TEST_P(Http1ServerConnectionImplTest, UnsupportedEncoding) {
   initialize();
 
   InSequence sequence;
@@ -425,7 +436,7 @@ TEST_F(Http1ServerConnectionImplTest, UnsupportedEncoding) {
 // Note that this test is validating a performance optimization, not a functional behavior
 // requirement. If future changes to the codec make this test not pass, but do not regress
 // performance of large HTTP body handling, this test can be changed or removed.
-TEST_F(Http1ServerConnectionImplTest, LargeBodyOptimization) {
+TEST_P(Http1ServerConnectionImplTest, LargeBodyOptimization) {
   initialize();
 
   InSequence sequence;
@@ -454,8 +465,98 @@ TEST_F(Http1ServerConnectionImplTest, LargeBodyOptimization) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// Verify that the body which follows the headers in the first slice is handed over along with the
+// slice, rather than copied out of it. Like LargeBodyOptimization, this validates a performance
+// optimization.
+TEST_P(Http1ServerConnectionImplTest, LargeBodyOptimizationAfterHeaders) {
+  initialize();
+
+  InSequence sequence;
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+  const std::string headers = "POST / HTTP/1.1\r\ncontent-length: 1000000\r\n\r\n";
+  Buffer::OwnedImpl buffer =
+      createBufferWithNByteSlices(headers + std::string(50000, '0'), 16384);
+
+  auto original_slices = buffer.getRawSlices();
+  original_slices[0].mem_ = static_cast<char*>(original_slices[0].mem_) + headers.size();
+  original_slices[0].len_ -= headers.size();
+
+  EXPECT_CALL(decoder, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder, decodeData(_, false)).WillOnce(Invoke([&](Buffer::Instance& body, bool) {
+    EXPECT_EQ(original_slices, body.getRawSlices());
+  }));
+
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+}
+
+// Chunk data which runs to the end of a slice is handed over along with the slice. Chunk data
+// which is followed by more of the message in the same slice is copied.
+TEST_P(Http1ServerConnectionImplTest, LargeChunkedBodyOptimization) {
+  initialize();
+
+  InSequence sequence;
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+  const std::string prefix =
+      "POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n" + absl::StrCat(absl::Hex(20000)) +
+      "\r\n";
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(prefix + std::string(16000, 'a'));
+  buffer.appendSliceForTest(std::string(4000, 'b') + "\r\n0\r\n\r\n");
+  const auto original_slices = buffer.getRawSlices();
+
+  EXPECT_CALL(decoder, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder, decodeData(_, false)).WillOnce(Invoke([&](Buffer::Instance& body, bool) {
+    const auto body_slices = body.getRawSlices();
+    ASSERT_EQ(2, body_slices.size());
+    EXPECT_EQ(static_cast<const char*>(original_slices[0].mem_) + prefix.size(),
+              body_slices[0].mem_);
+    EXPECT_EQ(16000, body_slices[0].len_);
+    EXPECT_NE(original_slices[1].mem_, body_slices[1].mem_);
+    EXPECT_EQ(4000, body_slices[1].len_);
+  }));
+  EXPECT_CALL(decoder, decodeData(BufferStringEqual(""), true));
+
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+}
+
+TEST_P(Http1ServerConnectionImplTest, LargeBodyOptimizationAfterHeadersDisabled) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_move_partial_body_slices", "false"}});
+  initialize();
+
+  InSequence sequence;
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+  const std::string headers = "POST / HTTP/1.1\r\ncontent-length: 1000000\r\n\r\n";
+  Buffer::OwnedImpl buffer =
+      createBufferWithNByteSlices(headers + std::string(50000, '0'), 16384);
+  const void* first_slice = buffer.frontSlice().mem_;
+
+  EXPECT_CALL(decoder, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder, decodeData(_, false)).WillOnce(Invoke([&](Buffer::Instance& body, bool) {
+    EXPECT_NE(static_cast<const char*>(first_slice) + headers.size(), body.frontSlice().mem_);
+  }));
+
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+}
+
 // Regression test for checking if content length exists when all bits are set (e.g. 3).
-TEST_F(Http1ServerConnectionImplTest, ContentLengthAllBitsSet) {
+TEST_P(Http1ServerConnectionImplTest, ContentLengthAllBitsSet) {
   initialize();
 
   InSequence sequence;
@@ -478,7 +579,7 @@ TEST_F(Http1ServerConnectionImplTest, ContentLengthAllBitsSet) {
 }
 
 // Verify that data in the two body chunks is merged before the call to decodeData.
-TEST_F(Http1ServerConnectionImplTest, ChunkedBody) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedBody) {
   initialize();
 
   InSequence sequence;
@@ -507,9 +608,40 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBody) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// A header value longer than the blocks the vectorized parser scans at a time.
+TEST_P(Http1ServerConnectionImplTest, ChunkedBodyLongHeaderValue) {
+  initialize();
+
+  InSequence sequence;
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+  TestRequestHeaderMapImpl expected_headers{
+      {":path", "/"},
+      {":method", "POST"},
+      {"transfer-encoding", "chunked"},
+      {"user-agent", "a user agent that is longer than a vector block"},
+  };
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers), false));
+  Buffer::OwnedImpl expected_data("Hello World");
+  EXPECT_CALL(decoder, decodeData(BufferEqual(&expected_data), false));
+  Buffer::OwnedImpl empty("");
+  EXPECT_CALL(decoder, decodeData(BufferEqual(&empty), true));
+
+  Buffer::OwnedImpl buffer("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n"
+                           "User-Agent:  a user agent that is longer than a vector block \r\n\r\n"
+                           "6\r\nHello \r\n"
+                           "5\r\nWorld\r\n"
+                           "0\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+}
+
 // Verify dispatch behavior when dispatching an incomplete chunk, and resumption of the parse via a
 // second dispatch.
-TEST_F(Http1ServerConnectionImplTest, ChunkedBodySplitOverTwoDispatches) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedBodySplitOverTwoDispatches) {
   initialize();
 
   InSequence sequence;
@@ -547,7 +679,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBodySplitOverTwoDispatches) {
 
 // Verify that headers and chunked body are processed correctly and data is merged before the
 // decodeData call even if delivered in a buffer that holds 1 byte per slice.
-TEST_F(Http1ServerConnectionImplTest, ChunkedBodyFragmentedBuffer) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedBodyFragmentedBuffer) {
   initialize();
 
   InSequence sequence;
@@ -576,7 +708,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBodyFragmentedBuffer) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, ChunkedBodyCase) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedBodyCase) {
   initialize();
 
   InSequence sequence;
@@ -603,7 +735,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBodyCase) {
 
 // Verify that body dispatch does not happen after detecting a parse error processing a chunk
 // header.
-TEST_F(Http1ServerConnectionImplTest, InvalidChunkHeader) {
+TEST_P(Http1ServerConnectionImplTest, InvalidChunkHeader) {
   initialize();
 
   InSequence sequence;
@@ -629,7 +761,7 @@ TEST_F(Http1ServerConnectionImplTest, InvalidChunkHeader) {
   EXPECT_EQ(status.message(), "http/1.1 protocol error: HPE_INVALID_CHUNK_SIZE");
 }
 
-TEST_F(Http1ServerConnectionImplTest, IdentityAndChunkedBody) {
+TEST_P(Http1ServerConnectionImplTest, IdentityAndChunkedBody) {
   initialize();
 
   InSequence sequence;
@@ -646,7 +778,7 @@ TEST_F(Http1ServerConnectionImplTest, IdentityAndChunkedBody) {
   EXPECT_EQ(status.message(), "http/1.1 protocol error: unsupported transfer encoding");
 }
 
-TEST_F(Http1ServerConnectionImplTest, HostWithLWS) {
+TEST_P(Http1ServerConnectionImplTest, HostWithLWS) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -667,7 +799,7 @@ TEST_F(Http1ServerConnectionImplTest, HostWithLWS) {
 // Regression test for https://github.com/envoyproxy/envoy/issues/10270. Linear whitespace at the
 // beginning and end of a header value should be stripped. Whitespace in the middle should be
 // preserved.
-TEST_F(Http1ServerConnectionImplTest, InnerLWSIsPreserved) {
+TEST_P(Http1ServerConnectionImplTest, InnerLWSIsPreserved) {
   initialize();
 
   // Header with many spaces surrounded by non-whitespace characters to ensure that dispatching is
@@ -700,7 +832,7 @@ TEST_F(Http1ServerConnectionImplTest, InnerLWSIsPreserved) {
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfTrue) {
+TEST_P(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfTrue) {
   codec_settings_.stream_error_on_invalid_http_message_ = true;
   codec_ = std::make_unique<Http1::ServerConnectionImpl>(
       connection_, http1CodecStats(), callbacks_, codec_settings_, max_request_headers_kb_,
@@ -719,7 +851,7 @@ TEST_F(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfTrue) {
   EXPECT_TRUE(response_encoder->streamErrorOnInvalidHttpMessage());
 }
 
-TEST_F(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfFalse) {
+TEST_P(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfFalse) {
   codec_settings_.stream_error_on_invalid_http_message_ = false;
   codec_ = std::make_unique<Http1::ServerConnectionImpl>(
       connection_, http1CodecStats(), callbacks_, codec_settings_, max_request_headers_kb_,
@@ -738,7 +870,7 @@ TEST_F(Http1ServerConnectionImplTest, CodecHasCorrectStreamErrorIfFalse) {
   EXPECT_FALSE(response_encoder->streamErrorOnInvalidHttpMessage());
 }
 
-TEST_F(Http1ServerConnectionImplTest, CodecHasDefaultStreamErrorIfNotSet) {
+TEST_P(Http1ServerConnectionImplTest, CodecHasDefaultStreamErrorIfNotSet) {
   initialize();
 
   Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n");
@@ -754,7 +886,7 @@ TEST_F(Http1ServerConnectionImplTest, CodecHasDefaultStreamErrorIfNotSet) {
   EXPECT_FALSE(response_encoder->streamErrorOnInvalidHttpMessage());
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10) {
+TEST_P(Http1ServerConnectionImplTest, Http10) {
   initialize();
 
   InSequence sequence;
@@ -772,7 +904,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10) {
   EXPECT_EQ(Protocol::Http10, codec_->protocol());
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
+TEST_P(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":path", "/"}, {":method", "GET"}};
@@ -780,7 +912,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
   expectHeadersTest(Protocol::Http10, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10Absolute) {
+TEST_P(Http1ServerConnectionImplTest, Http10Absolute) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com"},
@@ -791,7 +923,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10Absolute) {
   expectHeadersTest(Protocol::Http10, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10MultipleResponses) {
+TEST_P(Http1ServerConnectionImplTest, Http10MultipleResponses) {
   initialize();
 
   MockRequestDecoder decoder;
@@ -839,7 +971,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10MultipleResponses) {
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -848,7 +980,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com"},
@@ -859,7 +991,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com:4532"},
@@ -871,7 +1003,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithHttps) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathWithHttps) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com"},
@@ -882,7 +1014,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithHttps) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -891,7 +1023,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11InvalidRequest) {
+TEST_P(Http1ServerConnectionImplTest, Http11InvalidRequest) {
   initialize();
 
   // Invalid because www.somewhere.com is not an absolute path nor an absolute url
@@ -899,7 +1031,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11InvalidRequest) {
   expect400(Protocol::Http11, true, buffer, "http1.codec_error");
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11InvalidTrailerPost) {
+TEST_P(Http1ServerConnectionImplTest, Http11InvalidTrailerPost) {
   initialize();
 
   MockRequestDecoder decoder;
@@ -924,7 +1056,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11InvalidTrailerPost) {
   EXPECT_TRUE(isCodecProtocolError(status));
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -933,21 +1065,21 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathBad) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathBad) {
   initialize();
 
   Buffer::OwnedImpl buffer("GET * HTTP/1.1\r\nHost: bah\r\n\r\n");
   expect400(Protocol::Http11, true, buffer, "http1.invalid_url");
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePortTooLarge) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePortTooLarge) {
   initialize();
 
   Buffer::OwnedImpl buffer("GET http://foobar.com:1000000 HTTP/1.1\r\nHost: bah\r\n\r\n");
   expect400(Protocol::Http11, true, buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, SketchyConnectionHeader) {
+TEST_P(Http1ServerConnectionImplTest, SketchyConnectionHeader) {
   initialize();
 
   Buffer::OwnedImpl buffer(
@@ -955,7 +1087,7 @@ TEST_F(Http1ServerConnectionImplTest, SketchyConnectionHeader) {
   expect400(Protocol::Http11, true, buffer, "http1.connection_header_rejected");
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11RelativeOnly) {
+TEST_P(Http1ServerConnectionImplTest, Http11RelativeOnly) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -964,7 +1096,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11RelativeOnly) {
   expectHeadersTest(Protocol::Http11, false, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11Options) {
+TEST_P(Http1ServerConnectionImplTest, Http11Options) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -973,7 +1105,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11Options) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, SimpleGet) {
+TEST_P(Http1ServerConnectionImplTest, SimpleGet) {
   initialize();
 
   InSequence sequence;
@@ -992,7 +1124,7 @@ TEST_F(Http1ServerConnectionImplTest, SimpleGet) {
 
 // Test that if the stream is not created at the time an error is detected, it
 // is created as part of sending the protocol error.
-TEST_F(Http1ServerConnectionImplTest, BadRequestNoStream) {
+TEST_P(Http1ServerConnectionImplTest, BadRequestNoStream) {
   initialize();
 
   MockRequestDecoder decoder;
@@ -1012,7 +1144,7 @@ TEST_F(Http1ServerConnectionImplTest, BadRequestNoStream) {
 
 // This behavior was observed during CVE-2019-18801 and helped to limit the
 // scope of affected Envoy configurations.
-TEST_F(Http1ServerConnectionImplTest, RejectInvalidMethod) {
+TEST_P(Http1ServerConnectionImplTest, RejectInvalidMethod) {
   initialize();
 
   MockRequestDecoder decoder;
@@ -1024,7 +1156,7 @@ TEST_F(Http1ServerConnectionImplTest, RejectInvalidMethod) {
   EXPECT_TRUE(isCodecProtocolError(status));
 }
 
-TEST_F(Http1ServerConnectionImplTest, BadRequestStartedStream) {
+TEST_P(Http1ServerConnectionImplTest, BadRequestStartedStream) {
   initialize();
 
   MockRequestDecoder decoder;
@@ -1040,7 +1172,7 @@ TEST_F(Http1ServerConnectionImplTest, BadRequestStartedStream) {
   EXPECT_TRUE(isCodecProtocolError(status));
 }
 
-TEST_F(Http1ServerConnectionImplTest, FloodProtection) {
+TEST_P(Http1ServerConnectionImplTest, FloodProtection) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1091,7 +1223,7 @@ TEST_F(Http1ServerConnectionImplTest, FloodProtection) {
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, HostHeaderTranslation) {
+TEST_P(Http1ServerConnectionImplTest, HostHeaderTranslation) {
   initialize();
 
   InSequence sequence;
@@ -1111,7 +1243,7 @@ TEST_F(Http1ServerConnectionImplTest, HostHeaderTranslation) {
 
 // Ensures that requests with invalid HTTP header values are properly rejected
 // when the runtime guard is enabled for the feature.
-TEST_F(Http1ServerConnectionImplTest, HeaderInvalidCharsRejection) {
+TEST_P(Http1ServerConnectionImplTest, HeaderInvalidCharsRejection) {
   TestScopedRuntime scoped_runtime;
   // When the runtime-guarded feature is enabled, invalid header values
   // should result in a rejection.
@@ -1136,7 +1268,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderInvalidCharsRejection) {
 
 // Ensures that request headers with names containing the underscore character are allowed
 // when the option is set to allow.
-TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAllowed) {
+TEST_P(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAllowed) {
   headers_with_underscores_action_ = envoy::config::core::v3::HttpProtocolOptions::ALLOW;
   initialize();
 
@@ -1160,7 +1292,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAllowed) {
 
 // Ensures that request headers with names containing the underscore character are dropped
 // when the option is set to drop headers.
-TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAreDropped) {
+TEST_P(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAreDropped) {
   headers_with_underscores_action_ = envoy::config::core::v3::HttpProtocolOptions::DROP_HEADER;
   initialize();
 
@@ -1183,7 +1315,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAreDropped) {
 
 // Ensures that request with header names containing the underscore character are rejected
 // when the option is set to reject request.
-TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreCauseRequestRejected) {
+TEST_P(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreCauseRequestRejected) {
   headers_with_underscores_action_ = envoy::config::core::v3::HttpProtocolOptions::REJECT_REQUEST;
   initialize();
 
@@ -1204,7 +1336,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreCauseRequestReject
   EXPECT_EQ(1, store_.counter("http1.requests_rejected_with_underscores_in_headers").value());
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderInvalidAuthority) {
+TEST_P(Http1ServerConnectionImplTest, HeaderInvalidAuthority) {
   TestScopedRuntime scoped_runtime;
 
   initialize();
@@ -1227,7 +1359,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderInvalidAuthority) {
 
 // Mutate an HTTP GET with embedded NULs, this should always be rejected in some
 // way (not necessarily with "head value contains NUL" though).
-TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
+TEST_P(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
   const std::string example_input = "GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: barbaz\r\n";
 
   for (size_t n = 1; n < example_input.size(); ++n) {
@@ -1251,7 +1383,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
 // Mutate an HTTP GET with CR or LF. These can cause an error status or maybe
 // result in a valid decodeHeaders(). In any case, the validHeaderString()
 // ASSERTs should validate we never have any embedded CR or LF.
-TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
+TEST_P(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
   const std::string example_input = "GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: barbaz\r\n";
 
   for (const char c : {'\r', '\n'}) {
@@ -1271,7 +1403,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
+TEST_P(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
   initialize();
 
   InSequence sequence;
@@ -1293,7 +1425,7 @@ TEST_F(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
   EXPECT_NE(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, PostWithContentLength) {
+TEST_P(Http1ServerConnectionImplTest, PostWithContentLength) {
   initialize();
 
   InSequence sequence;
@@ -1319,7 +1451,7 @@ TEST_F(Http1ServerConnectionImplTest, PostWithContentLength) {
 
 // Verify that headers and body with content length are processed correctly and data is merged
 // before the decodeData call even if delivered in a buffer that holds 1 byte per slice.
-TEST_F(Http1ServerConnectionImplTest, PostWithContentLengthFragmentedBuffer) {
+TEST_P(Http1ServerConnectionImplTest, PostWithContentLengthFragmentedBuffer) {
   initialize();
 
   InSequence sequence;
@@ -1344,7 +1476,7 @@ TEST_F(Http1ServerConnectionImplTest, PostWithContentLengthFragmentedBuffer) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1370,7 +1502,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
 
 // As with Http1ClientConnectionImplTest.LargeHeaderRequestEncode but validate
 // the response encoder instead of request encoder.
-TEST_F(Http1ServerConnectionImplTest, LargeHeaderResponseEncode) {
+TEST_P(Http1ServerConnectionImplTest, LargeHeaderResponseEncode) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1396,7 +1528,7 @@ TEST_F(Http1ServerConnectionImplTest, LargeHeaderResponseEncode) {
             output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseTrainProperHeaders) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponseTrainProperHeaders) {
   codec_settings_.header_key_format_ = Http1Settings::HeaderKeyFormat::ProperCase;
   initialize();
 
@@ -1423,7 +1555,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseTrainProperHeaders) {
             output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, 304ResponseTransferEncodingNotAddedWhenContentLengthPresent) {
+TEST_P(Http1ServerConnectionImplTest, 304ResponseTransferEncodingNotAddedWhenContentLengthPresent) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1452,7 +1584,7 @@ TEST_F(Http1ServerConnectionImplTest, 304ResponseTransferEncodingNotAddedWhenCon
 // Upstream response 304 without content-length header
 // 304 Response does not need to have Transfer-Encoding added even it's allowed by RFC 7230,
 // Section 3.3.1. Both GET and HEAD response are the same and consistent
-TEST_F(Http1ServerConnectionImplTest,
+TEST_P(Http1ServerConnectionImplTest,
        304ResponseTransferEncodingContentLengthNotAddedWhenContentLengthNotPresent) {
   initialize();
 
@@ -1493,7 +1625,7 @@ TEST_F(Http1ServerConnectionImplTest,
 // The legacy behavior returns different headers for GET and HEAD requests
 // For GET, it adds "content-length: 0"
 // For HEAD, it adds "transfer-encoding: chunked"
-TEST_F(Http1ServerConnectionImplTest,
+TEST_P(Http1ServerConnectionImplTest,
        304ResponseTransferEncodingContentLengthNotAddedWhenContentLengthNotPresentLegacy) {
   // Testing old behavior with no_chunked_encoding_header_for_304 turned off
   // GET and HEAD returns different headers
@@ -1538,7 +1670,7 @@ TEST_F(Http1ServerConnectionImplTest,
       output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1562,7 +1694,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   EXPECT_EQ("HTTP/1.1 204 No Content\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1593,7 +1725,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, MetadataTest) {
+TEST_P(Http1ServerConnectionImplTest, MetadataTest) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1616,7 +1748,7 @@ TEST_F(Http1ServerConnectionImplTest, MetadataTest) {
   EXPECT_EQ(1, store_.counter("http1.metadata_not_supported_error").value());
 }
 
-TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedResponse) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1652,7 +1784,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
             output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, ChunkedResponseWithTrailers) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedResponseWithTrailers) {
   codec_settings_.enable_trailers_ = true;
   initialize();
   NiceMock<MockRequestDecoder> decoder;
@@ -1685,7 +1817,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedResponseWithTrailers) {
             output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, ContentLengthResponse) {
+TEST_P(Http1ServerConnectionImplTest, ContentLengthResponse) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1712,7 +1844,7 @@ TEST_F(Http1ServerConnectionImplTest, ContentLengthResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 11\r\n\r\nHello World", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeadRequestResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeadRequestResponse) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1736,7 +1868,7 @@ TEST_F(Http1ServerConnectionImplTest, HeadRequestResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1760,7 +1892,7 @@ TEST_F(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
+TEST_P(Http1ServerConnectionImplTest, DoubleRequest) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1786,11 +1918,11 @@ TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersDropped) { expectTrailersTest(false); }
+TEST_P(Http1ServerConnectionImplTest, RequestWithTrailersDropped) { expectTrailersTest(false); }
 
-TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersKept) { expectTrailersTest(true); }
+TEST_P(Http1ServerConnectionImplTest, RequestWithTrailersKept) { expectTrailersTest(true); }
 
-TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2c) {
+TEST_P(Http1ServerConnectionImplTest, IgnoreUpgradeH2c) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{
@@ -1801,7 +1933,7 @@ TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2c) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2cClose) {
+TEST_P(Http1ServerConnectionImplTest, IgnoreUpgradeH2cClose) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com"},
@@ -1815,7 +1947,7 @@ TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2cClose) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2cCloseEtc) {
+TEST_P(Http1ServerConnectionImplTest, IgnoreUpgradeH2cCloseEtc) {
   initialize();
 
   TestRequestHeaderMapImpl expected_headers{{":authority", "www.somewhere.com"},
@@ -1829,7 +1961,7 @@ TEST_F(Http1ServerConnectionImplTest, IgnoreUpgradeH2cCloseEtc) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequest) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequest) {
   initialize();
 
   InSequence sequence;
@@ -1853,7 +1985,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequest) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
   initialize();
 
   InSequence sequence;
@@ -1869,7 +2001,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
   initialize();
 
   InSequence sequence;
@@ -1887,7 +2019,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
   initialize();
 
   InSequence sequence;
@@ -1906,7 +2038,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
 }
 
 // Test that 101 upgrade responses do not contain content-length or transfer-encoding headers.
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestResponseHeaders) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestResponseHeaders) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -1930,7 +2062,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestResponseHeaders) {
   EXPECT_EQ("HTTP/1.1 101 Switching Protocols\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestNoContentLength) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestNoContentLength) {
   initialize();
 
   InSequence sequence;
@@ -1954,7 +2086,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestNoContentLength) {
 
 // We use the absolute URL parsing code for CONNECT requests, but it does not
 // actually allow absolute URLs.
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestAbsoluteURLNotallowed) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestAbsoluteURLNotallowed) {
   initialize();
 
   InSequence sequence;
@@ -1967,7 +2099,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestAbsoluteURLNotallowed) {
   EXPECT_TRUE(isCodecProtocolError(status));
 }
 
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithEarlyData) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestWithEarlyData) {
   initialize();
 
   InSequence sequence;
@@ -1982,7 +2114,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithEarlyData) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithTEChunked) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestWithTEChunked) {
   initialize();
 
   InSequence sequence;
@@ -1999,7 +2131,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithTEChunked) {
   EXPECT_EQ(status.message(), "http/1.1 protocol error: unsupported transfer encoding");
 }
 
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithNonZeroContentLength) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestWithNonZeroContentLength) {
   initialize();
 
   InSequence sequence;
@@ -2015,7 +2147,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithNonZeroContentLength) {
   EXPECT_EQ(status.message(), "http/1.1 protocol error: unsupported content length");
 }
 
-TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithZeroContentLength) {
+TEST_P(Http1ServerConnectionImplTest, ConnectRequestWithZeroContentLength) {
   initialize();
 
   InSequence sequence;
@@ -2032,7 +2164,7 @@ TEST_F(Http1ServerConnectionImplTest, ConnectRequestWithZeroContentLength) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, WatermarkTest) {
+TEST_P(Http1ServerConnectionImplTest, WatermarkTest) {
   EXPECT_CALL(connection_, bufferLimit()).WillOnce(Return(10));
   initialize();
 
@@ -2066,31 +2198,31 @@ TEST_F(Http1ServerConnectionImplTest, WatermarkTest) {
       ->onUnderlyingConnectionBelowWriteBufferLowWatermark();
 }
 
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength0) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength0) {
   testServerAllowChunkedContentLength(0, false);
 }
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength1) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength1) {
   // content-length less than POST body size
   testServerAllowChunkedContentLength(1, false);
 }
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength100) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingDisallowChunkedContentLength100) {
   // content-length greater than POST body size
   testServerAllowChunkedContentLength(100, false);
 }
 
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength0) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength0) {
   testServerAllowChunkedContentLength(0, true);
 }
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength1) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength1) {
   // content-length less than POST body size
   testServerAllowChunkedContentLength(1, true);
 }
-TEST_F(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength100) {
+TEST_P(Http1ServerConnectionImplTest, TestSmugglingAllowChunkedContentLength100) {
   // content-length greater than POST body size
   testServerAllowChunkedContentLength(100, true);
 }
 
-TEST_F(Http1ServerConnectionImplTest,
+TEST_P(Http1ServerConnectionImplTest,
        ShouldDumpParsedAndPartialHeadersWithoutAllocatingMemoryIfProcessingHeaders) {
   initialize();
 
@@ -2125,7 +2257,7 @@ TEST_F(Http1ServerConnectionImplTest,
                                  "Unfinished-Header, current_header_value_: Not-Finished-Value"));
 }
 
-TEST_F(Http1ServerConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingMemory) {
+TEST_P(Http1ServerConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingMemory) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -2168,6 +2300,8 @@ TEST_F(Http1ServerConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingM
 
 class Http1ClientConnectionImplTest : public Http1CodecTestBase {
 public:
+  Http1ClientConnectionImplTest() { codec_settings_.use_vectorized_parser_ = GetParam(); }
+
   void initialize() {
     codec_ = std::make_unique<Http1::ClientConnectionImpl>(
         connection_, http1CodecStats(), callbacks_, codec_settings_, max_response_headers_count_);
@@ -2189,6 +2323,9 @@ protected:
   uint32_t max_response_headers_count_{Http::DEFAULT_MAX_HEADERS_COUNT};
 };
 
+INSTANTIATE_TEST_SUITE_P(Parsers, Http1ClientConnectionImplTest, testing::Bool(),
+                         Http1CodecTestBase::parserToString);
+
 void Http1ClientConnectionImplTest::testClientAllowChunkedContentLength(uint32_t content_length,
                                                                         bool allow_chunked_length) {
   codec_settings_.allow_chunked_length_ = allow_chunked_length;
@@ -2230,7 +2367,7 @@ void Http1ClientConnectionImplTest::testClientAllowChunkedContentLength(uint32_t
   };
 }
 
-TEST_F(Http1ClientConnectionImplTest, SimpleGet) {
+TEST_P(Http1ClientConnectionImplTest, SimpleGet) {
   initialize();
 
   MockResponseDecoder response_decoder;
@@ -2244,7 +2381,7 @@ TEST_F(Http1ClientConnectionImplTest, SimpleGet) {
   EXPECT_EQ("GET / HTTP/1.1\r\n\r\n", output);
 }
 
-TEST_F(Http1ClientConnectionImplTest, SimpleGetWithHeaderCasing) {
+TEST_P(Http1ClientConnectionImplTest, SimpleGetWithHeaderCasing) {
   codec_settings_.header_key_format_ = Http1Settings::HeaderKeyFormat::ProperCase;
 
   initialize();
@@ -2260,7 +2397,7 @@ TEST_F(Http1ClientConnectionImplTest, SimpleGetWithHeaderCasing) {
   EXPECT_EQ("GET / HTTP/1.1\r\nMy-Custom-Header: hey\r\n\r\n", output);
 }
 
-TEST_F(Http1ClientConnectionImplTest, HostHeaderTranslate) {
+TEST_P(Http1ClientConnectionImplTest, HostHeaderTranslate) {
   initialize();
 
   MockResponseDecoder response_decoder;
@@ -2274,7 +2411,7 @@ TEST_F(Http1ClientConnectionImplTest, HostHeaderTranslate) {
   EXPECT_EQ("GET / HTTP/1.1\r\nhost: host\r\n\r\n", output);
 }
 
-TEST_F(Http1ClientConnectionImplTest, Reset) {
+TEST_P(Http1ClientConnectionImplTest, Reset) {
   initialize();
 
   MockResponseDecoder response_decoder;
@@ -2288,7 +2425,7 @@ TEST_F(Http1ClientConnectionImplTest, Reset) {
 
 // Verify that we correctly enable reads on the connection when the final response is
 // received.
-TEST_F(Http1ClientConnectionImplTest, FlowControlReadDisabledReenable) {
+TEST_P(Http1ClientConnectionImplTest, FlowControlReadDisabledReenable) {
   initialize();
 
   MockResponseDecoder response_decoder;
@@ -2317,7 +2454,7 @@ TEST_F(Http1ClientConnectionImplTest, FlowControlReadDisabledReenable) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, PrematureResponse) {
+TEST_P(Http1ClientConnectionImplTest, PrematureResponse) {
   initialize();
 
   Buffer::OwnedImpl response("HTTP/1.1 408 Request Timeout\r\nConnection: Close\r\n\r\n");
@@ -2325,7 +2462,7 @@ TEST_F(Http1ClientConnectionImplTest, PrematureResponse) {
   EXPECT_TRUE(isPrematureResponseError(status));
 }
 
-TEST_F(Http1ClientConnectionImplTest, EmptyBodyResponse503) {
+TEST_P(Http1ClientConnectionImplTest, EmptyBodyResponse503) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2339,7 +2476,7 @@ TEST_F(Http1ClientConnectionImplTest, EmptyBodyResponse503) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, EmptyBodyResponse200) {
+TEST_P(Http1ClientConnectionImplTest, EmptyBodyResponse200) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2353,7 +2490,7 @@ TEST_F(Http1ClientConnectionImplTest, EmptyBodyResponse200) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, HeadRequest) {
+TEST_P(Http1ClientConnectionImplTest, HeadRequest) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2367,7 +2504,7 @@ TEST_F(Http1ClientConnectionImplTest, HeadRequest) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, 204Response) {
+TEST_P(Http1ClientConnectionImplTest, 204Response) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2382,7 +2519,7 @@ TEST_F(Http1ClientConnectionImplTest, 204Response) {
 }
 
 // 204 No Content with Content-Length is barred by RFC 7230, Section 3.3.2.
-TEST_F(Http1ClientConnectionImplTest, 204ResponseContentLengthNotAllowed) {
+TEST_P(Http1ClientConnectionImplTest, 204ResponseContentLengthNotAllowed) {
   // By default, content-length is barred.
   {
     initialize();
@@ -2418,7 +2555,7 @@ TEST_F(Http1ClientConnectionImplTest, 204ResponseContentLengthNotAllowed) {
 
 // 204 No Content with Content-Length: 0 is technically barred by RFC 7230, Section 3.3.2, but we
 // allow it.
-TEST_F(Http1ClientConnectionImplTest, 204ResponseWithContentLength0) {
+TEST_P(Http1ClientConnectionImplTest, 204ResponseWithContentLength0) {
   {
     initialize();
 
@@ -2452,7 +2589,7 @@ TEST_F(Http1ClientConnectionImplTest, 204ResponseWithContentLength0) {
 }
 
 // 204 No Content with Transfer-Encoding headers is barred by RFC 7230, Section 3.3.1.
-TEST_F(Http1ClientConnectionImplTest, 204ResponseTransferEncodingNotAllowed) {
+TEST_P(Http1ClientConnectionImplTest, 204ResponseTransferEncodingNotAllowed) {
   // By default, transfer-encoding is barred.
   {
     initialize();
@@ -2487,7 +2624,7 @@ TEST_F(Http1ClientConnectionImplTest, 204ResponseTransferEncodingNotAllowed) {
 }
 
 // 100 response followed by 200 results in a [decode100ContinueHeaders, decodeHeaders] sequence.
-TEST_F(Http1ClientConnectionImplTest, ContinueHeaders) {
+TEST_P(Http1ClientConnectionImplTest, ContinueHeaders) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2509,7 +2646,7 @@ TEST_F(Http1ClientConnectionImplTest, ContinueHeaders) {
 }
 
 // Multiple 100 responses are passed to the response encoder (who is responsible for coalescing).
-TEST_F(Http1ClientConnectionImplTest, MultipleContinueHeaders) {
+TEST_P(Http1ClientConnectionImplTest, MultipleContinueHeaders) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2538,7 +2675,7 @@ TEST_F(Http1ClientConnectionImplTest, MultipleContinueHeaders) {
 
 // 101/102 headers etc. are passed to the response encoder (who is responsibly for deciding to
 // upgrade, ignore, etc.).
-TEST_F(Http1ClientConnectionImplTest, 1xxNonContinueHeaders) {
+TEST_P(Http1ClientConnectionImplTest, 1xxNonContinueHeaders) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2553,7 +2690,7 @@ TEST_F(Http1ClientConnectionImplTest, 1xxNonContinueHeaders) {
 }
 
 // 101 Switching Protocol with Transfer-Encoding headers is barred by RFC 7230, Section 3.3.1.
-TEST_F(Http1ClientConnectionImplTest, 101ResponseTransferEncodingNotAllowed) {
+TEST_P(Http1ClientConnectionImplTest, 101ResponseTransferEncodingNotAllowed) {
   // By default, transfer-encoding is barred.
   {
     initialize();
@@ -2589,7 +2726,7 @@ TEST_F(Http1ClientConnectionImplTest, 101ResponseTransferEncodingNotAllowed) {
   }
 }
 
-TEST_F(Http1ClientConnectionImplTest, BadEncodeParams) {
+TEST_P(Http1ClientConnectionImplTest, BadEncodeParams) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2609,7 +2746,7 @@ TEST_F(Http1ClientConnectionImplTest, BadEncodeParams) {
       testing::HasSubstr("missing required"));
 }
 
-TEST_F(Http1ClientConnectionImplTest, NoContentLengthResponse) {
+TEST_P(Http1ClientConnectionImplTest, NoContentLengthResponse) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2631,7 +2768,7 @@ TEST_F(Http1ClientConnectionImplTest, NoContentLengthResponse) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, ResponseWithTrailers) {
+TEST_P(Http1ClientConnectionImplTest, ResponseWithTrailers) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2646,7 +2783,7 @@ TEST_F(Http1ClientConnectionImplTest, ResponseWithTrailers) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, GiantPath) {
+TEST_P(Http1ClientConnectionImplTest, GiantPath) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -2661,7 +2798,7 @@ TEST_F(Http1ClientConnectionImplTest, GiantPath) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, PrematureUpgradeResponse) {
+TEST_P(Http1ClientConnectionImplTest, PrematureUpgradeResponse) {
   initialize();
 
   // make sure upgradeAllowed doesn't cause crashes if run with no pending response.
@@ -2671,7 +2808,7 @@ TEST_F(Http1ClientConnectionImplTest, PrematureUpgradeResponse) {
   EXPECT_TRUE(isPrematureResponseError(status));
 }
 
-TEST_F(Http1ClientConnectionImplTest, UpgradeResponse) {
+TEST_P(Http1ClientConnectionImplTest, UpgradeResponse) {
   initialize();
 
   InSequence s;
@@ -2707,7 +2844,7 @@ TEST_F(Http1ClientConnectionImplTest, UpgradeResponse) {
 
 // Same data as above, but make sure directDispatch immediately hands off any
 // outstanding data.
-TEST_F(Http1ClientConnectionImplTest, UpgradeResponseWithEarlyData) {
+TEST_P(Http1ClientConnectionImplTest, UpgradeResponseWithEarlyData) {
   initialize();
 
   InSequence s;
@@ -2731,7 +2868,7 @@ TEST_F(Http1ClientConnectionImplTest, UpgradeResponseWithEarlyData) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, ConnectResponse) {
+TEST_P(Http1ClientConnectionImplTest, ConnectResponse) {
   initialize();
 
   InSequence s;
@@ -2762,7 +2899,7 @@ TEST_F(Http1ClientConnectionImplTest, ConnectResponse) {
 
 // Same data as above, but make sure directDispatch immediately hands off any
 // outstanding data.
-TEST_F(Http1ClientConnectionImplTest, ConnectResponseWithEarlyData) {
+TEST_P(Http1ClientConnectionImplTest, ConnectResponseWithEarlyData) {
   initialize();
 
   InSequence s;
@@ -2781,7 +2918,7 @@ TEST_F(Http1ClientConnectionImplTest, ConnectResponseWithEarlyData) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, ConnectRejected) {
+TEST_P(Http1ClientConnectionImplTest, ConnectRejected) {
   initialize();
 
   InSequence s;
@@ -2799,7 +2936,7 @@ TEST_F(Http1ClientConnectionImplTest, ConnectRejected) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ClientConnectionImplTest, WatermarkTest) {
+TEST_P(Http1ClientConnectionImplTest, WatermarkTest) {
   EXPECT_CALL(connection_, bufferLimit()).WillOnce(Return(10));
   initialize();
 
@@ -2834,7 +2971,7 @@ TEST_F(Http1ClientConnectionImplTest, WatermarkTest) {
 // caller attempts to close the connection. This causes the network connection to attempt to write
 // pending data, even in the no flush scenario, which can cause us to go below low watermark
 // which then raises callbacks for a stream that no longer exists.
-TEST_F(Http1ClientConnectionImplTest, HighwatermarkMultipleResponses) {
+TEST_P(Http1ClientConnectionImplTest, HighwatermarkMultipleResponses) {
   initialize();
 
   InSequence s;
@@ -2868,7 +3005,7 @@ TEST_F(Http1ClientConnectionImplTest, HighwatermarkMultipleResponses) {
 
 // Regression test for https://github.com/envoyproxy/envoy/issues/10655. Make sure we correctly
 // handle going below low watermark when closing the connection during a completion callback.
-TEST_F(Http1ClientConnectionImplTest, LowWatermarkDuringClose) {
+TEST_P(Http1ClientConnectionImplTest, LowWatermarkDuringClose) {
   initialize();
 
   InSequence s;
@@ -2898,45 +3035,45 @@ TEST_F(Http1ClientConnectionImplTest, LowWatermarkDuringClose) {
   EXPECT_TRUE(status.ok());
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeTrailersRejected) {
+TEST_P(Http1ServerConnectionImplTest, LargeTrailersRejected) {
   // Default limit of 60 KiB
   std::string long_string = "big: " + std::string(60 * 1024, 'q') + "\r\n\r\n\r\n";
   testTrailersExceedLimit(long_string, "trailers size exceeds limit", true);
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeTrailerFieldRejected) {
+TEST_P(Http1ServerConnectionImplTest, LargeTrailerFieldRejected) {
   // Construct partial headers with a long field name that exceeds the default limit of 60KiB.
   std::string long_string = "bigfield" + std::string(60 * 1024, 'q');
   testTrailersExceedLimit(long_string, "trailers size exceeds limit", true);
 }
 
 // Tests that the default limit for the number of request headers is 100.
-TEST_F(Http1ServerConnectionImplTest, ManyTrailersRejected) {
+TEST_P(Http1ServerConnectionImplTest, ManyTrailersRejected) {
   // Send a request with 101 headers.
   testTrailersExceedLimit(createHeaderFragment(101) + "\r\n\r\n", "trailers count exceeds limit",
                           true);
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeTrailersRejectedIgnored) {
+TEST_P(Http1ServerConnectionImplTest, LargeTrailersRejectedIgnored) {
   // Default limit of 60 KiB
   std::string long_string = "big: " + std::string(60 * 1024, 'q') + "\r\n\r\n\r\n";
   testTrailersExceedLimit(long_string, "trailers size exceeds limit", false);
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeTrailerFieldRejectedIgnored) {
+TEST_P(Http1ServerConnectionImplTest, LargeTrailerFieldRejectedIgnored) {
   // Default limit of 60 KiB
   std::string long_string = "bigfield" + std::string(60 * 1024, 'q') + ": value\r\n\r\n\r\n";
   testTrailersExceedLimit(long_string, "trailers size exceeds limit", false);
 }
 
 // Tests that the default limit for the number of request headers is 100.
-TEST_F(Http1ServerConnectionImplTest, ManyTrailersIgnored) {
+TEST_P(Http1ServerConnectionImplTest, ManyTrailersIgnored) {
   // Send a request with 101 headers.
   testTrailersExceedLimit(createHeaderFragment(101) + "\r\n\r\n", "trailers count exceeds limit",
                           false);
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestUrlRejected) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestUrlRejected) {
   initialize();
 
   std::string exception_reason;
@@ -2958,26 +3095,26 @@ TEST_F(Http1ServerConnectionImplTest, LargeRequestUrlRejected) {
   EXPECT_EQ("http1.headers_too_large", response_encoder->getStream().responseDetails());
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersRejected) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersRejected) {
   // Default limit of 60 KiB
   std::string long_string = "big: " + std::string(60 * 1024, 'q') + "\r\n";
   testRequestHeadersExceedLimit(long_string, "headers size exceeds limit", "");
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersRejectedBeyondMaxConfigurable) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersRejectedBeyondMaxConfigurable) {
   max_request_headers_kb_ = 8192;
   std::string long_string = "big: " + std::string(8193 * 1024, 'q') + "\r\n";
   testRequestHeadersExceedLimit(long_string, "headers size exceeds limit", "");
 }
 
 // Tests that the default limit for the number of request headers is 100.
-TEST_F(Http1ServerConnectionImplTest, ManyRequestHeadersRejected) {
+TEST_P(Http1ServerConnectionImplTest, ManyRequestHeadersRejected) {
   // Send a request with 101 headers.
   testRequestHeadersExceedLimit(createHeaderFragment(101), "headers count exceeds limit",
                                 "http1.too_many_headers");
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejected) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejected) {
   // Default limit of 60 KiB
   initialize();
 
@@ -3006,7 +3143,7 @@ TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejected) {
   EXPECT_EQ("http1.headers_too_large", response_encoder->getStream().responseDetails());
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejectedMaxConfigurable) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejectedMaxConfigurable) {
   max_request_headers_kb_ = 8192;
   max_request_headers_count_ = 150;
   initialize();
@@ -3038,7 +3175,7 @@ TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersSplitRejectedMaxConfigu
 
 // Tests that the 101th request header causes overflow with the default max number of request
 // headers.
-TEST_F(Http1ServerConnectionImplTest, ManyRequestHeadersSplitRejected) {
+TEST_P(Http1ServerConnectionImplTest, ManyRequestHeadersSplitRejected) {
   // Default limit of 100.
   initialize();
 
@@ -3065,33 +3202,33 @@ TEST_F(Http1ServerConnectionImplTest, ManyRequestHeadersSplitRejected) {
   EXPECT_EQ(status.message(), "headers count exceeds limit");
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersAccepted) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersAccepted) {
   max_request_headers_kb_ = 4096;
   std::string long_string = "big: " + std::string(1024 * 1024, 'q') + "\r\n";
   testRequestHeadersAccepted(long_string);
 }
 
-TEST_F(Http1ServerConnectionImplTest, LargeRequestHeadersAcceptedMaxConfigurable) {
+TEST_P(Http1ServerConnectionImplTest, LargeRequestHeadersAcceptedMaxConfigurable) {
   max_request_headers_kb_ = 8192;
   std::string long_string = "big: " + std::string(8191 * 1024, 'q') + "\r\n";
   testRequestHeadersAccepted(long_string);
 }
 
 // Tests that the number of request headers is configurable.
-TEST_F(Http1ServerConnectionImplTest, ManyRequestHeadersAccepted) {
+TEST_P(Http1ServerConnectionImplTest, ManyRequestHeadersAccepted) {
   max_request_headers_count_ = 150;
   // Create a request with 150 headers.
   testRequestHeadersAccepted(createHeaderFragment(150));
 }
 
-TEST_F(Http1ServerConnectionImplTest, ManyLargeRequestHeadersAccepted) {
+TEST_P(Http1ServerConnectionImplTest, ManyLargeRequestHeadersAccepted) {
   max_request_headers_kb_ = 8192;
   // Create a request with 64 headers, each header of size ~64 KiB. Total size ~4MB.
   testRequestHeadersAccepted(createLargeHeaderFragment(64));
 }
 
 // Tests that incomplete response headers of 80 kB header value fails.
-TEST_F(Http1ClientConnectionImplTest, ResponseHeadersWithLargeValueRejected) {
+TEST_P(Http1ClientConnectionImplTest, ResponseHeadersWithLargeValueRejected) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3110,7 +3247,7 @@ TEST_F(Http1ClientConnectionImplTest, ResponseHeadersWithLargeValueRejected) {
 }
 
 // Tests that incomplete response headers with a 80 kB header field fails.
-TEST_F(Http1ClientConnectionImplTest, ResponseHeadersWithLargeFieldRejected) {
+TEST_P(Http1ClientConnectionImplTest, ResponseHeadersWithLargeFieldRejected) {
   initialize();
 
   NiceMock<MockRequestDecoder> decoder;
@@ -3130,7 +3267,7 @@ TEST_F(Http1ClientConnectionImplTest, ResponseHeadersWithLargeFieldRejected) {
 }
 
 // Tests that the size of response headers for HTTP/1 must be under 80 kB.
-TEST_F(Http1ClientConnectionImplTest, LargeResponseHeadersAccepted) {
+TEST_P(Http1ClientConnectionImplTest, LargeResponseHeadersAccepted) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3148,7 +3285,7 @@ TEST_F(Http1ClientConnectionImplTest, LargeResponseHeadersAccepted) {
 
 // Regression test for CVE-2019-18801. Large method headers should not trigger
 // ASSERTs or ASAN, which they previously did.
-TEST_F(Http1ClientConnectionImplTest, LargeMethodRequestEncode) {
+TEST_P(Http1ClientConnectionImplTest, LargeMethodRequestEncode) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3166,7 +3303,7 @@ TEST_F(Http1ClientConnectionImplTest, LargeMethodRequestEncode) {
 // in CVE-2019-18801, but the related code does explicit size calculations on
 // both path and method (these are the two distinguished headers). So,
 // belt-and-braces.
-TEST_F(Http1ClientConnectionImplTest, LargePathRequestEncode) {
+TEST_P(Http1ClientConnectionImplTest, LargePathRequestEncode) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3182,7 +3319,7 @@ TEST_F(Http1ClientConnectionImplTest, LargePathRequestEncode) {
 
 // As with LargeMethodEncode, but for an arbitrary header. This was not an issue
 // in CVE-2019-18801.
-TEST_F(Http1ClientConnectionImplTest, LargeHeaderRequestEncode) {
+TEST_P(Http1ClientConnectionImplTest, LargeHeaderRequestEncode) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3197,7 +3334,7 @@ TEST_F(Http1ClientConnectionImplTest, LargeHeaderRequestEncode) {
 }
 
 // Exception called when the number of response headers exceeds the default value of 100.
-TEST_F(Http1ClientConnectionImplTest, ManyResponseHeadersRejected) {
+TEST_P(Http1ClientConnectionImplTest, ManyResponseHeadersRejected) {
   initialize();
 
   NiceMock<MockResponseDecoder> response_decoder;
@@ -3215,7 +3352,7 @@ TEST_F(Http1ClientConnectionImplTest, ManyResponseHeadersRejected) {
 }
 
 // Tests that the number of response headers is configurable.
-TEST_F(Http1ClientConnectionImplTest, ManyResponseHeadersAccepted) {
+TEST_P(Http1ClientConnectionImplTest, ManyResponseHeadersAccepted) {
   max_response_headers_count_ = 152;
 
   initialize();
@@ -3232,31 +3369,31 @@ TEST_F(Http1ClientConnectionImplTest, ManyResponseHeadersAccepted) {
   status = codec_->dispatch(buffer);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplit0) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplit0) {
   testClientAllowChunkedContentLength(0, false);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplit1) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplit1) {
   testClientAllowChunkedContentLength(1, false);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplit100) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplit100) {
   testClientAllowChunkedContentLength(100, false);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength0) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength0) {
   testClientAllowChunkedContentLength(0, true);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength1) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength1) {
   testClientAllowChunkedContentLength(1, true);
 }
 
-TEST_F(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength100) {
+TEST_P(Http1ClientConnectionImplTest, TestResponseSplitAllowChunkedLength100) {
   testClientAllowChunkedContentLength(100, true);
 }
 
-TEST_F(Http1ClientConnectionImplTest,
+TEST_P(Http1ClientConnectionImplTest,
        ShouldDumpParsedAndPartialHeadersWithoutAllocatingMemoryIfProcessingHeaders) {
   initialize();
 
@@ -3284,7 +3421,7 @@ TEST_F(Http1ClientConnectionImplTest,
                                  "Content-Length, current_header_value_: 8"));
 }
 
-TEST_F(Http1ClientConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingMemory) {
+TEST_P(Http1ClientConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingMemory) {
   initialize();
 
   // Send request
@@ -3324,7 +3461,7 @@ TEST_F(Http1ClientConnectionImplTest, ShouldDumpDispatchBufferWithoutAllocatingM
                                  "\"HTTP/1.1 200 OK\\r\\nContent-Length: 5\\r\\n\\r\\nHello\"\n"));
 }
 
-TEST_F(Http1ClientConnectionImplTest, ShouldDumpCorrespondingRequestWithoutAllocatingMemory) {
+TEST_P(Http1ClientConnectionImplTest, ShouldDumpCorrespondingRequestWithoutAllocatingMemory) {
   initialize();
 
   // Send request
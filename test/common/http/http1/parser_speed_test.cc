@@ -0,0 +1,150 @@
+// Usage: bazel run //test/common/http/http1:parser_speed_test
+
+#include <memory>
+#include <string>
+
+#include "source/common/http/http1/legacy_parser_impl.h"
+#include "source/common/http/http1/vectorized_parser_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Callbacks which do as little as possible, so that the benchmark measures the parser itself.
+class NullCallbacks : public ParserCallbacks {
+public:
+  Status onMessageBegin() override { return okStatus(); }
+  Status onUrl(const char*, size_t length) override {
+    bytes_ += length;
+    return okStatus();
+  }
+  Status onHeaderField(const char*, size_t length) override {
+    bytes_ += length;
+    return okStatus();
+  }
+  Status onHeaderValue(const char*, size_t length) override {
+    bytes_ += length;
+    return okStatus();
+  }
+  StatusOr<ParserStatus> onHeadersComplete() override { return ParserStatus::Success; }
+  void bufferBody(const char*, size_t length) override { bytes_ += length; }
+  StatusOr<ParserStatus> onMessageComplete() override {
+    ++messages_;
+    return ParserStatus::Success;
+  }
+  void onChunkHeader(bool) override {}
+  int setAndCheckCallbackStatus(Status&& status) override { return status.ok() ? 0 : -1; }
+  int setAndCheckCallbackStatusOr(StatusOr<ParserStatus>&& statusor) override {
+    return statusor.ok() ? static_cast<int>(statusor.value()) : -1;
+  }
+
+  uint64_t bytes_{};
+  uint64_t messages_{};
+};
+
+ParserPtr createParser(ParserType type, MessageType message_type, ParserCallbacks* callbacks) {
+  switch (type) {
+  case ParserType::Legacy:
+    return std::make_unique<LegacyHttpParserImpl>(message_type, callbacks);
+  case ParserType::Vectorized:
+    return std::make_unique<VectorizedHttpParserImpl>(message_type, callbacks);
+  }
+  return nullptr;
+}
+
+std::string minimalRequest() { return "GET / HTTP/1.1\r\nHost: example.com\r\n\r\n"; }
+
+// A request as sent by a browser: long target, user agent and cookies.
+std::string browserRequest() {
+  return absl::StrCat(
+      "GET /static/js/app.bundle.min.js?v=2f8b1c7e9a0d4c3b8e6f HTTP/1.1\r\n"
+      "Host: www.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+      "Chrome/96.0.4664.110 Safari/537.36\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,"
+      "*/*;q=0.8\r\n"
+      "Accept-Language: en-US,en;q=0.9\r\n"
+      "Accept-Encoding: gzip, deflate, br\r\n"
+      "Referer: https://www.example.com/some/page/that/links/to/the/bundle.html\r\n"
+      "Cookie: session=",
+      std::string(256, 'a'), "; preferences=", std::string(128, 'b'),
+      "\r\n"
+      "Connection: keep-alive\r\n"
+      "Cache-Control: max-age=0\r\n\r\n");
+}
+
+std::string chunkedResponse() {
+  std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                         "Transfer-Encoding: chunked\r\n\r\n";
+  for (int i = 0; i < 4; ++i) {
+    absl::StrAppend(&response, "400\r\n", std::string(1024, 'x'), "\r\n");
+  }
+  absl::StrAppend(&response, "0\r\n\r\n");
+  return response;
+}
+
+// Parses `messages` back to back messages in a single buffer, split into slices of `slice_size`
+// bytes to model reads from the network.
+void parseMessages(benchmark::State& state, ParserType type, MessageType message_type,
+                   const std::string& message) {
+  const size_t messages = 100;
+  const size_t slice_size = state.range(0);
+  std::string input;
+  for (size_t i = 0; i < messages; ++i) {
+    input.append(message);
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    NullCallbacks callbacks;
+    ParserPtr parser = createParser(type, message_type, &callbacks);
+    for (size_t offset = 0; offset < input.size(); offset += slice_size) {
+      const size_t length = std::min(slice_size, input.size() - offset);
+      const auto result = parser->execute(input.data() + offset, length);
+      if (result.rc != 0 || result.nread != length) {
+        state.SkipWithError("parse error");
+        return;
+      }
+    }
+    if (callbacks.messages_ != messages) {
+      state.SkipWithError("unexpected message count");
+      return;
+    }
+    benchmark::DoNotOptimize(callbacks.bytes_);
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+void bmLegacyMinimalRequest(benchmark::State& state) {
+  parseMessages(state, ParserType::Legacy, MessageType::Request, minimalRequest());
+}
+void bmVectorizedMinimalRequest(benchmark::State& state) {
+  parseMessages(state, ParserType::Vectorized, MessageType::Request, minimalRequest());
+}
+void bmLegacyBrowserRequest(benchmark::State& state) {
+  parseMessages(state, ParserType::Legacy, MessageType::Request, browserRequest());
+}
+void bmVectorizedBrowserRequest(benchmark::State& state) {
+  parseMessages(state, ParserType::Vectorized, MessageType::Request, browserRequest());
+}
+void bmLegacyChunkedResponse(benchmark::State& state) {
+  parseMessages(state, ParserType::Legacy, MessageType::Response, chunkedResponse());
+}
+void bmVectorizedChunkedResponse(benchmark::State& state) {
+  parseMessages(state, ParserType::Vectorized, MessageType::Response, chunkedResponse());
+}
+
+BENCHMARK(bmLegacyMinimalRequest)->Arg(16384);
+BENCHMARK(bmVectorizedMinimalRequest)->Arg(16384);
+BENCHMARK(bmLegacyBrowserRequest)->Arg(16384)->Arg(512);
+BENCHMARK(bmVectorizedBrowserRequest)->Arg(16384)->Arg(512);
+BENCHMARK(bmLegacyChunkedResponse)->Arg(16384);
+BENCHMARK(bmVectorizedChunkedResponse)->Arg(16384);
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
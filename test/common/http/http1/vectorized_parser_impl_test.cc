@@ -0,0 +1,362 @@
+#include <string>
+#include <vector>
+
+#include "source/common/http/http1/vectorized_parser_impl.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records parser callbacks as a list of events. Consecutive data callbacks of the same kind are
+// merged so that the recorded events do not depend on how the input was sliced.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  Status onMessageBegin() override {
+    events_.push_back("begin");
+    return okStatus();
+  }
+  Status onUrl(const char* data, size_t length) override {
+    return appendData("url: ", data, length);
+  }
+  Status onHeaderField(const char* data, size_t length) override {
+    return appendData("field: ", data, length);
+  }
+  Status onHeaderValue(const char* data, size_t length) override {
+    return appendData("value: ", data, length);
+  }
+  StatusOr<ParserStatus> onHeadersComplete() override {
+    events_.push_back("headers complete");
+    if (pause_on_headers_complete_) {
+      return parser_->pause();
+    }
+    return headers_complete_status_;
+  }
+  void bufferBody(const char* data, size_t length) override {
+    appendData("body: ", data, length).IgnoreError();
+  }
+  StatusOr<ParserStatus> onMessageComplete() override {
+    events_.push_back("message complete");
+    if (pause_on_message_complete_) {
+      return parser_->pause();
+    }
+    return ParserStatus::Success;
+  }
+  void onChunkHeader(bool is_final_chunk) override {
+    events_.push_back(is_final_chunk ? "final chunk" : "chunk");
+  }
+  int setAndCheckCallbackStatus(Status&& status) override {
+    return parser_->statusToInt(status.ok() ? ParserStatus::Success : ParserStatus::Error);
+  }
+  int setAndCheckCallbackStatusOr(StatusOr<ParserStatus>&& statusor) override {
+    return parser_->statusToInt(statusor.ok() ? statusor.value() : ParserStatus::Error);
+  }
+
+  Status appendData(absl::string_view kind, const char* data, size_t length) {
+    if (!events_.empty() && absl::StartsWith(events_.back(), kind)) {
+      events_.back().append(data, length);
+    } else {
+      events_.push_back(absl::StrCat(kind, absl::string_view(data, length)));
+    }
+    if (fail_on_ == kind) {
+      return codecProtocolError("injected");
+    }
+    return okStatus();
+  }
+
+  Parser* parser_{};
+  std::vector<std::string> events_;
+  ParserStatus headers_complete_status_{ParserStatus::Success};
+  bool pause_on_headers_complete_{};
+  bool pause_on_message_complete_{};
+  std::string fail_on_;
+};
+
+class VectorizedParserImplTest : public testing::Test {
+public:
+  void initialize(MessageType type) {
+    parser_ = std::make_unique<VectorizedHttpParserImpl>(type, &callbacks_);
+    callbacks_.parser_ = parser_.get();
+  }
+
+  // Feeds the input in slices of at most slice_size bytes, resuming the parser whenever it pauses.
+  // Returns the name of the error the parser stopped with.
+  std::string parse(absl::string_view input, size_t slice_size) {
+    while (!input.empty()) {
+      parser_->resume();
+      const size_t length = std::min(slice_size, input.size());
+      auto [nread, rc] = parser_->execute(input.data(), length);
+      if (rc != parser_->statusToInt(ParserStatus::Success) &&
+          rc != parser_->statusToInt(ParserStatus::Paused)) {
+        return std::string(parser_->errnoName(rc));
+      }
+      EXPECT_LE(nread, length);
+      input.remove_prefix(nread);
+      if (nread == 0 && parser_->getStatus() == ParserStatus::Success) {
+        break;
+      }
+    }
+    return std::string(parser_->errnoName(0));
+  }
+
+  // Verifies the input parses to the same events no matter how it is split.
+  void expectEvents(MessageType type, absl::string_view input,
+                    const std::vector<std::string>& expected) {
+    for (size_t slice_size : {input.size(), size_t(1), size_t(2), size_t(7), size_t(17)}) {
+      SCOPED_TRACE(absl::StrCat("slice size ", slice_size));
+      callbacks_.events_.clear();
+      initialize(type);
+      EXPECT_EQ("HPE_OK", parse(input, slice_size));
+      EXPECT_EQ(expected, callbacks_.events_);
+    }
+  }
+
+  void expectError(MessageType type, absl::string_view input, absl::string_view error) {
+    for (size_t slice_size : {input.size(), size_t(1)}) {
+      SCOPED_TRACE(absl::StrCat("slice size ", slice_size));
+      initialize(type);
+      EXPECT_EQ(error, parse(input, slice_size));
+      EXPECT_EQ(ParserStatus::Unknown, parser_->getStatus());
+    }
+  }
+
+  RecordingCallbacks callbacks_;
+  std::unique_ptr<VectorizedHttpParserImpl> parser_;
+};
+
+TEST_F(VectorizedParserImplTest, RequestWithContentLength) {
+  expectEvents(MessageType::Request,
+               "POST /foo?bar=baz HTTP/1.1\r\nHost: example.com\r\nContent-Length: 5\r\n"
+               "X-Empty:\r\n\r\nhello",
+               {"begin", "url: /foo?bar=baz", "field: Host", "value: example.com",
+                "field: Content-Length", "value: 5", "field: X-Empty", "value: ",
+                "headers complete", "body: hello", "message complete"});
+  EXPECT_EQ("POST", parser_->methodName());
+  EXPECT_EQ(1, parser_->httpMajor());
+  EXPECT_EQ(1, parser_->httpMinor());
+  EXPECT_EQ(5, parser_->contentLength().value());
+  EXPECT_FALSE(parser_->isChunked());
+  EXPECT_EQ(0, parser_->hasTransferEncoding());
+}
+
+// Values longer than a vector block, containing tabs and non-ASCII bytes, are passed through
+// intact with leading whitespace stripped.
+TEST_F(VectorizedParserImplTest, LongHeaderValues) {
+  const std::string value = "a\tb \xc3\xa9 0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+  const std::string url = absl::StrCat("/", std::string(100, 'x'), "?q=1");
+  expectEvents(MessageType::Request,
+               absl::StrCat("GET ", url, " HTTP/1.0\r\nCookie: \t ", value, "\r\n\r\n"),
+               {"begin", absl::StrCat("url: ", url), "field: Cookie",
+                absl::StrCat("value: ", value), "headers complete", "message complete"});
+  EXPECT_EQ(0, parser_->httpMinor());
+}
+
+TEST_F(VectorizedParserImplTest, ChunkedRequestWithTrailers) {
+  expectEvents(MessageType::Request,
+               "PUT / HTTP/1.1\r\nTransfer-Encoding: gzip, chunked\r\n\r\n"
+               "5;ext=1\r\nhello\r\n6\r\n world\r\n0\r\nX-Trailer: done\r\n\r\n",
+               {"begin", "url: /", "field: Transfer-Encoding", "value: gzip, chunked",
+                "headers complete", "chunk", "body: hello", "chunk", "body:  world", "final chunk",
+                "field: X-Trailer", "value: done", "message complete"});
+  EXPECT_TRUE(parser_->isChunked());
+  EXPECT_EQ(1, parser_->hasTransferEncoding());
+  EXPECT_FALSE(parser_->contentLength().has_value());
+}
+
+TEST_F(VectorizedParserImplTest, PipelinedRequests) {
+  expectEvents(MessageType::Request,
+               "GET /a HTTP/1.1\r\n\r\n\r\nHEAD /b HTTP/1.1\r\nContent-Length: 0\r\n\r\n",
+               {"begin", "url: /a", "headers complete", "message complete", "begin", "url: /b",
+                "field: Content-Length", "value: 0", "headers complete", "message complete"});
+  EXPECT_EQ("HEAD", parser_->methodName());
+}
+
+// Besides origin-form, a target may be in asterisk-form or absolute-form, and is an authority for
+// CONNECT.
+TEST_F(VectorizedParserImplTest, RequestTargetForms) {
+  expectEvents(MessageType::Request, "OPTIONS * HTTP/1.1\r\n\r\n",
+               {"begin", "url: *", "headers complete", "message complete"});
+  expectEvents(MessageType::Request, "GET http://example.com/a HTTP/1.1\r\n\r\n",
+               {"begin", "url: http://example.com/a", "headers complete", "message complete"});
+  expectEvents(MessageType::Request, "CONNECT example.com:443 HTTP/1.1\r\n\r\n",
+               {"begin", "url: example.com:443", "headers complete", "message complete"});
+}
+
+TEST_F(VectorizedParserImplTest, Http09Request) {
+  expectEvents(MessageType::Request, "GET /\r\n\r\n",
+               {"begin", "url: /", "headers complete", "message complete"});
+  EXPECT_EQ(0, parser_->httpMajor());
+  EXPECT_EQ(9, parser_->httpMinor());
+}
+
+TEST_F(VectorizedParserImplTest, ResponseBodyUntilEof) {
+  for (size_t slice_size : {size_t(1), size_t(100)}) {
+    callbacks_.events_.clear();
+    initialize(MessageType::Response);
+    EXPECT_EQ("HPE_OK", parse("HTTP/1.1 200 OK\r\nServer: test\r\n\r\nbody", slice_size));
+    EXPECT_EQ(200, parser_->statusCode());
+    EXPECT_EQ(ParserStatus::Success, parser_->getStatus());
+    EXPECT_EQ(0, parser_->execute(nullptr, 0).rc);
+    EXPECT_EQ((std::vector<std::string>{"begin", "field: Server", "value: test",
+                                        "headers complete", "body: body", "message complete"}),
+              callbacks_.events_);
+  }
+}
+
+TEST_F(VectorizedParserImplTest, ResponsesWithoutBody) {
+  expectEvents(MessageType::Response,
+               "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 204\r\n\r\n"
+               "HTTP/1.1 304 Not Modified\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok",
+               {"begin", "headers complete", "message complete", "begin", "headers complete",
+                "message complete", "begin", "headers complete", "message complete", "begin",
+                "field: Content-Length", "value: 2", "headers complete", "body: ok",
+                "message complete"});
+}
+
+// A response to a HEAD request has no body even though it carries a content length.
+TEST_F(VectorizedParserImplTest, NoBodyFromHeadersComplete) {
+  callbacks_.headers_complete_status_ = ParserStatus::NoBody;
+  expectEvents(MessageType::Response,
+               "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nHTTP/1.1 200 OK\r\n\r\n",
+               {"begin", "field: Content-Length", "value: 10", "headers complete",
+                "message complete", "begin", "headers complete", "message complete"});
+}
+
+// After an upgrade the parser stops at the end of the headers and leaves the rest of the data
+// unconsumed.
+TEST_F(VectorizedParserImplTest, Upgrade) {
+  initialize(MessageType::Request);
+  callbacks_.headers_complete_status_ = ParserStatus::NoBodyData;
+  const absl::string_view headers =
+      "GET / HTTP/1.1\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n\r\n";
+  const std::string input = absl::StrCat(headers, "payload");
+  auto [nread, rc] = parser_->execute(input.data(), input.size());
+  EXPECT_EQ(0, rc);
+  EXPECT_EQ(headers.size(), nread);
+  EXPECT_EQ("message complete", callbacks_.events_.back());
+}
+
+// The body of an upgrade request is parsed, but the data after it is left unconsumed.
+TEST_F(VectorizedParserImplTest, UpgradeWithBody) {
+  initialize(MessageType::Request);
+  const absl::string_view request = "POST / HTTP/1.1\r\nConnection: Upgrade\r\nUpgrade: foo\r\n"
+                                    "Content-Length: 5\r\n\r\n12345";
+  const std::string input = absl::StrCat(request, "payload");
+  auto [nread, rc] = parser_->execute(input.data(), input.size());
+  EXPECT_EQ(0, rc);
+  EXPECT_EQ(request.size(), nread);
+  EXPECT_EQ("message complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedParserImplTest, PauseAndResume) {
+  initialize(MessageType::Request);
+  callbacks_.pause_on_headers_complete_ = true;
+  callbacks_.pause_on_message_complete_ = true;
+  const absl::string_view first = "POST / HTTP/1.1\r\nContent-Length: 1\r\n\r\n";
+  const std::string input = absl::StrCat(first, "xGET / HTTP/1.1\r\n\r\n");
+
+  auto result = parser_->execute(input.data(), input.size());
+  EXPECT_EQ(first.size(), result.nread);
+  EXPECT_EQ(parser_->statusToInt(ParserStatus::Paused), result.rc);
+  EXPECT_EQ(ParserStatus::Paused, parser_->getStatus());
+  EXPECT_EQ("headers complete", callbacks_.events_.back());
+
+  // Nothing is consumed while paused.
+  EXPECT_EQ(0, parser_->execute(input.data() + first.size(), 1).nread);
+
+  parser_->resume();
+  result = parser_->execute(input.data() + first.size(), input.size() - first.size());
+  EXPECT_EQ(1, result.nread);
+  EXPECT_EQ(ParserStatus::Paused, parser_->getStatus());
+  EXPECT_EQ("message complete", callbacks_.events_.back());
+
+  parser_->resume();
+  callbacks_.pause_on_headers_complete_ = false;
+  callbacks_.pause_on_message_complete_ = false;
+  result = parser_->execute(input.data() + first.size() + 1, input.size() - first.size() - 1);
+  EXPECT_EQ(input.size() - first.size() - 1, result.nread);
+  EXPECT_EQ(0, result.rc);
+  EXPECT_EQ("message complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedParserImplTest, CallbackError) {
+  callbacks_.fail_on_ = "value: ";
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\nHost: a\r\n\r\n", "HPE_CB_header_value");
+}
+
+TEST_F(VectorizedParserImplTest, RequestErrors) {
+  expectError(MessageType::Request, "get / HTTP/1.1\r\n\r\n", "HPE_INVALID_METHOD");
+  expectError(MessageType::Request, "FETCH / HTTP/1.1\r\n\r\n", "HPE_INVALID_METHOD");
+  expectError(MessageType::Request, "GET\r\n\r\n", "HPE_INVALID_METHOD");
+  expectError(MessageType::Request, "GET \r\n\r\n", "HPE_INVALID_URL");
+  expectError(MessageType::Request, "GET /\x01 HTTP/1.1\r\n\r\n", "HPE_INVALID_URL");
+  expectError(MessageType::Request, "GET foo HTTP/1.1\r\n\r\n", "HPE_INVALID_URL");
+  expectError(MessageType::Request, "GET 1http://a/ HTTP/1.1\r\n\r\n", "HPE_INVALID_URL");
+  expectError(MessageType::Request, "GET http:/a HTTP/1.1\r\n\r\n", "HPE_INVALID_URL");
+  expectError(MessageType::Request, "GET / HTTP/1.1 \r\n\r\n", "HPE_INVALID_VERSION");
+  expectError(MessageType::Request, "GET / HTTP/11\r\n\r\n", "HPE_INVALID_VERSION");
+  expectError(MessageType::Request, "GET / HTTP/1.1\rX", "HPE_LF_EXPECTED");
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\nHo st: a\r\n\r\n",
+              "HPE_INVALID_HEADER_TOKEN");
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\n: a\r\n\r\n", "HPE_INVALID_HEADER_TOKEN");
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\nA: b\r\n c\r\n\r\n",
+              "HPE_INVALID_HEADER_TOKEN");
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\nA: 0123456789abcdef\x7f\r\n\r\n",
+              "HPE_INVALID_HEADER_TOKEN");
+  expectError(MessageType::Request, "GET / HTTP/1.1\r\nA: b\rc\r\n\r\n", "HPE_STRICT");
+  expectError(MessageType::Request, "POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n",
+              "HPE_INVALID_CONTENT_LENGTH");
+  expectError(MessageType::Request,
+              "POST / HTTP/1.1\r\nContent-Length: 99999999999999999999\r\n\r\n",
+              "HPE_INVALID_CONTENT_LENGTH");
+  expectError(MessageType::Request,
+              "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\n",
+              "HPE_UNEXPECTED_CONTENT_LENGTH");
+  expectError(MessageType::Request, "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+              "HPE_INVALID_TRANSFER_ENCODING");
+  expectError(MessageType::Request,
+              "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nx\r\n",
+              "HPE_INVALID_CHUNK_SIZE");
+  expectError(MessageType::Request,
+              "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n11111111111111111\r\n",
+              "HPE_INVALID_CHUNK_SIZE");
+  expectError(MessageType::Request,
+              "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nab\r\n",
+              "HPE_STRICT");
+  expectError(MessageType::Request,
+              "GET / HTTP/1.1\r\nConnection: close\r\n\r\nGET / HTTP/1.1\r\n\r\n",
+              "HPE_CLOSED_CONNECTION");
+  expectError(MessageType::Request, "GET / HTTP/1.0\r\n\r\nGET / HTTP/1.0\r\n\r\n",
+              "HPE_CLOSED_CONNECTION");
+}
+
+TEST_F(VectorizedParserImplTest, ResponseErrors) {
+  expectError(MessageType::Response, "HTTP/1.1x200 OK\r\n\r\n", "HPE_INVALID_VERSION");
+  expectError(MessageType::Response, "HTTX/1.1 200 OK\r\n\r\n", "HPE_INVALID_VERSION");
+  expectError(MessageType::Response, "HTTP/1.1 OK\r\n\r\n", "HPE_INVALID_STATUS");
+  expectError(MessageType::Response, "HTTP/1.1 1000 OK\r\n\r\n", "HPE_INVALID_STATUS");
+  expectError(MessageType::Response, "HTTP/1.1 200x\r\n\r\n", "HPE_INVALID_STATUS");
+}
+
+TEST_F(VectorizedParserImplTest, EofInsideMessage) {
+  initialize(MessageType::Request);
+  const absl::string_view input = "POST / HTTP/1.1\r\nContent-Length: 10\r\n\r\nabc";
+  EXPECT_EQ(input.size(), parser_->execute(input.data(), input.size()).nread);
+  EXPECT_EQ("HPE_INVALID_EOF_STATE", parser_->errnoName(parser_->execute(nullptr, 0).rc));
+}
+
+TEST_F(VectorizedParserImplTest, KeepAliveHttp10) {
+  expectEvents(MessageType::Request,
+               "GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\nGET / HTTP/1.0\r\n\r\n",
+               {"begin", "url: /", "field: Connection", "value: Keep-Alive", "headers complete",
+                "message complete", "begin", "url: /", "headers complete", "message complete"});
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
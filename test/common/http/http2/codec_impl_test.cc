@@ -348,6 +348,89 @@ TEST_P(Http2CodecImplTest, ShutdownNotice) {
   response_encoder_->encodeHeaders(response_headers, true);
 }
 
+// Names and values decoded from the HPACK static table reference nghttp2's static storage.
+TEST_P(Http2CodecImplTest, StaticTableHeadersReferenced) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("accept-language", "en");
+  request_headers.addCopy("x-custom", "foo");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true))
+      .WillOnce(Invoke([](RequestHeaderMapPtr& headers, bool) {
+        EXPECT_TRUE(headers->Method()->value().isReference());
+        const auto accept_language = headers->get(LowerCaseString("accept-language"));
+        ASSERT_EQ(1, accept_language.size());
+        EXPECT_TRUE(accept_language[0]->key().isReference());
+        EXPECT_FALSE(accept_language[0]->value().isReference());
+        const auto custom = headers->get(LowerCaseString("x-custom"));
+        ASSERT_EQ(1, custom.size());
+        EXPECT_FALSE(custom[0]->key().isReference());
+        EXPECT_EQ("foo", custom[0]->value().getStringView());
+      }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+}
+
+// Verify that frames serialized by one nghttp2_session_send() call go out in a single write.
+TEST_P(Http2CodecImplTest, CoalesceOutboundFrames) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http2_coalesce_outbound_frames", "true"}});
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(0, nghttp2_submit_ping(client_->session(), NGHTTP2_FLAG_NONE, nullptr));
+  }
+
+  int write_count = 0;
+  Buffer::OwnedImpl buffer;
+  ON_CALL(server_connection_, write(_, _))
+      .WillByDefault(Invoke([&buffer, &write_count](Buffer::Instance& frame, bool) {
+        ++write_count;
+        buffer.move(frame);
+      }));
+
+  EXPECT_TRUE(client_->sendPendingFrames().ok());
+  // All of the PING acks are written at once. Each PING frame is 17 bytes.
+  EXPECT_EQ(1, write_count);
+  EXPECT_EQ(10 * 17, buffer.length());
+  EXPECT_FALSE(server_->wantsToWrite());
+}
+
+// Verify that DATA frames are sized up to max_outbound_data_frame_size when the peer allows it.
+TEST_P(Http2CodecImplTest, MaxOutboundDataFrameSize) {
+  client_http2_options_.mutable_max_outbound_data_frame_size()->set_value(65536);
+  auto* max_frame_size = server_http2_options_.add_custom_settings_parameters();
+  max_frame_size->mutable_identifier()->set_value(NGHTTP2_SETTINGS_MAX_FRAME_SIZE);
+  max_frame_size->mutable_value()->set_value(65536);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+
+  Buffer::OwnedImpl output;
+  ON_CALL(client_connection_, write(_, _))
+      .WillByDefault(Invoke([&output](Buffer::Instance& data, bool) { output.move(data); }));
+  Buffer::OwnedImpl body(std::string(65536, 'a'));
+  request_encoder_->encodeData(body, false);
+
+  // The body is sent as one DATA frame rather than four 16KiB ones.
+  ASSERT_EQ(65536 + 9, output.length());
+  const uint8_t* frame_header = static_cast<const uint8_t*>(output.linearize(9));
+  EXPECT_EQ(65536, (frame_header[0] << 16) | (frame_header[1] << 8) | frame_header[2]);
+  EXPECT_EQ(NGHTTP2_DATA, frame_header[3]);
+
+  EXPECT_CALL(request_decoder_, decodeData(_, false)).Times(AtLeast(1));
+  EXPECT_TRUE(server_wrapper_.dispatch(output, *server_).ok());
+}
+
 TEST_P(Http2CodecImplTest, ProtocolErrorForTest) {
   initialize();
   EXPECT_EQ(absl::nullopt, request_encoder_->http1StreamEncoderOptions());
@@ -0,0 +1,241 @@
+#include <memory>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/header_map_impl.h"
+#include "source/common/http/shared_conn_pool.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/network/utility.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/conn_pool.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class SharedConnPoolProxyTest : public testing::Test {
+public:
+  SharedConnPoolProxyTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        mailbox_(std::make_shared<WorkerMailbox>(*dispatcher_)),
+        proxy_(std::make_unique<SharedConnPoolProxy>(
+            *dispatcher_, mailbox_, mailbox_, host_,
+            [this]() -> ConnectionPool::Instance* { return home_pool_; })) {
+    proxy_->addIdleCallback([this]() { ++idle_callbacks_; });
+  }
+
+  // Runs the callbacks relayed between the two halves of the streams. Both halves live on the
+  // same dispatcher here.
+  void relay() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  // Starts a stream on the proxy and has the home pool assign it to a connection.
+  RequestEncoder* startStream() {
+    EXPECT_CALL(home_pool_instance_, newStream(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&home_decoder_), SaveArg<1>(&home_callbacks_),
+                        Return(&home_cancellable_)));
+    EXPECT_NE(nullptr, proxy_->newStream(decoder_, callbacks_));
+    relay();
+
+    RequestEncoder* local_encoder{};
+    EXPECT_CALL(callbacks_, onPoolReady(_, _, _, absl::make_optional(Protocol::Http2)))
+        .WillOnce(Invoke([&](RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                             const StreamInfo::StreamInfo& info, absl::optional<Protocol>) {
+          local_encoder = &encoder;
+          EXPECT_EQ(remote_address_, info.downstreamAddressProvider().remoteAddress());
+          EXPECT_EQ(42, info.downstreamAddressProvider().connectionID().value());
+        }));
+    home_callbacks_->onPoolReady(home_encoder_, host_, home_stream_info_, Protocol::Http2);
+    relay();
+    return local_encoder;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  WorkerMailboxSharedPtr mailbox_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{new NiceMock<Upstream::MockHost>()};
+  NiceMock<ConnectionPool::MockInstance> home_pool_instance_;
+  ConnectionPool::Instance* home_pool_{&home_pool_instance_};
+  std::unique_ptr<SharedConnPoolProxy> proxy_;
+  uint32_t idle_callbacks_{};
+
+  NiceMock<MockResponseDecoder> decoder_;
+  ConnectionPool::MockCallbacks callbacks_;
+
+  ResponseDecoder* home_decoder_{};
+  ConnectionPool::Callbacks* home_callbacks_{};
+  NiceMock<Envoy::ConnectionPool::MockCancellable> home_cancellable_;
+  NiceMock<MockRequestEncoder> home_encoder_;
+  Network::Address::InstanceConstSharedPtr local_address_{
+      Network::Utility::parseInternetAddressAndPort("10.0.0.1:1000")};
+  Network::Address::InstanceConstSharedPtr remote_address_{
+      Network::Utility::parseInternetAddressAndPort("10.0.0.2:443")};
+  std::shared_ptr<Network::ConnectionInfoSetterImpl> home_connection_info_{[this]() {
+    auto info =
+        std::make_shared<Network::ConnectionInfoSetterImpl>(local_address_, remote_address_);
+    info->setConnectionID(42);
+    return info;
+  }()};
+  StreamInfo::StreamInfoImpl home_stream_info_{api_->timeSource(), home_connection_info_};
+};
+
+TEST_F(SharedConnPoolProxyTest, RelaysRequestAndResponse) {
+  RequestEncoder* encoder = startStream();
+  ASSERT_NE(nullptr, encoder);
+  EXPECT_FALSE(proxy_->isIdle());
+
+  // The request is encoded on the home pool's stream.
+  TestRequestHeaderMapImpl request_headers{{":method", "POST"}, {":path", "/"}};
+  Buffer::OwnedImpl request_body("request");
+  EXPECT_TRUE(encoder->encodeHeaders(request_headers, false).ok());
+  encoder->encodeData(request_body, true);
+  EXPECT_EQ(0, request_body.length());
+  EXPECT_CALL(home_encoder_, encodeHeaders(HeaderMapEqualRef(&request_headers), false));
+  EXPECT_CALL(home_encoder_, encodeData(BufferStringEqual("request"), true));
+  relay();
+
+  // The response is replayed on the proxy's decoder.
+  home_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl response_body("response");
+  home_decoder_->decodeData(response_body, true);
+  EXPECT_CALL(decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder_, decodeData(BufferStringEqual("response"), true));
+  relay();
+
+  EXPECT_TRUE(proxy_->isIdle());
+  EXPECT_EQ(1, idle_callbacks_);
+}
+
+TEST_F(SharedConnPoolProxyTest, CancelBeforeReady) {
+  EXPECT_CALL(home_pool_instance_, newStream(_, _)).WillOnce(Return(&home_cancellable_));
+  ConnectionPool::Cancellable* handle = proxy_->newStream(decoder_, callbacks_);
+  relay();
+
+  handle->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  EXPECT_TRUE(proxy_->isIdle());
+  EXPECT_CALL(home_cancellable_, cancel(_));
+  relay();
+}
+
+TEST_F(SharedConnPoolProxyTest, NoHomePool) {
+  home_pool_ = nullptr;
+  proxy_->newStream(decoder_, callbacks_);
+  EXPECT_CALL(callbacks_,
+              onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure, _, _));
+  relay();
+  EXPECT_TRUE(proxy_->isIdle());
+}
+
+TEST_F(SharedConnPoolProxyTest, HomePoolFailure) {
+  EXPECT_CALL(home_pool_instance_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseDecoder&, ConnectionPool::Callbacks& callbacks) {
+        callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Timeout, "timeout", host_);
+        return nullptr;
+      }));
+  proxy_->newStream(decoder_, callbacks_);
+  EXPECT_CALL(callbacks_,
+              onPoolFailure(ConnectionPool::PoolFailureReason::Timeout, "timeout", _));
+  relay();
+  EXPECT_TRUE(proxy_->isIdle());
+}
+
+TEST_F(SharedConnPoolProxyTest, UpstreamResetRelayed) {
+  RequestEncoder* encoder = startStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  home_encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  relay();
+  EXPECT_TRUE(proxy_->isIdle());
+}
+
+TEST_F(SharedConnPoolProxyTest, LocalResetRelayed) {
+  RequestEncoder* encoder = startStream();
+  encoder->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_TRUE(proxy_->isIdle());
+
+  EXPECT_CALL(home_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  relay();
+}
+
+TEST_F(SharedConnPoolProxyTest, WatermarksRelayed) {
+  RequestEncoder* encoder = startStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  home_encoder_.stream_.runHighWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  relay();
+
+  home_encoder_.stream_.runLowWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  relay();
+
+  EXPECT_CALL(home_encoder_.stream_, readDisable(true));
+  encoder->getStream().readDisable(true);
+  relay();
+
+  encoder->getStream().removeCallbacks(stream_callbacks);
+  encoder->getStream().resetStream(StreamResetReason::LocalReset);
+  relay();
+}
+
+TEST_F(SharedConnPoolProxyTest, DestroyWithActiveStream) {
+  RequestEncoder* encoder = startStream();
+  MockStreamCallbacks stream_callbacks;
+  encoder->getStream().addCallbacks(stream_callbacks);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::ConnectionTermination, _));
+  proxy_.reset();
+
+  EXPECT_CALL(home_encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  relay();
+}
+
+// Once the worker which owns the pool has stopped, new streams fail right away rather than wait
+// for it.
+TEST_F(SharedConnPoolProxyTest, ClosedHomeMailboxFailsStream) {
+  mailbox_->close();
+  EXPECT_CALL(callbacks_, onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                        "shared connection pool stopped", _));
+  EXPECT_EQ(nullptr, proxy_->newStream(decoder_, callbacks_));
+  EXPECT_TRUE(proxy_->isIdle());
+  EXPECT_EQ(1, idle_callbacks_);
+
+  EXPECT_CALL(home_pool_instance_, newStream(_, _)).Times(0);
+  relay();
+}
+
+TEST(WorkerMailboxTest, ClosedMailboxDropsCallbacks) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  WorkerMailbox mailbox(*dispatcher);
+  uint32_t runs = 0;
+  EXPECT_TRUE(mailbox.post([&runs]() { ++runs; }));
+  mailbox.close();
+  EXPECT_FALSE(mailbox.post([&runs]() { ++runs; }));
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, runs);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
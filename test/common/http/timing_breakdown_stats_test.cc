@@ -0,0 +1,72 @@
+#include <chrono>
+
+#include "source/common/http/timing_breakdown_stats.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class TimingBreakdownStatsTest : public testing::Test {
+public:
+  void expectRecorded(const std::string& name, uint64_t value) {
+    EXPECT_CALL(store_, deliverHistogramToSinks(
+                            Property(&Stats::Metric::name, "timing_breakdown." + name), value));
+  }
+  void expectNotRecorded(const std::string& name) {
+    EXPECT_CALL(store_, deliverHistogramToSinks(
+                            Property(&Stats::Metric::name, "timing_breakdown." + name), _))
+        .Times(0);
+  }
+
+  NiceMock<Stats::MockIsolatedStatsStore> store_;
+  TimingBreakdownStats stats_{
+      {"envoy.filters.http.buffer", "envoy.filters.http.router", "envoy.filters.http.router"},
+      "timing_breakdown.",
+      store_};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+TEST_F(TimingBreakdownStatsTest, NoTimingBreakdown) {
+  EXPECT_CALL(store_, deliverHistogramToSinks(_, _)).Times(0);
+  stats_.record(stream_info_);
+}
+
+TEST_F(TimingBreakdownStatsTest, RecordsReachedTimingPoints) {
+  stream_info_.enableTimingBreakdown();
+  StreamInfo::TimingBreakdown& timing_breakdown = *stream_info_.timingBreakdown();
+  timing_breakdown.route_selection_ = std::chrono::microseconds(10);
+  timing_breakdown.codec_encode_ = std::chrono::microseconds(20);
+  timing_breakdown.filters_[timing_breakdown.addFilter("envoy.filters.http.buffer")].decode_ =
+      std::chrono::microseconds(30);
+  // Filters which are not configured on the connection manager are not recorded.
+  timing_breakdown.filters_[timing_breakdown.addFilter("unknown")].decode_ =
+      std::chrono::microseconds(40);
+  EXPECT_CALL(stream_info_, firstUpstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::microseconds(50)));
+
+  expectRecorded("route_selection_time", 10);
+  expectRecorded("codec_encode_time", 20);
+  expectRecorded("filter.envoy.filters.http.buffer.decode_time", 30);
+  expectRecorded("first_upstream_rx_byte_time", 50);
+  // The stream never reached these timing points.
+  expectNotRecorded("host_selection_time");
+  expectNotRecorded("conn_pool_wait_time");
+  expectNotRecorded("filter.envoy.filters.http.buffer.encode_time");
+  expectNotRecorded("filter.envoy.filters.http.router.decode_time");
+  stats_.record(stream_info_);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,92 @@
+#include <limits>
+#include <string>
+
+#include "source/common/json/json_writer.h"
+#include "source/common/protobuf/utility.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Json {
+namespace {
+
+std::string jsonString(absl::string_view value) {
+  std::string output;
+  Writer::appendString(value, output);
+  return output;
+}
+
+std::string jsonNumber(double value) {
+  std::string output;
+  Writer::appendNumber(value, output);
+  return output;
+}
+
+std::string jsonValue(const ProtobufWkt::Value& value) {
+  std::string output;
+  Writer::appendValue(value, output);
+  return output;
+}
+
+TEST(JsonWriterTest, String) {
+  EXPECT_EQ(R"("")", jsonString(""));
+  EXPECT_EQ(R"("plain")", jsonString("plain"));
+  EXPECT_EQ(R"("a\"b\\c")", jsonString("a\"b\\c"));
+  EXPECT_EQ(R"("\b\f\n\r\t")", jsonString("\b\f\n\r\t"));
+  EXPECT_EQ(R"("\u0000\u0001\u001f\u007f")", jsonString(absl::string_view("\0\x01\x1f\x7f", 4)));
+  // Other characters, including UTF-8 sequences, are written as they are.
+  EXPECT_EQ("\"caf\xc3\xa9 <&>\"", jsonString("caf\xc3\xa9 <&>"));
+}
+
+TEST(JsonWriterTest, StringAppends) {
+  std::string output = "prefix:";
+  Writer::appendString("value", output);
+  EXPECT_EQ(R"(prefix:"value")", output);
+}
+
+TEST(JsonWriterTest, Number) {
+  EXPECT_EQ("0", jsonNumber(0));
+  EXPECT_EQ("-3", jsonNumber(-3));
+  EXPECT_EQ("200", jsonNumber(200));
+  EXPECT_EQ("1.5", jsonNumber(1.5));
+  EXPECT_EQ("0.1", jsonNumber(0.1));
+  EXPECT_EQ("1e+21", jsonNumber(1e21));
+  EXPECT_EQ("null", jsonNumber(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("null", jsonNumber(std::numeric_limits<double>::quiet_NaN()));
+}
+
+TEST(JsonWriterTest, Value) {
+  EXPECT_EQ("null", jsonValue(ValueUtil::nullValue()));
+  EXPECT_EQ("null", jsonValue(ProtobufWkt::Value()));
+  EXPECT_EQ("true", jsonValue(ValueUtil::boolValue(true)));
+  EXPECT_EQ("false", jsonValue(ValueUtil::boolValue(false)));
+  EXPECT_EQ("5", jsonValue(ValueUtil::numberValue(5)));
+  EXPECT_EQ(R"("a\nb")", jsonValue(ValueUtil::stringValue("a\nb")));
+  EXPECT_EQ("[]", jsonValue(ValueUtil::listValue({})));
+  const ProtobufWkt::Value list = ValueUtil::listValue(
+      {ValueUtil::numberValue(1), ValueUtil::stringValue("two"), ValueUtil::nullValue()});
+  EXPECT_EQ(R"([1,"two",null])", jsonValue(list));
+}
+
+// Structs are written the same way as by the protobuf JSON printer, but the order of their fields
+// is not defined, so the output is compared after parsing it.
+TEST(JsonWriterTest, StructMatchesProtobufJson) {
+  ProtobufWkt::Struct nested;
+  (*nested.mutable_fields())["inner"] = ValueUtil::stringValue("quote\"d");
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["number"] = ValueUtil::numberValue(2.5);
+  (*s.mutable_fields())["list"] =
+      ValueUtil::listValue({ValueUtil::boolValue(true), ValueUtil::structValue(nested)});
+  (*s.mutable_fields())["nested"] = ValueUtil::structValue(nested);
+  (*s.mutable_fields())["null"] = ValueUtil::nullValue();
+
+  const std::string output = jsonValue(ValueUtil::structValue(s));
+  EXPECT_TRUE(
+      TestUtility::jsonStringEqual(output, MessageUtil::getJsonStringFromMessageOrDie(s, false)));
+}
+
+} // namespace
+} // namespace Json
+} // namespace Envoy
@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "source/common/profiler/continuous_profiler.h"
+
+#include "absl/base/attributes.h"
+#include "absl/strings/str_cat.h"
+#include "absl/debugging/symbolize.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#endif
+
+using testing::HasSubstr;
+using testing::Not;
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+void* frame(uintptr_t pc) { return reinterpret_cast<void*>(pc); }
+
+MonotonicTime at(int64_t seconds) { return MonotonicTime(std::chrono::seconds(seconds)); }
+
+ABSL_ATTRIBUTE_NOINLINE int frequentFunction(int value) { return value * 3 + 1; }
+ABSL_ATTRIBUTE_NOINLINE int rareFunction(int value) { return value * 5 - 7; }
+
+TEST(SampleRingTest, ReturnsSamplesSinceTime) {
+  SampleRing ring(4);
+  void* frames[] = {frame(0x10), frame(0x20)};
+  ring.record(at(1), 7, frames, 2);
+  ring.record(at(2), 8, frames, 1);
+
+  EXPECT_EQ(2U, ring.samplesSince(at(0)).size());
+  const std::vector<StackSample> samples = ring.samplesSince(at(2));
+  ASSERT_EQ(1U, samples.size());
+  EXPECT_EQ(at(2), samples[0].time_);
+  EXPECT_EQ(8, samples[0].thread_id_);
+  EXPECT_EQ(std::vector<void*>{frame(0x10)}, samples[0].frames_);
+}
+
+TEST(SampleRingTest, OverwritesOldestSamples) {
+  SampleRing ring(2);
+  void* frames[] = {frame(0x10)};
+  for (int32_t thread_id = 1; thread_id <= 5; ++thread_id) {
+    ring.record(at(thread_id), thread_id, frames, 1);
+  }
+
+  const std::vector<StackSample> samples = ring.samplesSince(at(0));
+  ASSERT_EQ(2U, samples.size());
+  EXPECT_EQ(4, samples[0].thread_id_);
+  EXPECT_EQ(5, samples[1].thread_id_);
+}
+
+TEST(SampleRingTest, TruncatesDeepStacks) {
+  SampleRing ring(1);
+  std::vector<void*> frames(SampleRing::MaxFrames + 8, frame(0x10));
+  ring.record(at(1), 1, frames.data(), static_cast<int>(frames.size()));
+
+  const std::vector<StackSample> samples = ring.samplesSince(at(0));
+  ASSERT_EQ(1U, samples.size());
+  EXPECT_EQ(SampleRing::MaxFrames, samples[0].frames_.size());
+}
+
+TEST(FoldStacksTest, CountsStacksPerThread) {
+  const std::vector<StackSample> samples{
+      {at(1), 1, {frame(0x10), frame(0x20)}},
+      {at(2), 1, {frame(0x10), frame(0x20)}},
+      {at(3), 1, {frame(0x30), frame(0x20)}},
+      {at(4), 2, {frame(0x10), frame(0x20)}},
+  };
+
+  EXPECT_EQ("thread_2;0x20;0x10 1\n"
+            "wrk:worker_0;0x20;0x10 2\n"
+            "wrk:worker_0;0x20;0x30 1\n",
+            foldStacks(samples, {{1, "wrk:worker_0"}}, 16));
+}
+
+TEST(FoldStacksTest, SymbolizesMostFrequentFrames) {
+  void* frequent = reinterpret_cast<void*>(&frequentFunction);
+  void* rare = reinterpret_cast<void*>(&rareFunction);
+  const std::vector<StackSample> samples{
+      {at(1), 1, {frequent}},
+      {at(2), 1, {frequent}},
+      {at(3), 1, {rare}},
+  };
+
+  const std::string folded = foldStacks(samples, {}, 1);
+  EXPECT_THAT(folded, HasSubstr("frequentFunction"));
+  EXPECT_THAT(folded, Not(HasSubstr("rareFunction")));
+  EXPECT_THAT(folded,
+              HasSubstr(absl::StrCat("0x", absl::Hex(reinterpret_cast<uintptr_t>(rare)), " 1")));
+}
+
+TEST(LegacyCpuProfileTest, MergesIdenticalStacks) {
+  const std::vector<StackSample> samples{
+      {at(1), 1, {frame(0x10), frame(0x20)}},
+      {at(2), 2, {frame(0x10), frame(0x20)}},
+      {at(3), 1, {}},
+  };
+
+  const std::string profile = legacyCpuProfile(samples, std::chrono::microseconds(10000), "maps");
+  const std::vector<uintptr_t> expected{0, 3, 0, 10000, 0, 2, 2, 0x10, 0x20, 0, 1, 0};
+  const size_t size = expected.size() * sizeof(uintptr_t);
+  ASSERT_EQ(size + 4, profile.size());
+  EXPECT_EQ(0, memcmp(expected.data(), profile.data(), size));
+  EXPECT_EQ("maps", profile.substr(size));
+}
+
+#ifdef __linux__
+std::chrono::nanoseconds threadCpuTime() {
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+// Burns CPU in its own frame for the given CPU time.
+ABSL_ATTRIBUTE_NOINLINE uint64_t spinForProfiler(std::chrono::milliseconds duration) {
+  const std::chrono::nanoseconds end = threadCpuTime() + duration;
+  volatile uint64_t value = 0;
+  while (threadCpuTime() < end) {
+    for (int i = 0; i < 100000; ++i) {
+      value = value * 31 + i;
+    }
+  }
+  return value;
+}
+
+ABSL_ATTRIBUTE_NOINLINE uint64_t spinningCaller(std::chrono::milliseconds duration) {
+  return spinForProfiler(duration) + 1;
+}
+
+bool symbolizesTo(void* pc, absl::string_view function) {
+  char symbol[1024];
+  return absl::Symbolize(pc, symbol, sizeof(symbol)) &&
+         absl::string_view(symbol).find(function) != absl::string_view::npos;
+}
+
+TEST(ContinuousCpuTest, SamplesInterruptedThread) {
+  ASSERT_TRUE(ContinuousCpu::startProfiler(1000, 4096));
+  spinningCaller(std::chrono::milliseconds(300));
+  const std::vector<StackSample> samples = ContinuousCpu::samplesSince(MonotonicTime());
+  ContinuousCpu::stopProfiler();
+
+  // The innermost frame is the interrupted instruction, which is mostly in the spinning function,
+  // followed by its caller. The frames of the signal handler are left out.
+  const int32_t thread_id = static_cast<int32_t>(syscall(SYS_gettid));
+  uint32_t spinning = 0;
+  for (const StackSample& sample : samples) {
+    if (sample.thread_id_ != thread_id || sample.frames_.empty()) {
+      continue;
+    }
+    if (symbolizesTo(sample.frames_[0], "spinForProfiler")) {
+      ++spinning;
+      ASSERT_GE(sample.frames_.size(), 2U);
+      EXPECT_TRUE(symbolizesTo(sample.frames_[1], "spinningCaller"));
+    }
+    for (void* frame : sample.frames_) {
+      EXPECT_FALSE(symbolizesTo(frame, "onProfilingSignal"));
+    }
+  }
+  EXPECT_GT(spinning, 0U);
+}
+
+TEST(ContinuousCpuTest, StartsOnce) {
+  EXPECT_FALSE(ContinuousCpu::isProfilerStarted());
+  EXPECT_FALSE(ContinuousCpu::startProfiler(0, 16));
+  EXPECT_FALSE(ContinuousCpu::startProfiler(100, 0));
+
+  EXPECT_TRUE(ContinuousCpu::startProfiler(100, 16));
+  EXPECT_TRUE(ContinuousCpu::isProfilerStarted());
+  EXPECT_EQ(std::chrono::microseconds(10000), ContinuousCpu::samplingPeriod());
+  EXPECT_FALSE(ContinuousCpu::startProfiler(100, 16));
+  EXPECT_FALSE(ContinuousCpu::memoryMappings().empty());
+
+  ContinuousCpu::stopProfiler();
+  EXPECT_FALSE(ContinuousCpu::isProfilerStarted());
+  EXPECT_TRUE(ContinuousCpu::samplesSince(MonotonicTime()).empty());
+}
+#endif
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
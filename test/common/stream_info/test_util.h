@@ -237,6 +237,20 @@ public:
     downstream_bytes_meter_ = downstream_bytes_meter;
   }
 
+  void enableTimingBreakdown() override {
+    if (timing_breakdown_ == nullptr) {
+      timing_breakdown_ = std::make_unique<Envoy::StreamInfo::TimingBreakdown>();
+    }
+  }
+
+  Envoy::StreamInfo::TimingBreakdown* timingBreakdown() override {
+    return timing_breakdown_.get();
+  }
+
+  const Envoy::StreamInfo::TimingBreakdown* timingBreakdown() const override {
+    return timing_breakdown_.get();
+  }
+
   Random::RandomGeneratorImpl random_;
   SystemTime start_time_;
   MonotonicTime start_time_monotonic_;
@@ -284,6 +298,7 @@ public:
       std::make_shared<Envoy::StreamInfo::BytesMeter>()};
   Envoy::StreamInfo::BytesMeterSharedPtr downstream_bytes_meter_{
       std::make_shared<Envoy::StreamInfo::BytesMeter>()};
+  std::unique_ptr<Envoy::StreamInfo::TimingBreakdown> timing_breakdown_;
 };
 
 } // namespace Envoy
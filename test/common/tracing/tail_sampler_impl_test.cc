@@ -0,0 +1,235 @@
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/tail_sampler_impl.h"
+
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Tracing {
+namespace {
+
+class TailSamplerTest : public testing::Test {
+public:
+  void setup(std::chrono::milliseconds latency_threshold, bool keep_errors,
+             uint32_t max_buffered_spans = DefaultTailSamplingMaxBufferedSpans) {
+    sampler_ = std::make_unique<TailSampler>(latency_threshold, keep_errors, max_buffered_spans,
+                                             time_system_, store_, "tracing.tail_sampling.");
+  }
+
+  // Starts a trace whose downstream span is downstream_.
+  SpanPtr startTrace(bool sampled) {
+    downstream_ = new NiceMock<MockSpan>();
+    return sampler_->wrapSpan(SpanPtr{downstream_}, time_system_.monotonicTime(), sampled);
+  }
+
+  // Spawns a child of span, whose span of the driver is returned in child.
+  SpanPtr spawnChild(Span& span, NiceMock<MockSpan>& parent, NiceMock<MockSpan>*& child) {
+    child = new NiceMock<MockSpan>();
+    EXPECT_CALL(parent, spawnChild_(_, "child", _)).WillOnce(Return(child));
+    return span.spawnChild(config_, "child", time_system_.systemTime());
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "tracing.tail_sampling." + name)->value();
+  }
+
+  uint64_t bufferedSpans() {
+    return TestUtility::findGauge(store_, "tracing.tail_sampling.spans_buffered")->value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<MockConfig> config_;
+  std::unique_ptr<TailSampler> sampler_;
+  NiceMock<MockSpan>* downstream_{};
+};
+
+TEST_F(TailSamplerTest, SampledTraceIsNotBuffered) {
+  setup(std::chrono::milliseconds(100), true);
+  SpanPtr span = startTrace(true);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+
+  EXPECT_CALL(*child, finishSpan());
+  child_span->finishSpan();
+  EXPECT_EQ(0U, bufferedSpans());
+
+  EXPECT_CALL(*downstream_, finishSpan());
+  span->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+TEST_F(TailSamplerTest, UnsampledTraceIsDiscarded) {
+  setup(std::chrono::milliseconds(100), true);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+
+  EXPECT_CALL(*child, finishSpan()).Times(0);
+  EXPECT_CALL(*child, setSampled(false));
+  child_span->finishSpan();
+  EXPECT_EQ(1U, bufferedSpans());
+
+  EXPECT_CALL(*downstream_, finishSpan()).Times(0);
+  EXPECT_CALL(*downstream_, setSampled(false));
+  span->finishSpan();
+  EXPECT_EQ(0U, bufferedSpans());
+  EXPECT_EQ(1U, counter("traces_discarded"));
+  EXPECT_EQ(0U, counter("traces_kept"));
+}
+
+TEST_F(TailSamplerTest, SlowTraceIsKept) {
+  setup(std::chrono::milliseconds(100), false);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+  child_span->finishSpan();
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  {
+    InSequence s;
+    EXPECT_CALL(*child, finishSpan());
+    EXPECT_CALL(*downstream_, finishSpan());
+  }
+  span->finishSpan();
+  EXPECT_EQ(0U, bufferedSpans());
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+// Latency is measured on the monotonic clock, so that wall clock adjustments do not affect it.
+TEST_F(TailSamplerTest, SlowTraceIsKeptWhenWallClockMovesBack) {
+  setup(std::chrono::milliseconds(100), false);
+  SpanPtr span = startTrace(false);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  time_system_.setSystemTime(time_system_.systemTime() - std::chrono::hours(1));
+  EXPECT_CALL(*downstream_, finishSpan());
+  span->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+TEST_F(TailSamplerTest, FailingTraceIsKept) {
+  setup(std::chrono::milliseconds(0), true);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+
+  EXPECT_CALL(*child, setTag(Tags::get().Error, Tags::get().True));
+  child_span->setTag(Tags::get().Error, Tags::get().True);
+  child_span->finishSpan();
+
+  EXPECT_CALL(*child, finishSpan());
+  EXPECT_CALL(*downstream_, finishSpan());
+  span->finishSpan();
+  EXPECT_EQ(1U, counter("traces_kept"));
+}
+
+TEST_F(TailSamplerTest, ErrorsAreIgnoredUnlessConfigured) {
+  setup(std::chrono::milliseconds(0), false);
+  SpanPtr span = startTrace(false);
+  span->setTag(Tags::get().Error, Tags::get().True);
+
+  EXPECT_CALL(*downstream_, finishSpan()).Times(0);
+  span->finishSpan();
+  EXPECT_EQ(1U, counter("traces_discarded"));
+}
+
+TEST_F(TailSamplerTest, SpansAreDiscardedWhenBufferIsFull) {
+  setup(std::chrono::milliseconds(100), false, 1);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* first;
+  SpanPtr first_span = spawnChild(*span, *downstream_, first);
+  NiceMock<MockSpan>* second;
+  SpanPtr second_span = spawnChild(*span, *downstream_, second);
+
+  first_span->finishSpan();
+  EXPECT_CALL(*second, finishSpan()).Times(0);
+  EXPECT_CALL(*second, setSampled(false));
+  second_span->finishSpan();
+  EXPECT_EQ(1U, bufferedSpans());
+  EXPECT_EQ(1U, counter("spans_overflowed"));
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  EXPECT_CALL(*first, finishSpan());
+  EXPECT_CALL(*downstream_, finishSpan());
+  span->finishSpan();
+  EXPECT_EQ(0U, bufferedSpans());
+}
+
+TEST_F(TailSamplerTest, ChildFinishedAfterDecision) {
+  setup(std::chrono::milliseconds(100), false);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+
+  time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+  span->finishSpan();
+
+  // The decision applies to the spans of the trace which finish later.
+  EXPECT_CALL(*child, finishSpan());
+  child_span->finishSpan();
+  EXPECT_EQ(0U, bufferedSpans());
+}
+
+TEST_F(TailSamplerTest, DownstreamSpanDestroyedWithoutFinishing) {
+  setup(std::chrono::milliseconds(100), false);
+  SpanPtr span = startTrace(false);
+  NiceMock<MockSpan>* child;
+  SpanPtr child_span = spawnChild(*span, *downstream_, child);
+  child_span->finishSpan();
+  EXPECT_EQ(1U, bufferedSpans());
+
+  EXPECT_CALL(*child, finishSpan()).Times(0);
+  child_span.reset();
+  span.reset();
+  EXPECT_EQ(0U, bufferedSpans());
+}
+
+TEST_F(TailSamplerTest, ForwardsToDriverSpan) {
+  setup(std::chrono::milliseconds(100), false);
+  SpanPtr span = startTrace(true);
+
+  EXPECT_CALL(*downstream_, setOperation("operation"));
+  span->setOperation("operation");
+  EXPECT_CALL(*downstream_, setTag("key", "value"));
+  span->setTag("key", "value");
+  EXPECT_CALL(*downstream_, log(_, "event"));
+  span->log(time_system_.systemTime(), "event");
+  Http::TestRequestHeaderMapImpl request_headers;
+  {
+    InSequence s;
+    EXPECT_CALL(*downstream_, setSampled(true));
+    EXPECT_CALL(*downstream_, injectContext(_));
+    EXPECT_CALL(*downstream_, setSampled(true));
+  }
+  span->injectContext(request_headers);
+  EXPECT_CALL(*downstream_, setBaggage("key", "value"));
+  span->setBaggage("key", "value");
+  EXPECT_CALL(*downstream_, getBaggage("key")).WillOnce(Return("value"));
+  EXPECT_EQ("value", span->getBaggage("key"));
+  EXPECT_CALL(*downstream_, getTraceIdAsHex()).WillOnce(Return("1234"));
+  EXPECT_EQ("1234", span->getTraceIdAsHex());
+  EXPECT_CALL(*downstream_, setSampled(false));
+  span->setSampled(false);
+
+  EXPECT_CALL(*downstream_, finishSpan());
+  span->finishSpan();
+
+  // The span is ignored once it finished.
+  span->setTag("key", "value");
+  EXPECT_EQ("", span->getTraceIdAsHex());
+}
+
+} // namespace
+} // namespace Tracing
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#include <vector>
+
+#include "source/common/upstream/alias_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Walk every random value in one period of the table and verify each index is picked exactly in
+// proportion to its weight.
+void expectExactDistribution(const std::vector<uint64_t>& weights) {
+  AliasTable table;
+  table.build(weights);
+  ASSERT_EQ(weights.size(), table.size());
+
+  std::vector<uint64_t> picks(weights.size());
+  const uint64_t period = table.size() * table.totalWeight();
+  for (uint64_t random = 0; random < period; ++random) {
+    const uint32_t index = table.pick(random);
+    ASSERT_LT(index, weights.size());
+    ++picks[index];
+  }
+  for (size_t i = 0; i < weights.size(); ++i) {
+    EXPECT_EQ(weights[i] * weights.size(), picks[i]) << "index " << i;
+  }
+}
+
+TEST(AliasTableTest, Empty) {
+  AliasTable table;
+  table.build({});
+  EXPECT_EQ(0, table.size());
+  EXPECT_EQ(0, table.totalWeight());
+}
+
+TEST(AliasTableTest, AllZero) {
+  AliasTable table;
+  table.build({0, 0, 0});
+  EXPECT_EQ(3, table.size());
+  EXPECT_EQ(0, table.totalWeight());
+}
+
+TEST(AliasTableTest, Single) { expectExactDistribution({7}); }
+
+TEST(AliasTableTest, Uniform) { expectExactDistribution({5, 5, 5, 5}); }
+
+// Zero weight entries, such as the local locality in zone aware routing, are never picked.
+TEST(AliasTableTest, ZeroWeights) {
+  expectExactDistribution({0, 10000, 5000});
+  expectExactDistribution({0, 667, 667});
+  expectExactDistribution({3, 0, 0, 9, 0});
+}
+
+TEST(AliasTableTest, Skewed) {
+  expectExactDistribution({1, 1000, 2, 3, 997, 1});
+  expectExactDistribution({1234, 1, 1, 1, 1, 1, 1, 1, 1});
+}
+
+// Rebuilding reuses storage and fully replaces the previous table.
+TEST(AliasTableTest, Rebuild) {
+  AliasTable table;
+  table.build({1, 2, 3, 4, 5});
+  EXPECT_EQ(5, table.size());
+  EXPECT_EQ(15, table.totalWeight());
+
+  table.build({0, 4});
+  EXPECT_EQ(2, table.size());
+  EXPECT_EQ(4, table.totalWeight());
+  for (uint64_t random = 0; random < 100; ++random) {
+    EXPECT_EQ(1, table.pick(random));
+  }
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -4,6 +4,7 @@
 #include "envoy/config/cluster/v3/cluster.pb.validate.h"
 #include "envoy/config/core/v3/base.pb.h"
 
+#include "source/common/http/shared_conn_pool.h"
 #include "source/common/network/raw_buffer_socket.h"
 #include "source/common/network/resolver_impl.h"
 #include "source/common/router/context_impl.h"
@@ -33,6 +34,10 @@ public:
     ASSERT(data.has_value());
     return dynamic_cast<Http::ConnectionPool::MockInstance*>(data.value().pool_);
   }
+  static Http::SharedConnPoolProxy* getSharedPoolProxy(absl::optional<HttpPoolData> data) {
+    ASSERT(data.has_value());
+    return dynamic_cast<Http::SharedConnPoolProxy*>(data.value().pool_);
+  }
 };
 
 class TcpPoolDataPeer {
@@ -57,6 +62,7 @@ using ::testing::Return;
 using ::testing::ReturnNew;
 using ::testing::ReturnRef;
 using ::testing::SaveArg;
+using ::testing::WithArg;
 
 using namespace std::chrono_literals;
 
@@ -97,6 +103,30 @@ public:
         [this, bootstrap]() { cluster_manager_->initializeSecondaryClusters(bootstrap); });
   }
 
+  // Creates the cluster manager along with the thread local cluster managers of the given number of
+  // workers, which all receive the cluster updates. The first worker is the current one.
+  void createWithWorkers(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
+                         uint32_t num_workers) {
+    factory_.tls_.defer_data_ = true;
+    worker_slot_ = factory_.tls_.current_slot_;
+    create(bootstrap);
+    for (uint32_t i = 0; i < num_workers; ++i) {
+      worker_dispatchers_.push_back(std::make_unique<NiceMock<Event::MockDispatcher>>());
+      workers_.push_back(factory_.tls_.deferred_data_[worker_slot_](*worker_dispatchers_.back()));
+    }
+    setCurrentWorker(0);
+    ON_CALL(factory_.tls_, runOnAllThreads(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      ThreadLocal::ThreadLocalObjectSharedPtr current = factory_.tls_.data_[worker_slot_];
+      for (const auto& worker : workers_) {
+        factory_.tls_.data_[worker_slot_] = worker;
+        cb();
+      }
+      factory_.tls_.data_[worker_slot_] = current;
+    }));
+  }
+
+  void setCurrentWorker(uint32_t index) { factory_.tls_.data_[worker_slot_] = workers_[index]; }
+
   void createWithLocalClusterUpdate(const bool enable_merge_window = true) {
     std::string yaml = R"EOF(
   static_resources:
@@ -192,6 +222,9 @@ public:
   Router::ContextImpl router_context_;
   NiceMock<Network::MockDnsResolverFactory> dns_resolver_factory_;
   Registry::InjectFactory<Network::DnsResolverFactory> registered_dns_factory_;
+  std::vector<std::unique_ptr<NiceMock<Event::MockDispatcher>>> worker_dispatchers_;
+  std::vector<ThreadLocal::ThreadLocalObjectSharedPtr> workers_;
+  uint32_t worker_slot_{};
 };
 
 envoy::config::bootstrap::v3::Bootstrap defaultConfig() {
@@ -1801,6 +1834,127 @@ TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
 }
 
+// Verify that no host gets a home for its shared HTTP/2 pool until every worker has registered, and
+// that all workers then agree on the home of each host.
+TEST_F(ClusterManagerImplTest, SharedHttp2PoolHomeIsTheSameOnEveryWorker) {
+  // The notification that all the workers created their thread local cluster managers is held
+  // back.
+  Event::PostCb workers_registered;
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_, _))
+      .WillOnce(SaveArg<1>(&workers_registered))
+      .WillRepeatedly(Invoke(&factory_.tls_, &ThreadLocal::MockInstance::runOnAllThreads2));
+  createWithWorkers(defaultConfig(), 4);
+  ASSERT_TRUE(workers_registered != nullptr);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster(new NiceMock<MockClusterMockPrioritySet>());
+  ON_CALL(*cluster->info_, shareHttp2ConnectionPoolAcrossWorkers()).WillByDefault(Return(true));
+  ON_CALL(*cluster->info_, upstreamHttpProtocol(_))
+      .WillByDefault(Return(std::vector<Http::Protocol>{Http::Protocol::Http2}));
+  HostVector hosts;
+  for (int i = 0; i < 8; ++i) {
+    hosts.push_back(
+        makeTestHost(cluster->info_, fmt::format("tcp://127.0.0.1:{}", 80 + i), time_system_));
+  }
+  cluster->prioritySet().getMockHostSet(0)->hosts_ = hosts;
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster, nullptr)));
+  EXPECT_CALL(*cluster, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), ""));
+
+  // Until every worker has registered, each worker uses a pool of its own.
+  Http::ConnectionPool::MockInstance* local_pool =
+      new NiceMock<Http::ConnectionPool::MockInstance>();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _)).WillOnce(Return(local_pool));
+  EXPECT_EQ(local_pool,
+            HttpPoolDataPeer::getPool(cluster_manager_->getThreadLocalCluster("fake_cluster")
+                                          ->httpConnPool(ResourcePriority::High,
+                                                         Http::Protocol::Http2, nullptr)));
+
+  workers_registered();
+
+  // Each worker either creates the pool of a host itself, or proxies to the worker which does.
+  std::vector<std::pair<const HostDescription*, Event::Dispatcher*>> homes;
+  Event::Dispatcher* worker_dispatcher = nullptr;
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _, _, _))
+      .WillRepeatedly(
+          WithArg<0>(Invoke([&](HostConstSharedPtr host) -> Http::ConnectionPool::Instance* {
+            homes.emplace_back(host.get(), worker_dispatcher);
+            return new NiceMock<Http::ConnectionPool::MockInstance>();
+          })));
+  uint32_t proxies = 0;
+  for (uint32_t i = 0; i < workers_.size(); ++i) {
+    setCurrentWorker(i);
+    worker_dispatcher = worker_dispatchers_[i].get();
+    for (size_t j = 0; j < hosts.size(); ++j) {
+      Http::SharedConnPoolProxy* proxy = HttpPoolDataPeer::getSharedPoolProxy(
+          cluster_manager_->getThreadLocalCluster("fake_cluster")
+              ->httpConnPool(ResourcePriority::Default, Http::Protocol::Http2, nullptr));
+      if (proxy != nullptr) {
+        EXPECT_EQ(worker_dispatcher, &proxy->dispatcher());
+        EXPECT_NE(worker_dispatcher, &proxy->homeMailbox()->dispatcher());
+        homes.emplace_back(proxy->host().get(), &proxy->homeMailbox()->dispatcher());
+        ++proxies;
+      }
+    }
+  }
+  EXPECT_GT(proxies, 0U);
+
+  absl::flat_hash_map<const HostDescription*, Event::Dispatcher*> home_of_host;
+  for (const auto& [host, home] : homes) {
+    EXPECT_EQ(home, home_of_host.emplace(host, home).first->second);
+  }
+
+  setCurrentWorker(0);
+  factory_.tls_.shutdownThread();
+}
+
+// Verify that a membership update hands the same host vectors to every worker, rather than a copy
+// to each of them.
+TEST_F(ClusterManagerImplTest, MembershipUpdateSharesHostVectorsAcrossWorkers) {
+  createWithWorkers(defaultConfig(), 2);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster, nullptr)));
+  EXPECT_CALL(*cluster, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), ""));
+
+  std::vector<const HostVector*> hosts_added;
+  std::vector<Common::CallbackHandlePtr> member_update_cbs;
+  for (uint32_t i = 0; i < workers_.size(); ++i) {
+    setCurrentWorker(i);
+    member_update_cbs.push_back(
+        cluster_manager_->getThreadLocalCluster("fake_cluster")
+            ->prioritySet()
+            .addMemberUpdateCb([&hosts_added](const HostVector& added, const HostVector&) {
+              hosts_added.push_back(&added);
+            }));
+  }
+
+  MockHostSet& host_set = *cluster->prioritySet().getMockHostSet(0);
+  host_set.hosts_ = {makeTestHost(cluster->info_, "tcp://127.0.0.1:80", time_system_)};
+  host_set.runCallbacks(host_set.hosts_, {});
+
+  ASSERT_EQ(2U, hosts_added.size());
+  EXPECT_EQ(hosts_added[0], hosts_added[1]);
+  std::vector<const HostVector*> hosts;
+  for (uint32_t i = 0; i < workers_.size(); ++i) {
+    setCurrentWorker(i);
+    const HostSet& worker_host_set = *cluster_manager_->getThreadLocalCluster("fake_cluster")
+                                          ->prioritySet()
+                                          .hostSetsPerPriority()[0];
+    EXPECT_EQ(1U, worker_host_set.hosts().size());
+    hosts.push_back(worker_host_set.hostsPtr().get());
+  }
+  EXPECT_EQ(hosts[0], hosts[1]);
+
+  member_update_cbs.clear();
+  setCurrentWorker(0);
+  factory_.tls_.shutdownThread();
+}
+
 TEST_F(ClusterManagerImplTest, AddOrUpdateClusterStaticExists) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
                                         clustersJson({defaultStaticClusterJson("fake_cluster")}));
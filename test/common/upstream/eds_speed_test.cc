@@ -40,7 +40,8 @@ namespace Upstream {
 
 class EdsSpeedTest {
 public:
-  EdsSpeedTest(State& state, bool use_unified_mux)
+  EdsSpeedTest(State& state, bool use_unified_mux,
+               std::chrono::milliseconds update_coalescing_window = {})
       : state_(state), use_unified_mux_(use_unified_mux),
         type_url_("type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment"),
         subscription_stats_(Config::Utility::generateStats(stats_)),
@@ -58,18 +59,31 @@ public:
               "envoy.service.endpoint.v3.EndpointDiscoveryService.StreamEndpoints"),
           random_, stats_, {}, true));
     }
-    resetCluster(R"EOF(
+    if (update_coalescing_window.count() > 0) {
+      EXPECT_CALL(dispatcher_, createTimer_(testing::_))
+          // Assignment timeout timer.
+          .WillOnce(testing::ReturnNew<NiceMock<Event::MockTimer>>())
+          .WillOnce(testing::Invoke([this](Event::TimerCb cb) {
+            coalescing_timer_ = new NiceMock<Event::MockTimer>();
+            coalescing_timer_->callback_ = cb;
+            return coalescing_timer_;
+          }))
+          .WillRepeatedly(testing::ReturnNew<NiceMock<Event::MockTimer>>());
+    }
+    resetCluster(fmt::format(R"EOF(
       name: name
       connect_timeout: 0.25s
       type: EDS
       eds_cluster_config:
         service_name: fare
+        update_coalescing_window: {}s
         eds_config:
           api_config_source:
             cluster_names:
             - eds
             refresh_delay: 1s
     )EOF",
+                             update_coalescing_window.count() / 1000.0),
                  Envoy::Upstream::Cluster::InitializePhase::Secondary);
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
@@ -101,7 +115,38 @@ public:
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
                                          bool healthy) {
     state_.PauseTiming();
+    auto response = buildResponse(num_hosts, healthy);
+
+    // this is what we're actually testing:
+    validation_visitor_.setSkipValidation(ignore_unknown_dynamic_fields);
+    state_.ResumeTiming();
+    deliverResponse(std::move(response));
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
+           num_hosts);
+  }
+
+  // Deliver a burst of assignments that alternate the health of all the hosts, as a control plane
+  // would while flapping. If a coalescing window is configured, it expires after the burst.
+  void burstUpdateHelper(size_t num_updates, size_t num_hosts) {
+    state_.PauseTiming();
+    std::vector<std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>> responses;
+    for (size_t i = 0; i < num_updates; ++i) {
+      responses.push_back(buildResponse(num_hosts, i % 2 == 0));
+    }
+    validation_visitor_.setSkipValidation(true);
+    state_.ResumeTiming();
+    for (auto& response : responses) {
+      deliverResponse(std::move(response));
+    }
+    if (coalescing_timer_ != nullptr && coalescing_timer_->enabled()) {
+      coalescing_timer_->invokeCallback();
+    }
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
+           num_hosts);
+  }
 
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> buildResponse(size_t num_hosts,
+                                                                                  bool healthy) {
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
     cluster_load_assignment.set_cluster_name("fare");
 
@@ -128,15 +173,15 @@ public:
       socket_address->set_port_value((port + i) % 60000);
     }
 
-    // this is what we're actually testing:
-    validation_visitor_.setSkipValidation(ignore_unknown_dynamic_fields);
-
     auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
     response->set_type_url(type_url_);
     response->set_version_info(fmt::format("version-{}", version_++));
     auto* resource = response->mutable_resources()->Add();
     resource->PackFrom(cluster_load_assignment);
-    state_.ResumeTiming();
+    return response;
+  }
+
+  void deliverResponse(std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse> response) {
     if (use_unified_mux_) {
       dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
           .grpcStreamForTest()
@@ -146,8 +191,6 @@ public:
           .grpcStreamForTest()
           .onReceiveMessage(std::move(response));
     }
-    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[1]->hostsPerLocality().get()[0].size() ==
-           num_hosts);
   }
 
   TestDeprecatedV2Api _deprecated_v2_api_;
@@ -179,6 +222,7 @@ public:
   NiceMock<Grpc::MockAsyncStream> async_stream_;
   Config::GrpcMuxSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
+  Event::MockTimer* coalescing_timer_{};
 };
 
 } // namespace Upstream
@@ -231,3 +275,20 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+static void burstUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // The coalescing window is either disabled or long enough to cover the whole burst.
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false,
+                                             std::chrono::milliseconds(state.range(1) ? 1000 : 0));
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true);
+    speed_test.burstUpdateHelper(10, endpoints);
+  }
+}
+
+BENCHMARK(burstUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
@@ -2290,6 +2290,162 @@ TEST_F(EdsAssignmentTimeoutTest, AssignmentLeaseExpired) {
   }
 }
 
+class EdsUpdateCoalescingTest : public EdsTest {
+public:
+  EdsUpdateCoalescingTest() {
+    EXPECT_CALL(dispatcher_, createTimer_(_))
+        .WillOnce(Invoke([this](Event::TimerCb cb) {
+          EXPECT_EQ(nullptr, assignment_timeout_timer_);
+          assignment_timeout_timer_ = new NiceMock<Event::MockTimer>();
+          assignment_timeout_timer_->callback_ = cb;
+          return assignment_timeout_timer_;
+        }))
+        .WillOnce(Invoke([this](Event::TimerCb cb) {
+          EXPECT_EQ(nullptr, coalescing_timer_);
+          coalescing_timer_ = new NiceMock<Event::MockTimer>();
+          coalescing_timer_->callback_ = cb;
+          return coalescing_timer_;
+        }))
+        .WillRepeatedly(Invoke([](Event::TimerCb) { return new NiceMock<Event::MockTimer>(); }));
+
+    resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      eds_cluster_config:
+        service_name: fare
+        update_coalescing_window: 1s
+        eds_config:
+          api_config_source:
+            api_type: REST
+            cluster_names:
+            - eds
+            refresh_delay: 1s
+    )EOF",
+                 Cluster::InitializePhase::Secondary);
+  }
+
+  envoy::config::endpoint::v3::ClusterLoadAssignment buildAssignment(uint32_t num_hosts) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address("1.2.3.4");
+      socket_address->set_port_value(80 + i);
+    }
+    return cluster_load_assignment;
+  }
+
+  size_t numHosts() { return cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size(); }
+
+  Event::MockTimer* assignment_timeout_timer_{nullptr};
+  Event::MockTimer* coalescing_timer_{nullptr};
+};
+
+// Validate that assignments received within the coalescing window are merged and only the latest
+// one is applied when the window expires.
+TEST_F(EdsUpdateCoalescingTest, CoalesceUpdatesWithinWindow) {
+  initialize();
+
+  // The first assignment is applied right away and opens the window.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(1));
+  EXPECT_TRUE(initialized_);
+  EXPECT_EQ(1UL, numHosts());
+  EXPECT_TRUE(coalescing_timer_->enabled());
+
+  // Assignments within the window are deferred, the last one wins.
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(2));
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(3));
+  EXPECT_EQ(1UL, numHosts());
+  EXPECT_EQ(2UL, stats_.counter("cluster.name.update_coalesced").value());
+
+  // The latest assignment is applied when the window expires, which opens a new window.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  coalescing_timer_->invokeCallback();
+  EXPECT_EQ(3UL, numHosts());
+  EXPECT_TRUE(coalescing_timer_->enabled());
+
+  // Nothing is pending, so the window closes without an update.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(_, _)).Times(0);
+  coalescing_timer_->invokeCallback();
+  EXPECT_EQ(3UL, numHosts());
+  EXPECT_FALSE(coalescing_timer_->enabled());
+
+  // With the window closed, the next assignment is applied immediately.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(2));
+  EXPECT_EQ(2UL, numHosts());
+  EXPECT_EQ(2UL, stats_.counter("cluster.name.update_coalesced").value());
+}
+
+// Validate that a deferred assignment that fails to apply does not throw out of the timer.
+TEST_F(EdsUpdateCoalescingTest, CoalescedUpdateFailure) {
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(1));
+
+  auto cluster_load_assignment = buildAssignment(1);
+  cluster_load_assignment.mutable_endpoints(0)
+      ->mutable_lb_endpoints(0)
+      ->mutable_endpoint()
+      ->mutable_address()
+      ->mutable_socket_address()
+      ->set_address("foo.bar.com");
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  const uint64_t update_failures = stats_.counter("cluster.name.update_failure").value();
+  coalescing_timer_->invokeCallback();
+  EXPECT_EQ(update_failures + 1, stats_.counter("cluster.name.update_failure").value());
+  EXPECT_EQ(1UL, numHosts());
+}
+
+// Validate that an empty update keeps the current config, which includes the assignment waiting
+// for the coalescing window.
+TEST_F(EdsUpdateCoalescingTest, EmptyUpdateKeepsPendingUpdate) {
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(1));
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(3));
+
+  eds_callbacks_->onConfigUpdate({}, "");
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_empty").value());
+  EXPECT_EQ(1UL, numHosts());
+
+  // The pending assignment is still applied when the window expires.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  coalescing_timer_->invokeCallback();
+  EXPECT_EQ(3UL, numHosts());
+}
+
+// Validate that stale assignments are removed as soon as the assignment timeout fires, even with
+// the coalescing window open, and that the stale assignment waiting for the window is dropped.
+TEST_F(EdsUpdateCoalescingTest, AssignmentTimeoutClearsPendingUpdate) {
+  initialize();
+  doOnConfigUpdateVerifyNoThrow(buildAssignment(1));
+
+  auto cluster_load_assignment = buildAssignment(3);
+  cluster_load_assignment.mutable_policy()->mutable_endpoint_stale_after()->set_seconds(5);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, numHosts());
+  EXPECT_TRUE(assignment_timeout_timer_->enabled());
+
+  // The empty assignment is applied right away, and opens a new window.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  assignment_timeout_timer_->invokeCallback();
+  EXPECT_EQ(0UL, numHosts());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.assignment_stale").value());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_coalesced").value());
+
+  // The window expires without applying the stale assignment.
+  EXPECT_CALL(*coalescing_timer_, enableTimer(_, _)).Times(0);
+  coalescing_timer_->invokeCallback();
+  EXPECT_EQ(0UL, numHosts());
+}
+
 // Validate that onConfigUpdate() with a config that contains both LEDS config
 // source and explicit list of endpoints is rejected.
 TEST_F(EdsTest, OnConfigUpdateLedsAndEndpoints) {
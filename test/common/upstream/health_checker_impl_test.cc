@@ -989,6 +989,41 @@ TEST_F(HttpHealthCheckerImplTest, SuccessWithMultipleHosts) {
   EXPECT_EQ(Host::Health::Healthy, cluster_->prioritySet().getMockHostSet(0)->hosts_[1]->health());
 }
 
+// Test that the first checks of multiple hosts are spread evenly over the interval.
+TEST_F(HttpHealthCheckerImplTest, SpreadInitialChecks) {
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    no_traffic_interval: 4s
+    spread_initial_checks: true
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    http_health_check:
+      service_name_matcher:
+        prefix: locations
+      path: /healthcheck
+    )EOF";
+  allocHealthChecker(yaml);
+  addCompletionCallback();
+
+  for (uint32_t i = 0; i < 4; i++) {
+    cluster_->prioritySet().getMockHostSet(0)->hosts_.push_back(
+        makeTestHost(cluster_->info_, fmt::format("tcp://127.0.0.1:{}", 80 + i), simTime()));
+    expectSessionCreate();
+  }
+
+  // Timers are handed out in reverse order of the expectations, so the session of the i-th host
+  // uses the timers of test_sessions_[3 - i]. Connections are handed out in order.
+  // The cluster has no traffic, so the checks are spread over the 4s no traffic interval, with
+  // the first one sent right away.
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[3]->timeout_timer_, enableTimer(_, _));
+  EXPECT_CALL(*test_sessions_[2]->interval_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  EXPECT_CALL(*test_sessions_[1]->interval_timer_, enableTimer(std::chrono::milliseconds(2000), _));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(std::chrono::milliseconds(3000), _));
+  health_checker_->start();
+}
+
 // Test host check success with multiple hosts across multiple priorities.
 TEST_F(HttpHealthCheckerImplTest, SuccessWithMultipleHostSets) {
   setupNoServiceValidationHC();
@@ -149,6 +149,114 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+// Round robin over a cluster spread across several localities, with the local locality of the
+// local cluster over-provisioned relative to the upstream cluster so that residual traffic is
+// routed cross zone.
+class ZoneAwareTester : public Event::TestUsingSimulatedTime {
+public:
+  ZoneAwareTester(uint64_t num_hosts, uint64_t num_localities) {
+    ASSERT(num_hosts < 65536);
+    std::vector<HostVector> upstream_per_locality(num_localities);
+    std::vector<HostVector> local_per_locality(num_localities);
+    HostVector upstream_hosts;
+    HostVector local_hosts;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      const uint64_t locality = i % num_localities;
+      auto host = makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256),
+                               simTime());
+      upstream_hosts.push_back(host);
+      upstream_per_locality[locality].push_back(host);
+
+      // The local locality gets twice its share of local hosts.
+      const uint64_t local_copies = locality == 0 ? 2 : 1;
+      for (uint64_t copy = 0; copy < local_copies; copy++) {
+        auto local_host = makeTestHost(
+            info_, fmt::format("tcp://10.1.{}.{}:{}", i / 256, i % 256, 6379 + copy), simTime());
+        local_hosts.push_back(local_host);
+        local_per_locality[locality].push_back(local_host);
+      }
+    }
+
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(upstream_hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality =
+        makeHostsPerLocality(std::move(upstream_per_locality));
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              upstream_hosts, {}, absl::nullopt);
+    HostVectorConstSharedPtr updated_local_hosts = std::make_shared<HostVector>(local_hosts);
+    HostsPerLocalityConstSharedPtr local_hosts_per_locality =
+        makeHostsPerLocality(std::move(local_per_locality));
+    local_priority_set_.updateHosts(
+        0, HostSetImpl::partitionHosts(updated_local_hosts, local_hosts_per_locality), {},
+        local_hosts, {}, absl::nullopt);
+
+    ON_CALL(runtime_.snapshot_, featureEnabled("upstream.zone_routing.enabled", 100))
+        .WillByDefault(testing::Return(true));
+    lb_ = std::make_unique<RoundRobinLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                   runtime_, random_, common_config_,
+                                                   round_robin_lb_config_, simTime());
+  }
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+
+  PrioritySetImpl priority_set_;
+  PrioritySetImpl local_priority_set_;
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStatNames stat_names_{stats_store_.symbolTable()};
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_, stat_names_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  envoy::config::cluster::v3::Cluster::RoundRobinLbConfig round_robin_lb_config_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  std::unique_ptr<RoundRobinLoadBalancer> lb_;
+};
+
+void benchmarkZoneAwareRoundRobinChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_localities = state.range(1);
+  constexpr uint64_t picks = 10000;
+
+  ZoneAwareTester tester(num_hosts, num_localities);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    for (uint64_t i = 0; i < picks; ++i) {
+      benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+    }
+  }
+
+  const double cross_zone = tester.stats_.lb_zone_routing_cross_zone_.value();
+  const double sampled = tester.stats_.lb_zone_routing_sampled_.value();
+  state.counters["cross_zone_fraction"] = cross_zone / (cross_zone + sampled);
+  state.SetItemsProcessed(state.iterations() * picks);
+}
+BENCHMARK(benchmarkZoneAwareRoundRobinChooseHost)
+    ->Args({100, 2})
+    ->Args({100, 3})
+    ->Args({500, 5})
+    ->Args({500, 10})
+    ->Args({1000, 20})
+    ->Args({1000, 50})
+    ->Unit(::benchmark::kMicrosecond);
+
+void benchmarkZoneAwareRoundRobinRecalculate(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_localities = state.range(1);
+
+  ZoneAwareTester tester(num_hosts, num_localities);
+  const HostSet& local_host_set = *tester.local_priority_set_.hostSetsPerPriority()[0];
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // An empty membership update on the local cluster regenerates the locality routing structures.
+    tester.local_priority_set_.updateHosts(
+        0, HostSetImpl::updateHostsParams(local_host_set), {}, {}, {}, absl::nullopt);
+  }
+}
+BENCHMARK(benchmarkZoneAwareRoundRobinRecalculate)
+    ->Args({100, 3})
+    ->Args({1000, 20})
+    ->Args({1000, 50})
+    ->Unit(::benchmark::kMicrosecond);
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
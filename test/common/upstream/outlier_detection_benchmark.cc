@@ -0,0 +1,106 @@
+// Usage: bazel run //test/common/upstream:outlier_detection_benchmark
+
+#include <memory>
+
+#include "envoy/config/cluster/v3/outlier_detection.pb.h"
+
+#include "source/common/upstream/outlier_detection_impl.h"
+#include "source/common/upstream/upstream_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+class OutlierDetectionTester : public Event::TestUsingSimulatedTime {
+public:
+  OutlierDetectionTester(uint64_t num_hosts) {
+    HostVector& hosts = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+    ASSERT(num_hosts < 65536);
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      const std::string url = fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256);
+      hosts.push_back(makeTestHost(cluster_.info_, url, simTime()));
+    }
+
+    // Ejections are not enforced by the default runtime mock, so every interval runs the full
+    // success rate and failure percentage computations over all the hosts.
+    envoy::config::cluster::v3::OutlierDetection config;
+    config.mutable_failure_percentage_minimum_hosts()->set_value(5);
+    detector_ = DetectorImpl::create(cluster_, config, dispatcher_, runtime_, simTime(), nullptr);
+  }
+
+  // Give every host a full interval worth of requests, with a spread of success rates.
+  void loadRequests() {
+    const auto& hosts = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+    for (uint64_t i = 0; i < hosts.size(); i++) {
+      const uint64_t num_errors = i % 10;
+      for (uint64_t j = 0; j < 100; j++) {
+        hosts[i]->outlierDetector().putHttpResponseCode(j < num_errors ? 503 : 200);
+      }
+    }
+  }
+
+  void runInterval() { interval_timer_->invokeCallback(); }
+
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  Event::MockTimer* interval_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+void benchmarkSuccessRateEjections(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  OutlierDetectionTester tester(num_hosts);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    tester.loadRequests();
+    state.ResumeTiming();
+
+    tester.runInterval();
+  }
+}
+
+BENCHMARK(benchmarkSuccessRateEjections)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(20000)
+    ->Unit(::benchmark::kMillisecond);
+
+void benchmarkSuccessRateEjectionThreshold(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  std::vector<double> success_rates;
+  double success_rate_sum = 0;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    success_rates.push_back(100.0 - (i % 10));
+    success_rate_sum += success_rates.back();
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(
+        DetectorImpl::successRateEjectionThreshold(success_rate_sum, success_rates, 1.9));
+  }
+}
+
+BENCHMARK(benchmarkSuccessRateEjectionThreshold)->Arg(100)->Arg(1000)->Arg(20000);
+
+} // namespace
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
@@ -2013,11 +2013,7 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
 }
 
 TEST(OutlierUtility, SRThreshold) {
-  std::vector<HostSuccessRatePair> data = {
-      HostSuccessRatePair(nullptr, 50),  HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100), HostSuccessRatePair(nullptr, 100),
-      HostSuccessRatePair(nullptr, 100),
-  };
+  std::vector<double> data = {50, 100, 100, 100, 100};
   double sum = 450;
 
   DetectorImpl::EjectionPair success_rate_nums =
@@ -2026,6 +2022,28 @@ TEST(OutlierUtility, SRThreshold) {
   EXPECT_EQ(52.0, success_rate_nums.ejection_threshold_);   // ejection threshold
 }
 
+// Exercise both the multi-lane and the remainder loops of the variance computation.
+TEST(OutlierUtility, SRThresholdManyHosts) {
+  std::vector<double> data(11, 100);
+  data[3] = 45;
+  double sum = 0;
+  for (const double success_rate : data) {
+    sum += success_rate;
+  }
+
+  const double mean = sum / data.size();
+  double variance = 0;
+  for (const double success_rate : data) {
+    variance += (success_rate - mean) * (success_rate - mean);
+  }
+  const double stdev = std::sqrt(variance / data.size());
+
+  DetectorImpl::EjectionPair success_rate_nums =
+      DetectorImpl::successRateEjectionThreshold(sum, data, 1.9);
+  EXPECT_DOUBLE_EQ(mean, success_rate_nums.success_rate_average_);
+  EXPECT_DOUBLE_EQ(mean - 1.9 * stdev, success_rate_nums.ejection_threshold_);
+}
+
 } // namespace
 } // namespace Outlier
 } // namespace Upstream
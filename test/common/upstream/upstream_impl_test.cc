@@ -4149,6 +4149,32 @@ TEST_F(ClusterInfoImplTest, MaxRequestsPerConnectionValidation) {
                             "HttpProtocolOptions can be specified");
 }
 
+TEST_F(ClusterInfoImplTest, ShareHttp2ConnectionPoolAcrossWorkers) {
+  const std::string yaml = R"EOF(
+  name: cluster1
+  type: STRICT_DNS
+  lb_policy: ROUND_ROBIN
+  share_http2_connection_pool_across_workers: true
+)EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_TRUE(cluster->info()->shareHttp2ConnectionPoolAcrossWorkers());
+  EXPECT_FALSE(cluster->info()->connectionPoolPerDownstreamConnection());
+
+  const std::string invalid_yaml = R"EOF(
+  name: cluster1
+  type: STRICT_DNS
+  lb_policy: ROUND_ROBIN
+  share_http2_connection_pool_across_workers: true
+  connection_pool_per_downstream_connection: true
+)EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(makeCluster(invalid_yaml), EnvoyException,
+                            "cluster: connection_pool_per_downstream_connection and "
+                            "share_http2_connection_pool_across_workers may not both be set for "
+                            "cluster cluster1");
+}
+
 TEST_F(ClusterInfoImplTest, DeprecatedMaxRequestsPerConnection) {
   const std::string yaml = R"EOF(
   name: cluster1
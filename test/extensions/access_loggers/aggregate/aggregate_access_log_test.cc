@@ -0,0 +1,237 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/aggregate/v3/aggregate.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/common/json/json_loader.h"
+#include "source/extensions/access_loggers/aggregate/config.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_split.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Aggregate {
+namespace {
+
+using AggregateAccessLogConfig =
+    envoy::extensions::access_loggers::aggregate::v3::AggregateAccessLog;
+
+class AggregateAccessLogTest : public testing::Test {
+public:
+  AccessLog::InstanceSharedPtr createLogger(const std::string& yaml) {
+    AggregateAccessLogConfig aggregate_config;
+    TestUtility::loadFromYaml(yaml, aggregate_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.set_name("envoy.access_loggers.aggregate");
+    config.mutable_typed_config()->PackFrom(aggregate_config);
+
+    EXPECT_CALL(context_.access_log_manager_,
+                createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File,
+                                                            "/dev/null"}))
+        .WillOnce(Return(file_));
+    EXPECT_CALL(*file_, write(_)).WillRepeatedly(Invoke([this](absl::string_view data) {
+      writes_++;
+      for (absl::string_view line : absl::StrSplit(data, '\n', absl::SkipEmpty())) {
+        summaries_.push_back(Json::Factory::loadFromString(std::string(line)));
+      }
+    }));
+    flush_timer_ = new NiceMock<Event::MockTimer>(&context_.dispatcher_);
+    EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+    return AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  void log(AccessLog::Instance& logger, uint32_t response_code) {
+    stream_info_.response_code_ = response_code;
+    logger.log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  }
+
+  void flush() {
+    EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+    flush_timer_->invokeCallback();
+  }
+
+  // Returns the summary with the given value of a key.
+  Json::ObjectSharedPtr summary(const std::string& key, const std::string& value) {
+    for (const Json::ObjectSharedPtr& summary : summaries_) {
+      if (summary->getString(key, "") == value) {
+        return summary;
+      }
+    }
+    ADD_FAILURE() << "no summary with " << key << " " << value;
+    return nullptr;
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  std::shared_ptr<AccessLog::MockAccessLogFile> file_{
+      std::make_shared<AccessLog::MockAccessLogFile>()};
+  NiceMock<Event::MockTimer>* flush_timer_{};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/foo"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  uint32_t writes_{};
+  std::vector<Json::ObjectSharedPtr> summaries_;
+};
+
+TEST_F(AggregateAccessLogTest, ValidateFail) {
+  EXPECT_THROW(
+      AggregateAccessLogFactory().createAccessLogInstance(AggregateAccessLogConfig(), nullptr,
+                                                          context_),
+      ProtoValidationException);
+}
+
+TEST_F(AggregateAccessLogTest, AggregatesByKey) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [ROUTE_NAME, RESPONSE_CODE_CLASS, REQUEST_METHOD]
+exemplars_per_key: 0
+)EOF");
+
+  stream_info_.route_name_ = "route";
+  stream_info_.bytes_received_ = 10;
+  stream_info_.bytes_sent_ = 100;
+  log(*logger, 200);
+  log(*logger, 204);
+  log(*logger, 503);
+  EXPECT_EQ(0, writes_);
+
+  flush();
+  EXPECT_EQ(1, writes_);
+  ASSERT_EQ(2, summaries_.size());
+
+  Json::ObjectSharedPtr ok = summary("response_code_class", "2xx");
+  ASSERT_NE(nullptr, ok);
+  EXPECT_EQ("route", ok->getString("route_name"));
+  EXPECT_EQ("GET", ok->getString("request_method"));
+  EXPECT_EQ(2, ok->getInteger("requests"));
+  EXPECT_EQ(20, ok->getInteger("bytes_received"));
+  EXPECT_EQ(200, ok->getInteger("bytes_sent"));
+  EXPECT_TRUE(ok->hasObject("duration_ms"));
+  EXPECT_FALSE(ok->hasObject("exemplars"));
+  EXPECT_FALSE(ok->hasObject("overflow"));
+
+  Json::ObjectSharedPtr error = summary("response_code_class", "5xx");
+  ASSERT_NE(nullptr, error);
+  EXPECT_EQ(1, error->getInteger("requests"));
+
+  // Each interval starts from scratch, and nothing is written for an empty one.
+  flush();
+  EXPECT_EQ(1, writes_);
+  log(*logger, 503);
+  flush();
+  EXPECT_EQ(2, writes_);
+  ASSERT_EQ(3, summaries_.size());
+  EXPECT_EQ(1, summaries_[2]->getInteger("requests"));
+}
+
+TEST_F(AggregateAccessLogTest, UnsetKeyValues) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [UPSTREAM_CLUSTER, RESPONSE_CODE]
+)EOF");
+
+  EXPECT_CALL(stream_info_, upstreamClusterInfo()).WillRepeatedly(Return(absl::nullopt));
+  stream_info_.end_time_.reset();
+  log(*logger, 0);
+  flush();
+  ASSERT_EQ(1, summaries_.size());
+  EXPECT_EQ("", summaries_[0]->getString("upstream_cluster"));
+  EXPECT_EQ("", summaries_[0]->getString("response_code"));
+  EXPECT_FALSE(summaries_[0]->hasObject("duration_ms"));
+}
+
+TEST_F(AggregateAccessLogTest, SamplesExemplars) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [REQUEST_METHOD]
+exemplars_per_key: 1
+exemplar_format:
+  text_format_source:
+    inline_string: "%RESPONSE_CODE%\n"
+)EOF");
+
+  // The first entry is always kept. Later ones replace it when the random index falls within the
+  // reservoir.
+  EXPECT_CALL(context_.api_.random_, random()).WillOnce(Return(1)).WillOnce(Return(3));
+  log(*logger, 200);
+  log(*logger, 404);
+  log(*logger, 503);
+  flush();
+  ASSERT_EQ(1, summaries_.size());
+  EXPECT_EQ(3, summaries_[0]->getInteger("requests"));
+  EXPECT_EQ(std::vector<std::string>{"503"}, summaries_[0]->getStringArray("exemplars"));
+}
+
+TEST_F(AggregateAccessLogTest, DefaultExemplarFormat) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [REQUEST_METHOD]
+)EOF");
+
+  log(*logger, 200);
+  flush();
+  ASSERT_EQ(1, summaries_.size());
+  const std::vector<std::string> exemplars = summaries_[0]->getStringArray("exemplars");
+  ASSERT_EQ(1, exemplars.size());
+  EXPECT_THAT(exemplars[0], testing::HasSubstr("\"GET /foo"));
+  EXPECT_THAT(exemplars[0], testing::Not(testing::EndsWith("\n")));
+}
+
+TEST_F(AggregateAccessLogTest, Overflow) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [RESPONSE_CODE]
+max_keys: 1
+exemplars_per_key: 0
+)EOF");
+
+  log(*logger, 200);
+  log(*logger, 404);
+  log(*logger, 503);
+  log(*logger, 200);
+  flush();
+  ASSERT_EQ(2, summaries_.size());
+  Json::ObjectSharedPtr ok = summary("response_code", "200");
+  ASSERT_NE(nullptr, ok);
+  EXPECT_EQ(2, ok->getInteger("requests"));
+  EXPECT_TRUE(summaries_[1]->getBoolean("overflow"));
+  EXPECT_FALSE(summaries_[1]->hasObject("response_code"));
+  EXPECT_EQ(2, summaries_[1]->getInteger("requests"));
+}
+
+TEST_F(AggregateAccessLogTest, WritesAggregatesOnDestruction) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+keys: [RESPONSE_CODE]
+exemplars_per_key: 0
+)EOF");
+
+  log(*logger, 200);
+  EXPECT_EQ(0, writes_);
+  logger.reset();
+  EXPECT_EQ(1, writes_);
+  ASSERT_EQ(1, summaries_.size());
+  EXPECT_EQ(1, summaries_[0]->getInteger("requests"));
+}
+
+} // namespace
+} // namespace Aggregate
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,370 @@
+#include <string>
+#include <vector>
+
+#include "envoy/config/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/columnar/v3/columnar.pb.h"
+
+#include "source/common/access_log/access_log_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/access_loggers/columnar/block_builder.h"
+#include "source/extensions/access_loggers/columnar/config.h"
+#include "source/extensions/compression/gzip/decompressor/zlib_decompressor_impl.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace Columnar {
+namespace {
+
+// Reads the varints and byte strings a block is made of.
+class Reader {
+public:
+  explicit Reader(absl::string_view data) : data_(data) {}
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (uint32_t shift = 0;; shift += 7) {
+      if (data_.empty()) {
+        ADD_FAILURE() << "truncated varint";
+        return value;
+      }
+      const uint8_t byte = data_[0];
+      data_.remove_prefix(1);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+  }
+
+  absl::string_view bytes(uint64_t length) {
+    EXPECT_LE(length, data_.size());
+    absl::string_view bytes = data_.substr(0, length);
+    data_.remove_prefix(bytes.size());
+    return bytes;
+  }
+
+  bool empty() const { return data_.empty(); }
+
+private:
+  absl::string_view data_;
+};
+
+struct DecodedColumn {
+  Field field_;
+  ColumnType type_;
+  uint64_t dictionary_size_{};
+  // The values of the column, rendered as strings, with "<unset>" for values which were not set.
+  std::vector<std::string> values_;
+};
+
+std::vector<DecodedColumn> decodePayload(absl::string_view payload) {
+  Reader reader(payload);
+  const uint64_t entries = reader.varint();
+  const uint64_t column_count = reader.varint();
+  std::vector<DecodedColumn> columns;
+  for (uint64_t i = 0; i < column_count; i++) {
+    DecodedColumn column;
+    column.field_ = static_cast<Field>(reader.varint());
+    column.type_ = static_cast<ColumnType>(reader.bytes(1)[0]);
+    Reader column_reader(reader.bytes(reader.varint()));
+
+    std::vector<std::string> dictionary;
+    if (column.type_ == ColumnType::Dictionary) {
+      column.dictionary_size_ = column_reader.varint();
+      for (uint64_t j = 0; j < column.dictionary_size_; j++) {
+        dictionary.emplace_back(column_reader.bytes(column_reader.varint()));
+      }
+    }
+
+    int64_t last_value = 0;
+    for (uint64_t j = 0; j < entries; j++) {
+      const uint64_t value = column_reader.varint();
+      switch (column.type_) {
+      case ColumnType::Integer:
+        column.values_.push_back(value == 0 ? "<unset>" : absl::StrCat(value - 1));
+        break;
+      case ColumnType::Delta:
+        last_value += static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        column.values_.push_back(absl::StrCat(last_value));
+        break;
+      case ColumnType::String:
+        column.values_.push_back(value == 0 ? "<unset>"
+                                            : std::string(column_reader.bytes(value - 1)));
+        break;
+      case ColumnType::Dictionary:
+        EXPECT_LE(value, dictionary.size());
+        column.values_.push_back(value == 0 ? "<unset>" : dictionary[value - 1]);
+        break;
+      }
+    }
+    EXPECT_TRUE(column_reader.empty());
+    columns.push_back(column);
+  }
+  EXPECT_TRUE(reader.empty());
+  return columns;
+}
+
+// Splits the blocks written to a file and returns their decompressed payloads.
+std::vector<std::string> decodeBlocks(absl::string_view data) {
+  std::vector<std::string> payloads;
+  Reader reader(data);
+  while (!reader.empty()) {
+    EXPECT_EQ(BlockWriter::MAGIC, reader.bytes(BlockWriter::MAGIC.size()));
+    const auto compression =
+        static_cast<ColumnarAccessLogConfig::Compression>(reader.bytes(1)[0]);
+    const absl::string_view payload = reader.bytes(reader.varint());
+    if (compression == ColumnarAccessLogConfig::GZIP) {
+      Stats::IsolatedStoreImpl stats_store;
+      Compression::Gzip::Decompressor::ZlibDecompressorImpl decompressor(stats_store, "test.");
+      decompressor.init(15 | 16);
+      Buffer::OwnedImpl input(payload);
+      Buffer::OwnedImpl output;
+      decompressor.decompress(input, output);
+      payloads.push_back(output.toString());
+    } else {
+      EXPECT_EQ(ColumnarAccessLogConfig::NONE, compression);
+      payloads.emplace_back(payload);
+    }
+  }
+  return payloads;
+}
+
+class BlockBuilderTest : public testing::Test {
+public:
+  BlockBuilderTest() {
+    ON_CALL(stream_info_, upstreamClusterInfo())
+        .WillByDefault(Return(absl::make_optional<Upstream::ClusterInfoConstSharedPtr>(cluster_)));
+  }
+
+  std::vector<DecodedColumn> finish(BlockBuilder& builder) {
+    Buffer::OwnedImpl payload;
+    builder.finish(payload);
+    EXPECT_EQ(0, builder.entries());
+    return decodePayload(payload.toString());
+  }
+
+  std::shared_ptr<NiceMock<Upstream::MockClusterInfo>> cluster_{
+      std::make_shared<NiceMock<Upstream::MockClusterInfo>>()};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  Http::TestRequestHeaderMapImpl request_headers_{
+      {":method", "GET"}, {":path", "/foo"}, {":authority", "example.com"}};
+};
+
+TEST_F(BlockBuilderTest, EncodesEachColumnType) {
+  BlockBuilder builder({ColumnarAccessLogConfig::START_TIME, ColumnarAccessLogConfig::RESPONSE_CODE,
+                        ColumnarAccessLogConfig::REQUEST_PATH,
+                        ColumnarAccessLogConfig::UPSTREAM_CLUSTER});
+
+  stream_info_.start_time_ = SystemTime(std::chrono::microseconds(1000));
+  stream_info_.response_code_ = 200;
+  builder.add(request_headers_, stream_info_);
+
+  stream_info_.start_time_ = SystemTime(std::chrono::microseconds(990));
+  stream_info_.response_code_ = absl::nullopt;
+  request_headers_.removePath();
+  builder.add(request_headers_, stream_info_);
+
+  stream_info_.start_time_ = SystemTime(std::chrono::microseconds(2000));
+  EXPECT_CALL(stream_info_, upstreamClusterInfo()).WillOnce(Return(absl::nullopt));
+  builder.add(request_headers_, stream_info_);
+  EXPECT_EQ(3, builder.entries());
+
+  const std::vector<DecodedColumn> columns = finish(builder);
+  ASSERT_EQ(4, columns.size());
+
+  EXPECT_EQ(ColumnarAccessLogConfig::START_TIME, columns[0].field_);
+  EXPECT_EQ(ColumnType::Delta, columns[0].type_);
+  EXPECT_THAT(columns[0].values_, testing::ElementsAre("1000", "990", "2000"));
+
+  EXPECT_EQ(ColumnarAccessLogConfig::RESPONSE_CODE, columns[1].field_);
+  EXPECT_EQ(ColumnType::Integer, columns[1].type_);
+  EXPECT_THAT(columns[1].values_, testing::ElementsAre("200", "<unset>", "<unset>"));
+
+  EXPECT_EQ(ColumnarAccessLogConfig::REQUEST_PATH, columns[2].field_);
+  EXPECT_EQ(ColumnType::String, columns[2].type_);
+  EXPECT_THAT(columns[2].values_, testing::ElementsAre("/foo", "<unset>", "<unset>"));
+
+  EXPECT_EQ(ColumnarAccessLogConfig::UPSTREAM_CLUSTER, columns[3].field_);
+  EXPECT_EQ(ColumnType::Dictionary, columns[3].type_);
+  EXPECT_EQ(1, columns[3].dictionary_size_);
+  EXPECT_THAT(columns[3].values_,
+              testing::ElementsAre("fake_cluster", "fake_cluster", "<unset>"));
+}
+
+TEST_F(BlockBuilderTest, DictionaryIsPerBlock) {
+  BlockBuilder builder({ColumnarAccessLogConfig::REQUEST_METHOD});
+
+  builder.add(request_headers_, stream_info_);
+  request_headers_.setMethod("POST");
+  builder.add(request_headers_, stream_info_);
+  request_headers_.setMethod("GET");
+  builder.add(request_headers_, stream_info_);
+
+  std::vector<DecodedColumn> columns = finish(builder);
+  ASSERT_EQ(1, columns.size());
+  EXPECT_EQ(2, columns[0].dictionary_size_);
+  EXPECT_THAT(columns[0].values_, testing::ElementsAre("GET", "POST", "GET"));
+
+  // A new block starts with an empty dictionary.
+  request_headers_.setMethod("PUT");
+  builder.add(request_headers_, stream_info_);
+  columns = finish(builder);
+  ASSERT_EQ(1, columns.size());
+  EXPECT_EQ(1, columns[0].dictionary_size_);
+  EXPECT_THAT(columns[0].values_, testing::ElementsAre("PUT"));
+}
+
+TEST_F(BlockBuilderTest, AllFields) {
+  std::vector<Field> fields;
+  for (int field = ColumnarAccessLogConfig::Field_MIN; field <= ColumnarAccessLogConfig::Field_MAX;
+       field++) {
+    fields.push_back(static_cast<Field>(field));
+  }
+  BlockBuilder builder(fields);
+
+  stream_info_.protocol_ = Http::Protocol::Http2;
+  stream_info_.route_name_ = "route";
+  stream_info_.host_ = nullptr;
+  builder.add(request_headers_, stream_info_);
+
+  const std::vector<DecodedColumn> columns = finish(builder);
+  ASSERT_EQ(fields.size(), columns.size());
+  for (const DecodedColumn& column : columns) {
+    EXPECT_EQ(columnType(column.field_), column.type_);
+    ASSERT_EQ(1, column.values_.size());
+  }
+  EXPECT_EQ("GET", columns[ColumnarAccessLogConfig::REQUEST_METHOD].values_[0]);
+  EXPECT_EQ("example.com", columns[ColumnarAccessLogConfig::REQUEST_AUTHORITY].values_[0]);
+  EXPECT_EQ("HTTP/2", columns[ColumnarAccessLogConfig::PROTOCOL].values_[0]);
+  EXPECT_EQ("route", columns[ColumnarAccessLogConfig::ROUTE_NAME].values_[0]);
+  EXPECT_EQ("<unset>", columns[ColumnarAccessLogConfig::UPSTREAM_HOST].values_[0]);
+  EXPECT_EQ("127.0.0.1:0", columns[ColumnarAccessLogConfig::DOWNSTREAM_REMOTE_ADDRESS].values_[0]);
+}
+
+class ColumnarAccessLogTest : public testing::Test {
+public:
+  AccessLog::InstanceSharedPtr createLogger(const std::string& yaml) {
+    ColumnarAccessLogConfig columnar_config;
+    TestUtility::loadFromYaml(yaml, columnar_config);
+    envoy::config::accesslog::v3::AccessLog config;
+    config.set_name("envoy.access_loggers.columnar");
+    config.mutable_typed_config()->PackFrom(columnar_config);
+
+    EXPECT_CALL(context_.access_log_manager_,
+                createAccessLog(Filesystem::FilePathAndType{Filesystem::DestinationType::File,
+                                                            "/dev/null"}))
+        .WillOnce(Return(file_));
+    EXPECT_CALL(*file_, write(_)).WillRepeatedly(Invoke([this](absl::string_view data) {
+      for (const std::string& payload : decodeBlocks(data)) {
+        blocks_.push_back(decodePayload(payload));
+      }
+    }));
+    flush_timer_ = new NiceMock<Event::MockTimer>(&context_.thread_local_.dispatcher_);
+    EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+    return AccessLog::AccessLogFactory::fromProto(config, context_);
+  }
+
+  void log(AccessLog::Instance& logger, uint32_t response_code) {
+    stream_info_.response_code_ = response_code;
+    logger.log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+  }
+
+  NiceMock<Server::Configuration::MockServerFactoryContext> context_;
+  std::shared_ptr<AccessLog::MockAccessLogFile> file_{
+      std::make_shared<AccessLog::MockAccessLogFile>()};
+  NiceMock<Event::MockTimer>* flush_timer_{};
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  Http::TestRequestHeaderMapImpl request_headers_{{":method", "GET"}, {":path", "/foo"}};
+  Http::TestResponseHeaderMapImpl response_headers_;
+  Http::TestResponseTrailerMapImpl response_trailers_;
+  std::vector<std::vector<DecodedColumn>> blocks_;
+};
+
+TEST_F(ColumnarAccessLogTest, ValidateFail) {
+  EXPECT_THROW(
+      ColumnarAccessLogFactory().createAccessLogInstance(ColumnarAccessLogConfig(), nullptr,
+                                                         context_),
+      ProtoValidationException);
+}
+
+TEST_F(ColumnarAccessLogTest, WritesFullBlocks) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+fields: [RESPONSE_CODE]
+max_entries_per_block: 2
+)EOF");
+
+  log(*logger, 200);
+  EXPECT_TRUE(blocks_.empty());
+  log(*logger, 404);
+  ASSERT_EQ(1, blocks_.size());
+  EXPECT_THAT(blocks_[0][0].values_, testing::ElementsAre("200", "404"));
+
+  // Partial blocks are written by the flush timer.
+  log(*logger, 503);
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  flush_timer_->invokeCallback();
+  ASSERT_EQ(2, blocks_.size());
+  EXPECT_THAT(blocks_[1][0].values_, testing::ElementsAre("503"));
+
+  // Nothing is written when there is nothing buffered.
+  EXPECT_CALL(*flush_timer_, enableTimer(std::chrono::milliseconds(1000), _));
+  flush_timer_->invokeCallback();
+  EXPECT_EQ(2, blocks_.size());
+}
+
+TEST_F(ColumnarAccessLogTest, WritesBufferedEntriesOnDestruction) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+fields: [RESPONSE_CODE, REQUEST_METHOD]
+)EOF");
+
+  log(*logger, 200);
+  EXPECT_TRUE(blocks_.empty());
+  logger.reset();
+  ASSERT_EQ(1, blocks_.size());
+  ASSERT_EQ(2, blocks_[0].size());
+  EXPECT_THAT(blocks_[0][0].values_, testing::ElementsAre("200"));
+  EXPECT_THAT(blocks_[0][1].values_, testing::ElementsAre("GET"));
+}
+
+TEST_F(ColumnarAccessLogTest, GzipCompression) {
+  AccessLog::InstanceSharedPtr logger = createLogger(R"EOF(
+path: /dev/null
+fields: [RESPONSE_CODE, REQUEST_PATH]
+max_entries_per_block: 100
+compression: GZIP
+)EOF");
+
+  for (uint32_t i = 0; i < 100; i++) {
+    log(*logger, 200 + i);
+  }
+  ASSERT_EQ(1, blocks_.size());
+  ASSERT_EQ(100, blocks_[0][0].values_.size());
+  EXPECT_EQ("200", blocks_[0][0].values_[0]);
+  EXPECT_EQ("299", blocks_[0][0].values_[99]);
+  EXPECT_EQ("/foo", blocks_[0][1].values_[99]);
+}
+
+} // namespace
+} // namespace Columnar
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -23,6 +23,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Extensions {
@@ -307,14 +308,56 @@ TEST_F(GrpcAccessLogTest, Flushing) {
   timer_->invokeCallback();
 }
 
+// Entries are queued by the shared logger and handed over to the logger on the main thread.
+TEST_F(GrpcAccessLogTest, SharedLogger) {
+  InSequence s;
+  initLogger(FlushInterval, 0);
+  NiceMock<Event::MockDispatcher> main_dispatcher;
+  auto shared_logger =
+      std::make_shared<Common::SharedGrpcAccessLogger<ProtobufWkt::Struct, ProtobufWkt::Empty>>(
+          main_dispatcher, 2,
+          Common::GrpcAccessLoggerStats{ALL_GRPC_ACCESS_LOGGER_STATS(
+              POOL_COUNTER_PREFIX(stats_store_, "mock_access_log_prefix."))});
+
+  // Only the first entry of a batch posts a drain.
+  Event::PostCb drain;
+  EXPECT_CALL(main_dispatcher, post(_)).WillOnce(SaveArg<0>(&drain));
+  shared_logger->log(mockHttpEntry());
+  shared_logger->log(ProtobufWkt::Empty());
+  // The queue is full.
+  shared_logger->log(mockHttpEntry());
+  EXPECT_EQ(1,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_dropped")->value());
+
+  // The entries stay queued until the logger is set.
+  drain();
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  expectFlushedLogEntriesCount(stream, MOCK_TCP_LOG_FIELD_NAME, 1);
+  shared_logger->setLogger(std::move(logger_));
+
+  // Once the queue has been drained, the next entry posts a drain again.
+  EXPECT_CALL(main_dispatcher, post(_)).WillOnce(SaveArg<0>(&drain));
+  shared_logger->log(mockHttpEntry());
+  expectFlushedLogEntriesCount(stream, MOCK_HTTP_LOG_FIELD_NAME, 1);
+  drain();
+  EXPECT_EQ(2,
+            TestUtility::findCounter(stats_store_, "mock_access_log_prefix.logs_written")->value());
+}
+
 class MockGrpcAccessLoggerCache
     : public Common::GrpcAccessLoggerCache<
           MockGrpcAccessLoggerImpl,
           envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig> {
 public:
   MockGrpcAccessLoggerCache(Grpc::AsyncClientManager& async_client_manager, Stats::Scope& scope,
-                            ThreadLocal::SlotAllocator& tls)
-      : GrpcAccessLoggerCache(async_client_manager, scope, tls) {}
+                            ThreadLocal::SlotAllocator& tls,
+                            Event::Dispatcher& main_thread_dispatcher)
+      : GrpcAccessLoggerCache(async_client_manager, scope, tls, main_thread_dispatcher,
+                              "mock_access_log_prefix.") {}
 
 private:
   // Common::GrpcAccessLoggerCache
@@ -331,7 +374,8 @@ private:
 
 class GrpcAccessLoggerCacheTest : public testing::Test {
 public:
-  GrpcAccessLoggerCacheTest() : logger_cache_(async_client_manager_, scope_, tls_) {}
+  GrpcAccessLoggerCacheTest()
+      : logger_cache_(async_client_manager_, scope_, tls_, tls_.dispatcher_) {}
 
   void expectClientCreation() {
     factory_ = new Grpc::MockAsyncClientFactory;
@@ -381,6 +425,27 @@ TEST_F(GrpcAccessLoggerCacheTest, Deduplication) {
   EXPECT_NE(logger1, logger_cache_.getOrCreateLogger(config, Common::GrpcAccessLoggerType::HTTP));
 }
 
+TEST_F(GrpcAccessLoggerCacheTest, SharedLogger) {
+  envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig config;
+  config.set_log_name("log-1");
+  config.mutable_grpc_service()->mutable_envoy_grpc()->set_cluster_name("cluster-1");
+  config.mutable_shared_export_queue_size()->set_value(100);
+
+  // The client of the logger which sends the entries is created on the main thread only.
+  expectClientCreation();
+  MockGrpcAccessLoggerImpl::SharedPtr logger1 =
+      logger_cache_.getOrCreateLogger(config, Common::GrpcAccessLoggerType::HTTP);
+  EXPECT_NE(nullptr,
+            dynamic_cast<Common::SharedGrpcAccessLogger<ProtobufWkt::Struct, ProtobufWkt::Empty>*>(
+                logger1.get()));
+  EXPECT_EQ(logger1, logger_cache_.getOrCreateLogger(config, Common::GrpcAccessLoggerType::HTTP));
+
+  // Loggers which send their own entries are not shared.
+  config.clear_shared_export_queue_size();
+  expectClientCreation();
+  EXPECT_NE(logger1, logger_cache_.getOrCreateLogger(config, Common::GrpcAccessLoggerType::HTTP));
+}
+
 } // namespace
 } // namespace GrpcCommon
 } // namespace AccessLoggers
@@ -126,7 +126,7 @@ class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest()
       : async_client_(new Grpc::MockAsyncClient), factory_(new Grpc::MockAsyncClientFactory),
-        logger_cache_(async_client_manager_, scope_, tls_, local_info_),
+        logger_cache_(async_client_manager_, scope_, tls_, tls_.dispatcher_, local_info_),
         grpc_access_logger_impl_test_helper_(local_info_, async_client_) {
     EXPECT_CALL(async_client_manager_, factoryForGrpcService(_, _, true))
         .WillOnce(Invoke([this](const envoy::config::core::v3::GrpcService&, Stats::Scope&, bool) {
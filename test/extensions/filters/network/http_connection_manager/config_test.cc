@@ -514,6 +514,7 @@ TEST_F(HttpConnectionManagerConfigTest, SamplingDefault) {
 
   EXPECT_EQ(100, config.tracingConfig()->client_sampling_.numerator());
   EXPECT_EQ(Tracing::DefaultMaxPathTagLength, config.tracingConfig()->max_path_tag_length_);
+  EXPECT_EQ(nullptr, config.tracingConfig()->tail_sampler_);
   EXPECT_EQ(envoy::type::v3::FractionalPercent::HUNDRED,
             config.tracingConfig()->client_sampling_.denominator());
   EXPECT_EQ(10000, config.tracingConfig()->random_sampling_.numerator());
@@ -558,6 +559,79 @@ TEST_F(HttpConnectionManagerConfigTest, SamplingConfigured) {
             config.tracingConfig()->overall_sampling_.denominator());
 }
 
+TEST_F(HttpConnectionManagerConfigTest, TailSamplingConfigured) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  tracing:
+    tail_sampling:
+      latency_threshold: 1s
+      keep_errors: true
+      max_buffered_spans: 100
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  ASSERT_NE(nullptr, config.tracingConfig()->tail_sampler_);
+  EXPECT_EQ(0U, config.tracingConfig()->tail_sampler_->stats().traces_kept_.value());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, TimingBreakdownDisabledByDefault) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  EXPECT_EQ(nullptr, config.timingBreakdownStats());
+}
+
+TEST_F(HttpConnectionManagerConfigTest, TimingBreakdownConfigured) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  record_timing_breakdown: true
+  upgrade_configs:
+  - upgrade_type: websocket
+    filters:
+    - name: encoder-decoder-buffer-filter
+      typed_config:
+        "@type": type.googleapis.com/google.protobuf.Empty
+    - name: envoy.filters.http.router
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromYaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_,
+                                     filter_config_provider_manager_);
+
+  ASSERT_NE(nullptr, config.timingBreakdownStats());
+  for (const std::string& name :
+       {"route_selection_time", "filter.envoy.filters.http.router.decode_time",
+        "filter.encoder-decoder-buffer-filter.encode_time"}) {
+    EXPECT_TRUE(
+        context_.scope_.findHistogramByString("http.ingress_http.timing_breakdown." + name)
+            .has_value())
+        << name;
+  }
+}
+
 TEST_F(HttpConnectionManagerConfigTest, FractionalSamplingConfigured) {
   const std::string yaml_string = R"EOF(
   stat_prefix: ingress_http
@@ -0,0 +1,316 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/grpc/common.h"
+#include "source/common/tracing/common_values.h"
+#include "source/common/tracing/null_span_impl.h"
+#include "source/extensions/tracers/opentelemetry/opentelemetry_tracer_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/grpc/mocks.h"
+#include "test/mocks/server/tracer_factory_context.h"
+#include "test/mocks/tracing/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/escaping.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "opentelemetry/proto/trace/v1/trace.pb.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+namespace {
+
+using opentelemetry::proto::trace::v1::Span_SpanKind_SPAN_KIND_CLIENT;
+using opentelemetry::proto::trace::v1::Span_SpanKind_SPAN_KIND_SERVER;
+
+class OpenTelemetryDriverTest : public testing::Test {
+public:
+  OpenTelemetryDriverTest()
+      : timer_(new NiceMock<Event::MockTimer>(
+            &context_.server_factory_context_.thread_local_.dispatcher_)) {}
+
+  void setupDriver(const std::string& yaml_string) {
+    auto mock_client_factory = std::make_unique<NiceMock<Grpc::MockAsyncClientFactory>>();
+    auto mock_client = std::make_unique<NiceMock<Grpc::MockAsyncClient>>();
+    mock_client_ = mock_client.get();
+    EXPECT_CALL(*mock_client_factory, createUncachedRawAsyncClient())
+        .WillOnce(Return(ByMove(std::move(mock_client))));
+
+    auto& factory_context = context_.server_factory_context_;
+    EXPECT_CALL(factory_context.cluster_manager_.async_client_manager_,
+                factoryForGrpcService(_, _, _))
+        .WillOnce(Return(ByMove(std::move(mock_client_factory))));
+    ON_CALL(factory_context.api_.random_, random()).WillByDefault(Invoke([this] {
+      return ++next_id_;
+    }));
+    ON_CALL(mock_tracing_config_, operationName())
+        .WillByDefault(Return(Tracing::OperationName::Ingress));
+
+    TestUtility::loadFromYaml(yaml_string, config_);
+    driver_ = std::make_unique<Driver>(config_, context_);
+  }
+
+  // Expects the next export, whose request is parsed into exported_.
+  void expectExport() {
+    EXPECT_CALL(*mock_client_, sendRaw(_, _, _, _, _, _))
+        .WillOnce(Invoke([this](absl::string_view service_full_name, absl::string_view method_name,
+                                Buffer::InstancePtr&& request,
+                                Grpc::RawAsyncRequestCallbacks& callbacks, Tracing::Span&,
+                                const Http::AsyncClient::RequestOptions&) {
+          EXPECT_EQ("opentelemetry.proto.collector.trace.v1.TraceService", service_full_name);
+          EXPECT_EQ("Export", method_name);
+          exported_.Clear();
+          EXPECT_TRUE(Grpc::Common::parseBufferInstance(std::move(request), exported_));
+          callbacks_ = &callbacks;
+          return &async_request_;
+        }));
+  }
+
+  Tracing::SpanPtr startSpan(Tracing::TraceContext& trace_context, bool traced = true) {
+    Tracing::Decision decision;
+    decision.traced = traced;
+    return driver_->startSpan(mock_tracing_config_, trace_context, "operation",
+                              time_system_.systemTime(), decision);
+  }
+
+  const SpanData& spanData(const Tracing::SpanPtr& span) {
+    return dynamic_cast<Span*>(span.get())->data();
+  }
+
+  uint64_t counter(const std::string& name) {
+    return context_.server_factory_context_.scope_.counter("tracing.opentelemetry." + name)
+        .value();
+  }
+
+protected:
+  NiceMock<Server::Configuration::MockTracerFactoryContext> context_;
+  NiceMock<Tracing::MockConfig> mock_tracing_config_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<Event::MockTimer>* timer_;
+  NiceMock<Grpc::MockAsyncClient>* mock_client_{};
+  NiceMock<Grpc::MockAsyncRequest> async_request_;
+  Grpc::RawAsyncRequestCallbacks* callbacks_{};
+  ExportTraceServiceRequest exported_;
+  uint64_t next_id_{};
+  envoy::config::trace::v3::OpenTelemetryConfig config_;
+  DriverPtr driver_;
+};
+
+const std::string DefaultConfig = R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: fake_cluster
+  service_name: test-service
+  max_queue_size: 3
+  max_export_batch_size: 2
+  export_interval: 1s
+)EOF";
+
+TEST_F(OpenTelemetryDriverTest, ExportsFullBatch) {
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  // The batch is not full yet.
+  EXPECT_CALL(*mock_client_, sendRaw(_, _, _, _, _, _)).Times(0);
+  Tracing::SpanPtr first = startSpan(request_headers);
+  first->finishSpan();
+  testing::Mock::VerifyAndClearExpectations(mock_client_);
+
+  Tracing::SpanPtr second = startSpan(request_headers);
+  second->setOperation("renamed");
+  expectExport();
+  second->finishSpan();
+
+  ASSERT_EQ(1, exported_.resource_spans_size());
+  const auto& resource_spans = exported_.resource_spans(0);
+  ASSERT_EQ(1, resource_spans.resource().attributes_size());
+  EXPECT_EQ("service.name", resource_spans.resource().attributes(0).key());
+  EXPECT_EQ("test-service", resource_spans.resource().attributes(0).value().string_value());
+  ASSERT_EQ(1, resource_spans.instrumentation_library_spans_size());
+  const auto& library_spans = resource_spans.instrumentation_library_spans(0);
+  EXPECT_EQ("envoy", library_spans.instrumentation_library().name());
+  ASSERT_EQ(2, library_spans.spans_size());
+  EXPECT_EQ("operation", library_spans.spans(0).name());
+  EXPECT_EQ("renamed", library_spans.spans(1).name());
+  EXPECT_EQ(Span_SpanKind_SPAN_KIND_SERVER, library_spans.spans(0).kind());
+  // A root span has no parent.
+  EXPECT_TRUE(library_spans.spans(0).parent_span_id().empty());
+  EXPECT_EQ(absl::HexStringToBytes("00000000000000010000000000000002"),
+            library_spans.spans(0).trace_id());
+  EXPECT_EQ(absl::HexStringToBytes("0000000000000003"), library_spans.spans(0).span_id());
+
+  EXPECT_EQ(2U, counter("spans_sent"));
+  EXPECT_EQ(1U, counter("exports_sent"));
+  EXPECT_EQ(0U, counter("spans_dropped"));
+
+  callbacks_->onSuccessRaw(std::make_unique<Buffer::OwnedImpl>(), Tracing::NullSpan::instance());
+  EXPECT_EQ(0U, counter("exports_failed"));
+}
+
+TEST_F(OpenTelemetryDriverTest, ExportsOnTimer) {
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(1000), _)).Times(2);
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  Tracing::SpanPtr span = startSpan(request_headers);
+  span->finishSpan();
+
+  expectExport();
+  timer_->invokeCallback();
+  EXPECT_EQ(1U, counter("timer_flushed"));
+  EXPECT_EQ(1U, counter("spans_sent"));
+  ASSERT_EQ(1, exported_.resource_spans(0).instrumentation_library_spans(0).spans_size());
+}
+
+TEST_F(OpenTelemetryDriverTest, DropsSpansWhenQueueIsFull) {
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  expectExport();
+  for (int i = 0; i < 2; ++i) {
+    startSpan(request_headers)->finishSpan();
+  }
+  EXPECT_EQ(1U, counter("exports_sent"));
+
+  // The spans queue up while the export is in flight, until the queue is full.
+  for (int i = 0; i < 4; ++i) {
+    startSpan(request_headers)->finishSpan();
+  }
+  EXPECT_EQ(1U, counter("exports_sent"));
+  EXPECT_EQ(1U, counter("spans_dropped"));
+
+  callbacks_->onFailure(Grpc::Status::Unavailable, "unavailable", Tracing::NullSpan::instance());
+  EXPECT_EQ(1U, counter("exports_failed"));
+
+  // Once the export completes, the next batch is exported on the timer.
+  expectExport();
+  timer_->invokeCallback();
+  EXPECT_EQ(2U, counter("exports_sent"));
+  EXPECT_EQ(4U, counter("spans_sent"));
+  EXPECT_EQ(2, exported_.resource_spans(0).instrumentation_library_spans(0).spans_size());
+
+  // The last queued span is exported on the next tick.
+  callbacks_->onSuccessRaw(std::make_unique<Buffer::OwnedImpl>(), Tracing::NullSpan::instance());
+  expectExport();
+  timer_->invokeCallback();
+  EXPECT_EQ(5U, counter("spans_sent"));
+}
+
+TEST_F(OpenTelemetryDriverTest, CancelsInFlightExportOnDestruction) {
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  expectExport();
+  for (int i = 0; i < 2; ++i) {
+    startSpan(request_headers)->finishSpan();
+  }
+
+  EXPECT_CALL(async_request_, cancel());
+  driver_.reset();
+}
+
+TEST_F(OpenTelemetryDriverTest, UnsampledSpansAreNotExported) {
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  EXPECT_CALL(*mock_client_, sendRaw(_, _, _, _, _, _)).Times(0);
+  for (int i = 0; i < 2; ++i) {
+    startSpan(request_headers, false)->finishSpan();
+  }
+  timer_->invokeCallback();
+  EXPECT_EQ(0U, counter("spans_sent"));
+}
+
+TEST_F(OpenTelemetryDriverTest, ContinuesRemoteParent) {
+  setupDriver(DefaultConfig);
+  ON_CALL(mock_tracing_config_, operationName())
+      .WillByDefault(Return(Tracing::OperationName::Egress));
+  // The remote parent is sampled, whatever the decision of Envoy.
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"traceparent", "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01"},
+      {"tracestate", "congo=t61rcWkgMzE"}};
+  Tracing::SpanPtr span = startSpan(request_headers, false);
+  EXPECT_EQ("0af7651916cd43dd8448eb211c80319c", span->getTraceIdAsHex());
+
+  Http::TestRequestHeaderMapImpl upstream_headers;
+  span->injectContext(upstream_headers);
+  EXPECT_EQ("00-0af7651916cd43dd8448eb211c80319c-0000000000000001-01",
+            upstream_headers.get_("traceparent"));
+  EXPECT_EQ("congo=t61rcWkgMzE", upstream_headers.get_("tracestate"));
+
+  Tracing::SpanPtr child =
+      span->spawnChild(mock_tracing_config_, "child", time_system_.systemTime());
+  EXPECT_EQ(1U, spanData(child).parent_span_id_);
+  EXPECT_EQ(2U, spanData(child).context_.spanId());
+
+  expectExport();
+  child->finishSpan();
+  span->finishSpan();
+
+  const auto& spans = exported_.resource_spans(0).instrumentation_library_spans(0).spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ("child", spans[0].name());
+  EXPECT_EQ(Span_SpanKind_SPAN_KIND_CLIENT, spans[0].kind());
+  EXPECT_EQ(absl::HexStringToBytes("0000000000000001"), spans[0].parent_span_id());
+  EXPECT_EQ(Span_SpanKind_SPAN_KIND_CLIENT, spans[1].kind());
+  EXPECT_EQ(absl::HexStringToBytes("0af7651916cd43dd8448eb211c80319c"), spans[1].trace_id());
+  EXPECT_EQ(absl::HexStringToBytes("b7ad6b7169203331"), spans[1].parent_span_id());
+  EXPECT_EQ("congo=t61rcWkgMzE", spans[1].trace_state());
+}
+
+TEST_F(OpenTelemetryDriverTest, TagsAndEvents) {
+  setupDriver(DefaultConfig);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  Tracing::SpanPtr span = startSpan(request_headers);
+  span->setTag("http.method", "GET");
+  span->setTag("http.status_code", "200");
+  span->setTag("http.status_code", "503");
+  span->setTag(Tracing::Tags::get().Error, Tracing::Tags::get().True);
+  span->log(time_system_.systemTime(), "upstream failure");
+  // Baggage is not supported.
+  span->setBaggage("key", "value");
+  EXPECT_EQ("", span->getBaggage("key"));
+
+  expectExport();
+  span->finishSpan();
+  startSpan(request_headers)->finishSpan();
+
+  const auto& exported = exported_.resource_spans(0).instrumentation_library_spans(0).spans(0);
+  ASSERT_EQ(2, exported.attributes_size());
+  EXPECT_EQ("http.method", exported.attributes(0).key());
+  EXPECT_EQ("GET", exported.attributes(0).value().string_value());
+  EXPECT_EQ("http.status_code", exported.attributes(1).key());
+  EXPECT_EQ("503", exported.attributes(1).value().string_value());
+  ASSERT_EQ(1, exported.events_size());
+  EXPECT_EQ("upstream failure", exported.events(0).name());
+  EXPECT_EQ(opentelemetry::proto::trace::v1::Status::STATUS_CODE_ERROR, exported.status().code());
+}
+
+TEST(OpenTelemetryAttributeKeyPoolTest, InternsBoundedNumberOfKeys) {
+  AttributeKeyPool pool(2);
+  const auto method = pool.intern("http.method");
+  ASSERT_TRUE(method.has_value());
+  ASSERT_TRUE(pool.intern("http.url").has_value());
+
+  // Interning a key again returns the same copy of it.
+  const auto again = pool.intern(std::string("http.method"));
+  ASSERT_TRUE(again.has_value());
+  EXPECT_EQ(method->data(), again->data());
+
+  // New keys are not interned once the pool is full.
+  EXPECT_FALSE(pool.intern("http.status_code").has_value());
+  EXPECT_EQ(2U, pool.size());
+}
+
+} // namespace
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,103 @@
+#include "source/extensions/tracers/opentelemetry/span_context.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace OpenTelemetry {
+namespace {
+
+TEST(OpenTelemetrySpanContextTest, ExtractValidTraceParent) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"traceparent", "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01"},
+      {"tracestate", "congo=t61rcWkgMzE"}};
+
+  const auto context = SpanContext::extract(request_headers);
+  ASSERT_TRUE(context.has_value());
+  EXPECT_EQ(0x0af7651916cd43ddULL, context->traceIdHigh());
+  EXPECT_EQ(0x8448eb211c80319cULL, context->traceIdLow());
+  EXPECT_EQ(0xb7ad6b7169203331ULL, context->spanId());
+  EXPECT_TRUE(context->sampled());
+  EXPECT_EQ("congo=t61rcWkgMzE", context->traceState());
+  EXPECT_EQ("0af7651916cd43dd8448eb211c80319c", context->traceIdAsHex());
+}
+
+TEST(OpenTelemetrySpanContextTest, ExtractUnsampledTraceParent) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"traceparent", "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-00"}};
+
+  const auto context = SpanContext::extract(request_headers);
+  ASSERT_TRUE(context.has_value());
+  EXPECT_FALSE(context->sampled());
+  EXPECT_TRUE(context->traceState().empty());
+}
+
+TEST(OpenTelemetrySpanContextTest, ExtractLaterVersion) {
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"traceparent", "01-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01-extra"}};
+
+  const auto context = SpanContext::extract(request_headers);
+  ASSERT_TRUE(context.has_value());
+  EXPECT_EQ(0xb7ad6b7169203331ULL, context->spanId());
+}
+
+TEST(OpenTelemetrySpanContextTest, ExtractInvalidTraceParent) {
+  for (const std::string trace_parent : {
+           // Missing fields.
+           "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331",
+           // Version 00 does not have any more fields.
+           "00-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01-extra",
+           // Invalid version.
+           "ff-0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01",
+           // Uppercase hex digits.
+           "00-0AF7651916CD43DD8448EB211C80319C-b7ad6b7169203331-01",
+           // Wrong delimiter.
+           "00_0af7651916cd43dd8448eb211c80319c-b7ad6b7169203331-01",
+           // All zero trace ID.
+           "00-00000000000000000000000000000000-b7ad6b7169203331-01",
+           // All zero span ID.
+           "00-0af7651916cd43dd8448eb211c80319c-0000000000000000-01",
+       }) {
+    Http::TestRequestHeaderMapImpl request_headers{{"traceparent", trace_parent}};
+    EXPECT_FALSE(SpanContext::extract(request_headers).has_value()) << trace_parent;
+  }
+
+  Http::TestRequestHeaderMapImpl request_headers;
+  EXPECT_FALSE(SpanContext::extract(request_headers).has_value());
+}
+
+TEST(OpenTelemetrySpanContextTest, Inject) {
+  SpanContext context(0x0af7651916cd43ddULL, 0x8448eb211c80319cULL, 0x00f067aa0ba902b7ULL, true,
+                      "congo=t61rcWkgMzE");
+  Http::TestRequestHeaderMapImpl request_headers;
+  context.inject(request_headers);
+
+  EXPECT_EQ("00-0af7651916cd43dd8448eb211c80319c-00f067aa0ba902b7-01",
+            request_headers.get_("traceparent"));
+  EXPECT_EQ("congo=t61rcWkgMzE", request_headers.get_("tracestate"));
+
+  // The injected context is extracted unchanged.
+  const auto extracted = SpanContext::extract(request_headers);
+  ASSERT_TRUE(extracted.has_value());
+  EXPECT_EQ(context.traceParent(), extracted->traceParent());
+  EXPECT_EQ(context.traceState(), extracted->traceState());
+}
+
+TEST(OpenTelemetrySpanContextTest, InjectWithoutTraceState) {
+  SpanContext context(1, 2, 3, false, "");
+  Http::TestRequestHeaderMapImpl request_headers;
+  context.inject(request_headers);
+
+  EXPECT_EQ("00-00000000000000010000000000000002-0000000000000003-00",
+            request_headers.get_("traceparent"));
+  EXPECT_FALSE(request_headers.has("tracestate"));
+}
+
+} // namespace
+} // namespace OpenTelemetry
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -6,6 +6,7 @@
 #include "source/extensions/tracers/zipkin/util.h"
 
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_format.h"
@@ -422,6 +423,35 @@ TEST(ZipkinSpanBufferTest, SerializeSpan) {
             serializedMessageToJson<zipkin::proto3::ListOfSpans>(buffer6.serialize()));
 }
 
+// The JSON spans written directly match the ones which go through a ProtobufWkt::Struct.
+TEST(ZipkinSpanBufferTest, DirectJsonSerializationMatchesStruct) {
+  const auto add_spans = [](SpanBuffer& buffer) {
+    buffer.addSpan(createSpan({"cs", "sr", "log_1", "log_2"}, IpType::V4));
+    buffer.addSpan(createSpan({"sr"}, IpType::V6));
+    Span span = createSpan({"cs"}, IpType::V4);
+    span.setName("quoted \"name\"\n");
+    span.setParentId(2);
+    span.setTag("escaped\\key", "a\"b");
+    span.setTag("escaped\\key", "last value");
+    buffer.addSpan(std::move(span));
+  };
+
+  for (const bool shared : {false, true}) {
+    SpanBuffer direct(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, shared, 3);
+    add_spans(direct);
+
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.zipkin_direct_json_serialization", "false"}});
+    SpanBuffer legacy(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, shared, 3);
+    add_spans(legacy);
+
+    EXPECT_THAT(wrapAsObject(direct.serialize()), JsonStringEq(wrapAsObject(legacy.serialize())));
+    EXPECT_THAT(direct.serialize(), HasSubstr(R"("timestamp":1584324295476871)"));
+    EXPECT_THAT(direct.serialize(), HasSubstr(R"("duration":2584324295476870)"));
+  }
+}
+
 TEST(ZipkinSpanBufferTest, TestSerializeTimestampInTheFuture) {
   ProtobufWkt::Struct objectWithScientificNotation;
   auto* objectWithScientificNotationFields = objectWithScientificNotation.mutable_fields();
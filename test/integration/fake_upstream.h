@@ -216,6 +216,7 @@ public:
     RELEASE_ASSERT(false, "initialize if this is needed");
     return *stream_info_;
   }
+  Http::HeaderMapArenaSharedPtr headerMapArena() override { return nullptr; }
 
   // Http::StreamCallbacks
   void onResetStream(Http::StreamResetReason reason,
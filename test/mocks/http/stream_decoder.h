@@ -31,6 +31,10 @@ public:
   // Http::RequestDecoder
   MOCK_METHOD(void, decodeHeaders_, (RequestHeaderMapPtr & headers, bool end_stream));
   MOCK_METHOD(void, decodeTrailers_, (RequestTrailerMapPtr & trailers));
+  // Not mocked so that strict mocks do not have to expect it.
+  HeaderMapArenaSharedPtr headerMapArena() override { return header_map_arena_; }
+
+  HeaderMapArenaSharedPtr header_map_arena_;
 };
 
 class MockResponseDecoder : public ResponseDecoder {
@@ -140,6 +140,17 @@ MockStreamInfo::MockStreamInfo()
       .WillByDefault(Invoke([this](const BytesMeterSharedPtr& downstream_bytes_meter) {
         downstream_bytes_meter_ = downstream_bytes_meter;
       }));
+  ON_CALL(*this, enableTimingBreakdown()).WillByDefault(Invoke([this]() {
+    if (timing_breakdown_ == nullptr) {
+      timing_breakdown_ = std::make_unique<TimingBreakdown>();
+    }
+  }));
+  ON_CALL(*this, timingBreakdown()).WillByDefault(Invoke([this]() {
+    return timing_breakdown_.get();
+  }));
+  ON_CALL(Const(*this), timingBreakdown()).WillByDefault(Invoke([this]() {
+    return timing_breakdown_.get();
+  }));
 }
 
 MockStreamInfo::~MockStreamInfo() = default;
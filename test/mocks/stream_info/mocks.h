@@ -106,6 +106,9 @@ public:
   MOCK_METHOD(const BytesMeterSharedPtr&, getDownstreamBytesMeter, (), (const));
   MOCK_METHOD(void, setUpstreamBytesMeter, (const BytesMeterSharedPtr&));
   MOCK_METHOD(void, setDownstreamBytesMeter, (const BytesMeterSharedPtr&));
+  MOCK_METHOD(void, enableTimingBreakdown, ());
+  MOCK_METHOD(TimingBreakdown*, timingBreakdown, ());
+  MOCK_METHOD(const TimingBreakdown*, timingBreakdown, (), (const));
   std::shared_ptr<testing::NiceMock<Upstream::MockHostDescription>> host_{
       new testing::NiceMock<Upstream::MockHostDescription>()};
   Envoy::Event::SimulatedTimeSystem ts_;
@@ -134,6 +137,7 @@ public:
   std::shared_ptr<Network::ConnectionInfoSetterImpl> downstream_connection_info_provider_;
   BytesMeterSharedPtr upstream_bytes_meter_;
   BytesMeterSharedPtr downstream_bytes_meter_;
+  std::unique_ptr<TimingBreakdown> timing_breakdown_;
   Ssl::ConnectionInfoConstSharedPtr downstream_connection_info_;
   Ssl::ConnectionInfoConstSharedPtr upstream_connection_info_;
   std::string route_name_;
@@ -1,7 +1,9 @@
+#include "source/common/profiler/continuous_profiler.h"
 #include "source/common/profiler/profiler.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
+#include "test/test_common/utility.h"
 
 namespace Envoy {
 namespace Server {
@@ -78,5 +80,44 @@ TEST_P(AdminInstanceTest, AdminBadProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminProfileNotConfigured) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+#ifdef __linux__
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/profile", header_map, data));
+#else
+  EXPECT_EQ(Http::Code::NotImplemented, getCallback("/profile", header_map, data));
+#endif
+}
+
+#ifdef __linux__
+TEST_P(AdminInstanceTest, AdminProfile) {
+  envoy::config::bootstrap::v3::Admin::ContinuousProfiling config;
+  config.mutable_max_samples()->set_value(16);
+  admin_.startContinuousProfiler(config);
+  EXPECT_TRUE(Profiler::ContinuousCpu::isProfilerStarted());
+  EXPECT_THROW_WITH_MESSAGE(admin_.startContinuousProfiler(config), EnvoyException,
+                            "failed to start the continuous profiler");
+
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/profile?seconds=10", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/profile?seconds=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest, getCallback("/profile?format=svg", header_map, data));
+
+  Buffer::OwnedImpl profile;
+  EXPECT_EQ(Http::Code::OK, getCallback("/profile?format=pprof", header_map, profile));
+  EXPECT_EQ("application/octet-stream", header_map.getContentTypeValue());
+  // The header records the sampling period of 19 Hz.
+  const uintptr_t header[] = {0, 3, 0, 52631, 0};
+  ASSERT_GE(profile.length(), sizeof(header));
+  EXPECT_EQ(0, memcmp(header, profile.linearize(sizeof(header)), sizeof(header)));
+
+  // Both profilers sample on SIGPROF.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+}
+#endif
+
 } // namespace Server
 } // namespace Envoy